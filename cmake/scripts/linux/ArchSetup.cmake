@@ -165,6 +165,15 @@ else()
   message(STATUS "memfd_create() not found")
 endif()
 
+set(CMAKE_REQUIRED_DEFINITIONS "-D_GNU_SOURCE")
+check_symbol_exists("copy_file_range" "unistd.h" HAVE_COPY_FILE_RANGE)
+set(CMAKE_REQUIRED_DEFINITIONS "")
+if(HAVE_COPY_FILE_RANGE)
+  list(APPEND ARCH_DEFINES "-DHAVE_COPY_FILE_RANGE=1")
+else()
+  message(STATUS "copy_file_range() not found")
+endif()
+
 # Additional SYSTEM_DEFINES
 list(APPEND SYSTEM_DEFINES -DHAS_POSIX_NETWORK -DHAS_LINUX_NETWORK)
 
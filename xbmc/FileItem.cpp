@@ -161,7 +161,7 @@ CFileItem::CFileItem(const std::shared_ptr<CPVREpgInfoTag>& tag)
   Initialize();
 
   m_bIsFolder = false;
-  m_epgInfoTag = tag;
+  GetExtras().epgInfoTag = tag;
   m_strPath = tag->Path();
   m_bCanQueue = false;
   SetLabel(GetEpgTagTitle(tag));
@@ -196,7 +196,7 @@ CFileItem::CFileItem(const std::shared_ptr<PVR::CPVREpgSearchFilter>& filter)
   Initialize();
 
   m_bIsFolder = true;
-  m_epgSearchFilter = filter;
+  GetExtras().epgSearchFilter = filter;
   m_strPath = filter->GetPath();
   m_bCanQueue = false;
   SetLabel(filter->GetTitle());
@@ -219,7 +219,7 @@ CFileItem::CFileItem(const std::shared_ptr<CPVRChannelGroupMember>& channelGroup
 
   const std::shared_ptr<const CPVRChannel> channel = channelGroupMember->Channel();
 
-  m_pvrChannelGroupMemberInfoTag = channelGroupMember;
+  GetExtras().pvrChannelGroupMemberInfoTag = channelGroupMember;
 
   m_strPath = channelGroupMember->Path();
   m_bIsFolder = false;
@@ -253,7 +253,7 @@ CFileItem::CFileItem(const std::shared_ptr<CPVRRecording>& record)
   Initialize();
 
   m_bIsFolder = false;
-  m_pvrRecordingInfoTag = record;
+  GetExtras().pvrRecordingInfoTag = record;
   m_strPath = record->m_strFileNameAndPath;
   SetLabel(record->m_strTitle);
   m_dateTime = record->RecordingTimeAsLocalTime();
@@ -291,7 +291,7 @@ CFileItem::CFileItem(const std::shared_ptr<CPVRTimerInfoTag>& timer)
   Initialize();
 
   m_bIsFolder = timer->IsTimerRule();
-  m_pvrTimerInfoTag = timer;
+  GetExtras().pvrTimerInfoTag = timer;
   m_strPath = timer->Path();
   SetLabel(timer->Title());
   m_dateTime = timer->StartAsLocalTime();
@@ -422,7 +422,7 @@ CFileItem::CFileItem(const EventPtr& eventLogEntry)
 {
   Initialize();
 
-  m_eventLogEntry = eventLogEntry;
+  GetExtras().eventLogEntry = eventLogEntry;
   SetLabel(eventLogEntry->GetLabel());
   m_dateTime = eventLogEntry->GetDateTime();
   if (!eventLogEntry->GetIcon().empty())
@@ -510,13 +510,8 @@ CFileItem& CFileItem::operator=(const CFileItem& item)
     m_gameInfoTag = NULL;
   }
 
-  m_epgInfoTag = item.m_epgInfoTag;
-  m_epgSearchFilter = item.m_epgSearchFilter;
-  m_pvrChannelGroupMemberInfoTag = item.m_pvrChannelGroupMemberInfoTag;
-  m_pvrRecordingInfoTag = item.m_pvrRecordingInfoTag;
-  m_pvrTimerInfoTag = item.m_pvrTimerInfoTag;
+  m_extras = item.m_extras ? std::make_unique<Extras>(*item.m_extras) : nullptr;
   m_addonInfo = item.m_addonInfo;
-  m_eventLogEntry = item.m_eventLogEntry;
 
   m_lStartOffset = item.m_lStartOffset;
   m_lStartPartNumber = item.m_lStartPartNumber;
@@ -531,7 +526,6 @@ CFileItem& CFileItem::operator=(const CFileItem& item)
   m_iBadPwdCount = item.m_iBadPwdCount;
   m_bCanQueue=item.m_bCanQueue;
   m_mimetype = item.m_mimetype;
-  m_extrainfo = item.m_extrainfo;
   m_specialSort = item.m_specialSort;
   m_bIsAlbum = item.m_bIsAlbum;
   m_doContentLookup = item.m_doContentLookup;
@@ -563,6 +557,24 @@ void CFileItem::Initialize()
   m_doContentLookup = true;
 }
 
+CFileItem::Extras& CFileItem::GetExtras()
+{
+  if (!m_extras)
+    m_extras = std::make_unique<Extras>();
+  return *m_extras;
+}
+
+void CFileItem::SetExtraInfo(const std::string& info)
+{
+  if (m_extras || !info.empty())
+    GetExtras().extraInfo = info;
+}
+
+const std::string& CFileItem::GetExtraInfo() const
+{
+  return m_extras ? m_extras->extraInfo : StringUtils::Empty;
+}
+
 void CFileItem::Reset()
 {
   // CGUIListItem members...
@@ -584,18 +596,12 @@ void CFileItem::Reset()
   m_musicInfoTag=NULL;
   delete m_videoInfoTag;
   m_videoInfoTag=NULL;
-  m_epgInfoTag.reset();
-  m_epgSearchFilter.reset();
-  m_pvrChannelGroupMemberInfoTag.reset();
-  m_pvrRecordingInfoTag.reset();
-  m_pvrTimerInfoTag.reset();
+  m_extras.reset();
   delete m_pictureInfoTag;
   m_pictureInfoTag=NULL;
   delete m_gameInfoTag;
   m_gameInfoTag = NULL;
-  m_extrainfo.clear();
   ClearProperties();
-  m_eventLogEntry.reset();
 
   Initialize();
   SetInvalid();
@@ -628,7 +634,7 @@ void CFileItem::Archive(CArchive& ar)
 
     ar << m_bCanQueue;
     ar << m_mimetype;
-    ar << m_extrainfo;
+    ar << GetExtraInfo();
     ar << m_specialSort;
     ar << m_doContentLookup;
 
@@ -686,7 +692,9 @@ void CFileItem::Archive(CArchive& ar)
 
     ar >> m_bCanQueue;
     ar >> m_mimetype;
-    ar >> m_extrainfo;
+    std::string extraInfo;
+    ar >> extraInfo;
+    SetExtraInfo(extraInfo);
     ar >> temp;
     m_specialSort = (SortSpecial)temp;
     ar >> m_doContentLookup;
@@ -720,7 +728,7 @@ void CFileItem::Serialize(CVariant& value) const
   value["DVDLabel"] = m_strDVDLabel;
   value["title"] = m_strTitle;
   value["mimetype"] = m_mimetype;
-  value["extrainfo"] = m_extrainfo;
+  value["extrainfo"] = GetExtraInfo();
 
   if (m_musicInfoTag)
     (*m_musicInfoTag).Serialize(value["musicInfoTag"]);
@@ -817,8 +825,8 @@ void CFileItem::ToSortable(SortItem &sortable, Field field) const
   if (HasGameInfoTag())
     GetGameInfoTag()->ToSortable(sortable, field);
 
-  if (m_eventLogEntry)
-    m_eventLogEntry->ToSortable(sortable, field);
+  if (m_extras && m_extras->eventLogEntry)
+    m_extras->eventLogEntry->ToSortable(sortable, field);
 
   if (IsFavourite())
   {
@@ -940,17 +948,17 @@ bool CFileItem::IsPVRRecording() const
 
 bool CFileItem::IsUsablePVRRecording() const
 {
-  return (m_pvrRecordingInfoTag && !m_pvrRecordingInfoTag->IsDeleted());
+  return (HasPVRRecordingInfoTag() && !m_extras->pvrRecordingInfoTag->IsDeleted());
 }
 
 bool CFileItem::IsDeletedPVRRecording() const
 {
-  return (m_pvrRecordingInfoTag && m_pvrRecordingInfoTag->IsDeleted());
+  return (HasPVRRecordingInfoTag() && m_extras->pvrRecordingInfoTag->IsDeleted());
 }
 
 bool CFileItem::IsInProgressPVRRecording() const
 {
-  return (m_pvrRecordingInfoTag && m_pvrRecordingInfoTag->IsInProgress());
+  return (HasPVRRecordingInfoTag() && m_extras->pvrRecordingInfoTag->IsInProgress());
 }
 
 bool CFileItem::IsPVRTimer() const
@@ -1753,7 +1761,8 @@ void CFileItem::UpdateInfo(const CFileItem &item, bool replaceLabels /*=true*/)
       m_videoInfoTag = new CVideoInfoTag;
     }
 
-    m_pvrRecordingInfoTag = item.m_pvrRecordingInfoTag;
+    if (item.HasPVRRecordingInfoTag() || HasPVRRecordingInfoTag())
+      GetExtras().pvrRecordingInfoTag = item.GetPVRRecordingInfoTag();
 
     SetOverlayImage(GetVideoInfoTag()->GetPlayCount() > 0 ? CGUIListItem::ICON_OVERLAY_WATCHED
                                                           : CGUIListItem::ICON_OVERLAY_UNWATCHED);
@@ -1776,22 +1785,22 @@ void CFileItem::UpdateInfo(const CFileItem &item, bool replaceLabels /*=true*/)
   }
   if (item.HasPVRChannelGroupMemberInfoTag())
   {
-    m_pvrChannelGroupMemberInfoTag = item.GetPVRChannelGroupMemberInfoTag();
+    GetExtras().pvrChannelGroupMemberInfoTag = item.GetPVRChannelGroupMemberInfoTag();
     SetInvalid();
   }
   if (item.HasPVRTimerInfoTag())
   {
-    m_pvrTimerInfoTag = item.m_pvrTimerInfoTag;
+    GetExtras().pvrTimerInfoTag = item.GetPVRTimerInfoTag();
     SetInvalid();
   }
   if (item.HasEPGInfoTag())
   {
-    m_epgInfoTag = item.m_epgInfoTag;
+    GetExtras().epgInfoTag = item.GetEPGInfoTag();
     SetInvalid();
   }
   if (item.HasEPGSearchFilter())
   {
-    m_epgSearchFilter = item.m_epgSearchFilter;
+    GetExtras().epgSearchFilter = item.GetEPGSearchFilter();
     SetInvalid();
   }
   SetDynPath(item.GetDynPath());
@@ -1821,7 +1830,8 @@ void CFileItem::MergeInfo(const CFileItem& item)
         m_videoInfoTag = new CVideoInfoTag(*item.m_videoInfoTag);
     }
 
-    m_pvrRecordingInfoTag = item.m_pvrRecordingInfoTag;
+    if (item.HasPVRRecordingInfoTag() || HasPVRRecordingInfoTag())
+      GetExtras().pvrRecordingInfoTag = item.GetPVRRecordingInfoTag();
 
     SetOverlayImage(GetVideoInfoTag()->GetPlayCount() > 0 ? CGUIListItem::ICON_OVERLAY_WATCHED
                                                           : CGUIListItem::ICON_OVERLAY_UNWATCHED);
@@ -1844,22 +1854,22 @@ void CFileItem::MergeInfo(const CFileItem& item)
   }
   if (item.HasPVRChannelGroupMemberInfoTag())
   {
-    m_pvrChannelGroupMemberInfoTag = item.GetPVRChannelGroupMemberInfoTag();
+    GetExtras().pvrChannelGroupMemberInfoTag = item.GetPVRChannelGroupMemberInfoTag();
     SetInvalid();
   }
   if (item.HasPVRTimerInfoTag())
   {
-    m_pvrTimerInfoTag = item.m_pvrTimerInfoTag;
+    GetExtras().pvrTimerInfoTag = item.GetPVRTimerInfoTag();
     SetInvalid();
   }
   if (item.HasEPGInfoTag())
   {
-    m_epgInfoTag = item.m_epgInfoTag;
+    GetExtras().epgInfoTag = item.GetEPGInfoTag();
     SetInvalid();
   }
   if (item.HasEPGSearchFilter())
   {
-    m_epgSearchFilter = item.m_epgSearchFilter;
+    GetExtras().epgSearchFilter = item.GetEPGSearchFilter();
     SetInvalid();
   }
   SetDynPath(item.GetDynPath());
@@ -3557,8 +3567,8 @@ std::string CFileItem::GetMovieName(bool bUseFolderNames /* = false */) const
   if (IsLabelPreformatted())
     return GetLabel();
 
-  if (m_pvrRecordingInfoTag)
-    return m_pvrRecordingInfoTag->m_strTitle;
+  if (HasPVRRecordingInfoTag())
+    return m_extras->pvrRecordingInfoTag->m_strTitle;
   else if (URIUtils::IsPVRRecording(m_strPath))
   {
     std::string title = CPVRRecording::GetTitleFromURL(m_strPath);
@@ -4029,14 +4039,14 @@ void CFileItemList::ClearSortState()
 bool CFileItem::HasVideoInfoTag() const
 {
   // Note: CPVRRecording is derived from CVideoInfoTag
-  return m_pvrRecordingInfoTag.get() != nullptr || m_videoInfoTag != nullptr;
+  return HasPVRRecordingInfoTag() || m_videoInfoTag != nullptr;
 }
 
 CVideoInfoTag* CFileItem::GetVideoInfoTag()
 {
   // Note: CPVRRecording is derived from CVideoInfoTag
-  if (m_pvrRecordingInfoTag)
-    return m_pvrRecordingInfoTag.get();
+  if (HasPVRRecordingInfoTag())
+    return m_extras->pvrRecordingInfoTag.get();
   else if (!m_videoInfoTag)
     m_videoInfoTag = new CVideoInfoTag;
 
@@ -4046,7 +4056,7 @@ CVideoInfoTag* CFileItem::GetVideoInfoTag()
 const CVideoInfoTag* CFileItem::GetVideoInfoTag() const
 {
   // Note: CPVRRecording is derived from CVideoInfoTag
-  return m_pvrRecordingInfoTag ? m_pvrRecordingInfoTag.get() : m_videoInfoTag;
+  return HasPVRRecordingInfoTag() ? m_extras->pvrRecordingInfoTag.get() : m_videoInfoTag;
 }
 
 CPictureInfoTag* CFileItem::GetPictureInfoTag()
@@ -4075,13 +4085,14 @@ CGameInfoTag* CFileItem::GetGameInfoTag()
 
 bool CFileItem::HasPVRChannelInfoTag() const
 {
-  return m_pvrChannelGroupMemberInfoTag && m_pvrChannelGroupMemberInfoTag->Channel() != nullptr;
+  return HasPVRChannelGroupMemberInfoTag() &&
+         m_extras->pvrChannelGroupMemberInfoTag->Channel() != nullptr;
 }
 
 const std::shared_ptr<PVR::CPVRChannel> CFileItem::GetPVRChannelInfoTag() const
 {
-  return m_pvrChannelGroupMemberInfoTag ? m_pvrChannelGroupMemberInfoTag->Channel()
-                                        : std::shared_ptr<CPVRChannel>();
+  return HasPVRChannelGroupMemberInfoTag() ? m_extras->pvrChannelGroupMemberInfoTag->Channel()
+                                           : std::shared_ptr<CPVRChannel>();
 }
 
 std::string CFileItem::FindTrailer() const
@@ -297,29 +297,29 @@ public:
 
   inline bool HasEPGInfoTag() const
   {
-    return m_epgInfoTag.get() != NULL;
+    return m_extras && m_extras->epgInfoTag;
   }
 
   inline const std::shared_ptr<PVR::CPVREpgInfoTag> GetEPGInfoTag() const
   {
-    return m_epgInfoTag;
+    return m_extras ? m_extras->epgInfoTag : nullptr;
   }
 
-  bool HasEPGSearchFilter() const { return m_epgSearchFilter != nullptr; }
+  bool HasEPGSearchFilter() const { return m_extras && m_extras->epgSearchFilter; }
 
   const std::shared_ptr<PVR::CPVREpgSearchFilter> GetEPGSearchFilter() const
   {
-    return m_epgSearchFilter;
+    return m_extras ? m_extras->epgSearchFilter : nullptr;
   }
 
   inline bool HasPVRChannelGroupMemberInfoTag() const
   {
-    return m_pvrChannelGroupMemberInfoTag.get() != nullptr;
+    return m_extras && m_extras->pvrChannelGroupMemberInfoTag;
   }
 
   inline const std::shared_ptr<PVR::CPVRChannelGroupMember> GetPVRChannelGroupMemberInfoTag() const
   {
-    return m_pvrChannelGroupMemberInfoTag;
+    return m_extras ? m_extras->pvrChannelGroupMemberInfoTag : nullptr;
   }
 
   bool HasPVRChannelInfoTag() const;
@@ -327,22 +327,22 @@ public:
 
   inline bool HasPVRRecordingInfoTag() const
   {
-    return m_pvrRecordingInfoTag.get() != NULL;
+    return m_extras && m_extras->pvrRecordingInfoTag;
   }
 
   inline const std::shared_ptr<PVR::CPVRRecording> GetPVRRecordingInfoTag() const
   {
-    return m_pvrRecordingInfoTag;
+    return m_extras ? m_extras->pvrRecordingInfoTag : nullptr;
   }
 
   inline bool HasPVRTimerInfoTag() const
   {
-    return m_pvrTimerInfoTag != NULL;
+    return m_extras && m_extras->pvrTimerInfoTag;
   }
 
   inline const std::shared_ptr<PVR::CPVRTimerInfoTag> GetPVRTimerInfoTag() const
   {
-    return m_pvrTimerInfoTag;
+    return m_extras ? m_extras->pvrTimerInfoTag : nullptr;
   }
 
   /*!
@@ -565,8 +565,8 @@ public:
   void SetContentLookup(bool enable) { m_doContentLookup = enable; }
 
   /* general extra info about the contents of the item, not for display */
-  void SetExtraInfo(const std::string& info) { m_extrainfo = info; }
-  const std::string& GetExtraInfo() const { return m_extrainfo; }
+  void SetExtraInfo(const std::string& info);
+  const std::string& GetExtraInfo() const;
 
   /*! \brief Update an item with information from another item
    We take metadata information from the given item and supplement the current item
@@ -665,19 +665,31 @@ private:
   bool m_bCanQueue;
   bool m_bLabelPreformatted;
   std::string m_mimetype;
-  std::string m_extrainfo;
   bool m_doContentLookup;
   MUSIC_INFO::CMusicInfoTag* m_musicInfoTag;
   CVideoInfoTag* m_videoInfoTag;
-  std::shared_ptr<PVR::CPVREpgInfoTag> m_epgInfoTag;
-  std::shared_ptr<PVR::CPVREpgSearchFilter> m_epgSearchFilter;
-  std::shared_ptr<PVR::CPVRRecording> m_pvrRecordingInfoTag;
-  std::shared_ptr<PVR::CPVRTimerInfoTag> m_pvrTimerInfoTag;
-  std::shared_ptr<PVR::CPVRChannelGroupMember> m_pvrChannelGroupMemberInfoTag;
   CPictureInfoTag* m_pictureInfoTag;
   std::shared_ptr<const ADDON::IAddon> m_addonInfo;
   KODI::GAME::CGameInfoTag* m_gameInfoTag;
-  EventPtr m_eventLogEntry;
+
+  /*!
+   \brief The members most items do without, allocated with the first of them that is set so
+   large lists of files or songs do not carry them.
+   */
+  struct Extras
+  {
+    std::string extraInfo;
+    std::shared_ptr<PVR::CPVREpgInfoTag> epgInfoTag;
+    std::shared_ptr<PVR::CPVREpgSearchFilter> epgSearchFilter;
+    std::shared_ptr<PVR::CPVRRecording> pvrRecordingInfoTag;
+    std::shared_ptr<PVR::CPVRTimerInfoTag> pvrTimerInfoTag;
+    std::shared_ptr<PVR::CPVRChannelGroupMember> pvrChannelGroupMemberInfoTag;
+    EventPtr eventLogEntry;
+  };
+
+  Extras& GetExtras();
+
+  std::unique_ptr<Extras> m_extras;
   bool m_bIsAlbum;
   int64_t m_lStartOffset;
   int64_t m_lEndOffset;
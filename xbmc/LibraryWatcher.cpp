@@ -0,0 +1,254 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibraryWatcher.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "filesystem/DirectoryWatcher.h"
+#include "music/MusicDatabase.h"
+#include "music/MusicLibraryQueue.h"
+#include "music/infoscanner/MusicInfoScanner.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoScanner.h"
+#include "video/VideoLibraryQueue.h"
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+//! Longest time the scan of a directory that keeps changing is put off
+constexpr auto MAX_SCAN_DELAY = 60s;
+} // namespace
+
+CLibraryWatcher::CLibraryWatcher() : CThread("LibraryWatcher")
+{
+}
+
+CLibraryWatcher::~CLibraryWatcher()
+{
+  Stop();
+}
+
+void CLibraryWatcher::Start()
+{
+  Stop();
+  Create();
+}
+
+void CLibraryWatcher::Stop()
+{
+  StopThread(true);
+}
+
+std::map<CLibraryWatcher::Library, std::set<std::string>> CLibraryWatcher::GetScanPaths(
+    const std::set<std::string>& changed, const std::vector<Source>& sources)
+{
+  std::map<Library, std::set<std::string>> paths;
+  for (const auto& directory : changed)
+  {
+    for (const auto& source : sources)
+    {
+      if (!URIUtils::PathHasParent(directory, source.path))
+        continue;
+
+      std::string path = directory;
+      if (source.singleTvShow)
+        path = source.path;
+      else if (source.tvShows && directory.size() > source.path.size())
+      {
+        // the directory of the show, seasons and episodes are scanned with their show
+        const size_t end = directory.find('/', source.path.size());
+        if (end != std::string::npos)
+          path = directory.substr(0, end + 1);
+      }
+      paths[source.library].insert(path);
+    }
+  }
+
+  // the directories inside another one come right after it
+  for (auto& library : paths)
+  {
+    std::set<std::string>& directories = library.second;
+    std::string parent;
+    for (auto it = directories.begin(); it != directories.end();)
+    {
+      if (!parent.empty() && URIUtils::PathHasParent(*it, parent))
+        it = directories.erase(it);
+      else
+        parent = *it++;
+    }
+  }
+  return paths;
+}
+
+void CLibraryWatcher::Process()
+{
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const std::chrono::seconds delay(advancedSettings->m_iLibraryWatcherDelay);
+  const std::chrono::minutes interval(advancedSettings->m_iLibraryWatcherPollInterval);
+
+  std::vector<Source> watched;
+  std::vector<Source> polled;
+  XFILE::CDirectoryWatcher watcher;
+  for (const auto& source : GetSources())
+  {
+    if (m_bStop)
+      return;
+    if (watcher.Watch(source.path))
+      watched.push_back(source);
+    else
+      polled.push_back(source);
+  }
+  CLog::Log(LOGINFO,
+            "CLibraryWatcher: watching {} directories of {} sources, {} sources scanned every {} "
+            "minutes",
+            watcher.Size(), watched.size(), polled.size(), interval.count());
+
+  std::set<std::string> changed;
+  auto firstChange = std::chrono::steady_clock::now();
+  auto lastChange = firstChange;
+  auto nextPoll = firstChange + interval;
+  while (!m_bStop)
+  {
+    if (watcher.Size() > 0)
+    {
+      std::set<std::string> directories;
+      if (!watcher.ReadChanges(1000ms, directories))
+      {
+        CLog::Log(LOGWARNING, "CLibraryWatcher: changes were missed, scanning the watched sources");
+        for (const auto& source : watched)
+          directories.insert(source.path);
+      }
+
+      if (!directories.empty())
+      {
+        lastChange = std::chrono::steady_clock::now();
+        if (changed.empty())
+          firstChange = lastChange;
+        changed.insert(directories.begin(), directories.end());
+      }
+    }
+    else
+      Sleep(1000ms);
+
+    // wait for the copies and downloads to complete before scanning
+    const auto now = std::chrono::steady_clock::now();
+    if (!changed.empty() && (now - lastChange >= delay || now - firstChange >= MAX_SCAN_DELAY))
+    {
+      Scan(GetScanPaths(changed, watched), true);
+      changed.clear();
+    }
+
+    if (!polled.empty() && interval.count() > 0 && now >= nextPoll)
+    {
+      std::set<std::string> sources;
+      for (const auto& source : polled)
+        sources.insert(source.path);
+      Scan(GetScanPaths(sources, polled), false);
+      nextPoll = now + interval;
+    }
+  }
+}
+
+std::vector<CLibraryWatcher::Source> CLibraryWatcher::GetSources()
+{
+  std::vector<Source> sources;
+
+  CVideoDatabase videodb;
+  if (videodb.Open())
+  {
+    // the paths with content, the ones inside them come right after them
+    std::set<std::string> paths;
+    videodb.GetPaths(paths);
+    std::string parent;
+    for (const auto& path : paths)
+    {
+      if (!parent.empty() && URIUtils::PathHasParent(path, parent))
+        continue;
+      parent = path;
+      const bool tvShows = videodb.GetContentForPath(path) == "tvshows";
+      VIDEO::SScanSettings settings;
+      bool foundDirectly = false;
+      const bool singleTvShow = tvShows &&
+                                videodb.GetScraperForPath(path, settings, foundDirectly) &&
+                                foundDirectly && settings.parent_name_root;
+      sources.push_back({path, Library::VIDEO, tvShows, singleTvShow});
+    }
+    videodb.Close();
+  }
+
+  CMusicDatabase musicdb;
+  if (musicdb.Open())
+  {
+    CFileItemList items;
+    musicdb.GetSources(items);
+    for (const auto& item : items)
+    {
+      const CVariant& paths = item->GetProperty("paths");
+      for (auto it = paths.begin_array(); it != paths.end_array(); ++it)
+      {
+        std::string path = it->asString();
+        URIUtils::AddSlashAtEnd(path);
+        sources.push_back({path, Library::MUSIC});
+      }
+    }
+    musicdb.Close();
+  }
+  return sources;
+}
+
+void CLibraryWatcher::Scan(const std::map<Library, std::set<std::string>>& paths, bool clean)
+{
+  for (const auto& library : paths)
+  {
+    for (const auto& path : library.second)
+    {
+      CLog::Log(LOGDEBUG, "CLibraryWatcher: scanning {} library path {}",
+                library.first == Library::VIDEO ? "video" : "music", CURL::GetRedacted(path));
+      if (library.first == Library::VIDEO)
+        CVideoLibraryQueue::GetInstance().ScanLibrary(path, false, false);
+      else
+        CMusicLibraryQueue::GetInstance().ScanLibrary(
+            path, MUSIC_INFO::CMusicInfoScanner::SCAN_NORMAL, false);
+    }
+  }
+
+  // a scan adds the new items only, the items of the removed files and directories are cleaned
+  const auto video = paths.find(Library::VIDEO);
+  if (!clean || video == paths.end())
+    return;
+
+  CVideoDatabase videodb;
+  if (!videodb.Open())
+    return;
+  std::set<int> pathIds;
+  for (const auto& path : video->second)
+  {
+    std::vector<std::pair<int, std::string>> subPaths;
+    if (videodb.GetSubPaths(path, subPaths))
+    {
+      for (const auto& subPath : subPaths)
+        pathIds.insert(subPath.first);
+    }
+  }
+  videodb.Close();
+
+  if (!pathIds.empty())
+    CVideoLibraryQueue::GetInstance().CleanLibrary(pathIds);
+}
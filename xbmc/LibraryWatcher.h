@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Thread.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Updates the video and music libraries with the directories that change.
+
+ The local sources of the libraries are watched for changes and the directories that changed are
+ scanned a few seconds after the last change, rather than the whole sources. The sources that can
+ not be watched, on network shares or with too many directories, are scanned periodically, the
+ scans skip the directories whose hash did not change.
+ */
+class CLibraryWatcher : private CThread
+{
+public:
+  enum class Library
+  {
+    VIDEO,
+    MUSIC
+  };
+
+  struct Source
+  {
+    std::string path;
+    Library library;
+    bool tvShows = false; ///< the directories of the source are tv shows
+    bool singleTvShow = false; ///< the source is a tv show of its own
+  };
+
+  CLibraryWatcher();
+  ~CLibraryWatcher() override;
+
+  //! Start watching the sources of the libraries of the current profile, again if started
+  void Start();
+
+  //! Stop watching the sources
+  void Stop();
+
+  /*!
+   \brief Get the directories to scan for the directories that changed.
+   The directories inside another directory to scan of the same library are dropped, a change in
+   a tv show is scanned from the directory of the show, the source itself for a single show.
+   \param changed the directories that changed
+   \param sources the sources of the directories, the changes outside of them are ignored
+   \return the directories to scan of each library
+   */
+  static std::map<Library, std::set<std::string>> GetScanPaths(
+      const std::set<std::string>& changed, const std::vector<Source>& sources);
+
+protected:
+  void Process() override;
+
+private:
+  //! Get the sources of both libraries, without the paths inside other sources
+  static std::vector<Source> GetSources();
+
+  /*!
+   \brief Scan the directories of each library.
+   \param paths the directories to scan
+   \param clean whether the video items of the directories that were removed are cleaned too
+   */
+  static void Scan(const std::map<Library, std::set<std::string>>& paths, bool clean);
+};
@@ -19,7 +19,10 @@
 #include "filesystem/File.h"
 #include "music/Album.h"
 #include "music/Artist.h"
+#include "utils/CharsetDetection.h"
+#include "utils/Utf8Utils.h"
 #include "video/VideoInfoDownloader.h"
+#include "video/VideoInfoTag.h"
 
 #include <string>
 #include <vector>
@@ -27,6 +30,18 @@
 using namespace XFILE;
 using namespace ADDON;
 
+namespace
+{
+// whether CXBMCTinyXML parses the document as UTF-8, as CVideoInfoTag::LoadFromXML() reads it
+bool IsUtf8(const std::string& document)
+{
+  std::string charset;
+  if (CCharsetDetection::DetectXmlEncoding(document, charset))
+    return charset == "UTF-8";
+  return charset != "UTF-8" && CUtf8Utils::isValidUtf8(document);
+}
+} // namespace
+
 CInfoScanner::INFO_TYPE CNfoFile::Create(const std::string& strPath,
                                          const ScraperPtr& info, int episode)
 {
@@ -53,28 +68,10 @@ CInfoScanner::INFO_TYPE CNfoFile::Create(const std::string& strPath,
   {
     // first check if it's an XML file with the info we need
     CVideoInfoTag details;
-    bNfo = GetDetails(details);
-    if (episode > -1 && bNfo && m_type == AddonType::SCRAPER_TVSHOWS)
-    {
-      int infos=0;
-      while (m_headPos != std::string::npos && details.m_iEpisode != episode)
-      {
-        m_headPos = m_doc.find("<episodedetails", m_headPos + 1);
-        if (m_headPos == std::string::npos)
-          break;
-
-        bNfo  = GetDetails(details);
-        infos++;
-      }
-      if (details.m_iEpisode != episode)
-      {
-        bNfo = false;
-        details.Reset();
-        m_headPos = 0;
-        if (infos == 1) // still allow differing nfo/file numbers for single ep nfo's
-          bNfo = GetDetails(details);
-      }
-    }
+    if (episode > -1 && m_type == AddonType::SCRAPER_TVSHOWS)
+      bNfo = GetEpisodeDetails(details, episode);
+    else
+      bNfo = GetDetails(details);
   }
 
   std::vector<ScraperPtr> vecScrapers = GetScrapers(m_type, m_info);
@@ -102,6 +99,94 @@ CInfoScanner::INFO_TYPE CNfoFile::Create(const std::string& strPath,
   return m_scurl.HasUrls() ? CInfoScanner::URL_NFO : CInfoScanner::NO_NFO;
 }
 
+bool CNfoFile::GetDetails(CVideoInfoTag& details, const char* document, bool prioritise)
+{
+  if (document)
+  {
+    if (IsUtf8(document) && details.LoadFromXML(document, true, prioritise))
+      return true;
+
+    CXBMCTinyXML doc;
+    doc.Parse(document, TIXML_ENCODING_UNKNOWN);
+    return details.Load(doc.RootElement(), true, prioritise);
+  }
+
+  // read the nfo in one pass once, unless it's parsed already
+  if (m_headPos < m_doc.size() && m_headDetailsPos != m_headPos && m_headDocPos != m_headPos)
+  {
+    const std::string head = GetHead();
+    m_headDetails = IsUtf8(head) ? CVideoInfoTag::ReadXML(head) : nullptr;
+    m_headDetailsPos = m_headPos;
+  }
+  if (m_headDetails && m_headDetailsPos == m_headPos)
+  {
+    details.LoadFromXML(*m_headDetails, true, prioritise);
+    return true;
+  }
+
+  const TiXmlElement* element = GetHeadElement();
+  if (!element)
+    return false;
+
+  return details.Load(element, true, prioritise);
+}
+
+bool CNfoFile::GetEpisodeDetails(CVideoInfoTag& details, int episode)
+{
+  bool bNfo = GetDetails(details);
+  if (!bNfo)
+    return false;
+
+  int infos=0;
+  while (m_headPos != std::string::npos && details.m_iEpisode != episode)
+  {
+    m_headPos = m_doc.find("<episodedetails", m_headPos + 1);
+    if (m_headPos == std::string::npos)
+      break;
+
+    bNfo  = GetDetails(details);
+    infos++;
+  }
+  if (details.m_iEpisode != episode)
+  {
+    bNfo = false;
+    details.Reset();
+    m_headPos = 0;
+    if (infos == 1) // still allow differing nfo/file numbers for single ep nfo's
+      bNfo = GetDetails(details);
+  }
+  return bNfo;
+}
+
+std::string CNfoFile::GetHead() const
+{
+  // an episode found in the nfo is read up to its end, rather than along with the episodes
+  // after it, so finding the last of many episodes takes one pass over the nfo
+  size_t length = std::string::npos;
+  if (m_headPos > 0)
+  {
+    static const std::string endTag = "</episodedetails>";
+    const size_t end = m_doc.find(endTag, m_headPos);
+    if (end != std::string::npos)
+      length = end + endTag.size() - m_headPos;
+  }
+  return m_doc.substr(m_headPos, length);
+}
+
+const TiXmlElement* CNfoFile::GetHeadElement()
+{
+  if (m_headPos >= m_doc.size())
+    return nullptr;
+
+  if (m_headDocPos != m_headPos)
+  {
+    m_headDoc.Clear();
+    m_headDoc.Parse(GetHead(), TIXML_ENCODING_UNKNOWN);
+    m_headDocPos = m_headPos;
+  }
+  return m_headDoc.RootElement();
+}
+
 // return value: 0 - success; 1 - no result; skip; 2 - error
 int CNfoFile::Scrape(ScraperPtr& scraper, CScraperUrl& url,
                      const std::string& content)
@@ -147,6 +232,10 @@ void CNfoFile::Close()
 {
   m_doc.clear();
   m_headPos = 0;
+  m_headDoc.Clear();
+  m_headDocPos = std::string::npos;
+  m_headDetails.reset();
+  m_headDetailsPos = std::string::npos;
   m_scurl.Clear();
 }
 
@@ -15,7 +15,9 @@
 #include "InfoScanner.h"
 #include "addons/Scraper.h"
 #include "utils/XBMCTinyXML.h"
+#include "video/VideoInfoTag.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -36,17 +38,45 @@ public:
     bool GetDetails(T& details, const char* document=NULL,
                     bool prioritise=false)
   {
-    CXBMCTinyXML doc;
     if (document)
+    {
+      CXBMCTinyXML doc;
       doc.Parse(document, TIXML_ENCODING_UNKNOWN);
-    else if (m_headPos < m_doc.size())
-      doc.Parse(m_doc.substr(m_headPos), TIXML_ENCODING_UNKNOWN);
-    else
+      return details.Load(doc.RootElement(), true, prioritise);
+    }
+
+    const TiXmlElement* element = GetHeadElement();
+    if (!element)
       return false;
 
-    return details.Load(doc.RootElement(), true, prioritise);
+    return details.Load(element, true, prioritise);
   }
 
+  /*! \brief Get video details from a document, or from the loaded nfo
+   A UTF-8 document is read in one pass with CVideoInfoTag::ReadXML(), one it can't read is
+   parsed and loaded as the other details are. The tags read from the loaded nfo are kept, so
+   following calls load them without reading the nfo again.
+   \param details [out] the details read
+   \param document the document to read, nullptr to read the loaded nfo
+   \param prioritise whether the details read replace (or are prepended to) the additive tags
+   \return true if details were read
+   */
+  bool GetDetails(CVideoInfoTag& details, const char* document = nullptr, bool prioritise = false);
+
+  /*! \brief Get the details of an episode from the loaded nfo
+   The nfo of a multi-episode file holds one <episodedetails> after another, the following
+   GetDetails() calls return the details of the episode found.
+   \param details [out] the details of the episode, or of the only episode of the nfo
+   \param episode the number of the episode
+   \return true if the nfo holds details
+   */
+  bool GetEpisodeDetails(CVideoInfoTag& details, int episode);
+
+  /*! \brief Load an nfo file
+   \return 0 on success, 1 if the file could not be read
+   */
+  int Load(const std::string&);
+
   void Close();
   void SetScraperInfo(ADDON::ScraperPtr info) { m_info = std::move(info); }
   ADDON::ScraperPtr GetScraperInfo() { return m_info; }
@@ -61,9 +91,18 @@ public:
 private:
   std::string m_doc;
   size_t m_headPos = 0;
+  CXBMCTinyXML m_headDoc; ///< the document parsed at m_headDocPos
+  size_t m_headDocPos = std::string::npos;
+  //! the tags read at m_headDetailsPos, nullptr if the nfo is parsed there
+  std::shared_ptr<const CVideoInfoTag::SXMLDetails> m_headDetails;
+  size_t m_headDetailsPos = std::string::npos;
   ADDON::ScraperPtr m_info;
   ADDON::AddonType m_type{};
   CScraperUrl m_scurl;
 
-  int Load(const std::string&);
+  //! Get the document from the head position, up to the end of the episode found there
+  std::string GetHead() const;
+
+  //! Get the element at the head position, parsing the document from there once
+  const TiXmlElement* GetHeadElement();
 };
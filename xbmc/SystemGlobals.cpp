@@ -10,6 +10,7 @@
 #include "GUIInfoManager.h"
 #include "filesystem/DllLibCurl.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/PersistentDirectoryCache.h"
 #include "GUIPassword.h"
 #include "utils/LangCodeExpander.h"
 #include "PartyModeManager.h"
@@ -29,6 +30,7 @@ std::map<std::string, std::string> CSpecialProtocol::m_pathMap;
   CLocalizeStrings   g_localizeStringsTemp;
 
   XFILE::CDirectoryCache g_directoryCache;
+  XFILE::CPersistentDirectoryCache g_persistentDirectoryCache;
 
   CGUIPassword       g_passwordManager;
 
@@ -18,6 +18,7 @@
 #include "profiles/ProfileManager.h"
 #include "settings/SettingsComponent.h"
 #include "utils/Crc32.h"
+#include "utils/Digest.h"
 #include "utils/Job.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -29,6 +30,7 @@
 #include <string.h>
 
 using namespace XFILE;
+using KODI::UTILITY::CDigest;
 using namespace std::chrono_literals;
 
 CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
@@ -214,7 +216,9 @@ void CTextureCache::ClearCachedImage(const std::string& image, bool deleteSource
   std::string path = deleteSource ? url : "";
   std::string cachedFile;
   if (ClearCachedTexture(url, cachedFile))
-    path = GetCachedPath(cachedFile);
+    path = cachedFile.empty() ? "" : GetCachedPath(cachedFile);
+  if (path.empty())
+    return;
   if (CFile::Exists(path))
     CFile::Delete(path);
   path = URIUtils::ReplaceExtension(path, ".dds");
@@ -227,6 +231,8 @@ bool CTextureCache::ClearCachedImage(int id)
   std::string cachedFile;
   if (ClearCachedTexture(id, cachedFile))
   {
+    if (cachedFile.empty())
+      return true;
     cachedFile = GetCachedPath(cachedFile);
     if (CFile::Exists(cachedFile))
       CFile::Delete(cachedFile);
@@ -244,10 +250,12 @@ bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &de
   return m_database.GetCachedTexture(url, details);
 }
 
-bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
+bool CTextureCache::AddCachedTexture(const std::string& url,
+                                     const CTextureDetails& details,
+                                     std::string& oldCacheFile)
 {
   std::unique_lock<CCriticalSection> lock(m_databaseSection);
-  return m_database.AddCachedTexture(url, details);
+  return m_database.AddCachedTexture(url, details, oldCacheFile);
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
@@ -269,6 +277,14 @@ bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateabl
   return m_database.SetCachedTextureValid(url, updateable);
 }
 
+bool CTextureCache::GetCachedTextureSize(const std::string& cacheFile,
+                                         unsigned int& width,
+                                         unsigned int& height)
+{
+  std::unique_lock<CCriticalSection> lock(m_databaseSection);
+  return m_database.GetCachedTextureSize(cacheFile, width, height);
+}
+
 bool CTextureCache::ClearCachedTexture(const std::string &url, std::string &cachedURL)
 {
   std::unique_lock<CCriticalSection> lock(m_databaseSection);
@@ -289,6 +305,22 @@ std::string CTextureCache::GetCacheFile(const std::string &url)
   return hash;
 }
 
+std::string CTextureCache::GetContentCacheFile(const uint8_t* pixels,
+                                               unsigned int width,
+                                               unsigned int height,
+                                               unsigned int pitch,
+                                               const std::string& options)
+{
+  CDigest digest{CDigest::Type::MD5};
+  digest.Update(StringUtils::Format("{}x{}:{}", width, height, options));
+  for (unsigned int y = 0; y < height; y++)
+    digest.Update(pixels + y * pitch, width * 4);
+
+  // 16 digits keep the names apart from the 8 digits of GetCacheFile
+  const std::string hex = digest.Finalize().substr(0, 16);
+  return StringUtils::Format("{}/{}", hex[0], hex);
+}
+
 std::string CTextureCache::GetCachedPath(const std::string &file)
 {
   const std::shared_ptr<CProfileManager> profileManager = CServiceBroker::GetSettingsComponent()->GetProfileManager();
@@ -303,7 +335,20 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
     if (job->m_details.hashRevalidated)
       SetCachedTextureValid(job->m_url, job->m_details.updateable);
     else
-      AddCachedTexture(job->m_url, job->m_details);
+    {
+      // a recached image may be cached to another file, e.g. one named after its content
+      std::string oldCacheFile;
+      AddCachedTexture(job->m_url, job->m_details, oldCacheFile);
+      if (!oldCacheFile.empty())
+      {
+        oldCacheFile = GetCachedPath(oldCacheFile);
+        if (CFile::Exists(oldCacheFile))
+          CFile::Delete(oldCacheFile);
+        oldCacheFile = URIUtils::ReplaceExtension(oldCacheFile, ".dds");
+        if (CFile::Exists(oldCacheFile))
+          CFile::Delete(oldCacheFile);
+      }
+    }
   }
 
   { // remove from our processing list
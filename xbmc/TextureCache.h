@@ -14,6 +14,7 @@
 #include "threads/Event.h"
 #include "utils/JobManager.h"
 
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <string>
@@ -136,6 +137,22 @@ public:
    */
   static std::string GetCachedPath(const std::string &file);
 
+  /*! \brief retrieve a cache file (relative to the cache path) named after the content of an image,
+   excluding extension
+   Images with the same pixels, such as frames generated from copies of a video, share the file.
+   \param pixels the BGRA pixels of the image
+   \param width width of the image
+   \param height height of the image
+   \param pitch bytes per row of the pixels, the padding past the width is ignored
+   \param options how the image is cached (eg size and scaling), part of the name
+   \return a "unique" filename for the content, excluding extension
+   */
+  static std::string GetContentCacheFile(const uint8_t* pixels,
+                                         unsigned int width,
+                                         unsigned int height,
+                                         unsigned int pitch,
+                                         const std::string& options);
+
   /*! \brief check whether an image:// URL may be cached
    \param url the URL to the image
    \return true if the given URL may be cached, false otherwise
@@ -146,9 +163,21 @@ public:
    Thread-safe wrapper of CTextureDatabase::AddCachedTexture
    \param image url of the original image
    \param details the texture details to add
+   \param oldCacheFile [out] the file the replaced texture was cached to, if no longer used.
    \return true if we successfully added to the database, false otherwise.
    */
-  bool AddCachedTexture(const std::string &image, const CTextureDetails &details);
+  bool AddCachedTexture(const std::string& image,
+                        const CTextureDetails& details,
+                        std::string& oldCacheFile);
+
+  /*! \brief Get the size of the image cached to a file
+   Thread-safe wrapper of CTextureDatabase::GetCachedTextureSize
+   \param cacheFile the cached file, relative to the cache path
+   \return true if an image is cached to the file, false otherwise.
+   */
+  bool GetCachedTextureSize(const std::string& cacheFile,
+                            unsigned int& width,
+                            unsigned int& height);
 
   /*! \brief Export a (possibly) cached image to a file
    \param image url of the original image
@@ -189,7 +218,7 @@ private:
   /*! \brief Clear an image from the database
    Thread-safe wrapper of CTextureDatabase::ClearCachedTexture
    \param image url of the original image
-   \param cacheFile [out] url of the cached original (if available)
+   \param cacheFile [out] url of the cached original (if available and not shared with other images)
    \return true if we had a cached version of this image, false otherwise.
    */
   bool ClearCachedTexture(const std::string &url, std::string &cacheFile);
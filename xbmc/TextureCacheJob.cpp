@@ -98,6 +98,13 @@ bool ShouldCheckForChanges(const std::string& additional_info, const std::string
       StringUtils::StartsWith(url, "http://") || StringUtils::StartsWith(url, "https://");
   return !isHTTP;
 }
+
+// frames generated from videos are often the same, e.g. black frames, or frames of copies of a
+// video, so they are cached to files named after their content
+bool IsGeneratedVideoImage(const std::string& additional_info)
+{
+  return additional_info == "video" || additional_info == "videochapter";
+}
 } // namespace
 
 bool CTextureCacheJob::CacheTexture(std::unique_ptr<CTexture>* out_texture)
@@ -127,10 +134,29 @@ bool CTextureCacheJob::CacheTexture(std::unique_ptr<CTexture>* out_texture)
   std::unique_ptr<CTexture> texture = LoadImage(image, width, height, additional_info, true);
   if (texture)
   {
+    std::string cachePath = m_cachePath;
+    if (IsGeneratedVideoImage(additional_info))
+      cachePath = CTextureCache::GetContentCacheFile(
+          texture->GetPixels(), texture->GetWidth(), texture->GetHeight(), texture->GetPitch(),
+          StringUtils::Format("{}x{}:{}:{}", width, height, static_cast<int>(scalingAlgorithm),
+                              texture->GetOrientation()));
+
     if (texture->HasAlpha())
-      m_details.file = m_cachePath + ".png";
+      m_details.file = cachePath + ".png";
     else
-      m_details.file = m_cachePath + ".jpg";
+      m_details.file = cachePath + ".jpg";
+
+    if (cachePath != m_cachePath &&
+        CServiceBroker::GetTextureCache()->GetCachedTextureSize(m_details.file, m_details.width,
+                                                                m_details.height) &&
+        XFILE::CFile::Exists(CTextureCache::GetCachedPath(m_details.file)))
+    {
+      CLog::Log(LOGDEBUG, "Image '{}' is the same as '{}', already cached",
+                CURL::GetRedacted(image), m_details.file);
+      if (out_texture) // caller wants the texture
+        *out_texture = std::move(texture);
+      return true;
+    }
 
     CLog::Log(LOGDEBUG, "{} image '{}' to '{}':", m_oldHash.empty() ? "Caching" : "Recaching",
               CURL::GetRedacted(image), m_details.file);
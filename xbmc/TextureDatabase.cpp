@@ -164,6 +164,7 @@ void CTextureDatabase::CreateAnalytics()
 {
   CLog::Log(LOGINFO, "{} creating indices", __FUNCTION__);
   m_pDS->exec("CREATE INDEX idxTexture ON texture(url)");
+  m_pDS->exec("CREATE INDEX idxTexture2 ON texture(cachedurl)");
   m_pDS->exec("CREATE INDEX idxSize ON sizes(idtexture, size)");
   m_pDS->exec("CREATE INDEX idxSize2 ON sizes(idtexture, width, height)");
   //! @todo Should the path index be a covering index? (we need only retrieve texture)
@@ -267,6 +268,38 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
   return false;
 }
 
+bool CTextureDatabase::GetCachedTextureSize(const std::string& cacheFile,
+                                            unsigned int& width,
+                                            unsigned int& height)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    std::string sql = PrepareSQL("SELECT width, height FROM texture JOIN sizes ON "
+                                 "(texture.id=sizes.idtexture AND sizes.size=1) "
+                                 "WHERE cachedurl='%s'",
+                                 cacheFile.c_str());
+    m_pDS->query(sql);
+    if (!m_pDS->eof())
+    {
+      width = m_pDS->fv(0).get_asInt();
+      height = m_pDS->fv(1).get_asInt();
+      m_pDS->close();
+      return true;
+    }
+    m_pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{}, failed on cached file '{}'", __FUNCTION__, cacheFile);
+  }
+  return false;
+}
+
 bool CTextureDatabase::GetTextures(CVariant &items, const Filter &filter)
 {
   try
@@ -322,8 +355,11 @@ bool CTextureDatabase::SetCachedTextureValid(const std::string &url, bool update
   return ExecuteQuery(sql);
 }
 
-bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDetails &details)
+bool CTextureDatabase::AddCachedTexture(const std::string& url,
+                                        const CTextureDetails& details,
+                                        std::string& oldCacheFile)
 {
+  oldCacheFile.clear();
   try
   {
     if (!m_pDB)
@@ -333,7 +369,10 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
 
     BeginTransaction();
 
-    std::string sql = PrepareSQL("DELETE FROM texture WHERE url='%s'", url.c_str());
+    std::string sql = PrepareSQL("select cachedurl from texture where url='%s'", url.c_str());
+    const std::string cacheFile = GetSingleValue(sql);
+
+    sql = PrepareSQL("DELETE FROM texture WHERE url='%s'", url.c_str());
     m_pDS->exec(sql);
 
     std::string date = details.updateable ? CDateTime::GetCurrentDateTime().GetAsDBDateTime() : "";
@@ -345,12 +384,21 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
     sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 1, 1, CURRENT_TIMESTAMP, %u, %u)", textureID, details.width, details.height);
     m_pDS->exec(sql);
 
+    // the file the texture was cached to before, unless other textures are cached to it as well
+    if (!cacheFile.empty() && cacheFile != details.file)
+    {
+      sql = PrepareSQL("select count(1) from texture where cachedurl='%s'", cacheFile.c_str());
+      if (GetSingleValueInt(sql) == 0)
+        oldCacheFile = cacheFile;
+    }
+
     CommitTransaction();
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "{} failed on url '{}'", __FUNCTION__, url);
     RollbackTransaction();
+    oldCacheFile.clear();
   }
   return true;
 }
@@ -380,6 +428,10 @@ bool CTextureDatabase::ClearCachedTexture(int id, std::string &cacheFile)
       // remove it
       sql = PrepareSQL("delete from texture where id=%u", id);
       m_pDS->exec(sql);
+      // keep files other textures are cached to as well
+      sql = PrepareSQL("select count(1) from texture where cachedurl='%s'", cacheFile.c_str());
+      if (GetSingleValueInt(sql) > 0)
+        cacheFile.clear();
       return true;
     }
     m_pDS->close();
@@ -63,10 +63,28 @@ public:
   bool Open() override;
 
   bool GetCachedTexture(const std::string &originalURL, CTextureDetails &details);
-  bool AddCachedTexture(const std::string &originalURL, const CTextureDetails &details);
+
+  /*! \brief Add a cached texture, replacing the one cached for the same image
+   \param originalURL the url of the image
+   \param details the texture details to add
+   \param oldCacheFile [out] the file the replaced texture was cached to, if no texture is cached
+   to it any more, so it can be deleted. Empty otherwise.
+   */
+  bool AddCachedTexture(const std::string& originalURL,
+                        const CTextureDetails& details,
+                        std::string& oldCacheFile);
+
   bool SetCachedTextureValid(const std::string &originalURL, bool updateable);
   bool ClearCachedTexture(const std::string &originalURL, std::string &cacheFile);
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
+
+  /*! \brief Get the size of an image cached to the given file
+   \param cacheFile the cached file, relative to the cache path
+   \return true if a texture is cached to the file
+   */
+  bool GetCachedTextureSize(const std::string& cacheFile,
+                            unsigned int& width,
+                            unsigned int& height);
   bool IncrementUseCount(const CTextureDetails &details);
 
   /*! \brief Invalidate a previously cached texture
@@ -120,6 +138,6 @@ protected:
   void CreateTables() override;
   void CreateAnalytics() override;
   void UpdateTables(int version) override;
-  int GetSchemaVersion() const override { return 13; }
+  int GetSchemaVersion() const override { return 14; }
   const char* GetBaseDBName() const override { return "Textures"; }
 };
@@ -1379,6 +1379,13 @@ bool CScraper::GetVideoDetails(XFILE::CCurlFile& fcurl,
   bool fRet(false);
   for (std::vector<std::string>::const_iterator i = vcsOut.begin(); i != vcsOut.end(); ++i)
   {
+    // most outputs are read in one pass, the others parsed
+    if (video.LoadFromXML(*i, true /*fChain*/, false, "details"))
+    {
+      fRet = true;
+      continue;
+    }
+
     CXBMCTinyXML doc;
     doc.Parse(*i, TIXML_ENCODING_UTF8);
     if (!doc.RootElement())
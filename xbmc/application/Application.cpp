@@ -18,6 +18,7 @@
 #include "GUIUserMessages.h"
 #include "HDRStatus.h"
 #include "LangInfo.h"
+#include "LibraryWatcher.h"
 #include "PartyModeManager.h"
 #include "PlayListPlayer.h"
 #include "SectionLoader.h"
@@ -58,11 +59,13 @@
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
 #include "filesystem/DirectoryFactory.h"
+#include "filesystem/DirectoryFanOut.h"
 #include "filesystem/DllLibCurl.h"
 #include "filesystem/File.h"
 #ifdef HAS_FILESYSTEM_NFS
 #include "filesystem/NFSFile.h"
 #endif
+#include "filesystem/PersistentDirectoryCache.h"
 #include "filesystem/PluginDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #ifdef HAS_UPNP
@@ -635,6 +638,14 @@ bool CApplication::Initialize()
 
   m_ServiceManager->GetNetwork().WaitForNet();
 
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  if (advancedSettings->m_bPersistentDirectoryCache)
+    g_persistentDirectoryCache.Initialize(
+        "special://temp/dircache/",
+        static_cast<uint64_t>(advancedSettings->m_iPersistentDirectoryCacheSize) * 1024 * 1024,
+        static_cast<uint64_t>(advancedSettings->m_iPersistentDirectoryCacheMemorySize) * 1024 *
+            1024);
+
   // initialize (and update as needed) our databases
   CDatabaseManager &databaseManager = m_ServiceManager->GetDatabaseManager();
 
@@ -1998,6 +2009,7 @@ bool CApplication::Cleanup()
     g_LangCodeExpander.Clear();
     g_charsetConverter.clear();
     g_directoryCache.Clear();
+    g_persistentDirectoryCache.Deinitialize();
     //CServiceBroker::GetInputManager().ClearKeymaps(); //! @todo
     CEventServer::RemoveInstance();
     CServiceBroker::GetPlaylistPlayer().Clear();
@@ -2139,12 +2151,17 @@ bool CApplication::Stop(int exitCode)
     CServiceBroker::GetJobManager()->CancelJobs();
 
     // stop scanning before we kill the network and so on
+    StopLibraryWatcher();
+
     if (CMusicLibraryQueue::GetInstance().IsRunning())
       CMusicLibraryQueue::GetInstance().CancelAllJobs();
 
     if (CVideoLibraryQueue::GetInstance().IsRunning())
       CVideoLibraryQueue::GetInstance().CancelAllJobs();
 
+    // the paths accessed on the workers are left out, without waiting for unresponsive servers
+    XFILE::CDirectoryFanOut::Stop();
+
     CServiceBroker::GetAppMessenger()->Cleanup();
 
     m_ServiceManager->GetNetwork().NetworkMessage(CNetworkBase::SERVICES_DOWN, 0);
@@ -3583,6 +3600,20 @@ void CApplication::UpdateLibraries()
         "", MUSIC_INFO::CMusicInfoScanner::SCAN_NORMAL,
         !settings->GetBool(CSettings::SETTING_MUSICLIBRARY_BACKGROUNDUPDATE));
   }
+
+  // (re)start watching the sources, they may have changed with the profile
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bLibraryWatcher)
+  {
+    if (!m_libraryWatcher)
+      m_libraryWatcher = std::make_unique<CLibraryWatcher>();
+    m_libraryWatcher->Start();
+  }
+}
+
+void CApplication::StopLibraryWatcher()
+{
+  if (m_libraryWatcher)
+    m_libraryWatcher->Stop();
 }
 
 void CApplication::UpdateCurrentPlayArt()
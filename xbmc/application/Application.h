@@ -37,6 +37,7 @@ class CFileItemList;
 class CGUIComponent;
 class CInertialScrollingHandler;
 class CKey;
+class CLibraryWatcher;
 class CSeekHandler;
 class CServiceManager;
 class CSettingsComponent;
@@ -164,6 +165,7 @@ public:
   void SeekTime( double dTime = 0.0 );
 
   void UpdateLibraries();
+  void StopLibraryWatcher();
 
   void UpdateCurrentPlayArt();
 
@@ -226,6 +228,7 @@ protected:
   bool m_skipGuiRender = false;
 
   std::unique_ptr<MUSIC_INFO::CMusicInfoScanner> m_musicInfoScanner;
+  std::unique_ptr<CLibraryWatcher> m_libraryWatcher;
 
   bool PlayStack(CFileItem& item, bool bRestart);
 
@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
 
 using namespace AE;
 using namespace ActiveAE;
@@ -75,6 +76,7 @@ void CEngineStats::GetDelay(AEDelayStatus& status)
 {
   std::unique_lock<CCriticalSection> lock(m_lock);
   status = m_sinkDelay;
+  status.delay += static_cast<double>(m_dspLatency);
   if (m_pcmOutput)
     status.delay += (double)m_bufferedSamples / m_sinkSampleRate;
   else
@@ -147,6 +149,7 @@ void CEngineStats::GetDelay(AEDelayStatus& status, CActiveAEStream *stream)
   std::unique_lock<CCriticalSection> lock(m_lock);
   status = m_sinkDelay;
   status.delay += static_cast<double>(m_sinkLatency);
+  status.delay += static_cast<double>(m_dspLatency);
   if (m_pcmOutput)
     status.delay += (double)m_bufferedSamples / m_sinkSampleRate;
   else
@@ -178,6 +181,7 @@ void CEngineStats::GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream)
         static_cast<double>(m_bufferedSamples) * m_sinkFormat.m_streamInfo.GetDuration() / 1000;
 
   status.delay += static_cast<double>(m_sinkLatency);
+  status.delay += static_cast<double>(m_dspLatency);
 
   for (auto &str : m_streamStats)
   {
@@ -1432,6 +1436,17 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
   }
 
+  // dsp stage for room correction, configured per output device
+  if (initSink || !CompareFormat(oldInternalFormat, m_internalFormat))
+  {
+    DSPConfig dspConfig;
+    if (m_mode != MODE_RAW && CActiveAEDSP::LoadConfig(m_settings.device, dspConfig))
+      m_dsp.Init(dspConfig, m_internalFormat.m_channelLayout, m_internalFormat.m_sampleRate);
+    else
+      m_dsp.Deinit();
+    m_stats.SetDSPLatency(static_cast<float>(m_dsp.GetLatency()));
+  }
+
   // reset gui sounds
   if (!CompareFormat(oldInternalFormat, m_internalFormat))
   {
@@ -1563,6 +1578,7 @@ void CActiveAE::FlushEngine()
     m_sinkBuffers->Flush();
   if (m_vizBuffers)
     m_vizBuffers->Flush();
+  m_dsp.Flush();
 
   // send message to sink
   Message *reply;
@@ -1913,15 +1929,20 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
+      std::vector<CSampleBuffer*> buffers;
       while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) &&
              !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
-        (*it)->m_streamPort->SendInMessage(CActiveAEDataProtocol::STREAMBUFFER, &buffer, sizeof(CSampleBuffer*));
+        buffers.push_back(buffer);
         (*it)->IncFreeBuffers();
         time += buftime;
       }
+      // hand all buffers to the stream with a single wakeup
+      if (!buffers.empty())
+        (*it)->m_streamPort->SendInMessages(CActiveAEDataProtocol::STREAMBUFFER, buffers.data(),
+                                            sizeof(CSampleBuffer*), buffers.size());
     }
     else
     {
@@ -2278,6 +2299,12 @@ bool CActiveAE::RunStages()
 
         // mix gui sounds
         MixSounds(*(out->pkt));
+
+        // room correction
+        if (m_dsp.IsActive())
+          m_dsp.Process(out->pkt->data, out->pkt->planes, out->pkt->config.channels,
+                        out->pkt->nb_samples);
+
         if (!m_sinkHasVolume || m_muted)
           Deamplify(*(out->pkt));
 
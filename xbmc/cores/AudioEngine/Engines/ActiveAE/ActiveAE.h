@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ActiveAEDSP.h"
 #include "ActiveAESink.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
@@ -199,12 +200,14 @@ public:
   void SetCurrentSinkFormat(const AEAudioFormat& SinkFormat);
   void SetSinkCacheTotal(float time) { m_sinkCacheTotal = time; }
   void SetSinkLatency(float time) { m_sinkLatency = time; }
+  void SetDSPLatency(float time) { m_dspLatency = time; }
   void SetSinkNeedIec(bool needIEC) { m_sinkNeedIecPack = needIEC; }
   bool IsSuspended();
   AEAudioFormat GetCurrentSinkFormat();
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
+  float m_dspLatency = 0.0f;
   int m_bufferedSamples;
   unsigned int m_sinkSampleRate;
   AEDelayStatus m_sinkDelay;
@@ -398,6 +401,9 @@ protected:
   bool m_muted;
   bool m_sinkHasVolume;
 
+  // room correction
+  CActiveAEDSP m_dsp;
+
   // viz
   std::vector<IAudioCallback*> m_audioCallback;
   bool m_vizInitialized;
@@ -0,0 +1,737 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ActiveAEDSP.h"
+
+#include "filesystem/File.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML2.h"
+#include "utils/XMLUtils.h"
+#include "utils/log.h"
+#include "utils/rfft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(TARGET_WINDOWS) && !defined(_USE_MATH_DEFINES)
+#define _USE_MATH_DEFINES
+#endif
+#include <math.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+constexpr const char* DSP_CONFIG_FILE = "special://profile/audiodsp.xml";
+
+bool ParseChannel(const std::string& name, AEChannel& channel)
+{
+  for (int ch = AE_CH_FL; ch < AE_CH_UNKNOWN1; ++ch)
+  {
+    if (StringUtils::EqualsNoCase(name, CAEChannelInfo::GetChName(static_cast<AEChannel>(ch))))
+    {
+      channel = static_cast<AEChannel>(ch);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ParseFilterType(const std::string& name, DSPFilter::Type& type)
+{
+  static const struct
+  {
+    const char* name;
+    DSPFilter::Type type;
+  } types[] = {{"peaking", DSPFilter::PEAKING},
+               {"lowshelf", DSPFilter::LOWSHELF},
+               {"highshelf", DSPFilter::HIGHSHELF},
+               {"lowpass", DSPFilter::LOWPASS},
+               {"highpass", DSPFilter::HIGHPASS}};
+
+  for (const auto& t : types)
+  {
+    if (StringUtils::EqualsNoCase(name, t.name))
+    {
+      type = t.type;
+      return true;
+    }
+  }
+  return false;
+}
+
+// impulse responses are stored as raw little endian 32 bit floats
+bool LoadImpulseResponse(const std::string& path, std::vector<float>& taps)
+{
+  std::vector<uint8_t> buffer;
+  XFILE::CFile file;
+  if (file.LoadFile(path, buffer) <= 0 || buffer.size() % sizeof(float))
+    return false;
+
+  taps.resize(buffer.size() / sizeof(float));
+  for (size_t i = 0; i < taps.size(); ++i)
+  {
+    const uint8_t* p = buffer.data() + i * sizeof(float);
+    const uint32_t word = p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+    std::memcpy(&taps[i], &word, sizeof(float));
+  }
+  return true;
+}
+
+// acc += x * h for count complex values in split format
+void ComplexMultiplyAccumulate(float* accRe,
+                               float* accIm,
+                               const float* xRe,
+                               const float* xIm,
+                               const float* hRe,
+                               const float* hIm,
+                               int count)
+{
+  int k = 0;
+#if defined(HAVE_SSE) && defined(__SSE__)
+  for (; k + 4 <= count; k += 4)
+  {
+    const __m128 xr = _mm_loadu_ps(xRe + k);
+    const __m128 xi = _mm_loadu_ps(xIm + k);
+    const __m128 hr = _mm_loadu_ps(hRe + k);
+    const __m128 hi = _mm_loadu_ps(hIm + k);
+    const __m128 re = _mm_sub_ps(_mm_mul_ps(xr, hr), _mm_mul_ps(xi, hi));
+    const __m128 im = _mm_add_ps(_mm_mul_ps(xr, hi), _mm_mul_ps(xi, hr));
+    _mm_storeu_ps(accRe + k, _mm_add_ps(_mm_loadu_ps(accRe + k), re));
+    _mm_storeu_ps(accIm + k, _mm_add_ps(_mm_loadu_ps(accIm + k), im));
+  }
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+  for (; k + 4 <= count; k += 4)
+  {
+    const float32x4_t xr = vld1q_f32(xRe + k);
+    const float32x4_t xi = vld1q_f32(xIm + k);
+    const float32x4_t hr = vld1q_f32(hRe + k);
+    const float32x4_t hi = vld1q_f32(hIm + k);
+    float32x4_t re = vld1q_f32(accRe + k);
+    float32x4_t im = vld1q_f32(accIm + k);
+    re = vmlsq_f32(vmlaq_f32(re, xr, hr), xi, hi);
+    im = vmlaq_f32(vmlaq_f32(im, xr, hi), xi, hr);
+    vst1q_f32(accRe + k, re);
+    vst1q_f32(accIm + k, im);
+  }
+#endif
+  for (; k < count; ++k)
+  {
+    accRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+    accIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+  }
+}
+} // unnamed namespace
+
+CActiveAEDSP::CActiveAEDSP() = default;
+
+CActiveAEDSP::~CActiveAEDSP() = default;
+
+bool CActiveAEDSP::LoadConfig(const std::string& device, DSPConfig& config)
+{
+  config.channels.clear();
+
+  if (!XFILE::CFile::Exists(DSP_CONFIG_FILE))
+    return false;
+
+  CXBMCTinyXML2 doc;
+  if (!doc.LoadFile(DSP_CONFIG_FILE))
+  {
+    CLog::Log(LOGERROR, "CActiveAEDSP::{} - unable to load {}: {}", __FUNCTION__, DSP_CONFIG_FILE,
+              doc.ErrorStr());
+    return false;
+  }
+
+  const tinyxml2::XMLElement* root = doc.RootElement();
+  if (!root || strcmp(root->Value(), "audiodsp") != 0)
+  {
+    CLog::Log(LOGERROR, "CActiveAEDSP::{} - {} does not contain <audiodsp>", __FUNCTION__,
+              DSP_CONFIG_FILE);
+    return false;
+  }
+
+  const tinyxml2::XMLElement* match = nullptr;
+  for (const auto* node = root->FirstChildElement("device"); node;
+       node = node->NextSiblingElement("device"))
+  {
+    const char* name = node->Attribute("name");
+    if (name && device == name)
+    {
+      match = node;
+      break;
+    }
+    if (!name && !match)
+      match = node;
+  }
+
+  if (!match)
+    return false;
+
+  for (const auto* node = match->FirstChildElement("channel"); node;
+       node = node->NextSiblingElement("channel"))
+  {
+    DSPChannelConfig channel;
+    const char* name = node->Attribute("name");
+    if (!name || !ParseChannel(name, channel.channel))
+    {
+      CLog::Log(LOGWARNING, "CActiveAEDSP::{} - ignoring unknown channel {}", __FUNCTION__,
+                name ? name : "");
+      continue;
+    }
+
+    XMLUtils::GetFloat(node, "gain", channel.gain, -60.0f, 30.0f);
+    XMLUtils::GetFloat(node, "delay", channel.delay, 0.0f, 1000.0f);
+
+    for (const auto* filterNode = node->FirstChildElement("filter"); filterNode;
+         filterNode = filterNode->NextSiblingElement("filter"))
+    {
+      DSPFilter filter;
+      const char* type = filterNode->Attribute("type");
+      if (!type || !ParseFilterType(type, filter.type))
+      {
+        CLog::Log(LOGWARNING, "CActiveAEDSP::{} - ignoring filter of unknown type {}",
+                  __FUNCTION__, type ? type : "");
+        continue;
+      }
+      filterNode->QueryFloatAttribute("frequency", &filter.frequency);
+      filterNode->QueryFloatAttribute("q", &filter.q);
+      filterNode->QueryFloatAttribute("gain", &filter.gain);
+      if (filter.frequency <= 0.0f || filter.q <= 0.0f)
+        continue;
+      channel.filters.push_back(filter);
+    }
+
+    std::string fir;
+    if (XMLUtils::GetString(node, "fir", fir) && !LoadImpulseResponse(fir, channel.fir))
+      CLog::Log(LOGERROR, "CActiveAEDSP::{} - unable to load impulse response {}", __FUNCTION__,
+                fir);
+
+    config.channels.push_back(std::move(channel));
+  }
+
+  return !config.channels.empty();
+}
+
+void CActiveAEDSP::SetupBiquad(BiquadLanes& lanes,
+                               int lane,
+                               const DSPFilter& filter,
+                               unsigned int sampleRate)
+{
+  // RBJ audio EQ cookbook
+  const double A = pow(10.0, static_cast<double>(filter.gain) / 40.0);
+  const double frequency = std::min(static_cast<double>(filter.frequency), sampleRate * 0.49);
+  const double w0 = 2.0 * M_PI * frequency / sampleRate;
+  const double cosw = cos(w0);
+  const double alpha = sin(w0) / (2.0 * static_cast<double>(filter.q));
+  const double sqrtA2alpha = 2.0 * sqrt(A) * alpha;
+  double b0, b1, b2, a0, a1, a2;
+
+  switch (filter.type)
+  {
+    case DSPFilter::LOWSHELF:
+      b0 = A * ((A + 1) - (A - 1) * cosw + sqrtA2alpha);
+      b1 = 2 * A * ((A - 1) - (A + 1) * cosw);
+      b2 = A * ((A + 1) - (A - 1) * cosw - sqrtA2alpha);
+      a0 = (A + 1) + (A - 1) * cosw + sqrtA2alpha;
+      a1 = -2 * ((A - 1) + (A + 1) * cosw);
+      a2 = (A + 1) + (A - 1) * cosw - sqrtA2alpha;
+      break;
+    case DSPFilter::HIGHSHELF:
+      b0 = A * ((A + 1) + (A - 1) * cosw + sqrtA2alpha);
+      b1 = -2 * A * ((A - 1) + (A + 1) * cosw);
+      b2 = A * ((A + 1) + (A - 1) * cosw - sqrtA2alpha);
+      a0 = (A + 1) - (A - 1) * cosw + sqrtA2alpha;
+      a1 = 2 * ((A - 1) - (A + 1) * cosw);
+      a2 = (A + 1) - (A - 1) * cosw - sqrtA2alpha;
+      break;
+    case DSPFilter::LOWPASS:
+      b0 = (1 - cosw) / 2;
+      b1 = 1 - cosw;
+      b2 = (1 - cosw) / 2;
+      a0 = 1 + alpha;
+      a1 = -2 * cosw;
+      a2 = 1 - alpha;
+      break;
+    case DSPFilter::HIGHPASS:
+      b0 = (1 + cosw) / 2;
+      b1 = -(1 + cosw);
+      b2 = (1 + cosw) / 2;
+      a0 = 1 + alpha;
+      a1 = -2 * cosw;
+      a2 = 1 - alpha;
+      break;
+    case DSPFilter::PEAKING:
+    default:
+      b0 = 1 + alpha * A;
+      b1 = -2 * cosw;
+      b2 = 1 - alpha * A;
+      a0 = 1 + alpha / A;
+      a1 = -2 * cosw;
+      a2 = 1 - alpha / A;
+      break;
+  }
+
+  lanes.b0[lane] = static_cast<float>(b0 / a0);
+  lanes.b1[lane] = static_cast<float>(b1 / a0);
+  lanes.b2[lane] = static_cast<float>(b2 / a0);
+  lanes.a1[lane] = static_cast<float>(a1 / a0);
+  lanes.a2[lane] = static_cast<float>(a2 / a0);
+}
+
+bool CActiveAEDSP::Init(const DSPConfig& config, const CAEChannelInfo& layout, unsigned int sampleRate)
+{
+  Deinit();
+
+  if (config.channels.empty() || !layout.Count() || !sampleRate)
+    return false;
+
+  m_channels = layout.Count();
+  m_sampleRate = sampleRate;
+  m_groups = (m_channels + 3) / 4;
+
+  // map the configuration onto the channel order of the output
+  std::vector<const DSPChannelConfig*> channelConfig(m_channels, nullptr);
+  for (const auto& channel : config.channels)
+  {
+    for (int i = 0; i < m_channels; ++i)
+    {
+      if (layout[i] == channel.channel)
+        channelConfig[i] = &channel;
+    }
+  }
+
+  size_t stages = 0;
+  size_t firTaps = 0;
+  for (const auto* channel : channelConfig)
+  {
+    if (!channel)
+      continue;
+    stages = std::max(stages, channel->filters.size());
+    firTaps = std::max(firTaps, channel->fir.size());
+    if (channel->gain != 0.0f || !channel->filters.empty())
+      m_iirActive = true;
+    if (channel->delay > 0.0f)
+      m_delayActive = true;
+  }
+  m_firActive = firTaps > 0;
+
+  // biquads and gain, unused stages and lanes are identity filters
+  if (m_iirActive)
+  {
+    BiquadLanes identity{};
+    std::fill_n(identity.b0, 4, 1.0f);
+    m_biquads.assign(m_groups, std::vector<BiquadLanes>(stages, identity));
+    m_gains.assign(m_groups * 4, 1.0f);
+    for (int i = 0; i < m_channels; ++i)
+    {
+      if (!channelConfig[i])
+        continue;
+      const int group = i / 4;
+      const int lane = i % 4;
+      for (size_t s = 0; s < channelConfig[i]->filters.size(); ++s)
+        SetupBiquad(m_biquads[group][s], lane, channelConfig[i]->filters[s], sampleRate);
+      m_gains[i] = static_cast<float>(pow(10.0, static_cast<double>(channelConfig[i]->gain) / 20.0));
+    }
+  }
+
+  // partitioned convolution, channels without impulse response are only delayed by a block
+  if (m_firActive)
+  {
+    const int fftSize = 2 * FIR_BLOCK_SIZE;
+    const int bins = FIR_BLOCK_SIZE + 1;
+    m_fft = std::make_unique<RFFT>(fftSize);
+    m_time.assign(fftSize, 0.0f);
+    m_accRe.assign(bins, 0.0f);
+    m_accIm.assign(bins, 0.0f);
+
+    m_convolvers.resize(m_channels);
+    for (int i = 0; i < m_channels; ++i)
+    {
+      Convolver& conv = m_convolvers[i];
+      conv.input.assign(fftSize, 0.0f);
+      conv.output.assign(FIR_BLOCK_SIZE, 0.0f);
+      if (!channelConfig[i] || channelConfig[i]->fir.empty())
+        continue;
+
+      const std::vector<float>& taps = channelConfig[i]->fir;
+      conv.partitions = static_cast<int>((taps.size() + FIR_BLOCK_SIZE - 1) / FIR_BLOCK_SIZE);
+      conv.filterRe.resize(conv.partitions * bins);
+      conv.filterIm.resize(conv.partitions * bins);
+      conv.spectraRe.assign(conv.partitions * bins, 0.0f);
+      conv.spectraIm.assign(conv.partitions * bins, 0.0f);
+
+      // the 1/N of the inverse transform is folded into the filter spectra
+      const float scale = 1.0f / fftSize;
+      for (int p = 0; p < conv.partitions; ++p)
+      {
+        std::fill(m_time.begin(), m_time.end(), 0.0f);
+        const size_t start = p * FIR_BLOCK_SIZE;
+        const size_t count = std::min<size_t>(FIR_BLOCK_SIZE, taps.size() - start);
+        std::copy_n(taps.begin() + start, count, m_time.begin());
+        float* re = conv.filterRe.data() + p * bins;
+        float* im = conv.filterIm.data() + p * bins;
+        m_fft->forward(m_time.data(), re, im);
+        for (int k = 0; k < bins; ++k)
+        {
+          re[k] *= scale;
+          im[k] *= scale;
+        }
+      }
+    }
+  }
+
+  if (m_delayActive)
+  {
+    m_delays.resize(m_channels);
+    m_minDelay = SIZE_MAX;
+    for (int i = 0; i < m_channels; ++i)
+    {
+      const float delay = channelConfig[i] ? channelConfig[i]->delay : 0.0f;
+      const size_t samples = static_cast<size_t>(lrintf(delay * sampleRate / 1000.0f));
+      m_delays[i].buffer.assign(samples, 0.0f);
+      m_minDelay = std::min(m_minDelay, samples);
+    }
+  }
+
+  m_channelData.resize(m_channels);
+  m_active = m_iirActive || m_firActive || m_delayActive;
+
+  if (m_active)
+    CLog::Log(LOGINFO,
+              "CActiveAEDSP::{} - {} channels, {} biquad stages, {} fir taps, latency {:.2f} ms",
+              __FUNCTION__, m_channels, stages, firTaps, GetLatency() * 1000);
+
+  return m_active;
+}
+
+void CActiveAEDSP::Deinit()
+{
+  m_active = false;
+  m_iirActive = false;
+  m_firActive = false;
+  m_delayActive = false;
+  m_channels = 0;
+  m_groups = 0;
+  m_firFill = 0;
+  m_minDelay = 0;
+  m_biquads.clear();
+  m_gains.clear();
+  m_convolvers.clear();
+  m_delays.clear();
+  m_fft.reset();
+}
+
+void CActiveAEDSP::Flush()
+{
+  for (auto& group : m_biquads)
+  {
+    for (auto& stage : group)
+    {
+      std::fill_n(stage.z1, 4, 0.0f);
+      std::fill_n(stage.z2, 4, 0.0f);
+    }
+  }
+
+  for (auto& conv : m_convolvers)
+  {
+    std::fill(conv.input.begin(), conv.input.end(), 0.0f);
+    std::fill(conv.output.begin(), conv.output.end(), 0.0f);
+    std::fill(conv.spectraRe.begin(), conv.spectraRe.end(), 0.0f);
+    std::fill(conv.spectraIm.begin(), conv.spectraIm.end(), 0.0f);
+    conv.current = 0;
+  }
+  m_firFill = 0;
+
+  for (auto& delay : m_delays)
+  {
+    std::fill(delay.buffer.begin(), delay.buffer.end(), 0.0f);
+    delay.pos = 0;
+  }
+}
+
+double CActiveAEDSP::GetLatency() const
+{
+  if (!m_sampleRate)
+    return 0.0;
+
+  size_t samples = m_minDelay;
+  if (m_firActive)
+    samples += FIR_BLOCK_SIZE;
+  return static_cast<double>(samples) / m_sampleRate;
+}
+
+void CActiveAEDSP::Process(uint8_t** data, int planes, int channels, int frames)
+{
+  if (!m_active || channels != m_channels || frames <= 0)
+    return;
+
+  const bool planar = planes > 1;
+
+  if (m_iirActive)
+  {
+    m_work.resize(static_cast<size_t>(frames) * 4);
+    for (int g = 0; g < m_groups; ++g)
+    {
+      const int lanes = std::min(4, channels - g * 4);
+
+      // gather up to four channels into one vector per frame
+      for (int l = 0; l < 4; ++l)
+      {
+        const int c = g * 4 + l;
+        if (l >= lanes)
+        {
+          for (int n = 0; n < frames; ++n)
+            m_work[n * 4 + l] = 0.0f;
+        }
+        else if (planar)
+        {
+          const float* src = reinterpret_cast<const float*>(data[c]);
+          for (int n = 0; n < frames; ++n)
+            m_work[n * 4 + l] = src[n];
+        }
+        else
+        {
+          const float* src = reinterpret_cast<const float*>(data[0]) + c;
+          for (int n = 0; n < frames; ++n)
+            m_work[n * 4 + l] = src[n * channels];
+        }
+      }
+
+      RunBiquads(g, m_work.data(), frames);
+
+      for (int l = 0; l < lanes; ++l)
+      {
+        const int c = g * 4 + l;
+        float* dst = planar ? reinterpret_cast<float*>(data[c])
+                            : reinterpret_cast<float*>(data[0]) + c;
+        const int stride = planar ? 1 : channels;
+        for (int n = 0; n < frames; ++n)
+          dst[n * stride] = m_work[n * 4 + l];
+      }
+    }
+  }
+
+  if (!m_firActive && !m_delayActive)
+    return;
+
+  // convolution and delay work on contiguous channels
+  if (planar)
+  {
+    for (int c = 0; c < channels; ++c)
+      m_channelData[c] = reinterpret_cast<float*>(data[c]);
+  }
+  else
+  {
+    m_channelBuffer.resize(static_cast<size_t>(frames) * channels);
+    const float* src = reinterpret_cast<const float*>(data[0]);
+    for (int c = 0; c < channels; ++c)
+    {
+      m_channelData[c] = m_channelBuffer.data() + static_cast<size_t>(c) * frames;
+      for (int n = 0; n < frames; ++n)
+        m_channelData[c][n] = src[n * channels + c];
+    }
+  }
+
+  if (m_firActive)
+    RunConvolution(m_channelData.data(), frames);
+
+  if (m_delayActive)
+  {
+    for (int c = 0; c < channels; ++c)
+      RunDelay(m_delays[c], m_channelData[c], frames);
+  }
+
+  if (!planar)
+  {
+    float* dst = reinterpret_cast<float*>(data[0]);
+    for (int c = 0; c < channels; ++c)
+    {
+      for (int n = 0; n < frames; ++n)
+        dst[n * channels + c] = m_channelData[c][n];
+    }
+  }
+}
+
+void CActiveAEDSP::RunBiquads(int group, float* work, int frames)
+{
+  std::vector<BiquadLanes>& stages = m_biquads[group];
+  const float* gain = m_gains.data() + group * 4;
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+  const __m128 g = _mm_loadu_ps(gain);
+  for (auto& bq : stages)
+  {
+    const __m128 b0 = _mm_loadu_ps(bq.b0);
+    const __m128 b1 = _mm_loadu_ps(bq.b1);
+    const __m128 b2 = _mm_loadu_ps(bq.b2);
+    const __m128 a1 = _mm_loadu_ps(bq.a1);
+    const __m128 a2 = _mm_loadu_ps(bq.a2);
+    __m128 z1 = _mm_loadu_ps(bq.z1);
+    __m128 z2 = _mm_loadu_ps(bq.z2);
+    for (int n = 0; n < frames; ++n)
+    {
+      // transposed direct form II
+      const __m128 x = _mm_loadu_ps(work + n * 4);
+      const __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+      z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+      z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+      _mm_storeu_ps(work + n * 4, y);
+    }
+    _mm_storeu_ps(bq.z1, z1);
+    _mm_storeu_ps(bq.z2, z2);
+  }
+  for (int n = 0; n < frames; ++n)
+    _mm_storeu_ps(work + n * 4, _mm_mul_ps(_mm_loadu_ps(work + n * 4), g));
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+  const float32x4_t g = vld1q_f32(gain);
+  for (auto& bq : stages)
+  {
+    const float32x4_t b0 = vld1q_f32(bq.b0);
+    const float32x4_t b1 = vld1q_f32(bq.b1);
+    const float32x4_t b2 = vld1q_f32(bq.b2);
+    const float32x4_t a1 = vld1q_f32(bq.a1);
+    const float32x4_t a2 = vld1q_f32(bq.a2);
+    float32x4_t z1 = vld1q_f32(bq.z1);
+    float32x4_t z2 = vld1q_f32(bq.z2);
+    for (int n = 0; n < frames; ++n)
+    {
+      // transposed direct form II
+      const float32x4_t x = vld1q_f32(work + n * 4);
+      const float32x4_t y = vmlaq_f32(z1, b0, x);
+      z1 = vaddq_f32(vmlsq_f32(vmulq_f32(b1, x), a1, y), z2);
+      z2 = vmlsq_f32(vmulq_f32(b2, x), a2, y);
+      vst1q_f32(work + n * 4, y);
+    }
+    vst1q_f32(bq.z1, z1);
+    vst1q_f32(bq.z2, z2);
+  }
+  for (int n = 0; n < frames; ++n)
+    vst1q_f32(work + n * 4, vmulq_f32(vld1q_f32(work + n * 4), g));
+#else
+  for (auto& bq : stages)
+  {
+    for (int n = 0; n < frames; ++n)
+    {
+      // transposed direct form II
+      for (int l = 0; l < 4; ++l)
+      {
+        const float x = work[n * 4 + l];
+        const float y = bq.b0[l] * x + bq.z1[l];
+        bq.z1[l] = bq.b1[l] * x - bq.a1[l] * y + bq.z2[l];
+        bq.z2[l] = bq.b2[l] * x - bq.a2[l] * y;
+        work[n * 4 + l] = y;
+      }
+    }
+  }
+  for (int n = 0; n < frames; ++n)
+  {
+    for (int l = 0; l < 4; ++l)
+      work[n * 4 + l] *= gain[l];
+  }
+#endif
+
+  // decaying filter states end up as denormals on silence, which are very slow on most cpus
+  for (auto& bq : stages)
+  {
+    for (int l = 0; l < 4; ++l)
+    {
+      if (std::abs(bq.z1[l]) < 1e-20f)
+        bq.z1[l] = 0.0f;
+      if (std::abs(bq.z2[l]) < 1e-20f)
+        bq.z2[l] = 0.0f;
+    }
+  }
+}
+
+void CActiveAEDSP::RunConvolution(float* const* channelData, int frames)
+{
+  int pos = 0;
+  while (pos < frames)
+  {
+    const int count = std::min(frames - pos, FIR_BLOCK_SIZE - m_firFill);
+    for (int c = 0; c < m_channels; ++c)
+    {
+      Convolver& conv = m_convolvers[c];
+      float* samples = channelData[c] + pos;
+      float* input = conv.input.data() + FIR_BLOCK_SIZE + m_firFill;
+      const float* output = conv.output.data() + m_firFill;
+      for (int n = 0; n < count; ++n)
+      {
+        input[n] = samples[n];
+        samples[n] = output[n];
+      }
+    }
+    m_firFill += count;
+    pos += count;
+
+    if (m_firFill == FIR_BLOCK_SIZE)
+    {
+      for (auto& conv : m_convolvers)
+        ProcessBlock(conv);
+      m_firFill = 0;
+    }
+  }
+}
+
+void CActiveAEDSP::ProcessBlock(Convolver& conv)
+{
+  if (conv.partitions)
+  {
+    const int bins = FIR_BLOCK_SIZE + 1;
+
+    // overlap-save: transform the last two blocks, keep the spectrum in the delay line
+    m_fft->forward(conv.input.data(), conv.spectraRe.data() + conv.current * bins,
+                   conv.spectraIm.data() + conv.current * bins);
+
+    std::fill(m_accRe.begin(), m_accRe.end(), 0.0f);
+    std::fill(m_accIm.begin(), m_accIm.end(), 0.0f);
+    for (int p = 0; p < conv.partitions; ++p)
+    {
+      const int slot = (conv.current - p + conv.partitions) % conv.partitions;
+      ComplexMultiplyAccumulate(m_accRe.data(), m_accIm.data(),
+                                conv.spectraRe.data() + slot * bins,
+                                conv.spectraIm.data() + slot * bins,
+                                conv.filterRe.data() + p * bins, conv.filterIm.data() + p * bins,
+                                bins);
+    }
+    conv.current = (conv.current + 1) % conv.partitions;
+
+    m_fft->inverse(m_accRe.data(), m_accIm.data(), m_time.data());
+    std::copy_n(m_time.begin() + FIR_BLOCK_SIZE, FIR_BLOCK_SIZE, conv.output.begin());
+  }
+  else
+  {
+    std::copy_n(conv.input.begin() + FIR_BLOCK_SIZE, FIR_BLOCK_SIZE, conv.output.begin());
+  }
+
+  std::copy_n(conv.input.begin() + FIR_BLOCK_SIZE, FIR_BLOCK_SIZE, conv.input.begin());
+}
+
+void CActiveAEDSP::RunDelay(DelayLine& delay, float* data, int frames)
+{
+  const size_t length = delay.buffer.size();
+  if (!length)
+    return;
+
+  for (int n = 0; n < frames; ++n)
+  {
+    const float sample = data[n];
+    data[n] = delay.buffer[delay.pos];
+    delay.buffer[delay.pos] = sample;
+    if (++delay.pos == length)
+      delay.pos = 0;
+  }
+}
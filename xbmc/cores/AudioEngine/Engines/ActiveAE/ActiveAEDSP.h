@@ -0,0 +1,153 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Utils/AEChannelInfo.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class RFFT;
+
+namespace ActiveAE
+{
+
+struct DSPFilter
+{
+  enum Type
+  {
+    PEAKING,
+    LOWSHELF,
+    HIGHSHELF,
+    LOWPASS,
+    HIGHPASS
+  };
+  Type type = PEAKING;
+  float frequency = 1000.0f; // Hz
+  float q = 0.707f;
+  float gain = 0.0f; // dB, peaking and shelving filters only
+};
+
+struct DSPChannelConfig
+{
+  AEChannel channel = AE_CH_NULL;
+  float gain = 0.0f; // dB
+  float delay = 0.0f; // ms
+  std::vector<DSPFilter> filters;
+  std::vector<float> fir; // impulse response at the output sample rate
+};
+
+struct DSPConfig
+{
+  std::vector<DSPChannelConfig> channels;
+};
+
+/*!
+ * \brief Room correction stage running on the mixed float output of the engine.
+ *
+ * Per channel it applies a cascade of biquads and a gain (four channels per SIMD
+ * vector), an FIR filter using uniformly partitioned overlap-save convolution and
+ * a delay. The configuration is read per output device from audiodsp.xml in the
+ * profile directory.
+ */
+class CActiveAEDSP
+{
+public:
+  CActiveAEDSP();
+  ~CActiveAEDSP();
+
+  /*!
+   * \brief Read the configuration for device from special://profile/audiodsp.xml.
+   * A <device> element without name attribute applies to all other devices.
+   * \return true if a configuration was found
+   */
+  static bool LoadConfig(const std::string& device, DSPConfig& config);
+
+  bool Init(const DSPConfig& config, const CAEChannelInfo& layout, unsigned int sampleRate);
+  void Deinit();
+  bool IsActive() const { return m_active; }
+
+  /*!
+   * \brief Reset the filter states, delay lines and the convolution history.
+   */
+  void Flush();
+
+  /*!
+   * \brief Process float samples in place.
+   * \param data planes of the packet, a single plane holds interleaved samples
+   * \param planes number of planes, 1 or channels
+   * \param channels number of channels
+   * \param frames number of frames
+   */
+  void Process(uint8_t** data, int planes, int channels, int frames);
+
+  /*!
+   * \brief Delay in seconds added to every channel, needs to be reported as engine delay.
+   */
+  double GetLatency() const;
+
+  static constexpr int FIR_BLOCK_SIZE = 256;
+
+protected:
+  struct BiquadLanes
+  {
+    float b0[4], b1[4], b2[4], a1[4], a2[4];
+    float z1[4], z2[4];
+  };
+
+  struct Convolver
+  {
+    int partitions = 0;
+    int current = 0;
+    std::vector<float> input; // previous and current block
+    std::vector<float> output; // filtered block, delayed by one block
+    std::vector<float> spectraRe, spectraIm; // frequency domain delay line
+    std::vector<float> filterRe, filterIm; // partitioned filter spectra
+  };
+
+  struct DelayLine
+  {
+    std::vector<float> buffer;
+    size_t pos = 0;
+  };
+
+  static void SetupBiquad(BiquadLanes& lanes, int lane, const DSPFilter& filter, unsigned int sampleRate);
+  void RunBiquads(int group, float* work, int frames);
+  void RunConvolution(float* const* channelData, int frames);
+  void ProcessBlock(Convolver& conv);
+  static void RunDelay(DelayLine& delay, float* data, int frames);
+
+  bool m_active = false;
+  int m_channels = 0;
+  unsigned int m_sampleRate = 0;
+
+  bool m_iirActive = false;
+  int m_groups = 0;
+  std::vector<std::vector<BiquadLanes>> m_biquads;
+  std::vector<float> m_gains; // 4 lanes per group
+  std::vector<float> m_work;
+
+  bool m_firActive = false;
+  int m_firFill = 0;
+  std::vector<Convolver> m_convolvers;
+  std::unique_ptr<RFFT> m_fft;
+  std::vector<float> m_time;
+  std::vector<float> m_accRe, m_accIm;
+
+  bool m_delayActive = false;
+  size_t m_minDelay = 0;
+  std::vector<DelayLine> m_delays;
+
+  std::vector<float> m_channelBuffer;
+  std::vector<float*> m_channelData;
+};
+
+}
@@ -0,0 +1,238 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEDSP.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+constexpr unsigned int SAMPLE_RATE = 48000;
+constexpr double PI = 3.14159265358979323846;
+
+CAEChannelInfo Layout(int channels)
+{
+  static const AEChannel order[] = {AE_CH_FL,  AE_CH_FR,  AE_CH_FC,  AE_CH_LFE,
+                                    AE_CH_SL,  AE_CH_SR,  AE_CH_BL,  AE_CH_BR};
+  CAEChannelInfo layout;
+  for (int i = 0; i < channels; ++i)
+    layout += order[i];
+  return layout;
+}
+
+// feeds planar channel buffers through the stage in chunks of chunk frames
+void ProcessPlanar(CActiveAEDSP& dsp, std::vector<std::vector<float>>& channels, int chunk)
+{
+  const int frames = static_cast<int>(channels[0].size());
+  std::vector<uint8_t*> planes(channels.size());
+  for (int pos = 0; pos < frames; pos += chunk)
+  {
+    for (size_t c = 0; c < channels.size(); ++c)
+      planes[c] = reinterpret_cast<uint8_t*>(channels[c].data() + pos);
+    dsp.Process(planes.data(), static_cast<int>(planes.size()), static_cast<int>(planes.size()),
+                std::min(chunk, frames - pos));
+  }
+}
+
+double Rms(const std::vector<float>& samples, size_t from)
+{
+  double sum = 0.0;
+  for (size_t i = from; i < samples.size(); ++i)
+    sum += static_cast<double>(samples[i]) * static_cast<double>(samples[i]);
+  return std::sqrt(sum / (samples.size() - from));
+}
+
+std::vector<float> Sine(double frequency, int frames)
+{
+  std::vector<float> samples(frames);
+  for (int n = 0; n < frames; ++n)
+    samples[n] = static_cast<float>(0.5 * std::sin(2.0 * PI * frequency * n / SAMPLE_RATE));
+  return samples;
+}
+} // namespace
+
+TEST(TestActiveAEDSP, Inactive)
+{
+  CActiveAEDSP dsp;
+  DSPConfig config;
+  EXPECT_FALSE(dsp.Init(config, Layout(2), SAMPLE_RATE));
+
+  // a configuration for channels missing in the output layout does nothing either
+  DSPChannelConfig channel;
+  channel.channel = AE_CH_BL;
+  channel.gain = -6.0f;
+  config.channels.push_back(channel);
+  EXPECT_FALSE(dsp.Init(config, Layout(2), SAMPLE_RATE));
+  EXPECT_FALSE(dsp.IsActive());
+  EXPECT_EQ(0.0, dsp.GetLatency());
+}
+
+TEST(TestActiveAEDSP, PeakingFilter)
+{
+  DSPConfig config;
+  DSPChannelConfig channel;
+  channel.channel = AE_CH_FR;
+  channel.filters.push_back({DSPFilter::PEAKING, 1000.0f, 1.0f, 6.0f});
+  config.channels.push_back(channel);
+
+  CActiveAEDSP dsp;
+  ASSERT_TRUE(dsp.Init(config, Layout(2), SAMPLE_RATE));
+  EXPECT_EQ(0.0, dsp.GetLatency());
+
+  const int frames = SAMPLE_RATE / 2;
+  std::vector<std::vector<float>> channels{Sine(1000.0, frames), Sine(1000.0, frames)};
+  const double rmsIn = Rms(channels[0], 0);
+  ProcessPlanar(dsp, channels, 1024);
+
+  // FL is untouched, FR is raised by 6dB at the centre frequency
+  EXPECT_NEAR(rmsIn, Rms(channels[0], 0), 1e-6);
+  EXPECT_NEAR(6.0, 20.0 * std::log10(Rms(channels[1], frames / 2) / rmsIn), 0.05);
+
+  // an octave away the boost is clearly lower
+  ASSERT_TRUE(dsp.Init(config, Layout(2), SAMPLE_RATE));
+  channels = {Sine(4000.0, frames), Sine(4000.0, frames)};
+  ProcessPlanar(dsp, channels, 1024);
+  EXPECT_LT(20.0 * std::log10(Rms(channels[1], frames / 2) / rmsIn), 2.0);
+}
+
+TEST(TestActiveAEDSP, GainAndDelay)
+{
+  DSPConfig config;
+  DSPChannelConfig channel;
+  channel.channel = AE_CH_FL;
+  channel.gain = -20.0f;
+  channel.delay = 1.0f;
+  config.channels.push_back(channel);
+  channel.channel = AE_CH_FR;
+  channel.gain = 0.0f;
+  channel.delay = 2.0f;
+  config.channels.push_back(channel);
+
+  CActiveAEDSP dsp;
+  ASSERT_TRUE(dsp.Init(config, Layout(2), SAMPLE_RATE));
+  // both channels are delayed, the common part is reported as latency
+  EXPECT_DOUBLE_EQ(0.001, dsp.GetLatency());
+
+  // interleaved, a single impulse per channel
+  const int frames = 500;
+  std::vector<float> samples(frames * 2, 0.0f);
+  samples[0] = 1.0f;
+  samples[1] = 1.0f;
+  uint8_t* plane = reinterpret_cast<uint8_t*>(samples.data());
+  dsp.Process(&plane, 1, 2, frames);
+
+  for (int n = 0; n < frames; ++n)
+  {
+    EXPECT_FLOAT_EQ(n == 48 ? 0.1f : 0.0f, samples[n * 2]) << "frame " << n;
+    EXPECT_FLOAT_EQ(n == 96 ? 1.0f : 0.0f, samples[n * 2 + 1]) << "frame " << n;
+  }
+
+  dsp.Flush();
+  std::fill(samples.begin(), samples.end(), 0.0f);
+  dsp.Process(&plane, 1, 2, frames);
+  for (float sample : samples)
+    EXPECT_EQ(0.0f, sample);
+}
+
+TEST(TestActiveAEDSP, Convolution)
+{
+  constexpr int B = CActiveAEDSP::FIR_BLOCK_SIZE;
+  std::mt19937 rng(99);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+  DSPConfig config;
+  DSPChannelConfig channel;
+  channel.channel = AE_CH_FC;
+  channel.fir.resize(3 * B + 17);
+  for (auto& tap : channel.fir)
+    tap = dist(rng) * 0.1f;
+  config.channels.push_back(channel);
+
+  const std::vector<float> taps = channel.fir;
+  const int frames = 10 * B + 123;
+  std::vector<float> input(frames);
+  for (auto& sample : input)
+    sample = dist(rng);
+
+  for (int chunk : {1, 100, B, 3000})
+  {
+    CActiveAEDSP dsp;
+    ASSERT_TRUE(dsp.Init(config, Layout(3), SAMPLE_RATE));
+    EXPECT_DOUBLE_EQ(static_cast<double>(B) / SAMPLE_RATE, dsp.GetLatency());
+
+    std::vector<std::vector<float>> channels{input, input, input};
+    ProcessPlanar(dsp, channels, chunk);
+
+    for (int n = 0; n < frames; ++n)
+    {
+      // channels without impulse response are only delayed by one block
+      const float delayed = n >= B ? input[n - B] : 0.0f;
+      ASSERT_FLOAT_EQ(delayed, channels[0][n]) << "chunk " << chunk << " frame " << n;
+
+      double expected = 0.0;
+      for (size_t k = 0; k < taps.size() && static_cast<int>(k) <= n - B; ++k)
+        expected += static_cast<double>(taps[k]) * static_cast<double>(input[n - B - k]);
+      ASSERT_NEAR(expected, channels[2][n], 1e-4) << "chunk " << chunk << " frame " << n;
+    }
+  }
+}
+
+// the speed of a 7.1 room correction, run with --gtest_also_run_disabled_tests
+TEST(TestActiveAEDSP, DISABLED_Benchmark)
+{
+  constexpr int CHANNELS = 8;
+  constexpr int FRAMES = 1024;
+  constexpr int PERIODS = 500;
+
+  DSPConfig config;
+  const CAEChannelInfo layout = Layout(CHANNELS);
+  for (int i = 0; i < CHANNELS; ++i)
+  {
+    DSPChannelConfig channel;
+    channel.channel = layout[i];
+    channel.gain = -3.0f;
+    channel.delay = 0.5f * i;
+    for (int s = 0; s < 8; ++s)
+      channel.filters.push_back({DSPFilter::PEAKING, 50.0f * (s + 1), 2.0f, -3.0f});
+    channel.fir.assign(4096, 0.0f);
+    channel.fir[0] = 1.0f;
+    config.channels.push_back(channel);
+  }
+
+  CActiveAEDSP dsp;
+  ASSERT_TRUE(dsp.Init(config, layout, SAMPLE_RATE));
+
+  std::vector<float> source(FRAMES * CHANNELS);
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+  for (auto& sample : source)
+    sample = dist(rng);
+
+  std::vector<float> samples(source.size());
+  uint8_t* plane = reinterpret_cast<uint8_t*>(samples.data());
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < PERIODS; ++i)
+  {
+    std::copy(source.begin(), source.end(), samples.begin());
+    dsp.Process(&plane, 1, CHANNELS, FRAMES);
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const double audioSeconds = static_cast<double>(PERIODS) * FRAMES / SAMPLE_RATE;
+  RecordProperty("times_realtime", static_cast<int>(audioSeconds / seconds));
+  RecordProperty("us_per_period", static_cast<int>(seconds * 1000000 / PERIODS));
+}
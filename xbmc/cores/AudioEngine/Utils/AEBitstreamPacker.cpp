@@ -12,6 +12,7 @@
 #include "AEStreamInfo.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <array>
 #include <stddef.h>
 #include <stdint.h>
@@ -21,6 +22,7 @@ namespace
 {
 constexpr auto BURST_HEADER_SIZE = 8;
 constexpr auto EAC3_MAX_BURST_PAYLOAD_SIZE = 24576 - BURST_HEADER_SIZE;
+constexpr unsigned int DTSHD_START_CODE_SIZE = 12;
 } // namespace
 
 CAEBitstreamPacker::CAEBitstreamPacker()
@@ -34,12 +36,16 @@ CAEBitstreamPacker::~CAEBitstreamPacker()
 
 void CAEBitstreamPacker::Pack(CAEStreamInfo &info, uint8_t* data, int size)
 {
-  m_pauseDuration = 0;
+  m_buffer = m_packedBuffer;
   switch (info.m_type)
   {
     case CAEStreamInfo::STREAM_TYPE_TRUEHD:
       m_dataSize = CAEPackIEC61937::PackTrueHD(data + IEC61937_DATA_OFFSET,
-                                               size - IEC61937_DATA_OFFSET, m_packedBuffer);
+                                               size - IEC61937_DATA_OFFSET, m_packedBuffer,
+                                               m_dirty);
+      // an empty frame repeats the previous burst
+      if (size > IEC61937_DATA_OFFSET)
+        UpdateDirty(size + 1, m_dataSize);
       break;
 
     case CAEStreamInfo::STREAM_TYPE_DTSHD:
@@ -48,7 +54,8 @@ void CAEBitstreamPacker::Pack(CAEStreamInfo &info, uint8_t* data, int size)
       break;
 
     case CAEStreamInfo::STREAM_TYPE_AC3:
-      m_dataSize = CAEPackIEC61937::PackAC3(data, size, m_packedBuffer);
+      m_dataSize = CAEPackIEC61937::PackAC3(data, size, m_packedBuffer, m_dirty);
+      UpdateDirty(IEC61937_DATA_OFFSET + size + 1, m_dataSize);
       break;
 
     case CAEStreamInfo::STREAM_TYPE_EAC3:
@@ -57,15 +64,21 @@ void CAEBitstreamPacker::Pack(CAEStreamInfo &info, uint8_t* data, int size)
 
     case CAEStreamInfo::STREAM_TYPE_DTSHD_CORE:
     case CAEStreamInfo::STREAM_TYPE_DTS_512:
-      m_dataSize = CAEPackIEC61937::PackDTS_512(data, size, m_packedBuffer, info.m_dataIsLE);
+      m_dataSize = CAEPackIEC61937::PackDTS_512(data, size, m_packedBuffer, info.m_dataIsLE,
+                                                m_dirty);
+      UpdateDirty(IEC61937_DATA_OFFSET + size + 1, m_dataSize);
       break;
 
     case CAEStreamInfo::STREAM_TYPE_DTS_1024:
-      m_dataSize = CAEPackIEC61937::PackDTS_1024(data, size, m_packedBuffer, info.m_dataIsLE);
+      m_dataSize = CAEPackIEC61937::PackDTS_1024(data, size, m_packedBuffer, info.m_dataIsLE,
+                                                 m_dirty);
+      UpdateDirty(IEC61937_DATA_OFFSET + size + 1, m_dataSize);
       break;
 
     case CAEStreamInfo::STREAM_TYPE_DTS_2048:
-      m_dataSize = CAEPackIEC61937::PackDTS_2048(data, size, m_packedBuffer, info.m_dataIsLE);
+      m_dataSize = CAEPackIEC61937::PackDTS_2048(data, size, m_packedBuffer, info.m_dataIsLE,
+                                                 m_dirty);
+      UpdateDirty(IEC61937_DATA_OFFSET + size + 1, m_dataSize);
       break;
 
     default:
@@ -76,15 +89,20 @@ void CAEBitstreamPacker::Pack(CAEStreamInfo &info, uint8_t* data, int size)
 bool CAEBitstreamPacker::PackPause(CAEStreamInfo &info, unsigned int millis, bool iecBursts)
 {
   // re-use last buffer
-  if (m_pauseDuration == millis)
+  if (m_pauseDuration == millis && m_pauseType == info.m_type &&
+      m_pauseSampleRate == info.m_sampleRate && m_pauseBursts == iecBursts)
+  {
+    m_buffer = m_pauseBuffer.data();
+    m_dataSize = m_pauseSize;
     return false;
+  }
 
+  unsigned int repPeriod;
   switch (info.m_type)
   {
     case CAEStreamInfo::STREAM_TYPE_TRUEHD:
     case CAEStreamInfo::STREAM_TYPE_EAC3:
-      m_dataSize = CAEPackIEC61937::PackPause(m_packedBuffer, millis, GetOutputChannelMap(info).Count() * 2, GetOutputRate(info), 4, info.m_sampleRate);
-      m_pauseDuration = millis;
+      repPeriod = 4;
       break;
 
     case CAEStreamInfo::STREAM_TYPE_AC3:
@@ -94,19 +112,29 @@ bool CAEBitstreamPacker::PackPause(CAEStreamInfo &info, unsigned int millis, boo
     case CAEStreamInfo::STREAM_TYPE_DTS_512:
     case CAEStreamInfo::STREAM_TYPE_DTS_1024:
     case CAEStreamInfo::STREAM_TYPE_DTS_2048:
-      m_dataSize = CAEPackIEC61937::PackPause(m_packedBuffer, millis, GetOutputChannelMap(info).Count() * 2, GetOutputRate(info), 3, info.m_sampleRate);
-      m_pauseDuration = millis;
+      repPeriod = 3;
       break;
 
     default:
       CLog::Log(LOGERROR, "CAEBitstreamPacker::Pack - no pack function");
+      return false;
   }
 
+  m_pauseBuffer.resize(MAX_IEC61937_PACKET);
+  m_pauseSize = CAEPackIEC61937::PackPause(m_pauseBuffer.data(), millis,
+                                           GetOutputChannelMap(info).Count() * 2,
+                                           GetOutputRate(info), repPeriod, info.m_sampleRate);
   if (!iecBursts)
   {
-    memset(m_packedBuffer, 0, m_dataSize);
+    memset(m_pauseBuffer.data(), 0, m_pauseSize);
   }
 
+  m_pauseDuration = millis;
+  m_pauseType = info.m_type;
+  m_pauseSampleRate = info.m_sampleRate;
+  m_pauseBursts = iecBursts;
+  m_buffer = m_pauseBuffer.data();
+  m_dataSize = m_pauseSize;
   return true;
 }
 
@@ -117,34 +145,29 @@ unsigned int CAEBitstreamPacker::GetSize() const
 
 uint8_t* CAEBitstreamPacker::GetBuffer()
 {
-  return m_packedBuffer;
+  return m_buffer;
 }
 
 void CAEBitstreamPacker::Reset()
 {
   m_dataSize = 0;
-  m_pauseDuration = 0;
   m_packedBuffer[0] = 0;
+  m_buffer = m_packedBuffer;
 }
 
-void CAEBitstreamPacker::PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size)
+void CAEBitstreamPacker::UpdateDirty(unsigned int end, unsigned int burstSize)
 {
-  static const uint8_t dtshd_start_code[10] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe };
-  unsigned int dataSize = sizeof(dtshd_start_code) + 2 + size;
-
-  if (dataSize > m_dtsHDSize)
-  {
-    m_dtsHDSize = dataSize;
-    m_dtsHD.resize(dataSize);
-    memcpy(m_dtsHD.data(), dtshd_start_code, sizeof(dtshd_start_code));
-  }
-
-  m_dtsHD[sizeof(dtshd_start_code) + 0] = ((uint16_t)size & 0xFF00) >> 8;
-  m_dtsHD[sizeof(dtshd_start_code) + 1] = ((uint16_t)size & 0x00FF);
-  memcpy(m_dtsHD.data() + sizeof(dtshd_start_code) + 2, data, size);
+  // a failed pack leaves the buffer untouched, a burst clears its padding up to the old extent
+  if (!burstSize)
+    return;
+  m_dirty = std::max(end, m_dirty > burstSize ? m_dirty : 0);
+}
 
+void CAEBitstreamPacker::PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size)
+{
   m_dataSize =
-      CAEPackIEC61937::PackDTSHD(m_dtsHD.data(), dataSize, m_packedBuffer, info.m_dtsPeriod);
+      CAEPackIEC61937::PackDTSHD(data, size, m_packedBuffer, info.m_dtsPeriod, m_dirty);
+  UpdateDirty(IEC61937_DATA_OFFSET + DTSHD_START_CODE_SIZE + size + 1, m_dataSize);
 }
 
 void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
@@ -161,28 +184,30 @@ void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
   if (m_eac3FramesPerBurst == 1)
   {
     /* simple case, just pass through */
-    m_dataSize = CAEPackIEC61937::PackEAC3(data, size, m_packedBuffer);
+    m_dataSize = CAEPackIEC61937::PackEAC3(data, size, m_packedBuffer, m_dirty);
+    UpdateDirty(IEC61937_DATA_OFFSET + size + 1, m_dataSize);
   }
   else
   {
-    /* multiple frames needed to achieve 6 blocks as required by IEC 61937-3:2007 */
-
-    if (m_eac3.size() == 0)
-      m_eac3.resize(EAC3_MAX_BURST_PAYLOAD_SIZE);
+    /* multiple frames needed to achieve 6 blocks as required by IEC 61937-3:2007,
+     * frames are whole 16 bit words so they are swapped straight into the burst */
 
     unsigned int newsize = m_eac3Size + size;
     bool overrun = newsize > EAC3_MAX_BURST_PAYLOAD_SIZE;
 
     if (!overrun)
     {
-      memcpy(m_eac3.data() + m_eac3Size, data, size);
+      CAEPackIEC61937::WritePayload(m_packedBuffer + IEC61937_DATA_OFFSET + m_eac3Size, data,
+                                    size);
       m_eac3Size = newsize;
       m_eac3FramesCount++;
+      m_dirty = std::max(m_dirty, IEC61937_DATA_OFFSET + m_eac3Size + 1);
     }
 
     if (m_eac3FramesCount >= m_eac3FramesPerBurst || overrun)
     {
-      m_dataSize = CAEPackIEC61937::PackEAC3(m_eac3.data(), m_eac3Size, m_packedBuffer);
+      m_dataSize = CAEPackIEC61937::PackEAC3(nullptr, m_eac3Size, m_packedBuffer, m_dirty);
+      UpdateDirty(IEC61937_DATA_OFFSET + m_eac3Size + 1, m_dataSize);
       m_eac3Size = 0;
       m_eac3FramesCount = 0;
     }
@@ -10,13 +10,12 @@
 
 #include "AEChannelInfo.h"
 #include "AEPackIEC61937.h"
+#include "AEStreamInfo.h"
 
 #include <list>
 #include <stdint.h>
 #include <vector>
 
-class CAEStreamInfo;
-
 class CAEBitstreamPacker
 {
 public:
@@ -34,17 +33,24 @@ public:
 private:
   void PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size);
   void PackEAC3(CAEStreamInfo &info, uint8_t* data, int size);
+  void UpdateDirty(unsigned int end, unsigned int burstSize);
 
-  std::vector<uint8_t> m_dtsHD;
-  unsigned int m_dtsHDSize = 0;
-
-  std::vector<uint8_t> m_eac3;
+  // E-AC3 frames are collected in the payload of m_packedBuffer
   unsigned int m_eac3Size = 0;
   unsigned int m_eac3FramesCount = 0;
   unsigned int m_eac3FramesPerBurst = 0;
 
   unsigned int  m_dataSize = 0;
   uint8_t       m_packedBuffer[MAX_IEC61937_PACKET];
+  unsigned int m_dirty = MAX_IEC61937_PACKET; // bytes of m_packedBuffer that may be non-zero
+  uint8_t* m_buffer = m_packedBuffer; // current output, the packed or the pause buffer
+
+  // pause bursts are built once and reused until the stream or duration changes
+  std::vector<uint8_t> m_pauseBuffer;
+  unsigned int m_pauseSize = 0;
   unsigned int m_pauseDuration = 0;
+  CAEStreamInfo::DataType m_pauseType = CAEStreamInfo::STREAM_TYPE_NULL;
+  unsigned int m_pauseSampleRate = 0;
+  bool m_pauseBursts = false;
 };
 
@@ -8,19 +8,45 @@
 
 #include "AEPackIEC61937.h"
 
+#include "utils/EndianSwap.h"
+
+#include <algorithm>
 #include <cassert>
 #include <string.h>
 
 #define IEC61937_PREAMBLE1  0xF872
 #define IEC61937_PREAMBLE2  0x4E1F
 
-inline void SwapEndian(uint16_t *dst, uint16_t *src, unsigned int size)
+namespace
+{
+// zero the burst from end up to burstSize, bytes from dirty on are already zero
+inline void PadBurst(uint8_t* dest, unsigned int end, unsigned int burstSize, unsigned int dirty)
+{
+  const unsigned int limit = std::min(burstSize, dirty);
+  if (limit > end)
+    memset(dest + end, 0, limit - end);
+}
+} // unnamed namespace
+
+void CAEPackIEC61937::WritePayload(uint8_t* dest, const uint8_t* data, unsigned int size)
 {
-  for (unsigned int i = 0; i < size; ++i, ++dst, ++src)
-    *dst = ((*src & 0xFF00) >> 8) | ((*src & 0x00FF) << 8);
+#ifdef __BIG_ENDIAN__
+  memcpy(dest, data, size);
+  if (size & 0x1)
+    dest[size] = 0;
+#else
+  Endian_Swap16_buf(reinterpret_cast<uint16_t*>(dest), reinterpret_cast<const uint16_t*>(data),
+                    size >> 1);
+  // an odd trailing byte is padded with zero instead of reading past the frame
+  if (size & 0x1)
+  {
+    dest[size - 1] = 0;
+    dest[size] = data[size - 1];
+  }
+#endif
 }
 
-int CAEPackIEC61937::PackAC3(uint8_t *data, unsigned int size, uint8_t *dest)
+int CAEPackIEC61937::PackAC3(const uint8_t* data, unsigned int size, uint8_t* dest, unsigned int dirty)
 {
   assert(size <= OUT_FRAMESTOBYTES(AC3_FRAME_SIZE));
   struct IEC61937Packet *packet = (struct IEC61937Packet*)dest;
@@ -29,25 +55,29 @@ int CAEPackIEC61937::PackAC3(uint8_t *data, unsigned int size, uint8_t *dest)
   packet->m_preamble2 = IEC61937_PREAMBLE2;
   packet->m_length    = size << 3;
 
-  if (data == NULL)
-    data = packet->m_data;
-#ifdef __BIG_ENDIAN__
+  int bitstream_mode;
+  if (data)
+  {
+    bitstream_mode = data[5] & 0x7;
+    WritePayload(packet->m_data, data, size);
+  }
   else
-    memcpy(packet->m_data, data, size);
+  {
+    // bsmod is in byte 5 of the bitstream, byte 4 of the swapped payload
+#ifdef __BIG_ENDIAN__
+    bitstream_mode = packet->m_data[5] & 0x7;
 #else
-
-  int bitstream_mode  = data[5] & 0x7;
+    bitstream_mode = packet->m_data[4] & 0x7;
+#endif
+  }
   packet->m_type      = IEC61937_TYPE_AC3 | (bitstream_mode << 8);
 
   size += size & 0x1;
-  SwapEndian((uint16_t*)packet->m_data, (uint16_t*)data, size >> 1);
-#endif
-
-  memset(packet->m_data + size, 0, OUT_FRAMESTOBYTES(AC3_FRAME_SIZE) - IEC61937_DATA_OFFSET - size);
+  PadBurst(dest, IEC61937_DATA_OFFSET + size, OUT_FRAMESTOBYTES(AC3_FRAME_SIZE), dirty);
   return OUT_FRAMESTOBYTES(AC3_FRAME_SIZE);
 }
 
-int CAEPackIEC61937::PackEAC3(uint8_t *data, unsigned int size, uint8_t *dest)
+int CAEPackIEC61937::PackEAC3(const uint8_t* data, unsigned int size, uint8_t* dest, unsigned int dirty)
 {
   assert(size <= OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE));
   struct IEC61937Packet *packet = (struct IEC61937Packet*)dest;
@@ -57,36 +87,45 @@ int CAEPackIEC61937::PackEAC3(uint8_t *data, unsigned int size, uint8_t *dest)
   packet->m_type      = IEC61937_TYPE_EAC3;
   packet->m_length    = size;
 
-  if (data == NULL)
-    data = packet->m_data;
-#ifdef __BIG_ENDIAN__
-  else
-    memcpy(packet->m_data, data, size);
-#else
-  size += size & 0x1;
-  SwapEndian((uint16_t*)packet->m_data, (uint16_t*)data, size >> 1);
-#endif
+  if (data)
+    WritePayload(packet->m_data, data, size);
 
-  memset(packet->m_data + size, 0, OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE) - IEC61937_DATA_OFFSET - size);
+  size += size & 0x1;
+  PadBurst(dest, IEC61937_DATA_OFFSET + size, OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE), dirty);
   return OUT_FRAMESTOBYTES(EAC3_FRAME_SIZE);
 }
 
-int CAEPackIEC61937::PackDTS_512(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian)
+int CAEPackIEC61937::PackDTS_512(const uint8_t* data,
+                                 unsigned int size,
+                                 uint8_t* dest,
+                                 bool littleEndian,
+                                 unsigned int dirty)
 {
-  return PackDTS(data, size, dest, littleEndian, OUT_FRAMESTOBYTES(DTS1_FRAME_SIZE), IEC61937_TYPE_DTS1);
+  return PackDTS(data, size, dest, littleEndian, OUT_FRAMESTOBYTES(DTS1_FRAME_SIZE),
+                 IEC61937_TYPE_DTS1, dirty);
 }
 
-int CAEPackIEC61937::PackDTS_1024(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian)
+int CAEPackIEC61937::PackDTS_1024(const uint8_t* data,
+                                  unsigned int size,
+                                  uint8_t* dest,
+                                  bool littleEndian,
+                                  unsigned int dirty)
 {
-  return PackDTS(data, size, dest, littleEndian, OUT_FRAMESTOBYTES(DTS2_FRAME_SIZE), IEC61937_TYPE_DTS2);
+  return PackDTS(data, size, dest, littleEndian, OUT_FRAMESTOBYTES(DTS2_FRAME_SIZE),
+                 IEC61937_TYPE_DTS2, dirty);
 }
 
-int CAEPackIEC61937::PackDTS_2048(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian)
+int CAEPackIEC61937::PackDTS_2048(const uint8_t* data,
+                                  unsigned int size,
+                                  uint8_t* dest,
+                                  bool littleEndian,
+                                  unsigned int dirty)
 {
-  return PackDTS(data, size, dest, littleEndian, OUT_FRAMESTOBYTES(DTS3_FRAME_SIZE), IEC61937_TYPE_DTS3);
+  return PackDTS(data, size, dest, littleEndian, OUT_FRAMESTOBYTES(DTS3_FRAME_SIZE),
+                 IEC61937_TYPE_DTS3, dirty);
 }
 
-int CAEPackIEC61937::PackTrueHD(const uint8_t* data, unsigned int size, uint8_t* dest)
+int CAEPackIEC61937::PackTrueHD(const uint8_t* data, unsigned int size, uint8_t* dest, unsigned int dirty)
 {
   if (size == 0)
     return OUT_FRAMESTOBYTES(TRUEHD_FRAME_SIZE);
@@ -98,21 +137,19 @@ int CAEPackIEC61937::PackTrueHD(const uint8_t* data, unsigned int size, uint8_t*
   packet->m_type = IEC61937_TYPE_TRUEHD;
   packet->m_length = 61424;
 
-  if (data == NULL)
-    data = packet->m_data;
-#ifdef __BIG_ENDIAN__
-  else
-    memcpy(packet->m_data, data, size);
-#else
-  size += size & 0x1;
-  SwapEndian((uint16_t*)packet->m_data, (uint16_t*)data, size >> 1);
-#endif
+  if (data)
+    WritePayload(packet->m_data, data, size);
 
-  memset(packet->m_data + size, 0, OUT_FRAMESTOBYTES(TRUEHD_FRAME_SIZE) - IEC61937_DATA_OFFSET - size);
+  size += size & 0x1;
+  PadBurst(dest, IEC61937_DATA_OFFSET + size, OUT_FRAMESTOBYTES(TRUEHD_FRAME_SIZE), dirty);
   return OUT_FRAMESTOBYTES(TRUEHD_FRAME_SIZE);
 }
 
-int CAEPackIEC61937::PackDTSHD(uint8_t *data, unsigned int size, uint8_t *dest, unsigned int period)
+int CAEPackIEC61937::PackDTSHD(const uint8_t* data,
+                               unsigned int size,
+                               uint8_t* dest,
+                               unsigned int period,
+                               unsigned int dirty)
 {
   unsigned int subtype;
   switch (period)
@@ -128,6 +165,12 @@ int CAEPackIEC61937::PackDTSHD(uint8_t *data, unsigned int size, uint8_t *dest,
       return 0;
   }
 
+  // DTS-HD start code followed by the big endian frame size
+  const uint8_t header[12] = {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe,
+                              static_cast<uint8_t>((size >> 8) & 0xFF),
+                              static_cast<uint8_t>(size & 0xFF)};
+  unsigned int dataSize = sizeof(header) + size;
+
   struct IEC61937Packet *packet = (struct IEC61937Packet*)dest;
   packet->m_preamble1 = IEC61937_PREAMBLE1;
   packet->m_preamble2 = IEC61937_PREAMBLE2;
@@ -135,25 +178,25 @@ int CAEPackIEC61937::PackDTSHD(uint8_t *data, unsigned int size, uint8_t *dest,
 
   /* Align so that (length_code & 0xf) == 0x8. This is reportedly needed
    * with some receivers, but the exact requirement is unconfirmed. */
-  packet->m_length    = ((size + 0x17) &~ 0x0f) - 0x08;
+  packet->m_length    = ((dataSize + 0x17) &~ 0x0f) - 0x08;
 
-  if (data == NULL)
-    data = packet->m_data;
-#ifdef __BIG_ENDIAN__
-  else
-    memcpy(packet->m_data, data, size);
-#else
-  size += size & 0x1;
-  SwapEndian((uint16_t*)packet->m_data, (uint16_t*)data, size >> 1);
-#endif
+  WritePayload(packet->m_data, header, sizeof(header));
+  if (data)
+    WritePayload(packet->m_data + sizeof(header), data, size);
 
+  dataSize += dataSize & 0x1;
   unsigned int burstsize = period << 2;
-  memset(packet->m_data + size, 0, burstsize - IEC61937_DATA_OFFSET - size);
+  PadBurst(dest, IEC61937_DATA_OFFSET + dataSize, burstsize, dirty);
   return burstsize;
 }
 
-int CAEPackIEC61937::PackDTS(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian,
-                             unsigned int frameSize, uint16_t type)
+int CAEPackIEC61937::PackDTS(const uint8_t* data,
+                             unsigned int size,
+                             uint8_t* dest,
+                             bool littleEndian,
+                             unsigned int frameSize,
+                             uint16_t type,
+                             unsigned int dirty)
 {
   assert(size <= frameSize);
 
@@ -189,19 +232,25 @@ int CAEPackIEC61937::PackDTS(uint8_t *data, unsigned int size, uint8_t *dest, bo
     return 0;
   }
 
-  if (data == NULL)
-    data = dataTo;
-  else if (!byteSwapNeeded)
-    memcpy(dataTo, data, size);
+  if (data)
+  {
+#ifdef __BIG_ENDIAN__
+    if (byteSwapNeeded)
+      Endian_Swap16_buf(reinterpret_cast<uint16_t*>(dataTo),
+                        reinterpret_cast<const uint16_t*>(data), (size + 1) >> 1);
+#else
+    if (byteSwapNeeded)
+      WritePayload(dataTo, data, size);
+#endif
+    else
+      memcpy(dataTo, data, size);
+  }
 
   if (byteSwapNeeded)
-  {
     size += size & 0x1;
-    SwapEndian((uint16_t*)dataTo, (uint16_t*)data, size >> 1);
-  }
 
   if (size != frameSize)
-    memset(packet->m_data + size, 0, frameSize - IEC61937_DATA_OFFSET - size);
+    PadBurst(dest, IEC61937_DATA_OFFSET + size, frameSize, dirty);
 
   return frameSize;
 }
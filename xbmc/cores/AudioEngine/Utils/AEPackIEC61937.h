@@ -25,24 +25,75 @@
 #define OUT_CHANNELS 2
 #define OUT_FRAMESTOBYTES(a) ((a) * OUT_CHANNELS * (OUT_SAMPLESIZE>>3))
 
+/*!
+ * \brief Packs compressed frames into IEC 61937 bursts.
+ *
+ * The frame is byte swapped straight into the burst. If data is nullptr the payload
+ * has already been written to dest + IEC61937_DATA_OFFSET in output byte order and
+ * only the burst header and the padding are added.
+ *
+ * Padding is only written up to dirty, the number of bytes at the start of dest that
+ * may be non-zero. Callers that reuse the destination buffer can pass the extent of
+ * the previous burst to avoid clearing the whole burst on every frame.
+ */
 class CAEPackIEC61937
 {
 public:
   CAEPackIEC61937() = default;
   typedef int (*PackFunc)(uint8_t *data, unsigned int size, uint8_t *dest);
 
-  static int PackAC3     (uint8_t *data, unsigned int size, uint8_t *dest);
-  static int PackEAC3    (uint8_t *data, unsigned int size, uint8_t *dest);
-  static int PackDTS_512 (uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian);
-  static int PackDTS_1024(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian);
-  static int PackDTS_2048(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian);
-  static int PackTrueHD(const uint8_t* data, unsigned int size, uint8_t* dest);
-  static int PackDTSHD(uint8_t* data, unsigned int size, uint8_t* dest, unsigned int period);
+  static int PackAC3(const uint8_t* data,
+                     unsigned int size,
+                     uint8_t* dest,
+                     unsigned int dirty = MAX_IEC61937_PACKET);
+  static int PackEAC3(const uint8_t* data,
+                      unsigned int size,
+                      uint8_t* dest,
+                      unsigned int dirty = MAX_IEC61937_PACKET);
+  static int PackDTS_512(const uint8_t* data,
+                         unsigned int size,
+                         uint8_t* dest,
+                         bool littleEndian,
+                         unsigned int dirty = MAX_IEC61937_PACKET);
+  static int PackDTS_1024(const uint8_t* data,
+                          unsigned int size,
+                          uint8_t* dest,
+                          bool littleEndian,
+                          unsigned int dirty = MAX_IEC61937_PACKET);
+  static int PackDTS_2048(const uint8_t* data,
+                          unsigned int size,
+                          uint8_t* dest,
+                          bool littleEndian,
+                          unsigned int dirty = MAX_IEC61937_PACKET);
+  static int PackTrueHD(const uint8_t* data,
+                        unsigned int size,
+                        uint8_t* dest,
+                        unsigned int dirty = MAX_IEC61937_PACKET);
+
+  /*!
+   * \brief Pack a DTS-HD frame, the DTS-HD start code and the frame size are prepended.
+   */
+  static int PackDTSHD(const uint8_t* data,
+                       unsigned int size,
+                       uint8_t* dest,
+                       unsigned int period,
+                       unsigned int dirty = MAX_IEC61937_PACKET);
   static int PackPause(uint8_t *dest, unsigned int millis, unsigned int framesize, unsigned int samplerate, unsigned int rep_period, unsigned int encodedRate);
+
+  /*!
+   * \brief Copy size bytes of a big endian bitstream into a burst payload in output byte order.
+   */
+  static void WritePayload(uint8_t* dest, const uint8_t* data, unsigned int size);
+
 private:
 
-  static int PackDTS(uint8_t *data, unsigned int size, uint8_t *dest, bool littleEndian,
-                     unsigned int frameSize, uint16_t type);
+  static int PackDTS(const uint8_t* data,
+                     unsigned int size,
+                     uint8_t* dest,
+                     bool littleEndian,
+                     unsigned int frameSize,
+                     uint16_t type,
+                     unsigned int dirty);
 
   enum IEC61937DataType
   {
@@ -15,6 +15,12 @@
 #include <iomanip>
 #include <sstream>
 
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 // Reference for DTS and DTS-UHD (aka DTS:X)
 // https://www.etsi.org/deliver/etsi_ts/102100_102199/102114/01.06.01_60/ts_102114v010601p.pdf
 // https://www.etsi.org/deliver/etsi_ts/103400_103499/103491/01.02.01_60/ts_103491v010201p.pdf
@@ -254,6 +260,130 @@ void CAEStreamParser::GetPacket(uint8_t** buffer, unsigned int* bufferSize)
 
 // SYNC FUNCTIONS
 
+namespace
+{
+// the first two bytes of every sync pattern, TrueHD major sync is matched at offset 4
+inline bool IsSyncCandidate(const uint8_t* data, unsigned int types)
+{
+  if ((types & CAEStreamParser::SYNC_AC3) && data[0] == 0x0b && data[1] == 0x77)
+    return true;
+  if ((types & CAEStreamParser::SYNC_DTS) &&
+      ((data[0] == 0x7f && data[1] == 0xfe) || (data[0] == 0xfe && data[1] == 0x7f) ||
+       (data[0] == 0x1f && data[1] == 0xff) || (data[0] == 0xff && data[1] == 0x1f)))
+    return true;
+  if ((types & CAEStreamParser::SYNC_TRUEHD) && data[4] == 0xf8 && data[5] == 0x72)
+    return true;
+  return false;
+}
+} // namespace
+
+unsigned int CAEStreamParser::FindSyncCandidate(const uint8_t* data,
+                                                unsigned int size,
+                                                unsigned int limit,
+                                                unsigned int types)
+{
+  unsigned int pos = 0;
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  const __m128i ac3 = _mm_set1_epi8(0x0b);
+  const __m128i dtsA = _mm_set1_epi8(0x7f);
+  const __m128i dtsB = _mm_set1_epi8(static_cast<char>(0xfe));
+  const __m128i dtsC = _mm_set1_epi8(0x1f);
+  const __m128i dtsD = _mm_set1_epi8(static_cast<char>(0xff));
+  const __m128i ac3Second = _mm_set1_epi8(0x77);
+  const __m128i thdFirst = _mm_set1_epi8(static_cast<char>(0xf8));
+  const __m128i thdSecond = _mm_set1_epi8(0x72);
+
+  // test 16 offsets per iteration, the loads reach up to pos + 20
+  while (pos + 16 <= limit && pos + 21 <= size)
+  {
+    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 1));
+    __m128i hit = _mm_setzero_si128();
+
+    if (types & SYNC_AC3)
+      hit = _mm_and_si128(_mm_cmpeq_epi8(b0, ac3), _mm_cmpeq_epi8(b1, ac3Second));
+
+    if (types & SYNC_DTS)
+    {
+      const __m128i a0 = _mm_cmpeq_epi8(b0, dtsA);
+      const __m128i a1 = _mm_cmpeq_epi8(b1, dtsA);
+      const __m128i b0e = _mm_cmpeq_epi8(b0, dtsB);
+      const __m128i b1e = _mm_cmpeq_epi8(b1, dtsB);
+      const __m128i c0 = _mm_cmpeq_epi8(b0, dtsC);
+      const __m128i c1 = _mm_cmpeq_epi8(b1, dtsC);
+      const __m128i d0 = _mm_cmpeq_epi8(b0, dtsD);
+      const __m128i d1 = _mm_cmpeq_epi8(b1, dtsD);
+      hit = _mm_or_si128(hit, _mm_or_si128(_mm_and_si128(a0, b1e), _mm_and_si128(b0e, a1)));
+      hit = _mm_or_si128(hit, _mm_or_si128(_mm_and_si128(c0, d1), _mm_and_si128(d0, c1)));
+    }
+
+    if (types & SYNC_TRUEHD)
+    {
+      const __m128i b4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 4));
+      const __m128i b5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 5));
+      hit = _mm_or_si128(
+          hit, _mm_and_si128(_mm_cmpeq_epi8(b4, thdFirst), _mm_cmpeq_epi8(b5, thdSecond)));
+    }
+
+    const int mask = _mm_movemask_epi8(hit);
+    if (mask)
+    {
+      unsigned int bit = 0;
+      while (!(mask & (1 << bit)))
+        ++bit;
+      return pos + bit;
+    }
+    pos += 16;
+  }
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+  // test 16 offsets per iteration, the loads reach up to pos + 20
+  while (pos + 16 <= limit && pos + 21 <= size)
+  {
+    const uint8x16_t b0 = vld1q_u8(data + pos);
+    const uint8x16_t b1 = vld1q_u8(data + pos + 1);
+    uint8x16_t hit = vdupq_n_u8(0);
+
+    if (types & SYNC_AC3)
+      hit = vandq_u8(vceqq_u8(b0, vdupq_n_u8(0x0b)), vceqq_u8(b1, vdupq_n_u8(0x77)));
+
+    if (types & SYNC_DTS)
+    {
+      const uint8x16_t a0 = vceqq_u8(b0, vdupq_n_u8(0x7f));
+      const uint8x16_t a1 = vceqq_u8(b1, vdupq_n_u8(0x7f));
+      const uint8x16_t e0 = vceqq_u8(b0, vdupq_n_u8(0xfe));
+      const uint8x16_t e1 = vceqq_u8(b1, vdupq_n_u8(0xfe));
+      const uint8x16_t c0 = vceqq_u8(b0, vdupq_n_u8(0x1f));
+      const uint8x16_t c1 = vceqq_u8(b1, vdupq_n_u8(0x1f));
+      const uint8x16_t d0 = vceqq_u8(b0, vdupq_n_u8(0xff));
+      const uint8x16_t d1 = vceqq_u8(b1, vdupq_n_u8(0xff));
+      hit = vorrq_u8(hit, vorrq_u8(vandq_u8(a0, e1), vandq_u8(e0, a1)));
+      hit = vorrq_u8(hit, vorrq_u8(vandq_u8(c0, d1), vandq_u8(d0, c1)));
+    }
+
+    if (types & SYNC_TRUEHD)
+    {
+      const uint8x16_t b4 = vld1q_u8(data + pos + 4);
+      const uint8x16_t b5 = vld1q_u8(data + pos + 5);
+      hit = vorrq_u8(hit, vandq_u8(vceqq_u8(b4, vdupq_n_u8(0xf8)), vceqq_u8(b5, vdupq_n_u8(0x72))));
+    }
+
+    // any lane set, locate it with the scalar test
+    const uint64x2_t lanes = vreinterpretq_u64_u8(hit);
+    if (vgetq_lane_u64(lanes, 0) | vgetq_lane_u64(lanes, 1))
+      break;
+    pos += 16;
+  }
+#endif
+
+  for (; pos < limit; ++pos)
+  {
+    if (IsSyncCandidate(data + pos, types))
+      return pos;
+  }
+  return limit;
+}
+
 // This function looks for sync words across the types in parallel, and only does an exhaustive
 // test if it finds a syncword. Once sync has been established, the relevant sync function sets
 // m_syncFunc to itself. This function will only be called again if total sync is lost, which
@@ -265,6 +395,14 @@ unsigned int CAEStreamParser::DetectType(uint8_t* data, unsigned int size)
 
   while (size > 8)
   {
+    // jump straight to the next offset that may hold a sync word
+    unsigned int next = FindSyncCandidate(data, size, size - 8, SYNC_ALL);
+    size -= next;
+    skipped += next;
+    data += next;
+    if (size <= 8)
+      break;
+
     // DTS Sync Header check
     unsigned int header = data[0] << 24 | data[1] << 16 | data[2] << 8 | data[3];
 
@@ -636,6 +774,12 @@ unsigned int CAEStreamParser::SyncAC3(uint8_t* data, unsigned int size)
 
   for (; size - skip > 7; ++skip, ++data)
   {
+    unsigned int next = FindSyncCandidate(data, size - skip, size - skip - 7, SYNC_AC3);
+    skip += next;
+    data += next;
+    if (size - skip <= 7)
+      break;
+
     bool resyncing = (skip != 0);
     if (TrySyncAC3(data, size - skip, resyncing, false))
       return skip;
@@ -682,6 +826,12 @@ unsigned int CAEStreamParser::SyncDTS(uint8_t* data, unsigned int size)
   unsigned int skip = 0;
   for (; size - skip > 13; ++skip, ++data)
   {
+    unsigned int next = FindSyncCandidate(data, size - skip, size - skip - 13, SYNC_DTS);
+    skip += next;
+    data += next;
+    if (size - skip <= 13)
+      break;
+
     unsigned int header = data[0] << 24 | data[1] << 16 | data[2] << 8 | data[3];
     unsigned int dtsBlocks;
     unsigned int amode;
@@ -979,6 +1129,15 @@ unsigned int CAEStreamParser::SyncTrueHD(uint8_t* data, unsigned int size)
   // if TrueHD
   for (; left; ++skip, ++data, --left)
   {
+    // without sync only a major sync can be used, jump straight to the next one
+    if (!m_hasSync && left >= 8)
+    {
+      unsigned int next = FindSyncCandidate(data, left, left - 7, SYNC_TRUEHD);
+      skip += next;
+      data += next;
+      left -= next;
+    }
+
     // if we dont have sync and there is less the 8 bytes, then break out
     if (!m_hasSync && left < 8)
       return size;
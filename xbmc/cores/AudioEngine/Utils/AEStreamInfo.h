@@ -80,6 +80,28 @@ public:
   CAEStreamInfo& GetStreamInfo() { return m_info; }
   void Reset();
 
+  enum SyncType
+  {
+    SYNC_AC3 = 1 << 0,
+    SYNC_DTS = 1 << 1,
+    SYNC_TRUEHD = 1 << 2,
+    SYNC_ALL = SYNC_AC3 | SYNC_DTS | SYNC_TRUEHD
+  };
+
+  /*!
+   * \brief Find the first offset below limit that may start a frame of one of the given types.
+   * Only the sync pattern is tested, the header still has to be validated by the caller.
+   * \param data buffer to scan, the 6 bytes following each tested offset must be readable
+   * \param size number of readable bytes in data
+   * \param limit number of offsets to test, must not exceed size - 6
+   * \param types bitmask of SyncType
+   * \return offset of the candidate, or limit if there is none
+   */
+  static unsigned int FindSyncCandidate(const uint8_t* data,
+                                        unsigned int size,
+                                        unsigned int limit,
+                                        unsigned int types);
+
 private:
   uint8_t m_buffer[MAX_IEC61937_PACKET];
   unsigned int m_bufferSize = 0;
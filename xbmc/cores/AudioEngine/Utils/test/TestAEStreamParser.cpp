@@ -0,0 +1,186 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEStreamInfo.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr unsigned int EAC3_FRAME_BYTES = 768;
+constexpr unsigned int EAC3_FRAME_SAMPLES = 1536;
+
+bool IsCandidateReference(const uint8_t* data, unsigned int types)
+{
+  if ((types & CAEStreamParser::SYNC_AC3) && data[0] == 0x0b && data[1] == 0x77)
+    return true;
+  if (types & CAEStreamParser::SYNC_DTS)
+  {
+    const unsigned int word = data[0] << 8 | data[1];
+    if (word == 0x7ffe || word == 0xfe7f || word == 0x1fff || word == 0xff1f)
+      return true;
+  }
+  return (types & CAEStreamParser::SYNC_TRUEHD) && data[4] == 0xf8 && data[5] == 0x72;
+}
+
+// bytes in 0x20..0x5f never start a sync pattern
+uint8_t FillerByte(std::mt19937& rng)
+{
+  return static_cast<uint8_t>(0x20 + rng() % 0x40);
+}
+
+// 48kHz stereo E-AC3 frame with 6 blocks, the payload is filler
+void AppendEAC3Frame(std::vector<uint8_t>& stream, std::mt19937& rng)
+{
+  const unsigned int words = EAC3_FRAME_BYTES / 2 - 1;
+  const size_t start = stream.size();
+  stream.resize(start + EAC3_FRAME_BYTES);
+  uint8_t* frame = stream.data() + start;
+  for (unsigned int i = 0; i < EAC3_FRAME_BYTES; ++i)
+    frame[i] = FillerByte(rng);
+  frame[0] = 0x0b;
+  frame[1] = 0x77;
+  frame[2] = (words >> 8) & 0x7;
+  frame[3] = words & 0xff;
+  frame[4] = (3 << 4) | (2 << 1);
+  frame[5] = 16 << 3;
+}
+
+// chunks must be smaller than a frame, AddData returns at most one packet per call
+unsigned int ParseAll(CAEStreamParser& parser,
+                      std::vector<uint8_t>& stream,
+                      unsigned int chunk,
+                      std::vector<unsigned int>* sizes = nullptr)
+{
+  uint8_t* buffer = nullptr;
+  unsigned int bufferSize = 0;
+  unsigned int packets = 0;
+  uint8_t* data = stream.data();
+  unsigned int left = static_cast<unsigned int>(stream.size());
+  while (left)
+  {
+    const unsigned int used = parser.AddData(data, std::min(left, chunk), &buffer, &bufferSize);
+    data += used;
+    left -= used;
+    if (bufferSize)
+    {
+      ++packets;
+      if (sizes)
+        sizes->push_back(bufferSize);
+    }
+  }
+  delete[] buffer;
+  return packets;
+}
+} // namespace
+
+TEST(TestAEStreamParser, FindSyncCandidateCorpus)
+{
+  std::mt19937 rng(1234);
+  const uint8_t patterns[][6] = {{0x0b, 0x77}, {0x7f, 0xfe}, {0xfe, 0x7f},
+                                 {0x1f, 0xff}, {0xff, 0x1f}, {0, 0, 0, 0, 0xf8, 0x72}};
+  const unsigned int typeMasks[] = {CAEStreamParser::SYNC_ALL, CAEStreamParser::SYNC_AC3,
+                                    CAEStreamParser::SYNC_DTS, CAEStreamParser::SYNC_TRUEHD};
+
+  for (int round = 0; round < 500; ++round)
+  {
+    std::vector<uint8_t> corpus(16 + rng() % 512);
+    for (auto& byte : corpus)
+      byte = (round & 1) ? static_cast<uint8_t>(rng()) : FillerByte(rng);
+
+    // inject a few patterns, partly overlapping the vector block boundaries
+    for (unsigned int n = rng() % 4; n; --n)
+    {
+      const auto& pattern = patterns[rng() % 6];
+      const size_t pos = rng() % (corpus.size() - 6);
+      for (int i = 0; i < 6; ++i)
+        if (pattern[i] || i < 2)
+          corpus[pos + i] = pattern[i];
+    }
+
+    const unsigned int size = static_cast<unsigned int>(corpus.size());
+    for (unsigned int types : typeMasks)
+    {
+      for (unsigned int start = 0; start + 6 < size; start += 1 + rng() % 7)
+      {
+        const uint8_t* data = corpus.data() + start;
+        const unsigned int limit = size - start - 6;
+        unsigned int expected = 0;
+        while (expected < limit && !IsCandidateReference(data + expected, types))
+          ++expected;
+        ASSERT_EQ(expected, CAEStreamParser::FindSyncCandidate(data, size - start, limit, types))
+            << "round " << round << " start " << start << " types " << types;
+      }
+    }
+  }
+}
+
+TEST(TestAEStreamParser, EAC3Resync)
+{
+  std::mt19937 rng(42);
+  std::vector<uint8_t> stream(1000 + rng() % 1000);
+  for (auto& byte : stream)
+    byte = FillerByte(rng);
+
+  constexpr unsigned int FRAMES = 40;
+  const size_t first = stream.size();
+  for (unsigned int i = 0; i < FRAMES; ++i)
+    AppendEAC3Frame(stream, rng);
+
+  // destroy the sync word of one frame, the parser has to skip it and relock on the next
+  stream[first + 10 * EAC3_FRAME_BYTES] = 0x20;
+
+  for (unsigned int chunk : {1u, 64u, 700u})
+  {
+    CAEStreamParser parser;
+    std::vector<unsigned int> sizes;
+    // the last frame is held back until the parser sees what follows it
+    EXPECT_EQ(FRAMES - 2, ParseAll(parser, stream, chunk, &sizes)) << "chunk " << chunk;
+    for (unsigned int size : sizes)
+      EXPECT_EQ(EAC3_FRAME_BYTES, size);
+    EXPECT_EQ(CAEStreamInfo::STREAM_TYPE_EAC3, parser.GetDataType());
+    EXPECT_EQ(48000u, parser.GetSampleRate());
+    EXPECT_EQ(2u, parser.GetChannels());
+  }
+}
+
+// the resync scan and parse rates, run with --gtest_also_run_disabled_tests
+TEST(TestAEStreamParser, DISABLED_Benchmark)
+{
+  std::mt19937 rng(7);
+
+  std::vector<uint8_t> noise(16 * 1024 * 1024);
+  for (auto& byte : noise)
+    byte = static_cast<uint8_t>(rng());
+
+  std::vector<uint8_t> stream;
+  constexpr unsigned int FRAMES = 8000;
+  for (unsigned int i = 0; i < FRAMES; ++i)
+    AppendEAC3Frame(stream, rng);
+
+  CAEStreamParser noiseParser;
+  auto start = std::chrono::steady_clock::now();
+  ParseAll(noiseParser, noise, 65536);
+  const double noiseSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CAEStreamParser streamParser;
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(FRAMES - 1, ParseAll(streamParser, stream, 512));
+  const double streamSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  RecordProperty("resync_mb_per_second",
+                 static_cast<int>(noise.size() / noiseSeconds / (1024 * 1024)));
+  RecordProperty("samples_per_second",
+                 static_cast<int>(FRAMES * EAC3_FRAME_SAMPLES / streamSeconds));
+}
@@ -433,6 +433,21 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     m_pCodecContext->skip_loop_filter = static_cast<AVDiscard>(iSkipLoopFilter);
   }
 
+  // thumbnails only need a key frame, decoded at the smallest scale still larger than the image
+  if (hints.codecOptions & CODEC_THUMBNAIL)
+  {
+    m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
+    m_pCodecContext->skip_loop_filter = AVDISCARD_ALL;
+
+    const unsigned int imageRes =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes;
+    int lowres = 0;
+    while (lowres < pCodec->max_lowres && imageRes > 0 &&
+           static_cast<unsigned int>(hints.width >> (lowres + 1)) >= imageRes)
+      lowres++;
+    m_pCodecContext->lowres = lowres;
+  }
+
   // set any special options
   for(std::vector<CDVDCodecOption>::iterator it = options.m_keys.begin(); it != options.m_keys.end(); ++it)
   {
@@ -17,6 +17,9 @@
 #include "pictures/Picture.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "utils/CPUInfo.h"
 #include "utils/MemUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -40,8 +43,10 @@
 #include "Util.h"
 #include "utils/LangCodeExpander.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <mutex>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -49,6 +54,49 @@ extern "C" {
 #include <libswscale/swscale.h>
 }
 
+namespace
+{
+/*!
+ \brief Bounds the thumbnails decoded at a time, so loaders extracting them in parallel leave
+ processors to playback and the GUI.
+ */
+class CExtractionSlot
+{
+public:
+  CExtractionSlot()
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    const int maxRunning = GetMaxRunning();
+    m_freed.wait(lock, [maxRunning]() { return m_running < maxRunning; });
+    m_running++;
+  }
+
+  ~CExtractionSlot()
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    m_running--;
+    m_freed.notifyAll();
+  }
+
+  CExtractionSlot(const CExtractionSlot&) = delete;
+  CExtractionSlot& operator=(const CExtractionSlot&) = delete;
+
+private:
+  static int GetMaxRunning()
+  {
+    const int jobs =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoThumbnailJobs;
+    if (jobs > 0)
+      return jobs;
+    return std::max(1, CServiceBroker::GetCPUInfo()->GetCPUCount() / 2);
+  }
+
+  static inline CCriticalSection m_critSection;
+  static inline XbmcThreads::ConditionVariable m_freed;
+  static inline int m_running = 0;
+};
+} // namespace
+
 bool CDVDFileInfo::GetFileDuration(const std::string &path, int& duration)
 {
   std::unique_ptr<CDVDDemux> demux;
@@ -140,13 +188,15 @@ std::unique_ptr<CTexture> CDVDFileInfo::ExtractThumbToTexture(const CFileItem& f
   std::unique_ptr<CTexture> result{};
   if (nVideoStream != -1)
   {
+    CExtractionSlot slot;
+
     std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
     std::vector<AVPixelFormat> pixFmts;
     pixFmts.push_back(AV_PIX_FMT_YUV420P);
     pProcessInfo->SetPixFormats(pixFmts);
 
     CDVDStreamInfo hint(*demuxer->GetStream(demuxerId, nVideoStream), true);
-    hint.codecOptions = CODEC_FORCE_SOFTWARE;
+    hint.codecOptions = CODEC_FORCE_SOFTWARE | CODEC_THUMBNAIL;
 
     std::unique_ptr<CDVDVideoCodec> pVideoCodec =
         CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
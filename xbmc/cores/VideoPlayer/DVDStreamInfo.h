@@ -19,6 +19,7 @@ extern "C"
 
 #define CODEC_FORCE_SOFTWARE 0x01
 #define CODEC_ALLOW_FALLBACK 0x02
+#define CODEC_THUMBNAIL      0x04 // decode key frames only, at a reduced resolution if possible
 #define CODEC_INTERLACED     0x40
 #define CODEC_UNKNOWN_I_P    0x80
 
@@ -10,6 +10,8 @@
 
 #include "DatabaseManager.h"
 #include "DbUrl.h"
+#include "LangInfo.h"
+#include "QueryProfiler.h"
 #include "ServiceBroker.h"
 #include "filesystem/SpecialProtocol.h"
 #if defined(HAS_MYSQL) || defined(HAS_MARIADB)
@@ -19,6 +21,10 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "sqlitedataset.h"
+#include "threads/CriticalSection.h"
+#include "utils/Crc32.h"
+#include "utils/DatabaseUtils.h"
+#include "utils/Random.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/log.h"
@@ -27,12 +33,67 @@
 #include "platform/posix/ConvUtils.h"
 #endif
 
+#include <algorithm>
+#include <ctime>
+#include <map>
 #include <memory>
+#include <mutex>
 
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
 
+namespace
+{
+// identifies the sort tokens of the current language, keys made with other tokens are rebuilt
+std::string GetSortTokensChecksum()
+{
+  std::string tokens;
+  for (const auto& token : g_langInfo.GetSortTokens())
+    tokens += token + "\n";
+  return std::to_string(Crc32::Compute(tokens));
+}
+
+// the key of an item in the search index combines its id with its media type
+int GetSearchIndexType(const std::string& mediaType)
+{
+  static const std::vector<std::string> types = {MediaTypeArtist, MediaTypeAlbum,
+                                                 MediaTypeSong,   MediaTypeMovie,
+                                                 MediaTypeTvShow, MediaTypeEpisode,
+                                                 MediaTypeMusicVideo};
+  const auto it = std::find(types.begin(), types.end(), mediaType);
+  return it != types.end() ? static_cast<int>(std::distance(types.begin(), it)) + 1 : 0;
+}
+
+constexpr int SEARCH_INDEX_TYPES = 16;
+
+// idle read-only connections by database file, shared by all CDatabase instances
+CCriticalSection readConnectionsSection;
+std::map<std::string, std::vector<std::unique_ptr<Database>>> readConnections;
+
+std::unique_ptr<Database> AcquireReadConnection(const std::string& host, const std::string& name)
+{
+  {
+    std::unique_lock<CCriticalSection> lock(readConnectionsSection);
+    auto& idle = readConnections[host + name];
+    if (!idle.empty())
+    {
+      std::unique_ptr<Database> db = std::move(idle.back());
+      idle.pop_back();
+      return db;
+    }
+  }
+
+  auto db = std::make_unique<SqliteDatabase>();
+  db->setHostName(host.c_str());
+  db->setDatabase(name.c_str());
+  db->setReadOnly(true);
+  if (db->connect(false) != DB_CONNECTION_OK)
+    return nullptr;
+  return db;
+}
+} // namespace
+
 void CDatabase::Filter::AppendField(const std::string& strField)
 {
   if (strField.empty())
@@ -426,6 +487,22 @@ bool CDatabase::ResultQuery(const std::string& strQuery) const
   return bReturn;
 }
 
+std::unique_ptr<Statement> CDatabase::PrepareStatement(const std::string& strQuery) const
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return nullptr;
+
+    return m_pDB->prepareStatement(strQuery);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to prepare statement '{}'", __FUNCTION__, strQuery);
+  }
+  return nullptr;
+}
+
 bool CDatabase::QueueInsertQuery(const std::string& strQuery)
 {
   if (strQuery.empty())
@@ -582,6 +659,8 @@ void CDatabase::DropAnalytics()
 
 bool CDatabase::Connect(const std::string& dbName, const DatabaseSettings& dbSettings, bool create)
 {
+  m_searchIndex = -1;
+
   // create the appropriate database structure
   if (dbSettings.type == "sqlite3")
   {
@@ -618,6 +697,17 @@ bool CDatabase::Connect(const std::string& dbName, const DatabaseSettings& dbSet
   m_pDB->setConfig(dbSettings.key.c_str(), dbSettings.cert.c_str(), dbSettings.ca.c_str(),
                    dbSettings.capath.c_str(), dbSettings.ciphers.c_str(), dbSettings.compression);
 
+  // the profiler follows its debug logging component, changes apply with the next connection
+  CQueryProfiler::GetInstance().SetEnabled(
+      CServiceBroker::GetLogging().CanLogComponent(LOGDATABASEPROFILER));
+
+  m_readConnections = 0;
+  if (dbSettings.type == "sqlite3")
+  {
+    m_pDB->setJournalMode(dbSettings.journalmode.c_str());
+    m_readConnections = std::max(dbSettings.readconnections, 0);
+  }
+
   // create the datasets
   m_pDS.reset(m_pDB->CreateDataset());
   m_pDS2.reset(m_pDB->CreateDataset());
@@ -694,6 +784,8 @@ void CDatabase::Close()
 
   if (nullptr == m_pDB)
     return;
+  CommitBatch();
+  ReleaseReadConnection();
   if (nullptr != m_pDS)
     m_pDS->close();
   m_pDB->disconnect();
@@ -702,6 +794,47 @@ void CDatabase::Close()
   m_pDS2.reset();
 }
 
+const std::unique_ptr<Dataset>& CDatabase::GetReadDataset()
+{
+  if (m_readConnections == 0 || m_pDB->in_transaction())
+    return m_pDS;
+
+  if (nullptr == m_pReadDS)
+  {
+    try
+    {
+      m_pReadDB = AcquireReadConnection(m_pDB->getHostName(), m_pDB->getDatabase());
+    }
+    catch (...)
+    {
+      m_pReadDB.reset();
+    }
+    if (nullptr == m_pReadDB)
+    {
+      CLog::Log(LOGWARNING, "{} - unable to open a read connection to {}, reading on the writer",
+                __FUNCTION__, m_pDB->getDatabase());
+      m_readConnections = 0;
+      return m_pDS;
+    }
+    m_pReadDS.reset(m_pReadDB->CreateDataset());
+  }
+  return m_pReadDS;
+}
+
+void CDatabase::ReleaseReadConnection()
+{
+  if (nullptr == m_pReadDB)
+    return;
+
+  m_pReadDS.reset();
+  std::unique_ptr<Database> db = std::move(m_pReadDB);
+  const std::string key = std::string(db->getHostName()) + db->getDatabase();
+  std::unique_lock<CCriticalSection> lock(readConnectionsSection);
+  auto& idle = readConnections[key];
+  if (idle.size() < m_readConnections)
+    idle.emplace_back(std::move(db));
+}
+
 bool CDatabase::Compress(bool bForce /* =true */)
 {
   if (!m_sqlite)
@@ -747,6 +880,26 @@ void CDatabase::Interrupt()
 
 void CDatabase::BeginTransaction()
 {
+  if (m_batch.active)
+  {
+    // the batch takes the write lock with its first write, not when it is begun
+    if (!m_batch.open && nullptr != m_pDB)
+    {
+      try
+      {
+        m_pDB->start_transaction();
+        m_batch.open = true;
+        m_batch.started = std::chrono::steady_clock::now();
+      }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "database:begintransaction failed");
+      }
+    }
+    ExecuteSavepoint(StringUtils::Format("SAVEPOINT batch{}", m_batch.savepoints++));
+    return;
+  }
+
   try
   {
     if (nullptr != m_pDB)
@@ -760,6 +913,14 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_batch.active)
+  {
+    // the batch is committed as a whole
+    if (m_batch.savepoints == 0)
+      return true;
+    return ExecuteSavepoint(StringUtils::Format("RELEASE SAVEPOINT batch{}", --m_batch.savepoints));
+  }
+
   try
   {
     if (nullptr != m_pDB)
@@ -775,6 +936,19 @@ bool CDatabase::CommitTransaction()
 
 void CDatabase::RollbackTransaction()
 {
+  if (m_batch.active)
+  {
+    if (m_batch.savepoints == 0)
+    {
+      CLog::Log(LOGWARNING, "database:rollbacktransaction outside of a transaction of the batch");
+      return;
+    }
+    const unsigned int savepoint = --m_batch.savepoints;
+    ExecuteSavepoint(StringUtils::Format("ROLLBACK TO SAVEPOINT batch{}", savepoint));
+    ExecuteSavepoint(StringUtils::Format("RELEASE SAVEPOINT batch{}", savepoint));
+    return;
+  }
+
   try
   {
     if (nullptr != m_pDB)
@@ -786,6 +960,104 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+bool CDatabase::ExecuteSavepoint(const std::string& strQuery)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    // m_pDS may hold results the caller is still reading
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    pDS->exec(strQuery);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to execute '{}'", __FUNCTION__, strQuery);
+  }
+  return false;
+}
+
+bool CDatabase::BeginBatch(unsigned int maxItems /* = 500 */,
+                           std::chrono::milliseconds maxDuration /* = 2s */)
+{
+  if (m_batch.active || nullptr == m_pDB)
+    return false;
+
+  m_batch.active = true;
+  m_batch.open = false;
+  m_batch.savepoints = 0;
+  m_batch.maxItems = maxItems;
+  m_batch.maxDuration = maxDuration;
+  m_batch.counters = BatchCounters();
+  return true;
+}
+
+bool CDatabase::BatchItemDone()
+{
+  if (!m_batch.active)
+    return true;
+
+  m_batch.counters.items++;
+  if (!m_batch.open)
+    return true;
+  m_batch.counters.pending++;
+
+  // never commit in the middle of a transaction of the batch
+  if (m_batch.savepoints > 0 ||
+      (m_batch.counters.pending < m_batch.maxItems &&
+       std::chrono::steady_clock::now() - m_batch.started < m_batch.maxDuration))
+    return true;
+
+  return CommitBatchTransaction();
+}
+
+bool CDatabase::CommitBatchWrites()
+{
+  if (!m_batch.active || !m_batch.open || m_batch.savepoints > 0)
+    return true;
+
+  return CommitBatchTransaction();
+}
+
+bool CDatabase::CommitBatch()
+{
+  if (!m_batch.active)
+    return true;
+
+  const bool committed = CommitBatchTransaction();
+  m_batch.active = false;
+  CLog::Log(LOGDEBUG, "{} - {} items written in {} transactions, committing took {} ms",
+            __FUNCTION__, m_batch.counters.items, m_batch.counters.commits,
+            m_batch.counters.commitTime.count());
+  return committed;
+}
+
+bool CDatabase::CommitBatchTransaction()
+{
+  if (m_batch.savepoints > 0)
+  {
+    CLog::Log(LOGWARNING, "{} - {} transactions of the batch are still open", __FUNCTION__,
+              m_batch.savepoints);
+    m_batch.savepoints = 0;
+  }
+
+  m_batch.counters.pending = 0;
+  if (!m_batch.open)
+    return true;
+
+  // committed as a plain transaction, so that derived classes see the commit
+  m_batch.open = false;
+  m_batch.active = false;
+  const auto start = std::chrono::steady_clock::now();
+  const bool committed = CommitTransaction();
+  m_batch.active = true;
+  m_batch.counters.commitTime += std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  m_batch.counters.commits++;
+  return committed;
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
@@ -836,6 +1108,524 @@ bool CDatabase::BuildSQL(const std::string& strQuery,
   return true;
 }
 
+void CDatabase::CreateSortKeyTable()
+{
+  // keys are compared byte by byte, BLOB avoids the case insensitive collation of MySQL
+  m_pDS->exec("CREATE TABLE sortkey (media_id INTEGER, media_type TEXT, tokens TEXT, title BLOB, "
+              "titlenoarticle BLOB, sorttitle BLOB, sorttitlenoarticle BLOB)");
+}
+
+void CDatabase::CreatePathCheckTable()
+{
+  m_pDS->exec("CREATE TABLE pathcheck (idPath INTEGER PRIMARY KEY, mtime BIGINT, checked BIGINT)");
+}
+
+std::map<int, int64_t> CDatabase::GetPathChecks(std::chrono::seconds maxAge)
+{
+  std::map<int, int64_t> mtimes;
+  if (nullptr == m_pDB)
+    return mtimes;
+
+  try
+  {
+    const int64_t since = static_cast<int64_t>(std::time(nullptr)) - maxAge.count();
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    if (!pDS->query("SELECT idPath, mtime FROM pathcheck WHERE checked >= " +
+                    std::to_string(since)))
+      return mtimes;
+
+    const result_set& rows = pDS->get_result_set();
+    for (size_t i = 0; i < rows.records.size(); i++)
+      mtimes[rows.records[i]->at(0).get_asInt()] = rows.records[i]->at(1).get_asInt64();
+    pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} failed", __FUNCTION__);
+    mtimes.clear();
+  }
+  return mtimes;
+}
+
+bool CDatabase::SetPathChecks(const std::map<int, int64_t>& mtimes)
+{
+  auto stmt = PrepareStatement("REPLACE INTO pathcheck (idPath, mtime, checked) VALUES (?, ?, ?)");
+  if (!stmt)
+    return false;
+
+  try
+  {
+    const int64_t now = static_cast<int64_t>(std::time(nullptr));
+    for (const auto& mtime : mtimes)
+    {
+      stmt->bind(0, mtime.first);
+      stmt->bind(1, mtime.second);
+      stmt->bind(2, now);
+      stmt->execute();
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} failed", __FUNCTION__);
+  }
+  return false;
+}
+
+void CDatabase::CleanPathChecks()
+{
+  ExecuteQuery("DELETE FROM pathcheck "
+               "WHERE NOT EXISTS (SELECT 1 FROM path WHERE path.idPath = pathcheck.idPath)");
+}
+
+bool CDatabase::SetSortKey(int mediaId,
+                           const std::string& mediaType,
+                           const std::string& title,
+                           const std::string& sortTitle /* = std::string() */)
+{
+  auto stmt = PrepareStatement(
+      "REPLACE INTO sortkey (media_id, media_type, tokens, title, titlenoarticle, sorttitle, "
+      "sorttitlenoarticle) VALUES (?, ?, ?, ?, ?, ?, ?)");
+  if (!stmt)
+    return false;
+
+  try
+  {
+    const std::string& sortName = sortTitle.empty() ? title : sortTitle;
+    stmt->bind(0, mediaId);
+    stmt->bind(1, mediaType);
+    stmt->bind(2, GetSortTokensChecksum());
+    stmt->bind(3, StringUtils::AlphaNumericSortKey(title));
+    stmt->bind(4, StringUtils::AlphaNumericSortKey(SortUtils::RemoveArticles(title)));
+    stmt->bind(5, StringUtils::AlphaNumericSortKey(sortName));
+    stmt->bind(6, StringUtils::AlphaNumericSortKey(SortUtils::RemoveArticles(sortName)));
+    stmt->execute();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed for {} {}", __FUNCTION__, mediaType, mediaId);
+  }
+  return false;
+}
+
+bool CDatabase::UpdateSortKeys(const std::string& mediaType,
+                               const std::string& table,
+                               const std::string& idField,
+                               const std::string& titleField,
+                               const std::string& sortTitleField /* = std::string() */)
+{
+  if (nullptr == m_pDB)
+    return false;
+
+  struct Item
+  {
+    int id;
+    std::string title;
+    std::string sortTitle;
+  };
+  std::vector<Item> items;
+
+  try
+  {
+    const std::string tokens = GetSortTokensChecksum();
+    const std::string sql = PrepareSQL(
+        "SELECT %s.%s, %s.%s, %s FROM %s LEFT JOIN sortkey ON sortkey.media_id = %s.%s AND "
+        "sortkey.media_type = '%s' WHERE sortkey.media_id IS NULL OR sortkey.tokens <> '%s'",
+        table.c_str(), idField.c_str(), table.c_str(), titleField.c_str(),
+        sortTitleField.empty() ? "NULL" : (table + "." + sortTitleField).c_str(), table.c_str(),
+        table.c_str(), idField.c_str(), mediaType.c_str(), tokens.c_str());
+
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    if (!pDS->query(sql))
+      return false;
+    const result_set& rows = pDS->get_result_set();
+    items.reserve(rows.records.size());
+    for (size_t i = 0; i < rows.records.size(); i++)
+    {
+      const sql_record* row = rows.records[i];
+      items.push_back({row->at(0).get_asInt(), row->at(1).get_asString(),
+                       row->at(2).get_asString()});
+    }
+    pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to get the {} items without sort keys", __FUNCTION__,
+              mediaType);
+    return false;
+  }
+
+  if (items.empty())
+    return true;
+
+  CLog::Log(LOGDEBUG, "{} - updating the sort keys of {} {} items", __FUNCTION__, items.size(),
+            mediaType);
+  const bool transaction = !m_pDB->in_transaction();
+  if (transaction)
+    BeginTransaction();
+  bool success = true;
+  for (const auto& item : items)
+  {
+    if (!SetSortKey(item.id, mediaType, item.title, item.sortTitle))
+    {
+      success = false;
+      break;
+    }
+  }
+  if (transaction)
+  {
+    if (success)
+      success = CommitTransaction();
+    else
+      RollbackTransaction();
+  }
+  return success;
+}
+
+bool CDatabase::GetSortKeyOrder(const std::string& mediaType,
+                                const SortDescription& sorting,
+                                Filter& filter) const
+{
+  /*
+  The sort preparators of SortUtils combine a value with the label of the item, e.g.
+  "<playcount> <label>", so sort by the value first and the sort key of the label next.
+  Ties keep the order of the ids like the stable sort does.
+  */
+  const std::string id = DatabaseUtils::GetField(FieldId, mediaType, DatabaseQueryPartOrderBy);
+  if (id.empty())
+    return false;
+  auto field = [&mediaType](Field f) {
+    return DatabaseUtils::GetField(f, mediaType, DatabaseQueryPartOrderBy);
+  };
+
+  const bool ignoreArticle = (sorting.sortAttributes & SortAttributeIgnoreArticle) != 0;
+  const std::string title = ignoreArticle ? "sortkey.titlenoarticle" : "sortkey.title";
+
+  // the labels of episodes and songs start with their number, so no articles are removed
+  std::vector<std::string> label;
+  if (mediaType == MediaTypeMovie)
+    label = {title};
+  else if (mediaType == MediaTypeEpisode)
+    label = {"(" + field(FieldSeason) + "+0)", "(" + field(FieldEpisodeNumber) + "+0)",
+             "sortkey.title"};
+  else if (mediaType == MediaTypeSong)
+    label = {field(FieldTrackNumber), "sortkey.title"};
+  else
+    return false;
+
+  std::vector<std::string> order;
+  switch (sorting.sortBy)
+  {
+    case SortByLabel:
+      order = label;
+      break;
+    case SortByTitle:
+      order = {title};
+      break;
+    case SortBySortTitle:
+      if (mediaType != MediaTypeMovie)
+        return false;
+      order = {ignoreArticle ? "sortkey.sorttitlenoarticle" : "sortkey.sorttitle"};
+      break;
+    case SortByTrackNumber:
+      if (mediaType != MediaTypeSong)
+        return false;
+      order = {field(FieldTrackNumber)};
+      break;
+    case SortByDateAdded:
+      order = {field(FieldDateAdded), id};
+      break;
+    case SortByLastPlayed:
+      order = {"COALESCE(" + field(FieldLastPlayed) + ", '')"};
+      if (!(sorting.sortAttributes & SortAttributeIgnoreLabel))
+        order.insert(order.end(), label.begin(), label.end());
+      break;
+    case SortByPlaycount:
+    case SortByRating:
+    case SortByUserRating:
+    case SortByVotes:
+    {
+      const Field value = sorting.sortBy == SortByPlaycount ? FieldPlaycount
+                          : sorting.sortBy == SortByRating  ? FieldRating
+                          : sorting.sortBy == SortByUserRating ? FieldUserRating
+                                                                : FieldVotes;
+      order = {"COALESCE(" + field(value) + ", 0)"};
+      order.insert(order.end(), label.begin(), label.end());
+      break;
+    }
+    default:
+      return false;
+  }
+
+  if (std::find(order.begin(), order.end(), std::string()) != order.end())
+    return false;
+
+  const std::string direction = sorting.sortOrder == SortOrderDescending ? " DESC" : "";
+  for (const auto& part : order)
+    filter.AppendOrder(part + direction);
+  filter.AppendOrder(id);
+
+  const std::string view = id.substr(0, id.find('.'));
+  filter.AppendJoin(PrepareSQL("LEFT JOIN sortkey ON sortkey.media_id = %s AND "
+                               "sortkey.media_type = '%s'",
+                               id.c_str(), mediaType.c_str()));
+  if (filter.fields.empty() || filter.fields == "*")
+    filter.fields = view + ".*";
+  return true;
+}
+
+void CDatabase::CreateSearchIndexTable()
+{
+  m_searchIndex = -1;
+  if (!m_sqlite)
+  {
+    m_pDS->exec("CREATE TABLE searchindex (search_id BIGINT PRIMARY KEY, media_id INTEGER, "
+                "media_type VARCHAR(20), title TEXT, people TEXT, tags TEXT, text TEXT)");
+    return;
+  }
+
+  try
+  {
+    m_pDS->exec("CREATE VIRTUAL TABLE searchindex USING fts5(media_id UNINDEXED, "
+                "media_type UNINDEXED, title, people, tags, text, "
+                "tokenize = 'unicode61 remove_diacritics 1', prefix = '2 3')");
+  }
+  catch (...)
+  {
+    // keep the triggers working when SQLite is built without FTS5
+    CLog::Log(LOGWARNING, "{} - FTS5 is not available, library search will not be indexed",
+              __FUNCTION__);
+    m_pDS->exec("CREATE TABLE searchindex (media_id INTEGER, media_type TEXT, title TEXT, "
+                "people TEXT, tags TEXT, text TEXT)");
+  }
+}
+
+void CDatabase::CreateSearchIndexAnalytics()
+{
+  if (m_sqlite)
+    return;
+
+  m_pDS->exec("CREATE FULLTEXT INDEX ix_searchindex_1 ON searchindex (title, people, tags, text)");
+  m_pDS->exec("CREATE FULLTEXT INDEX ix_searchindex_2 ON searchindex (title)");
+}
+
+std::string CDatabase::GetSearchIndexDeleteSQL(const std::string& idField,
+                                               const std::string& mediaType) const
+{
+  return PrepareSQL("DELETE FROM searchindex WHERE %s = %s * %i + %i; ",
+                    m_sqlite ? "rowid" : "search_id", idField.c_str(), SEARCH_INDEX_TYPES,
+                    GetSearchIndexType(mediaType));
+}
+
+bool CDatabase::UpdateSearchIndex(const std::string& mediaType, int mediaId /* = -1 */)
+{
+  SearchIndexSource source;
+  if (nullptr == m_pDB || !GetSearchIndexSource(mediaType, source))
+    return false;
+
+  auto column = [](const std::string& expression) {
+    return expression.empty() ? std::string("NULL") : expression;
+  };
+  const std::string id = source.table + "." + source.idField;
+  const std::string key = m_sqlite ? "rowid" : "search_id";
+  const int type = GetSearchIndexType(mediaType);
+
+  std::string sqlDelete;
+  std::string sqlInsert = PrepareSQL(
+      "INSERT INTO searchindex (%s, media_id, media_type, title, people, tags, text) "
+      "SELECT %s * %i + %i, %s, '%s', ",
+      key.c_str(), id.c_str(), SEARCH_INDEX_TYPES, type, id.c_str(), mediaType.c_str());
+  // the expressions are not passed through PrepareSQL, they may hold quoted strings
+  sqlInsert += column(source.title) + ", " + column(source.people) + ", " +
+               column(source.tags) + ", " + column(source.text) + " FROM " + source.table;
+  if (mediaId >= 0)
+  {
+    sqlDelete = PrepareSQL("DELETE FROM searchindex WHERE %s = %i", key.c_str(),
+                           mediaId * SEARCH_INDEX_TYPES + type);
+    sqlInsert += PrepareSQL(" WHERE %s = %i", id.c_str(), mediaId);
+  }
+  else
+    sqlDelete = PrepareSQL("DELETE FROM searchindex WHERE media_type = '%s'", mediaType.c_str());
+
+  try
+  {
+    // callers may be iterating the results of m_pDS
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    pDS->exec(sqlDelete);
+    pDS->exec(sqlInsert);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed for {} {}", __FUNCTION__, mediaType, mediaId);
+  }
+  return false;
+}
+
+std::string CDatabase::GetSearchIndexFilter(const std::string& search,
+                                            const std::string& mediaType,
+                                            const std::string& idField,
+                                            std::string& order,
+                                            bool titleOnly /* = false */,
+                                            int limit /* = 1000 */) const
+{
+  order.clear();
+  if (nullptr == m_pDB)
+    return "";
+
+  // split into words like the tokenizers do, anything but ascii letters and digits separates
+  std::vector<std::string> words;
+  std::string word;
+  for (const char c : search + " ")
+  {
+    if (isalnum(static_cast<unsigned char>(c)) || static_cast<unsigned char>(c) >= 0x80)
+      word += c;
+    else if (!word.empty())
+    {
+      words.push_back(word);
+      word.clear();
+    }
+  }
+  if (words.empty())
+    return "";
+
+  try
+  {
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    std::string sql;
+    if (m_sqlite)
+    {
+      if (m_searchIndex < 0)
+        m_searchIndex =
+            GetSingleValue("SELECT sql FROM sqlite_master WHERE name = 'searchindex'", pDS)
+                .find("fts5") != std::string::npos;
+      if (m_searchIndex == 0)
+        return "";
+
+      // "word"* matches words that start with word, the words of an expression are ANDed
+      std::string match;
+      for (const auto& w : words)
+        match += (match.empty() ? "" : " ") + std::string(titleOnly ? "title : \"" : "\"") + w +
+                 "\"*";
+      // bm25 weights of the columns, smaller ranks are better
+      sql = PrepareSQL("SELECT media_id FROM searchindex WHERE searchindex MATCH '%s' "
+                       "AND media_type = '%s' "
+                       "ORDER BY bm25(searchindex, 0.0, 0.0, 10.0, 4.0, 2.0, 1.0) LIMIT %i",
+                       match.c_str(), mediaType.c_str(), limit);
+    }
+    else
+    {
+      // InnoDB does not index words shorter than innodb_ft_min_token_size
+      std::string all;
+      std::string any;
+      for (const auto& w : words)
+      {
+        if (w.size() < 3)
+          return "";
+        all += "+" + w + "* ";
+        any += w + "* ";
+      }
+      if (titleOnly)
+        sql = PrepareSQL("SELECT media_id FROM searchindex "
+                         "WHERE MATCH (title) AGAINST ('%s' IN BOOLEAN MODE) "
+                         "AND media_type = '%s' "
+                         "ORDER BY MATCH (title) AGAINST ('%s' IN BOOLEAN MODE) DESC LIMIT %i",
+                         all.c_str(), mediaType.c_str(), any.c_str(), limit);
+      else
+        sql = PrepareSQL(
+            "SELECT media_id FROM searchindex "
+            "WHERE MATCH (title, people, tags, text) AGAINST ('%s' IN BOOLEAN MODE) "
+            "AND media_type = '%s' "
+            "ORDER BY MATCH (title) AGAINST ('%s' IN BOOLEAN MODE) DESC, "
+            "MATCH (title, people, tags, text) AGAINST ('%s' IN BOOLEAN MODE) DESC LIMIT %i",
+            all.c_str(), mediaType.c_str(), any.c_str(), any.c_str(), limit);
+    }
+
+    if (!pDS->query(sql))
+      return "";
+
+    std::vector<int> ids;
+    const result_set& rows = pDS->get_result_set();
+    ids.reserve(rows.records.size());
+    for (size_t i = 0; i < rows.records.size(); i++)
+      ids.push_back(rows.records[i]->at(0).get_asInt());
+    pDS->close();
+
+    order = GetIdOrder(idField, ids);
+    return GetIdFilter(idField, ids);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to search {} for '{}'", __FUNCTION__, mediaType, search);
+  }
+  return "";
+}
+
+int CDatabase::GetRandomIds(const std::string& sql, unsigned int count, std::vector<int>& ids)
+{
+  ids.clear();
+  if (nullptr == m_pDB)
+    return -1;
+
+  try
+  {
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    if (!pDS->query(sql))
+      return -1;
+
+    const result_set& rows = pDS->get_result_set();
+    ids.reserve(rows.records.size());
+    for (size_t i = 0; i < rows.records.size(); i++)
+      ids.push_back(rows.records[i]->at(0).get_asInt());
+    pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to pick random ids ({})", __FUNCTION__, sql);
+    ids.clear();
+    return -1;
+  }
+
+  const int total = static_cast<int>(ids.size());
+  ids.erase(KODI::UTILS::RandomSample(ids.begin(), ids.end(), count > 0 ? count : ids.size()),
+            ids.end());
+  return total;
+}
+
+unsigned int CDatabase::GetRandomLimit(const SortDescription& sorting)
+{
+  if (sorting.limitEnd <= 0)
+    return 0;
+  return static_cast<unsigned int>(std::max(sorting.limitEnd - std::max(sorting.limitStart, 0), 1));
+}
+
+std::string CDatabase::GetIdFilter(const std::string& idField, const std::vector<int>& ids)
+{
+  if (ids.empty())
+    return "1 = 0";
+
+  std::string filter = idField + " IN (";
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    if (i > 0)
+      filter += ",";
+    filter += std::to_string(ids[i]);
+  }
+  return filter + ")";
+}
+
+std::string CDatabase::GetIdOrder(const std::string& idField, const std::vector<int>& ids)
+{
+  if (ids.empty())
+    return "NULL";
+
+  std::string order = "CASE " + idField;
+  for (size_t i = 0; i < ids.size(); i++)
+    order += " WHEN " + std::to_string(ids[i]) + " THEN " + std::to_string(i);
+  return order + " END";
+}
+
 bool CDatabase::BuildSQL(const std::string& strBaseDir,
                          const std::string& strQuery,
                          Filter& filter,
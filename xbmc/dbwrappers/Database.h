@@ -12,8 +12,12 @@ namespace dbiplus
 {
 class Database;
 class Dataset;
+class Statement;
 } // namespace dbiplus
 
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -184,6 +188,16 @@ public:
    */
   bool ResultQuery(const std::string& strQuery) const;
 
+  /*!
+   * @brief Get a compiled statement for a query that is run many times.
+   * @remarks Parameters are given as ? in the query and bound by index, starting with 0.
+   *          Compiled statements are cached per connection, so the statement has to be
+   *          destroyed before the database is closed.
+   * @param strQuery The query to prepare, it is not passed through PrepareSQL().
+   * @return The statement, or nullptr if the query could not be prepared.
+   */
+  std::unique_ptr<dbiplus::Statement> PrepareStatement(const std::string& strQuery) const;
+
   /*!
    * @brief Start a multiple execution queue. Any ExecuteQuery() function
    *        following this call will be queued rather than executed until
@@ -242,6 +256,66 @@ public:
    */
   size_t GetDeleteQueriesCount();
 
+  /*!
+   * @brief Progress of a write batch.
+   */
+  struct BatchCounters
+  {
+    unsigned int items = 0; ///< items written since the batch was begun
+    unsigned int pending = 0; ///< items written but not committed yet
+    unsigned int commits = 0; ///< transactions committed
+    std::chrono::milliseconds commitTime{0}; ///< time spent committing
+  };
+
+  /*!
+   * @brief Group the writes that follow into a few large transactions.
+   *        Every commit syncs the database to storage, which dominates the
+   *        time to add items one by one. While batching, transactions begun
+   *        with BeginTransaction() become savepoints of the batch, so they can
+   *        still be rolled back on their own. The transaction of the batch
+   *        is begun by the first of them, and holds the write lock until it
+   *        is committed, so call CommitBatchWrites() before blocking on I/O.
+   * @param maxItems The number of items after which BatchItemDone() commits.
+   * @param maxDuration The time after the first write of the transaction,
+   *        after which BatchItemDone() commits. Only checked between items.
+   * @return True if the batch was begun, false if a batch is already running.
+   * @sa BatchItemDone, CommitBatch
+   */
+  bool BeginBatch(unsigned int maxItems = 500,
+                  std::chrono::milliseconds maxDuration = std::chrono::seconds(2));
+
+  /*!
+   * @brief Count an item written in the batch, and commit the batch when it
+   *        is large or old enough. Does nothing if no batch is running.
+   * @return False if committing failed, true otherwise.
+   */
+  bool BatchItemDone();
+
+  /*!
+   * @brief Commit what the batch has written so far, e.g. before scraping or
+   *        reading files over the network, so that other connections can
+   *        write meanwhile. The batch goes on, its next write begins a new
+   *        transaction. Does nothing within a transaction of the batch.
+   * @return False if committing failed, true otherwise.
+   */
+  bool CommitBatchWrites();
+
+  /*!
+   * @brief Commit and end the batch. Also done when the database is closed.
+   * @return True if the batch was committed successfully, false otherwise.
+   */
+  bool CommitBatch();
+
+  /*!
+   * @brief Whether a batch is running.
+   */
+  bool IsBatchActive() const { return m_batch.active; }
+
+  /*!
+   * @brief Get the progress of the running or last batch.
+   */
+  const BatchCounters& GetBatchCounters() const { return m_batch.counters; }
+
   virtual bool GetFilter(CDbUrl& dbUrl, Filter& filter, SortDescription& sorting) { return true; }
   virtual bool BuildSQL(const std::string& strBaseDir,
                         const std::string& strQuery,
@@ -298,6 +372,176 @@ protected:
 
   bool BuildSQL(const std::string& strQuery, const Filter& filter, std::string& strSQL) const;
 
+  /*! \brief Create the sortkey table that holds the precomputed sort keys of library items.
+   Keys are made with StringUtils::AlphaNumericSortKey(), so they sort with a plain byte
+   comparison, and are stored with and without leading articles.
+   */
+  void CreateSortKeyTable();
+
+  /*! \brief Store the sort keys of an item.
+   \param mediaId id of the item
+   \param mediaType media type of the item, e.g. MediaTypeMovie
+   \param title title of the item
+   \param sortTitle sort title of the item, the title is used when empty
+   \return true on success, false otherwise
+   */
+  bool SetSortKey(int mediaId,
+                  const std::string& mediaType,
+                  const std::string& title,
+                  const std::string& sortTitle = std::string());
+
+  /*! \brief Store the sort keys of all items of a table that have none yet, or that were made
+   with other sort tokens than the ones of the current language.
+   \param mediaType media type of the items, e.g. MediaTypeMovie
+   \param table table holding the items
+   \param idField id field of the table
+   \param titleField title field of the table
+   \param sortTitleField sort title field of the table, may be empty
+   \return true on success, false otherwise
+   */
+  bool UpdateSortKeys(const std::string& mediaType,
+                      const std::string& table,
+                      const std::string& idField,
+                      const std::string& titleField,
+                      const std::string& sortTitleField = std::string());
+
+  /*! \brief Set the join and order of a filter to sort items with their sort keys in the same
+   order as SortUtils::Sort() does.
+   \param mediaType media type of the items, e.g. MediaTypeMovie
+   \param sorting the sort method, order and attributes
+   \param filter [in/out] the filter to add the join and order to
+   \return true if the sort method can be done in the query, false otherwise
+   */
+  bool GetSortKeyOrder(const std::string& mediaType,
+                       const SortDescription& sorting,
+                       Filter& filter) const;
+
+  //! how long a clean trusts that the files of a path with an unchanged modification time exist
+  static constexpr std::chrono::hours PATH_CHECK_MAX_AGE{7 * 24};
+
+  /*! \brief Create the pathcheck table that holds the modification times of the library paths
+   at the last clean that found all of their files.
+   */
+  void CreatePathCheckTable();
+
+  /*! \brief Get the modification times of the paths whose files were all found by a clean.
+   \param maxAge how long the result of a clean is trusted
+   \return the modification times by path id
+   */
+  std::map<int, int64_t> GetPathChecks(std::chrono::seconds maxAge);
+
+  /*! \brief Store the modification times of the paths whose files were all found by a clean.
+   \param mtimes the modification times by path id
+   \return true on success, false otherwise
+   */
+  bool SetPathChecks(const std::map<int, int64_t>& mtimes);
+
+  /*! \brief Remove the modification times of paths that were removed from the path table.
+   */
+  void CleanPathChecks();
+
+  /*! \brief The columns of the search index for one media type, as SQL expressions on the table
+   holding the items. Empty expressions are indexed as NULL.
+   */
+  struct SearchIndexSource
+  {
+    std::string table;
+    std::string idField;
+    std::string title;
+    std::string people;
+    std::string tags;
+    std::string text;
+  };
+
+  /*! \brief Get the columns of the search index for the items of a media type.
+   \param mediaType media type of the items, e.g. MediaTypeMovie
+   \param source [out] the table and expressions to index
+   \return true if the media type is indexed, false otherwise
+   */
+  virtual bool GetSearchIndexSource(const std::string& mediaType, SearchIndexSource& source) const
+  {
+    return false;
+  }
+
+  /*! \brief Create the searchindex table, a FTS5 table with SQLite and a table with FULLTEXT
+   indexes with MySQL. SQLite builds without FTS5 get a plain table and search with LIKE.
+   */
+  void CreateSearchIndexTable();
+
+  /*! \brief Create the FULLTEXT indexes of the searchindex table with MySQL.
+   */
+  void CreateSearchIndexAnalytics();
+
+  /*! \brief Get the statement for a delete trigger that removes an item from the search index.
+   \param idField the id of the deleted item, e.g. "old.idMovie"
+   \param mediaType media type of the item, e.g. MediaTypeMovie
+   \return the statement including the trailing semicolon
+   */
+  std::string GetSearchIndexDeleteSQL(const std::string& idField,
+                                      const std::string& mediaType) const;
+
+  /*! \brief Index an item, or all items of a media type, for searching.
+   \param mediaType media type of the items, e.g. MediaTypeMovie
+   \param mediaId id of the item, or -1 to index all items
+   \return true on success, false otherwise
+   */
+  bool UpdateSearchIndex(const std::string& mediaType, int mediaId = -1);
+
+  /*! \brief Search the search index. Every word of the search has to match the start of a word
+   of the item, best matches in the title come first.
+   \param search the words to search for
+   \param mediaType media type of the items, e.g. MediaTypeMovie
+   \param idField the field to compare the ids of the found items with, e.g. "movie.idMovie"
+   \param order [out] an ORDER BY expression listing the found items best match first
+   \param titleOnly whether only the titles are searched, e.g. to find an item by its name
+   \param limit the maximum number of items
+   \return a condition matching the found items, empty if the search index can not be used
+   */
+  std::string GetSearchIndexFilter(const std::string& search,
+                                   const std::string& mediaType,
+                                   const std::string& idField,
+                                   std::string& order,
+                                   bool titleOnly = false,
+                                   int limit = 1000) const;
+
+  /*! \brief Pick random ids from the result of a query without ordering it by RANDOM()
+   Only the ids are read, ordering by RANDOM() numbers and sorts every row of the result.
+   \param sql the query returning the candidate ids in its first column
+   \param count the number of ids to pick, 0 to shuffle all of them
+   \param ids [out] the picked ids in random order
+   \return the number of candidates, -1 on error
+   */
+  int GetRandomIds(const std::string& sql, unsigned int count, std::vector<int>& ids);
+
+  /*! \brief Get the number of random items requested by the limits of a sort description
+   Pages of random items are all alike, only the size of the page matters.
+   \param sorting the sort description
+   \return the number of items, 0 for all of them
+   */
+  static unsigned int GetRandomLimit(const SortDescription& sorting);
+
+  /*! \brief Get a condition matching the given ids
+   \param idField the id field, including the table name if needed
+   \param ids the ids to match
+   \return the condition, one matching nothing if there are no ids
+   */
+  static std::string GetIdFilter(const std::string& idField, const std::vector<int>& ids);
+
+  /*! \brief Get an ORDER BY expression listing items in the order of the given ids
+   \param idField the id field, including the table name if needed
+   \param ids the ids in the order to list them
+   \return the expression, NULL if there are no ids
+   */
+  static std::string GetIdOrder(const std::string& idField, const std::vector<int>& ids);
+
+  /*! \brief Get the dataset to run a listing query on, the one of a pooled read-only connection.
+   With WAL journaling a read-only connection reads the last commit without waiting for the
+   writers on other connections, e.g. the library scanners. The writer connection is used while
+   it has a transaction open, so the uncommitted writes are read, and without read connections.
+   \return the dataset, valid until the database is closed
+   */
+  const std::unique_ptr<dbiplus::Dataset>& GetReadDataset();
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -320,4 +564,26 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  mutable int m_searchIndex = -1; ///< whether searchindex is a FTS5 table, -1 until checked
+
+  void ReleaseReadConnection();
+
+  unsigned int m_readConnections = 0; ///< idle read connections to keep, 0 to read on m_pDB
+  std::unique_ptr<dbiplus::Database> m_pReadDB;
+  std::unique_ptr<dbiplus::Dataset> m_pReadDS;
+
+  bool ExecuteSavepoint(const std::string& strQuery);
+  bool CommitBatchTransaction();
+
+  struct
+  {
+    bool active = false;
+    bool open = false; ///< the transaction of the batch has been begun
+    unsigned int savepoints = 0; ///< nested transactions within the batch
+    unsigned int maxItems = 0;
+    std::chrono::milliseconds maxDuration{0};
+    std::chrono::steady_clock::time_point started;
+    BatchCounters counters;
+  } m_batch;
 };
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "QueryProfiler.h"
+
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+CQueryProfiler& CQueryProfiler::GetInstance()
+{
+  static CQueryProfiler profiler;
+  return profiler;
+}
+
+bool CQueryProfiler::Record(const std::string& sql, std::chrono::microseconds duration)
+{
+  const std::string key = Normalize(sql);
+  const bool slow = duration >= GetSlowThreshold();
+
+  size_t bucket = 0;
+  while (bucket < BUCKET_LIMITS.size() &&
+         duration >= std::chrono::milliseconds(BUCKET_LIMITS[bucket]))
+    bucket++;
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  auto it = m_entries.find(key);
+  if (it == m_entries.end())
+  {
+    if (m_entries.size() >= MAX_ENTRIES)
+    {
+      m_untracked++;
+      return false;
+    }
+    it = m_entries.emplace(key, Stats()).first;
+    it->second.entry.sql = key;
+  }
+
+  Entry& entry = it->second.entry;
+  entry.count++;
+  entry.total += duration;
+  entry.max = std::max(entry.max, duration);
+  entry.histogram[bucket]++;
+  if (!slow)
+    return false;
+
+  CLog::Log(LOGDEBUG, LOGDATABASEPROFILER, "{} - slow query took {:.1f} ms: {}", __FUNCTION__,
+            duration.count() / 1000.0, sql);
+
+  if (it->second.explained)
+    return false;
+  it->second.explained = true;
+  return true;
+}
+
+void CQueryProfiler::SetPlan(const std::string& sql, const std::string& plan)
+{
+  if (plan.empty())
+    return;
+
+  CLog::Log(LOGDEBUG, LOGDATABASEPROFILER, "{} - plan of {}:\n{}", __FUNCTION__, sql, plan);
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  auto it = m_entries.find(Normalize(sql));
+  if (it != m_entries.end())
+    it->second.entry.plan = plan;
+}
+
+std::vector<CQueryProfiler::Entry> CQueryProfiler::GetEntries(size_t limit /* = 0 */) const
+{
+  std::vector<Entry> entries;
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    entries.reserve(m_entries.size());
+    for (const auto& it : m_entries)
+      entries.push_back(it.second.entry);
+  }
+
+  if (limit == 0 || limit > entries.size())
+    limit = entries.size();
+  std::partial_sort(entries.begin(), entries.begin() + limit, entries.end(),
+                    [](const Entry& a, const Entry& b) { return a.total > b.total; });
+  entries.resize(limit);
+  return entries;
+}
+
+unsigned int CQueryProfiler::GetUntracked() const
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  return m_untracked;
+}
+
+void CQueryProfiler::Reset()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  m_entries.clear();
+  m_untracked = 0;
+}
+
+std::string CQueryProfiler::Normalize(const std::string& sql)
+{
+  std::string normalized;
+  normalized.reserve(sql.size());
+
+  const auto isWord = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+  const auto addValue = [&normalized]()
+  {
+    // lists of values, e.g. of IN (...), become a single ?
+    if (normalized.size() >= 3 && normalized.compare(normalized.size() - 3, 3, "?, ") == 0)
+      normalized.resize(normalized.size() - 2);
+    else if (normalized.size() >= 2 && normalized.compare(normalized.size() - 2, 2, "?,") == 0)
+      normalized.pop_back();
+    else
+      normalized += '?';
+  };
+
+  for (size_t i = 0; i < sql.size(); i++)
+  {
+    const char c = sql[i];
+    if (c == '\'')
+    {
+      // quotes in strings are doubled
+      while (++i < sql.size())
+      {
+        if (sql[i] == '\'')
+        {
+          if (i + 1 < sql.size() && sql[i + 1] == '\'')
+            i++;
+          else
+            break;
+        }
+      }
+      addValue();
+    }
+    else if (std::isdigit(static_cast<unsigned char>(c)) &&
+             (normalized.empty() || !isWord(normalized.back())))
+    {
+      while (i + 1 < sql.size() &&
+             (std::isdigit(static_cast<unsigned char>(sql[i + 1])) || sql[i + 1] == '.'))
+        i++;
+      addValue();
+    }
+    else if (std::isspace(static_cast<unsigned char>(c)))
+    {
+      if (!normalized.empty() && normalized.back() != ' ')
+        normalized += ' ';
+    }
+    else
+      normalized += c;
+  }
+
+  if (!normalized.empty() && normalized.back() == ' ')
+    normalized.pop_back();
+  return normalized;
+}
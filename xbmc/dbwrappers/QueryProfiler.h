@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Collects the run times of the database queries, keyed by the query with its literal values
+ replaced by ?. The plan of queries slower than a threshold is captured once, so the queries
+ scanning whole tables can be found.
+
+ Recording is enabled together with the "Database profiler" debug logging component, which also
+ logs every slow query.
+ */
+class CQueryProfiler
+{
+public:
+  //! upper bounds of the histogram buckets in ms, the last bucket holds the slower queries
+  static constexpr std::array<unsigned int, 6> BUCKET_LIMITS = {1, 4, 16, 64, 256, 1024};
+
+  struct Entry
+  {
+    std::string sql; ///< normalized query
+    unsigned int count = 0;
+    std::chrono::microseconds total{0};
+    std::chrono::microseconds max{0};
+    std::array<unsigned int, BUCKET_LIMITS.size() + 1> histogram{};
+    std::string plan; ///< plan of the first slow run, empty if the query was never slow
+  };
+
+  static CQueryProfiler& GetInstance();
+
+  bool IsEnabled() const { return m_enabled; }
+  void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+  std::chrono::milliseconds GetSlowThreshold() const { return m_slowThreshold.load(); }
+  void SetSlowThreshold(std::chrono::milliseconds threshold) { m_slowThreshold = threshold; }
+
+  /*!
+   \brief Record a run of a query.
+   \param sql the query as run
+   \param duration the run time of the query
+   \return true if the query was slow and its plan has not been captured yet
+   \sa SetPlan
+   */
+  bool Record(const std::string& sql, std::chrono::microseconds duration);
+
+  /*!
+   \brief Store the plan of a slow query.
+   \param sql the query as run
+   \param plan the plan, one step per line
+   */
+  void SetPlan(const std::string& sql, const std::string& plan);
+
+  /*!
+   \brief Get the recorded queries, the ones with the largest total run time first.
+   \param limit the maximum number of queries, 0 for all of them
+   */
+  std::vector<Entry> GetEntries(size_t limit = 0) const;
+
+  //! number of queries not recorded because too many different queries were seen
+  unsigned int GetUntracked() const;
+
+  void Reset();
+
+  /*!
+   \brief Replace the literal values of a query by ?, collapse the lists of values and the white
+   space, so the runs of a query with different values are recorded together.
+   */
+  static std::string Normalize(const std::string& sql);
+
+private:
+  CQueryProfiler() = default;
+
+  static constexpr size_t MAX_ENTRIES = 1000;
+
+  std::atomic<bool> m_enabled{false};
+  std::atomic<std::chrono::milliseconds> m_slowThreshold{std::chrono::milliseconds(50)};
+
+  struct Stats
+  {
+    Entry entry;
+    bool explained = false; ///< the plan was requested, some statements have none
+  };
+
+  mutable CCriticalSection m_critSection;
+  std::map<std::string, Stats> m_entries;
+  unsigned int m_untracked = 0;
+};
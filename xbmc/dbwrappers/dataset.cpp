@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <vector>
 
 #ifndef __GNUC__
 #pragma warning(disable : 4800)
@@ -37,6 +38,7 @@ Database::Database()
 {
   active = false; // No connection yet
   compression = false;
+  read_only = false;
 }
 
 Database::~Database()
@@ -80,6 +82,125 @@ std::string Database::prepare(const char* format, ...)
   return result;
 }
 
+namespace
+{
+// statement for backends without native support, the bound values are
+// substituted into the SQL text which is then run on its own dataset
+class TextStatement : public Statement
+{
+public:
+  TextStatement(Database* database, const std::string& sql)
+    : db(database), ds(database->CreateDataset()), sql(sql)
+  {
+    size_t pos = sql.find_first_not_of(" \t\r\n(");
+    is_query = pos != std::string::npos && StringUtils::StartsWithNoCase(sql.c_str() + pos, "select");
+  }
+
+  void bind(int index, int value) override { set_param(index, std::to_string(value)); }
+  void bind(int index, int64_t value) override { set_param(index, std::to_string(value)); }
+  void bind(int index, double value) override
+  {
+    set_param(index, StringUtils::Format("{}", value));
+  }
+  void bind(int index, const std::string& value) override
+  {
+    set_param(index, db->prepare("'%s'", value.c_str()));
+  }
+  void bind_null(int index) override { set_param(index, "NULL"); }
+
+  bool step() override
+  {
+    if (executed)
+    {
+      if (!is_query || ds->eof())
+        return false;
+      ds->next();
+      return !ds->eof();
+    }
+
+    executed = true;
+    if (!is_query)
+    {
+      ds->exec(build_sql());
+      return false;
+    }
+    ds->query(build_sql());
+    return !ds->eof();
+  }
+  void execute() override
+  {
+    step();
+    reset();
+  }
+  void reset() override
+  {
+    if (is_query)
+      ds->close();
+    executed = false;
+  }
+
+  int column_count() override { return ds->fieldCount(); }
+  bool is_null(int column) override { return ds->fv(column).get_isNull(); }
+  int get_asInt(int column) override { return ds->fv(column).get_asInt(); }
+  int64_t get_asInt64(int column) override { return ds->fv(column).get_asInt64(); }
+  double get_asDouble(int column) override { return ds->fv(column).get_asDouble(); }
+  std::string get_asString(int column) override { return ds->fv(column).get_asString(); }
+
+  int64_t lastinsertid() override { return ds->lastinsertid(); }
+
+private:
+  void set_param(int index, std::string&& value)
+  {
+    if (index < 0)
+      throw DbErrors("Parameter index %d out of range", index);
+    if (static_cast<size_t>(index) >= params.size())
+      params.resize(index + 1, "NULL");
+    params[index] = std::move(value);
+  }
+
+  std::string build_sql() const
+  {
+    std::string result;
+    result.reserve(sql.size() + 16 * params.size());
+    size_t param = 0;
+    char quote = 0;
+    for (char c : sql)
+    {
+      if (quote)
+      {
+        if (c == quote)
+          quote = 0;
+      }
+      else if (c == '\'' || c == '"')
+        quote = c;
+      else if (c == '?')
+      {
+        // unbound parameters are NULL, as with native statements
+        result += param < params.size() ? params[param] : "NULL";
+        ++param;
+        continue;
+      }
+      result += c;
+    }
+    return result;
+  }
+
+  Database* db;
+  std::unique_ptr<Dataset> ds;
+  std::string sql;
+  std::vector<std::string> params;
+  bool is_query;
+  bool executed = false;
+};
+} // namespace
+
+std::unique_ptr<Statement> Database::prepareStatement(const std::string& sql)
+{
+  if (!active)
+    throw DbErrors("Can't prepare statement: no active connection...");
+  return std::make_unique<TextStatement>(this, sql);
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset() : select_sql("")
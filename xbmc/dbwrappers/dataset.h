@@ -17,6 +17,7 @@
 #include <cstdio>
 #include <list>
 #include <map>
+#include <memory>
 #include <stdarg.h>
 #include <string>
 #include <unordered_map>
@@ -24,6 +25,7 @@
 namespace dbiplus
 {
 class Dataset; // forward declaration of class Dataset
+class Statement; // forward declaration of class Statement
 
 #define S_NO_CONNECTION "No active connection";
 
@@ -51,6 +53,8 @@ class Database
 protected:
   bool active;
   bool compression;
+  bool read_only; // connect without write access
+  std::string journal_mode; // journal mode of the connection, empty for the default
   std::string error, // Error description
       host, port, db, login, passwd, //Login info
       sequence_table, //Sequence table for nextid
@@ -83,6 +87,14 @@ public:
   void setPasswd(const char* newPasswd) { passwd = newPasswd; }
   /* gets a password */
   const char* getPasswd(void) const { return passwd.c_str(); }
+  /* sets the journal mode set when connecting, if supported */
+  void setJournalMode(const char* newMode) { journal_mode = newMode; }
+  /* gets the journal mode */
+  const char* getJournalMode(void) const { return journal_mode.c_str(); }
+  /* sets whether to connect without write access, if supported */
+  void setReadOnly(bool newReadOnly) { read_only = newReadOnly; }
+  /* gets whether the connection has no write access */
+  bool isReadOnly(void) const { return read_only; }
   /* active status is OK state */
   virtual bool isActive(void) const { return active; }
   /* Set new name of sequence table */
@@ -146,6 +158,15 @@ public:
   virtual void commit_transaction() {}
   virtual void rollback_transaction() {}
 
+  /*! \brief Compile a SQL statement with positional ? parameters.
+   The default implementation substitutes the bound values into the SQL text and runs it on a
+   new dataset, backends with native support reuse compiled statements per connection.
+   A statement must be destroyed before the connection is closed.
+   \param sql - statement with ? placeholders, parameters are bound by the caller.
+   \return the statement, throws DbErrors on failure.
+   */
+  virtual std::unique_ptr<Statement> prepareStatement(const std::string& sql);
+
   /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
@@ -448,6 +469,43 @@ public:
   const char* get_select_sql();
 };
 
+/******************* Class Statement definition *******************
+
+  compiled SQL statement with positional ? parameters, parameter and
+  column indexes start with 0
+
+******************************************************************/
+class Statement
+{
+public:
+  virtual ~Statement() = default;
+
+  /* bind a value to a parameter, bindings are kept over reset() */
+  virtual void bind(int index, int value) = 0;
+  virtual void bind(int index, int64_t value) = 0;
+  virtual void bind(int index, double value) = 0;
+  virtual void bind(int index, const std::string& value) = 0;
+  virtual void bind_null(int index) = 0;
+
+  /* execute or continue, returns true while a result row is available */
+  virtual bool step() = 0;
+  /* execute a statement that doesn't return rows and reset it */
+  virtual void execute() = 0;
+  /* rewind the statement so it can be executed again */
+  virtual void reset() = 0;
+
+  /* typed access to the columns of the current row */
+  virtual int column_count() = 0;
+  virtual bool is_null(int column) = 0;
+  virtual int get_asInt(int column) = 0;
+  virtual int64_t get_asInt64(int column) = 0;
+  virtual double get_asDouble(int column) = 0;
+  virtual std::string get_asString(int column) = 0;
+
+  /* last inserted id on the connection */
+  virtual int64_t lastinsertid() = 0;
+};
+
 /******************** Class DbErrors definition *********************
 
 			   error handling
@@ -7,6 +7,7 @@
  */
 
 #include "mysqldataset.h"
+#include "QueryProfiler.h"
 
 #include "Util.h"
 #include "network/DNSNameCache.h"
@@ -16,6 +17,8 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <set>
 #include <string>
@@ -1745,17 +1748,14 @@ void MysqlDataset::fill_fields()
   }
 
   //Filling result
-  if (result.records.size() != 0)
+  if (frecno >= 0 && (unsigned int)frecno < result.records.size())
   {
     const sql_record* row = result.records[frecno];
-    if (row)
-    {
-      const unsigned int ncols = row->size();
-      fields_object->resize(ncols);
-      for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
-      return;
-    }
+    const unsigned int ncols = row->size();
+    fields_object->resize(ncols);
+    for (unsigned int i = 0; i < ncols; i++)
+      (*fields_object)[i].val = row->at(i).get_value();
+    return;
   }
   const unsigned int ncols = result.record_header.size();
   fields_object->resize(ncols);
@@ -1836,6 +1836,7 @@ int MysqlDataset::exec(const std::string& sql)
 
   CLog::Log(LOGDEBUG, "Mysql execute: {}", qry);
 
+  const auto start = std::chrono::steady_clock::now();
   if (db->setErr(static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) !=
       MYSQL_OK)
   {
@@ -1843,6 +1844,11 @@ int MysqlDataset::exec(const std::string& sql)
   }
   else
   {
+    // only the run times are recorded, plans are not captured with MySQL
+    if (CQueryProfiler::GetInstance().IsEnabled())
+      CQueryProfiler::GetInstance().Record(
+          qry, std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start));
     //! @todo collect results and store in exec_res
     return res;
   }
@@ -1878,6 +1884,7 @@ bool MysqlDataset::query(const std::string& query)
 
   MYSQL_RES* stmt = NULL;
 
+  const auto start = std::chrono::steady_clock::now();
   if (static_cast<MysqlDatabase*>(db)->setErr(
           static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) !=
       MYSQL_OK)
@@ -1899,21 +1906,19 @@ bool MysqlDataset::query(const std::string& query)
   // returned rows
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record* res = new sql_record;
-    res->resize(numColumns);
+    result.add_row();
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value& v = res->at(i);
       switch (fields[i].type)
       {
         case MYSQL_TYPE_LONGLONG:
           if (row[i] != nullptr)
           {
-            v.set_asInt64(strtoll(row[i], nullptr, 10));
+            result.add_int64(strtoll(row[i], nullptr, 10));
           }
           else
           {
-            v.set_asInt64(0);
+            result.add_int64(0);
           }
           break;
         case MYSQL_TYPE_DECIMAL:
@@ -1924,48 +1929,49 @@ bool MysqlDataset::query(const std::string& query)
         case MYSQL_TYPE_LONG:
           if (row[i] != NULL)
           {
-            v.set_asInt(atoi(row[i]));
+            result.add_int(atoi(row[i]));
           }
           else
           {
-            v.set_asInt(0);
+            result.add_int(0);
           }
           break;
         case MYSQL_TYPE_FLOAT:
         case MYSQL_TYPE_DOUBLE:
           if (row[i] != NULL)
           {
-            v.set_asDouble(atof(row[i]));
+            result.add_double(atof(row[i]));
           }
           else
           {
-            v.set_asDouble(0);
+            result.add_double(0);
           }
           break;
         case MYSQL_TYPE_STRING:
         case MYSQL_TYPE_VAR_STRING:
         case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL)
-            v.set_asString((const char*)row[i]);
-          break;
         case MYSQL_TYPE_TINY_BLOB:
         case MYSQL_TYPE_MEDIUM_BLOB:
         case MYSQL_TYPE_LONG_BLOB:
         case MYSQL_TYPE_BLOB:
           if (row[i] != NULL)
-            v.set_asString((const char*)row[i]);
+            result.add_string(row[i], strlen(row[i]));
+          else
+            result.add_string("", 0);
           break;
         case MYSQL_TYPE_NULL:
         default:
           CLog::Log(LOGDEBUG, "MYSQL: Unknown field type: {}", fields[i].type);
-          v.set_asString("");
-          v.set_isNull();
+          result.add_null();
           break;
       }
     }
-    result.records.push_back(res);
   }
   mysql_free_result(stmt);
+  if (CQueryProfiler::GetInstance().IsEnabled())
+    CQueryProfiler::GetInstance().Record(
+        qry, std::chrono::duration_cast<std::chrono::microseconds>(
+                 std::chrono::steady_clock::now() - start));
   active = true;
   ds_state = dsSelect;
   this->first();
@@ -2053,15 +2059,7 @@ void MysqlDataset::next(void)
 
 void MysqlDataset::free_row(void)
 {
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record* row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
+  // rows are stored by column in the result set and released with it
 }
 
 bool MysqlDataset::seek(int pos)
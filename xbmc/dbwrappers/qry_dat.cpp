@@ -17,6 +17,7 @@
 
 #include "qry_dat.h"
 
+#include <cstring>
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -947,4 +948,237 @@ std::string field_value::gft()
   return tmp;
 }
 
+//************* field_ref ***************************
+
+field_value field_ref::get_value() const
+{
+  field_value v;
+  switch (type)
+  {
+    case ft_String:
+    {
+      const std::string_view str = get_asStringView();
+      v.set_asString(str.data(), str.size());
+      break;
+    }
+    case ft_Int:
+      v.set_asInt(static_cast<int>(value.int64_value));
+      break;
+    case ft_Int64:
+      v.set_asInt64(value.int64_value);
+      break;
+    case ft_Double:
+      v.set_asDouble(value.double_value);
+      break;
+    default:
+      break;
+  }
+  if (is_null)
+    v.set_isNull();
+  return v;
+}
+
+std::string field_ref::get_asString() const
+{
+  if (type == ft_String)
+    return std::string(get_asStringView());
+  return get_value().get_asString();
+}
+
+bool field_ref::get_asBool() const
+{
+  switch (type)
+  {
+    case ft_String:
+    {
+      const std::string_view str = get_asStringView();
+      return str == "True" || str == "true" || str == "1";
+    }
+    case ft_Int:
+    case ft_Int64:
+      return value.int64_value != 0;
+    case ft_Double:
+      return value.double_value != 0.0;
+    default:
+      return get_value().get_asBool();
+  }
+}
+
+int field_ref::get_asInt() const
+{
+  switch (type)
+  {
+    case ft_String:
+      return atoi(c_str());
+    case ft_Int:
+    case ft_Int64:
+      return static_cast<int>(value.int64_value);
+    case ft_Double:
+      return static_cast<int>(value.double_value);
+    default:
+      return get_value().get_asInt();
+  }
+}
+
+float field_ref::get_asFloat() const
+{
+  switch (type)
+  {
+    case ft_String:
+      return static_cast<float>(atof(c_str()));
+    case ft_Int:
+      return static_cast<float>(static_cast<int>(value.int64_value));
+    case ft_Int64:
+      return static_cast<float>(value.int64_value);
+    case ft_Double:
+      return static_cast<float>(value.double_value);
+    default:
+      return get_value().get_asFloat();
+  }
+}
+
+double field_ref::get_asDouble() const
+{
+  switch (type)
+  {
+    case ft_String:
+      return atof(c_str());
+    case ft_Int:
+    case ft_Int64:
+      return static_cast<double>(value.int64_value);
+    case ft_Double:
+      return value.double_value;
+    default:
+      return get_value().get_asDouble();
+  }
+}
+
+int64_t field_ref::get_asInt64() const
+{
+  switch (type)
+  {
+    case ft_String:
+      return std::atoll(c_str());
+    case ft_Int:
+    case ft_Int64:
+      return value.int64_value;
+    case ft_Double:
+      return static_cast<int64_t>(value.double_value);
+    default:
+      return get_value().get_asInt64();
+  }
+}
+
+//************* result_set ***************************
+
+void result_set::clear()
+{
+  std::vector<sql_record>().swap(records.rows);
+  record_header.clear();
+  columns.clear();
+  next_column = 0;
+  strings.clear();
+  strings_next = nullptr;
+  strings_left = 0;
+  strings_size = 0;
+}
+
+void result_set::add_row()
+{
+  if (columns.size() != record_header.size())
+    columns.resize(record_header.size());
+
+  const unsigned int row = static_cast<unsigned int>(records.rows.size());
+  records.rows.emplace_back(this, row);
+  next_column = 0;
+}
+
+void result_set::add(fType type, bool null, cell_value value)
+{
+  if (records.rows.empty() || next_column >= columns.size())
+    return;
+
+  column& c = columns[next_column++];
+  // fill values skipped in the rows before, they read as NULL
+  const std::size_t row = records.rows.size() - 1;
+  if (c.types.size() < row)
+  {
+    c.values.resize(row, cell_value{0});
+    c.types.resize(row, ft_String | NULL_FLAG);
+  }
+  c.values.push_back(value);
+  c.types.push_back(static_cast<uint8_t>(type | (null ? NULL_FLAG : 0)));
+}
+
+void result_set::add_null()
+{
+  add(ft_String, true, cell_value{0});
+}
+
+void result_set::add_int(int i)
+{
+  cell_value value;
+  value.int64_value = i;
+  add(ft_Int, false, value);
+}
+
+void result_set::add_int64(int64_t i)
+{
+  cell_value value;
+  value.int64_value = i;
+  add(ft_Int64, false, value);
+}
+
+void result_set::add_double(double d)
+{
+  cell_value value;
+  value.double_value = d;
+  add(ft_Double, false, value);
+}
+
+void result_set::add_string(const char* s, std::size_t len)
+{
+  const uint32_t len32 = static_cast<uint32_t>(len);
+  char* p = allocate(sizeof(len32) + len + 1);
+  std::memcpy(p, &len32, sizeof(len32));
+  p += sizeof(len32);
+  if (len > 0)
+    std::memcpy(p, s, len);
+  p[len] = '\0';
+
+  cell_value value;
+  value.str_value = p;
+  add(ft_String, false, value);
+}
+
+char* result_set::allocate(std::size_t size)
+{
+  // large strings get a block of their own, the current block is kept for the next ones
+  if (size > STRING_BLOCK / 4)
+  {
+    strings.emplace_back(new char[size]);
+    strings_size += size;
+    return strings.back().get();
+  }
+  if (size > strings_left)
+  {
+    strings.emplace_back(new char[STRING_BLOCK]);
+    strings_size += STRING_BLOCK;
+    strings_next = strings.back().get();
+    strings_left = STRING_BLOCK;
+  }
+  char* p = strings_next;
+  strings_next += size;
+  strings_left -= size;
+  return p;
+}
+
+std::size_t result_set::memory_used() const
+{
+  std::size_t size = strings_size + records.rows.capacity() * sizeof(sql_record);
+  for (const column& c : columns)
+    size += c.values.capacity() * sizeof(cell_value) + c.types.capacity();
+  return size;
+}
+
 } // namespace dbiplus
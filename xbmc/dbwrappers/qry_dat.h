@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace dbiplus
@@ -247,29 +251,163 @@ struct field
 };
 
 typedef std::vector<field> Fields;
-typedef std::vector<field_value> sql_record;
 typedef std::vector<field_prop> record_prop;
-typedef std::vector<sql_record*> query_data;
 typedef field_value variant;
 
+class result_set;
+
+/* Storage of a single value in a result_set. Strings live in the string arena of the result
+   set, preceded by their length. */
+union cell_value
+{
+  int64_t int64_value;
+  double double_value;
+  const char* str_value;
+};
+
+/* Read-only value of a result_set with the accessors of field_value. Strings are not copied,
+   get_asStringView returns them in place as long as the result set is not cleared. */
+class field_ref
+{
+public:
+  field_ref(fType type, bool null, cell_value value) : value(value), type(type), is_null(null) {}
+
+  fType get_fType() const { return type; }
+  bool get_isNull() const { return is_null; }
+  std::string get_asString() const;
+  std::string_view get_asStringView() const; // empty for values that are not strings
+  bool get_asBool() const;
+  char get_asChar() const { return get_value().get_asChar(); }
+  short get_asShort() const { return get_value().get_asShort(); }
+  unsigned short get_asUShort() const { return get_value().get_asUShort(); }
+  int get_asInt() const;
+  unsigned int get_asUInt() const { return get_value().get_asUInt(); }
+  float get_asFloat() const;
+  double get_asDouble() const;
+  int64_t get_asInt64() const;
+
+  field_value get_value() const; // copy of the value as field_value
+
+private:
+  const char* c_str() const { return value.str_value ? value.str_value : ""; }
+
+  cell_value value;
+  fType type;
+  bool is_null;
+};
+
+/* A row of a result_set. The values are stored per column by the result set, a record only
+   refers to them. */
+class sql_record
+{
+public:
+  sql_record(const result_set* set, unsigned int row) : set(set), row(row) {}
+
+  field_ref at(std::size_t col) const;
+  field_ref operator[](std::size_t col) const;
+  std::size_t size() const;
+
+private:
+  const result_set* set;
+  unsigned int row;
+};
+
+/* The rows of a result_set, indexed like the former vector of row pointers. */
+class query_data
+{
+public:
+  const sql_record* operator[](std::size_t row) const { return &rows[row]; }
+  const sql_record* at(std::size_t row) const { return &rows.at(row); }
+  std::size_t size() const { return rows.size(); }
+  bool empty() const { return rows.empty(); }
+
+private:
+  friend class result_set;
+  std::vector<sql_record> rows;
+};
+
+/* Result of a query, stored by column: every column keeps its values in a vector of 8 bytes
+   and a type tag per row, all strings are copied into one arena. A row is started with add_row
+   and then gets one value per column in order, missing values are NULL. */
 class result_set
 {
 public:
   result_set() = default;
-  ~result_set() { clear(); };
-  void clear()
+  result_set(const result_set&) = delete;
+  result_set& operator=(const result_set&) = delete;
+  ~result_set() = default;
+
+  void clear();
+
+  void add_row();
+  void add_null();
+  void add_int(int i);
+  void add_int64(int64_t i);
+  void add_double(double d);
+  void add_string(const char* s, std::size_t len);
+
+  field_ref get(unsigned int col, unsigned int row) const
   {
-    for (unsigned int i = 0; i < records.size(); i++)
-      if (records[i])
-        delete records[i];
-    records.clear();
-    record_header.clear();
-  };
+    const column& c = columns[col];
+    if (row >= c.types.size())
+      return field_ref(ft_String, true, cell_value{0});
+    const uint8_t tag = c.types[row];
+    return field_ref(static_cast<fType>(tag & TYPE_MASK), (tag & NULL_FLAG) != 0, c.values[row]);
+  }
+
+  std::size_t memory_used() const; // bytes allocated for the values
 
   record_prop record_header;
   query_data records;
+
+private:
+  static constexpr uint8_t NULL_FLAG = 0x80;
+  static constexpr uint8_t TYPE_MASK = 0x7f;
+  static constexpr std::size_t STRING_BLOCK = 64 * 1024;
+
+  struct column
+  {
+    std::vector<cell_value> values;
+    std::vector<uint8_t> types;
+  };
+
+  void add(fType type, bool null, cell_value value);
+  char* allocate(std::size_t size);
+
+  std::vector<column> columns;
+  unsigned int next_column = 0;
+  std::vector<std::unique_ptr<char[]>> strings;
+  char* strings_next = nullptr;
+  std::size_t strings_left = 0;
+  std::size_t strings_size = 0;
 };
 
+inline field_ref sql_record::at(std::size_t col) const
+{
+  if (col >= set->record_header.size())
+    throw std::out_of_range("sql_record::at");
+  return set->get(static_cast<unsigned int>(col), row);
+}
+
+inline field_ref sql_record::operator[](std::size_t col) const
+{
+  return set->get(static_cast<unsigned int>(col), row);
+}
+
+inline std::size_t sql_record::size() const
+{
+  return set->record_header.size();
+}
+
+inline std::string_view field_ref::get_asStringView() const
+{
+  if (type != ft_String || !value.str_value)
+    return {};
+  uint32_t len;
+  std::memcpy(&len, value.str_value - sizeof(len), sizeof(len));
+  return {value.str_value, len};
+}
+
 #ifdef TARGET_WINDOWS_STORE
 #pragma pack(pop)
 #endif
@@ -11,12 +11,16 @@
  */
 
 #include "sqlitedataset.h"
+#include "QueryProfiler.h"
 
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <sstream>
@@ -180,32 +184,226 @@ int callback(void* res_ptr, int ncol, char** result, char** cols)
 
   if (result != NULL)
   {
-    sql_record* rec = new sql_record;
-    rec->resize(ncol);
+    r->add_row();
     for (int i = 0; i < ncol; i++)
     {
-      field_value& v = rec->at(i);
       if (result[i] == NULL)
-      {
-        v.set_asString("");
-        v.set_isNull();
-      }
+        r->add_null();
       else
-      {
-        v.set_asString(result[i]);
-      }
+        r->add_string(result[i], strlen(result[i]));
     }
-    r->records.push_back(rec);
   }
   return 0;
 }
 
 static int busy_callback(void*, int busyCount)
 {
-  KODI::TIME::Sleep(100ms);
+  // writers wait for each other, poll often at first to take over right after a short commit
+  KODI::TIME::Sleep(std::chrono::milliseconds(std::min(5 << std::min(busyCount, 5), 100)));
   return 1;
 }
 
+static int journal_mode_callback(void* result, int argc, char** argv, char**)
+{
+  if (argc > 0 && argv[0])
+    *static_cast<std::string*>(result) = argv[0];
+  return 0;
+}
+
+// the plan of a query, one step per line, indented by its depth
+static std::string explain_query_plan(sqlite3* conn, const std::string& sql)
+{
+  std::string plan;
+  sqlite3_stmt* stmt = NULL;
+  if (sqlite3_prepare_v2(conn, ("EXPLAIN QUERY PLAN " + sql).c_str(), -1, &stmt, NULL) == SQLITE_OK)
+  {
+    std::map<int, size_t> depths;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      const auto parent = depths.find(sqlite3_column_int(stmt, 1));
+      const size_t depth = parent != depths.end() ? parent->second + 1 : 0;
+      depths[sqlite3_column_int(stmt, 0)] = depth;
+      const char* detail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+      plan += std::string(2 * depth, ' ') + (detail ? detail : "") + "\n";
+    }
+  }
+  sqlite3_finalize(stmt);
+  if (!plan.empty())
+    plan.pop_back();
+  return plan;
+}
+
+static void profile_query(sqlite3* conn,
+                          const std::string& sql,
+                          std::chrono::steady_clock::time_point start)
+{
+  CQueryProfiler& profiler = CQueryProfiler::GetInstance();
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  if (!profiler.Record(sql, duration))
+    return;
+
+  const size_t begin = sql.find_first_not_of(" \t\r\n(");
+  if (begin == std::string::npos)
+    return;
+  const char* statement = sql.c_str() + begin;
+  if (StringUtils::StartsWithNoCase(statement, "select") ||
+      StringUtils::StartsWithNoCase(statement, "with") ||
+      StringUtils::StartsWithNoCase(statement, "update") ||
+      StringUtils::StartsWithNoCase(statement, "delete") ||
+      StringUtils::StartsWithNoCase(statement, "insert"))
+    profiler.SetPlan(sql, explain_query_plan(conn, sql));
+}
+
+//************* SqliteStatementCache implementation *********
+
+int SqliteStatementCache::acquire(sqlite3* conn, const std::string& sql, sqlite3_stmt** stmt)
+{
+  auto it = index.find(sql);
+  if (it != index.end())
+  {
+    auto entry = it->second;
+    if (entry->in_use)
+    {
+      // used by an outer caller, compile a private copy
+      return sqlite3_prepare_v2(conn, sql.c_str(), static_cast<int>(sql.size() + 1), stmt, NULL);
+    }
+    entry->in_use = true;
+    entries.splice(entries.begin(), entries, entry);
+    *stmt = entry->stmt;
+    return SQLITE_OK;
+  }
+
+#if SQLITE_VERSION_NUMBER >= 3020000
+  int rc = sqlite3_prepare_v3(conn, sql.c_str(), static_cast<int>(sql.size() + 1),
+                              SQLITE_PREPARE_PERSISTENT, stmt, NULL);
+#else
+  int rc = sqlite3_prepare_v2(conn, sql.c_str(), static_cast<int>(sql.size() + 1), stmt, NULL);
+#endif
+  if (rc != SQLITE_OK || *stmt == NULL)
+    return rc;
+
+  entries.push_front({sql, *stmt, true});
+  index.emplace(entries.front().sql, entries.begin());
+
+  // evict the least recently used statements that are not in use
+  for (auto entry = entries.end(); entries.size() > capacity && entry != entries.begin();)
+  {
+    --entry;
+    if (!entry->in_use)
+    {
+      index.erase(entry->sql);
+      sqlite3_finalize(entry->stmt);
+      entry = entries.erase(entry);
+    }
+  }
+  return rc;
+}
+
+void SqliteStatementCache::release(const std::string& sql, sqlite3_stmt* stmt)
+{
+  if (stmt == NULL)
+    return;
+
+  auto it = index.find(sql);
+  if (it != index.end() && it->second->stmt == stmt)
+  {
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    it->second->in_use = false;
+  }
+  else
+    sqlite3_finalize(stmt);
+}
+
+void SqliteStatementCache::clear()
+{
+  // statements still in use are finalized by their owners, release() no longer finds them
+  for (const Entry& entry : entries)
+  {
+    if (!entry.in_use)
+      sqlite3_finalize(entry.stmt);
+  }
+  index.clear();
+  entries.clear();
+}
+
+//************* SqliteStatement implementation **************
+
+namespace
+{
+class SqliteStatement : public Statement
+{
+public:
+  SqliteStatement(SqliteDatabase* database, const std::string& sql, sqlite3_stmt* stmt)
+    : db(database), sql(sql), stmt(stmt)
+  {
+  }
+  ~SqliteStatement() override { db->getStatementCache().release(sql, stmt); }
+
+  void bind(int index, int value) override { check(sqlite3_bind_int(stmt, index + 1, value)); }
+  void bind(int index, int64_t value) override
+  {
+    check(sqlite3_bind_int64(stmt, index + 1, value));
+  }
+  void bind(int index, double value) override
+  {
+    check(sqlite3_bind_double(stmt, index + 1, value));
+  }
+  void bind(int index, const std::string& value) override
+  {
+    check(sqlite3_bind_text(stmt, index + 1, value.c_str(), static_cast<int>(value.size()),
+                            SQLITE_TRANSIENT));
+  }
+  void bind_null(int index) override { check(sqlite3_bind_null(stmt, index + 1)); }
+
+  bool step() override
+  {
+    const int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW)
+      return true;
+    if (rc == SQLITE_DONE)
+      return false;
+    db->setErr(rc, sql.c_str());
+    sqlite3_reset(stmt);
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+  void execute() override
+  {
+    while (step())
+      ;
+    sqlite3_reset(stmt);
+  }
+  void reset() override { sqlite3_reset(stmt); }
+
+  int column_count() override { return sqlite3_data_count(stmt); }
+  bool is_null(int column) override { return sqlite3_column_type(stmt, column) == SQLITE_NULL; }
+  int get_asInt(int column) override { return sqlite3_column_int(stmt, column); }
+  int64_t get_asInt64(int column) override { return sqlite3_column_int64(stmt, column); }
+  double get_asDouble(int column) override { return sqlite3_column_double(stmt, column); }
+  std::string get_asString(int column) override
+  {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    if (text == NULL)
+      return std::string();
+    return std::string(reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt, column));
+  }
+
+  int64_t lastinsertid() override { return sqlite3_last_insert_rowid(db->getHandle()); }
+
+private:
+  void check(int rc)
+  {
+    if (db->setErr(rc, sql.c_str()) != SQLITE_OK)
+      throw DbErrors("%s", db->getErrorMsg());
+  }
+
+  SqliteDatabase* db;
+  std::string sql;
+  sqlite3_stmt* stmt;
+};
+} // namespace
+
 //************* SqliteDatabase implementation ***************
 
 SqliteDatabase::SqliteDatabase()
@@ -318,8 +516,8 @@ int SqliteDatabase::connect(bool create)
   try
   {
     disconnect();
-    int flags = SQLITE_OPEN_READWRITE;
-    if (create)
+    int flags = read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
+    if (create && !read_only)
       flags |= SQLITE_OPEN_CREATE;
     int errorCode = sqlite3_open_v2(db_fullpath.c_str(), &conn, flags, NULL);
     if (create && errorCode == SQLITE_CANTOPEN)
@@ -336,11 +534,23 @@ int SqliteDatabase::connect(bool create)
       {
         throw DbErrors("%s", getErrorMsg());
       }
-      else if (sqlite3_db_readonly(conn, nullptr) == 1)
+      else if (!read_only && sqlite3_db_readonly(conn, nullptr) == 1)
       {
         CLog::Log(LOGFATAL, "SqliteDatabase: {} is read only", db_fullpath);
         throw std::runtime_error("SqliteDatabase: " + db_fullpath + " is read only");
       }
+      // the journal mode is stored in the database file, readers use what the writer set
+      if (!read_only && !journal_mode.empty())
+      {
+        const std::string sql = "PRAGMA journal_mode=" + journal_mode;
+        std::string mode;
+        if (setErr(sqlite3_exec(conn, sql.c_str(), journal_mode_callback, &mode, NULL),
+                   sql.c_str()) != SQLITE_OK)
+          throw DbErrors("%s", getErrorMsg());
+        if (!StringUtils::EqualsNoCase(mode, journal_mode))
+          CLog::Log(LOGWARNING, "SqliteDatabase: journal mode {} is not supported for {}, using {}",
+                    journal_mode, db_fullpath, mode);
+      }
       errorCode = sqlite3_create_collation(conn, "ALPHANUM", SQLITE_UTF8, 0, AlphaNumericCollation);
       if (errorCode != SQLITE_OK)
       {
@@ -383,7 +593,10 @@ void SqliteDatabase::disconnect(void)
 {
   if (active == false)
     return;
-  sqlite3_close(conn);
+  stmt_cache.clear();
+  query_cache.clear();
+  // the connection is closed once statements still held are finalized
+  sqlite3_close_v2(conn);
   active = false;
 }
 
@@ -571,6 +784,20 @@ void SqliteDatabase::rollback_transaction()
   }
 }
 
+std::unique_ptr<Statement> SqliteDatabase::prepareStatement(const std::string& sql)
+{
+  if (active == false)
+    throw DbErrors("Can't prepare statement: no active connection...");
+
+  sqlite3_stmt* stmt = NULL;
+  if (setErr(stmt_cache.acquire(conn, sql, &stmt), sql.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", getErrorMsg());
+  if (stmt == NULL)
+    throw DbErrors("Can't prepare statement: empty query '%s'", sql.c_str());
+
+  return std::make_unique<SqliteStatement>(this, sql, stmt);
+}
+
 // methods for formatting
 // ---------------------------------------------
 std::string SqliteDatabase::vprepare(const char* format, va_list args)
@@ -772,17 +999,14 @@ void SqliteDataset::fill_fields()
   }
 
   //Filling result
-  if (result.records.size() != 0)
+  if (frecno >= 0 && (unsigned int)frecno < result.records.size())
   {
     const sql_record* row = result.records[frecno];
-    if (row)
-    {
-      const unsigned int ncols = row->size();
-      fields_object->resize(ncols);
-      for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
-      return;
-    }
+    const unsigned int ncols = row->size();
+    fields_object->resize(ncols);
+    for (unsigned int i = 0; i < ncols; i++)
+      (*fields_object)[i].val = row->at(i).get_value();
+    return;
   }
   const unsigned int ncols = result.record_header.size();
   fields_object->resize(ncols);
@@ -847,9 +1071,14 @@ int SqliteDataset::exec(const std::string& sql)
   }
 
   char* errmsg;
+  const auto start = std::chrono::steady_clock::now();
   if ((res = db->setErr(sqlite3_exec(handle(), qry.c_str(), &callback, &exec_res, &errmsg),
                         qry.c_str())) == SQLITE_OK)
+  {
+    if (CQueryProfiler::GetInstance().IsEnabled())
+      profile_query(handle(), qry, start);
     return res;
+  }
   else
   {
     if (errmsg)
@@ -887,10 +1116,15 @@ bool SqliteDataset::query(const std::string& query)
 
   close();
 
+  const auto start = std::chrono::steady_clock::now();
+
+  // list views run the same queries again and again, keep their compiled form around
+  SqliteStatementCache& cache = static_cast<SqliteDatabase*>(db)->getQueryCache();
   sqlite3_stmt* stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(), query.c_str(), -1, &stmt, NULL), query.c_str()) !=
-      SQLITE_OK)
+  if (db->setErr(cache.acquire(handle(), query, &stmt), query.c_str()) != SQLITE_OK)
     throw DbErrors("%s", db->getErrorMsg());
+  if (stmt == NULL)
+    throw DbErrors("Empty query: '%s'", query.c_str());
 
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
@@ -899,40 +1133,40 @@ bool SqliteDataset::query(const std::string& query)
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
   // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
   { // have a row of data
-    sql_record* res = new sql_record;
-    res->resize(numColumns);
+    result.add_row();
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value& v = res->at(i);
       switch (sqlite3_column_type(stmt, i))
       {
         case SQLITE_INTEGER:
-          v.set_asInt64(sqlite3_column_int64(stmt, i));
+          result.add_int64(sqlite3_column_int64(stmt, i));
           break;
         case SQLITE_FLOAT:
-          v.set_asDouble(sqlite3_column_double(stmt, i));
+          result.add_double(sqlite3_column_double(stmt, i));
           break;
         case SQLITE_TEXT:
-          v.set_asString(reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)),
-                         sqlite3_column_bytes(stmt, i));
-          break;
         case SQLITE_BLOB:
-          v.set_asString(reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)),
-                         sqlite3_column_bytes(stmt, i));
+          result.add_string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)),
+                            sqlite3_column_bytes(stmt, i));
           break;
         case SQLITE_NULL:
         default:
-          v.set_asString("");
-          v.set_isNull();
+          result.add_null();
           break;
       }
     }
-    result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt), query.c_str()) == SQLITE_OK)
+  if (rc == SQLITE_DONE)
+    rc = SQLITE_OK;
+  db->setErr(rc, query.c_str());
+  cache.release(query, stmt);
+  if (rc == SQLITE_OK)
   {
+    if (CQueryProfiler::GetInstance().IsEnabled())
+      profile_query(handle(), query, start);
     active = true;
     ds_state = dsSelect;
     this->first();
@@ -1025,15 +1259,7 @@ void SqliteDataset::next(void)
 
 void SqliteDataset::free_row(void)
 {
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record* row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
+  // rows are stored by column in the result set and released with it
 }
 
 bool SqliteDataset::seek(int pos)
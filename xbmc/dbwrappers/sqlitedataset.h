@@ -14,12 +14,48 @@
 
 #include "dataset.h"
 
+#include <list>
 #include <stdio.h>
+#include <string_view>
+#include <unordered_map>
 
 #include <sqlite3.h>
 
 namespace dbiplus
 {
+/*************** Class SqliteStatementCache definition ***************
+
+       LRU cache of compiled statements keyed by their SQL
+
+******************************************************************/
+class SqliteStatementCache
+{
+public:
+  explicit SqliteStatementCache(size_t capacity) : capacity(capacity) {}
+  ~SqliteStatementCache() { clear(); }
+
+  /* returns a compiled statement for sql, a statement that is already in use is compiled again */
+  int acquire(sqlite3* conn, const std::string& sql, sqlite3_stmt** stmt);
+  /* resets the statement and returns it to the cache, or finalizes it if it isn't cached */
+  void release(const std::string& sql, sqlite3_stmt* stmt);
+  /* finalizes the cached statements, those in use are left to be finalized when released */
+  void clear();
+
+  size_t size() const { return entries.size(); }
+
+private:
+  struct Entry
+  {
+    std::string sql;
+    sqlite3_stmt* stmt;
+    bool in_use;
+  };
+
+  size_t capacity;
+  std::list<Entry> entries; // most recently used first
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index; // views into entries
+};
+
 /***************** Class SqliteDatabase definition ******************
 
        class 'SqliteDatabase' connects with Sqlite-server
@@ -32,6 +68,8 @@ protected:
   sqlite3* conn;
   bool _in_transaction;
   int last_err;
+  SqliteStatementCache stmt_cache{64}; // statements from prepareStatement()
+  SqliteStatementCache query_cache{16}; // dataset queries, repeated list views
 
 public:
   /* default constructor */
@@ -43,6 +81,10 @@ public:
 
   /* func. returns connection handle with SQLite-server */
   sqlite3* getHandle() { return conn; }
+  /* func. returns the cache of compiled statements */
+  SqliteStatementCache& getStatementCache() { return stmt_cache; }
+  /* func. returns the cache of compiled dataset queries */
+  SqliteStatementCache& getQueryCache() { return query_cache; }
   /* func. returns current status about SQLite-server connection */
   int status() override;
   int setErr(int err_code, const char* qry) override;
@@ -79,6 +121,8 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+  std::unique_ptr<Statement> prepareStatement(const std::string& sql) override;
+
   /* virtual methods for formatting */
   std::string vprepare(const char* format, va_list args) override;
 
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/QueryProfiler.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+TEST(TestQueryProfiler, Normalize)
+{
+  EXPECT_EQ("SELECT * FROM movie_view WHERE idMovie = ?",
+            CQueryProfiler::Normalize("SELECT * FROM movie_view WHERE idMovie = 42"));
+  EXPECT_EQ("SELECT c00 FROM movie WHERE c00 LIKE ? LIMIT ?",
+            CQueryProfiler::Normalize("SELECT c00  FROM movie\n WHERE c00 LIKE '%It''s%'\tLIMIT 10 "));
+  EXPECT_EQ("SELECT * FROM song WHERE idSong IN (?) AND rating > ?",
+            CQueryProfiler::Normalize(
+                "SELECT * FROM song WHERE idSong IN (1, 2,3, 'four') AND rating > 7.5"));
+  // numbers within names are kept
+  EXPECT_EQ("SELECT c05, idFile2 FROM files",
+            CQueryProfiler::Normalize("SELECT c05, idFile2 FROM files"));
+}
+
+class TestQueryProfilerSqlite : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    db.setDatabase("TestQueryProfiler");
+    std::remove(Path().c_str());
+    ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+
+    ds.reset(db.CreateDataset());
+    ds->exec("CREATE TABLE movie (idMovie INTEGER PRIMARY KEY, c00 TEXT, premiered TEXT)");
+    ds->exec("CREATE INDEX ix_movie ON movie (premiered)");
+
+    CQueryProfiler& profiler = CQueryProfiler::GetInstance();
+    profiler.Reset();
+    profiler.SetEnabled(true);
+    profiler.SetSlowThreshold(std::chrono::milliseconds(0));
+  }
+
+  void TearDown() override
+  {
+    CQueryProfiler& profiler = CQueryProfiler::GetInstance();
+    profiler.SetEnabled(false);
+    profiler.SetSlowThreshold(std::chrono::milliseconds(50));
+    profiler.Reset();
+
+    ds.reset();
+    db.disconnect();
+    std::remove(Path().c_str());
+  }
+
+  std::string Path() const { return std::string(db.getHostName()) + db.getDatabase(); }
+
+  SqliteDatabase db;
+  std::unique_ptr<Dataset> ds;
+};
+
+TEST_F(TestQueryProfilerSqlite, Record)
+{
+  for (int i = 0; i < 3; i++)
+  {
+    ds->exec(db.prepare("INSERT INTO movie VALUES (NULL, 'Movie %i', '2024-01-0%i')", i, i + 1));
+    ASSERT_TRUE(ds->query(db.prepare("SELECT idMovie FROM movie WHERE c00 = 'Movie %i'", i)));
+    ds->close();
+  }
+  ASSERT_TRUE(ds->query("SELECT idMovie FROM movie WHERE premiered > '2024-01-02'"));
+  ds->close();
+
+  const auto entries = CQueryProfiler::GetInstance().GetEntries();
+  ASSERT_EQ(3u, entries.size());
+
+  const CQueryProfiler::Entry* scan = nullptr;
+  const CQueryProfiler::Entry* search = nullptr;
+  const CQueryProfiler::Entry* insert = nullptr;
+  for (const auto& entry : entries)
+  {
+    if (entry.sql == "SELECT idMovie FROM movie WHERE c00 = ?")
+      scan = &entry;
+    else if (entry.sql == "SELECT idMovie FROM movie WHERE premiered > ?")
+      search = &entry;
+    else if (entry.sql == "INSERT INTO movie VALUES (NULL, ?)")
+      insert = &entry;
+  }
+
+  ASSERT_NE(nullptr, scan);
+  EXPECT_EQ(3u, scan->count);
+  unsigned int runs = 0;
+  for (unsigned int count : scan->histogram)
+    runs += count;
+  EXPECT_EQ(3u, runs);
+  EXPECT_GE(scan->total, scan->max);
+  EXPECT_NE(std::string::npos, scan->plan.find("SCAN")) << scan->plan;
+
+  ASSERT_NE(nullptr, search);
+  EXPECT_NE(std::string::npos, search->plan.find("USING COVERING INDEX ix_movie")) << search->plan;
+
+  ASSERT_NE(nullptr, insert);
+  EXPECT_EQ(3u, insert->count);
+
+  // nothing is recorded while disabled
+  CQueryProfiler::GetInstance().Reset();
+  CQueryProfiler::GetInstance().SetEnabled(false);
+  ASSERT_TRUE(ds->query("SELECT idMovie FROM movie"));
+  ds->close();
+  EXPECT_TRUE(CQueryProfiler::GetInstance().GetEntries().empty());
+}
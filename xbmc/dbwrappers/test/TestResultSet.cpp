@@ -0,0 +1,221 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+void ExpectSameConversions(const field_value& expected, const field_ref& value)
+{
+  EXPECT_EQ(expected.get_fType(), value.get_fType());
+  EXPECT_EQ(expected.get_isNull(), value.get_isNull());
+  EXPECT_EQ(expected.get_asString(), value.get_asString());
+  EXPECT_EQ(expected.get_asBool(), value.get_asBool());
+  EXPECT_EQ(expected.get_asChar(), value.get_asChar());
+  EXPECT_EQ(expected.get_asShort(), value.get_asShort());
+  EXPECT_EQ(expected.get_asUShort(), value.get_asUShort());
+  EXPECT_EQ(expected.get_asInt(), value.get_asInt());
+  EXPECT_EQ(expected.get_asUInt(), value.get_asUInt());
+  EXPECT_EQ(expected.get_asFloat(), value.get_asFloat());
+  EXPECT_EQ(expected.get_asDouble(), value.get_asDouble());
+  EXPECT_EQ(expected.get_asInt64(), value.get_asInt64());
+}
+} // namespace
+
+TEST(TestResultSet, Values)
+{
+  result_set set;
+  set.record_header.resize(6);
+  set.add_row();
+  set.add_int(-7);
+  set.add_int64(int64_t(1) << 40);
+  set.add_double(2.5);
+  set.add_string("true", 4);
+  set.add_null();
+  set.add_string("12 monkeys", 10);
+  set.add_row();
+  set.add_string("1", 1);
+  set.add_string("", 0);
+  set.add_string("-3.75", 5);
+  // the remaining values of the row are NULL
+
+  ASSERT_EQ(2u, set.records.size());
+  const sql_record* row = set.records[0];
+  ASSERT_EQ(6u, row->size());
+  EXPECT_THROW(row->at(6), std::out_of_range);
+
+  ExpectSameConversions(field_value(-7), row->at(0));
+  ExpectSameConversions(field_value(int64_t(1) << 40), row->at(1));
+  ExpectSameConversions(field_value(2.5), row->at(2));
+  ExpectSameConversions(field_value("true"), row->at(3));
+  field_value null;
+  null.set_asString("");
+  null.set_isNull();
+  ExpectSameConversions(null, row->at(4));
+  ExpectSameConversions(field_value("12 monkeys"), row->at(5));
+
+  row = set.records.at(1);
+  ExpectSameConversions(field_value("1"), row->at(0));
+  ExpectSameConversions(field_value(""), row->at(1));
+  ExpectSameConversions(field_value("-3.75"), row->at(2));
+  for (unsigned int col = 3; col < 6; col++)
+    ExpectSameConversions(null, row->at(col));
+
+  // strings are read in place
+  EXPECT_EQ("12 monkeys", set.records[0]->at(5).get_asStringView());
+  EXPECT_EQ(set.records[0]->at(5).get_asStringView().data(),
+            set.records[0]->at(5).get_asStringView().data());
+  EXPECT_TRUE(set.records[0]->at(0).get_asStringView().empty());
+
+  const std::string large(100000, 'x');
+  set.add_row();
+  set.add_string(large.data(), large.size());
+  set.add_string("after", 5);
+  EXPECT_EQ(large, set.records[2]->at(0).get_asStringView());
+  EXPECT_EQ("after", set.records[2]->at(1).get_asStringView());
+  EXPECT_EQ("12 monkeys", set.records[0]->at(5).get_asString());
+
+  set.clear();
+  EXPECT_TRUE(set.records.empty());
+  EXPECT_EQ(0u, set.memory_used());
+}
+
+class TestSqliteResultSet : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    db.setDatabase("TestSqliteResultSet");
+    std::remove(Path().c_str());
+    ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+
+    ds.reset(db.CreateDataset());
+    ds->exec("CREATE TABLE movie (idMovie INTEGER PRIMARY KEY, c00 TEXT, c01 TEXT, "
+             "rating FLOAT, playCount INTEGER, lastPlayed TEXT)");
+  }
+
+  void TearDown() override
+  {
+    ds.reset();
+    db.disconnect();
+    std::remove(Path().c_str());
+  }
+
+  std::string Path() const { return std::string(db.getHostName()) + db.getDatabase(); }
+
+  SqliteDatabase db;
+  std::unique_ptr<Dataset> ds;
+};
+
+TEST_F(TestSqliteResultSet, Query)
+{
+  ds->exec("INSERT INTO movie VALUES (1, 'Alien', 'In space no one can hear you scream.', 8.5, "
+           "2, NULL)");
+  ds->exec("INSERT INTO movie VALUES (2, 'Heat', '', 8.25, NULL, '2024-01-01 10:00:00')");
+
+  ASSERT_TRUE(ds->query("SELECT * FROM movie ORDER BY idMovie"));
+  ASSERT_EQ(2, ds->num_rows());
+  const result_set& set = ds->get_result_set();
+  ASSERT_EQ(6u, set.record_header.size());
+  EXPECT_EQ("c01", set.record_header[2].name);
+
+  const sql_record* row = ds->get_sql_record();
+  EXPECT_EQ(ft_Int64, row->at(0).get_fType());
+  EXPECT_EQ(1, row->at(0).get_asInt());
+  EXPECT_EQ("Alien", row->at(1).get_asStringView());
+  EXPECT_EQ("In space no one can hear you scream.", row->at(2).get_asString());
+  EXPECT_DOUBLE_EQ(8.5, row->at(3).get_asDouble());
+  EXPECT_TRUE(row->at(5).get_isNull());
+  EXPECT_EQ("", row->at(5).get_asString());
+
+  // fields of the current row are still copied for fv()
+  EXPECT_EQ("Alien", ds->fv("c00").get_asString());
+  EXPECT_EQ(2, ds->fv("playCount").get_asInt());
+  ds->next();
+  EXPECT_EQ("Heat", ds->fv("c00").get_asString());
+  EXPECT_TRUE(ds->fv("playCount").get_isNull());
+  EXPECT_EQ("2024-01-01 10:00:00", ds->get_sql_record()->at(5).get_asString());
+  EXPECT_EQ("Heat", set.records[1]->at(1).get_asString());
+  ds->close();
+
+  // results of exec() are text only
+  ASSERT_EQ(0, ds->exec("SELECT idMovie, lastPlayed FROM movie ORDER BY idMovie"));
+  ASSERT_TRUE(db.exists());
+}
+
+// the time to query and scan rows and the memory they use, run with
+// --gtest_also_run_disabled_tests
+TEST_F(TestSqliteResultSet, DISABLED_Benchmark)
+{
+  constexpr int MOVIES = 20000;
+  int expectedPlayCount = 0;
+  db.start_transaction();
+  for (int i = 0; i < MOVIES; ++i)
+  {
+    expectedPlayCount += i % 3;
+    ds->exec(db.prepare("INSERT INTO movie VALUES (NULL, '%s', '%s', %f, %i, NULL)",
+                        ("Movie title number " + std::to_string(i)).c_str(),
+                        "A plot that is long enough to not fit into a short string buffer",
+                        i % 100 / 10.0, i % 3));
+  }
+  db.commit_transaction();
+
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(ds->query("SELECT * FROM movie"));
+  const double querySeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const result_set& set = ds->get_result_set();
+  ASSERT_EQ(static_cast<size_t>(MOVIES), set.records.size());
+
+  start = std::chrono::steady_clock::now();
+  size_t titleBytes = 0;
+  int playCount = 0;
+  for (size_t i = 0; i < set.records.size(); i++)
+  {
+    const sql_record* row = set.records[i];
+    titleBytes += row->at(1).get_asStringView().size();
+    playCount += row->at(4).get_asInt();
+  }
+  const double scanSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_GT(titleBytes, 0u);
+  EXPECT_EQ(expectedPlayCount, playCount);
+
+  // the same rows as one field_value per value
+  size_t rowBytes = 0;
+  for (size_t i = 0; i < set.records.size(); i++)
+  {
+    const sql_record* row = set.records[i];
+    rowBytes += sizeof(std::vector<field_value>*) + sizeof(std::vector<field_value>) +
+                row->size() * sizeof(field_value);
+    for (size_t col = 0; col < row->size(); col++)
+    {
+      // strings that do not fit the small string buffer are allocated
+      const size_t len = row->at(col).get_asStringView().size();
+      if (len >= sizeof(std::string))
+        rowBytes += len + 1;
+    }
+  }
+
+  RecordProperty("query_ms", static_cast<int>(querySeconds * 1000));
+  RecordProperty("scan_ms", static_cast<int>(scanSeconds * 1000));
+  RecordProperty("column_kib", static_cast<int>(set.memory_used() / 1024));
+  RecordProperty("row_kib", static_cast<int>(rowBytes / 1024));
+}
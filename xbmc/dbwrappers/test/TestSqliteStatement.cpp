@@ -0,0 +1,218 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+class TestSqliteStatement : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    db.setDatabase("TestSqliteStatement");
+    std::remove(Path().c_str());
+    ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+
+    ds.reset(db.CreateDataset());
+    ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT, iTrack INTEGER, "
+             "rating FLOAT, strMood TEXT)");
+  }
+
+  void TearDown() override
+  {
+    ds.reset();
+    db.disconnect();
+    std::remove(Path().c_str());
+  }
+
+  std::string Path() const { return std::string(db.getHostName()) + db.getDatabase(); }
+
+  SqliteDatabase db;
+  std::unique_ptr<Dataset> ds;
+};
+
+TEST_F(TestSqliteStatement, BindAndRead)
+{
+  auto insert = db.prepareStatement(
+      "INSERT INTO song (idSong, strTitle, iTrack, rating, strMood) VALUES (NULL, ?, ?, ?, ?)");
+  insert->bind(0, std::string("It's a 'quote'?"));
+  insert->bind(1, 3);
+  insert->bind(2, 7.5);
+  insert->bind_null(3);
+  insert->execute();
+  EXPECT_EQ(1, insert->lastinsertid());
+
+  insert->bind(0, std::string("second"));
+  insert->bind(1, int64_t(1) << 40);
+  insert->bind(3, std::string("calm"));
+  insert->execute();
+  EXPECT_EQ(2, insert->lastinsertid());
+
+  auto select = db.prepareStatement("SELECT strTitle, iTrack, rating, strMood FROM song "
+                                    "WHERE iTrack >= ? ORDER BY idSong");
+  select->bind(0, 0);
+  ASSERT_TRUE(select->step());
+  EXPECT_EQ(4, select->column_count());
+  EXPECT_EQ("It's a 'quote'?", select->get_asString(0));
+  EXPECT_EQ(3, select->get_asInt(1));
+  EXPECT_DOUBLE_EQ(7.5, select->get_asDouble(2));
+  EXPECT_TRUE(select->is_null(3));
+  EXPECT_EQ("", select->get_asString(3));
+  ASSERT_TRUE(select->step());
+  EXPECT_EQ(int64_t(1) << 40, select->get_asInt64(1));
+  EXPECT_EQ("calm", select->get_asString(3));
+  EXPECT_FALSE(select->step());
+
+  // bindings are kept over a reset
+  select->reset();
+  ASSERT_TRUE(select->step());
+  EXPECT_EQ(3, select->get_asInt(1));
+
+  // errors are reported as with datasets
+  EXPECT_THROW(db.prepareStatement("SELECT nothing FROM nowhere"), DbErrors);
+  auto duplicate = db.prepareStatement("INSERT INTO song (idSong) VALUES (?)");
+  duplicate->bind(0, 1);
+  EXPECT_THROW(duplicate->execute(), DbErrors);
+}
+
+TEST_F(TestSqliteStatement, Cache)
+{
+  const std::string sql = "SELECT strTitle FROM song WHERE idSong=?";
+  EXPECT_EQ(0u, db.getStatementCache().size());
+  ds->exec("INSERT INTO song (idSong, strTitle) VALUES (1, 'one'), (2, 'two')");
+
+  {
+    auto outer = db.prepareStatement(sql);
+    outer->bind(0, 1);
+    ASSERT_TRUE(outer->step());
+
+    // the cached statement is busy, a nested use gets its own copy
+    auto inner = db.prepareStatement(sql);
+    inner->bind(0, 2);
+    ASSERT_TRUE(inner->step());
+    EXPECT_EQ("two", inner->get_asString(0));
+    EXPECT_EQ("one", outer->get_asString(0));
+  }
+  EXPECT_EQ(1u, db.getStatementCache().size());
+
+  // a returned statement is reset and its bindings are cleared
+  {
+    auto stmt = db.prepareStatement(sql);
+    EXPECT_FALSE(stmt->step());
+  }
+  EXPECT_EQ(1u, db.getStatementCache().size());
+
+  for (int i = 0; i < 200; ++i)
+    db.prepareStatement("SELECT " + std::to_string(i));
+  EXPECT_EQ(64u, db.getStatementCache().size());
+
+  // dataset queries use their own cache
+  ASSERT_TRUE(ds->query("SELECT strTitle FROM song ORDER BY idSong"));
+  EXPECT_EQ(2, ds->num_rows());
+  EXPECT_EQ("one", ds->fv(0).get_asString());
+  ds->close();
+  ASSERT_TRUE(ds->query("SELECT strTitle FROM song ORDER BY idSong"));
+  EXPECT_EQ(2, ds->num_rows());
+  ds->close();
+  EXPECT_EQ(1u, db.getQueryCache().size());
+}
+
+TEST_F(TestSqliteStatement, HeldAcrossDisconnect)
+{
+  ds->exec("INSERT INTO song (idSong, strTitle) VALUES (1, 'one')");
+  auto stmt = db.prepareStatement("SELECT strTitle FROM song WHERE idSong=?");
+  stmt->bind(0, 1);
+  ASSERT_TRUE(stmt->step());
+
+  // the held statement is left to its owner, which finalizes it once
+  ds.reset();
+  db.disconnect();
+  EXPECT_EQ(0u, db.getStatementCache().size());
+  EXPECT_EQ("one", stmt->get_asString(0));
+  stmt.reset();
+
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(false));
+  ds.reset(db.CreateDataset());
+  stmt = db.prepareStatement("SELECT strTitle FROM song WHERE idSong=?");
+  stmt->bind(0, 1);
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ("one", stmt->get_asString(0));
+}
+
+TEST_F(TestSqliteStatement, TextFallback)
+{
+  // the generic implementation used by backends without native statements
+  auto insert = db.Database::prepareStatement(
+      "INSERT INTO song (idSong, strTitle, iTrack, rating, strMood) VALUES (NULL, ?, ?, ?, '?')");
+  insert->bind(0, std::string("It's"));
+  insert->bind(1, 5);
+  insert->bind(2, 0.1);
+  insert->execute();
+  EXPECT_EQ(1, insert->lastinsertid());
+
+  auto select = db.Database::prepareStatement(
+      "SELECT strTitle, iTrack, rating, strMood FROM song WHERE strTitle=?");
+  select->bind(0, std::string("It's"));
+  ASSERT_TRUE(select->step());
+  EXPECT_EQ("It's", select->get_asString(0));
+  EXPECT_EQ(5, select->get_asInt(1));
+  EXPECT_DOUBLE_EQ(0.1, select->get_asDouble(2));
+  EXPECT_EQ("?", select->get_asString(3));
+  EXPECT_FALSE(select->step());
+}
+
+// the time to insert and look up rows, run with --gtest_also_run_disabled_tests
+TEST_F(TestSqliteStatement, DISABLED_Benchmark)
+{
+  constexpr int SONGS = 20000;
+  ds->exec("CREATE INDEX ix_song ON song (strTitle)");
+
+  auto start = std::chrono::steady_clock::now();
+  db.start_transaction();
+  for (int i = 0; i < SONGS; ++i)
+  {
+    ds->exec(db.prepare("INSERT INTO song (idSong, strTitle, iTrack) VALUES (NULL, '%s', %i)",
+                        ("title " + std::to_string(i)).c_str(), i));
+    ds->query(db.prepare("SELECT idSong FROM song WHERE strTitle='%s'",
+                         ("title " + std::to_string(i)).c_str()));
+    ds->close();
+  }
+  db.rollback_transaction();
+  const double textSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  db.start_transaction();
+  for (int i = 0; i < SONGS; ++i)
+  {
+    auto insert =
+        db.prepareStatement("INSERT INTO song (idSong, strTitle, iTrack) VALUES (NULL, ?, ?)");
+    insert->bind(0, "title " + std::to_string(i));
+    insert->bind(1, i);
+    insert->execute();
+    auto select = db.prepareStatement("SELECT idSong FROM song WHERE strTitle=?");
+    select->bind(0, "title " + std::to_string(i));
+    ASSERT_TRUE(select->step());
+  }
+  db.commit_transaction();
+  const double statementSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  RecordProperty("text_query_ms", static_cast<int>(textSeconds * 1000));
+  RecordProperty("statement_ms", static_cast<int>(statementSeconds * 1000));
+}
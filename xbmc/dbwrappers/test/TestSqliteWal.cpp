@@ -0,0 +1,243 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+class CTestDatabase : public CDatabase
+{
+public:
+  static DatabaseSettings GetSettings()
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    return settings;
+  }
+
+  static std::string GetPath(const char* suffix = "")
+  {
+    return GetSettings().host + "TestSqliteWalPool.db" + suffix;
+  }
+
+  bool Connect(bool create)
+  {
+    return CDatabase::Connect("TestSqliteWalPool", GetSettings(), create);
+  }
+
+  void AddSong(const std::string& title)
+  {
+    m_pDS->exec(PrepareSQL("INSERT INTO song (idSong, strTitle) VALUES (NULL, '%s')",
+                           title.c_str()));
+  }
+
+  //! the number of songs read on the dataset for listings, -1 if they can't be read
+  int CountSongs()
+  {
+    const auto& ds = GetReadDataset();
+    if (!ds->query("SELECT COUNT(1) FROM song"))
+      return -1;
+    const int count = ds->fv(0).get_asInt();
+    ds->close();
+    return count;
+  }
+
+  bool ReadsOnWriter() { return &GetReadDataset() == &m_pDS; }
+
+  const std::unique_ptr<Dataset>& ReadDataset() { return GetReadDataset(); }
+
+protected:
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT)");
+  }
+  void CreateAnalytics() override {}
+  int GetSchemaVersion() const override { return 1; }
+  const char* GetBaseDBName() const override { return "TestSqliteWalPool"; }
+};
+} // namespace
+
+class TestSqliteWal : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    writer.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    writer.setDatabase("TestSqliteWal");
+    writer.setJournalMode("wal");
+    RemoveFiles();
+    ASSERT_EQ(DB_CONNECTION_OK, writer.connect(true));
+
+    writerDS.reset(writer.CreateDataset());
+    writerDS->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT)");
+    writerDS->exec("INSERT INTO song (idSong, strTitle) VALUES (NULL, 'first')");
+
+    reader.setHostName(writer.getHostName());
+    reader.setDatabase(writer.getDatabase());
+    reader.setReadOnly(true);
+    ASSERT_EQ(DB_CONNECTION_OK, reader.connect(false));
+    readerDS.reset(reader.CreateDataset());
+  }
+
+  void TearDown() override
+  {
+    readerDS.reset();
+    reader.disconnect();
+    writerDS.reset();
+    writer.disconnect();
+    RemoveFiles();
+  }
+
+  void RemoveFiles() const
+  {
+    const std::string path = std::string(writer.getHostName()) + writer.getDatabase();
+    for (const char* suffix : {"", "-wal", "-shm"})
+      std::remove((path + suffix).c_str());
+  }
+
+  int CountSongs()
+  {
+    if (!readerDS->query("SELECT COUNT(1) FROM song"))
+      return -1;
+    const int count = readerDS->fv(0).get_asInt();
+    readerDS->close();
+    return count;
+  }
+
+  SqliteDatabase writer;
+  SqliteDatabase reader;
+  std::unique_ptr<Dataset> writerDS;
+  std::unique_ptr<Dataset> readerDS;
+};
+
+TEST_F(TestSqliteWal, ReadDuringWrite)
+{
+  ASSERT_TRUE(writerDS->query("SELECT journal_mode FROM pragma_journal_mode"));
+  EXPECT_EQ("wal", writerDS->fv(0).get_asString());
+  writerDS->close();
+
+  // the reader sees the last commit while the writer holds the database exclusively
+  writerDS->exec("BEGIN EXCLUSIVE");
+  writerDS->exec("INSERT INTO song (idSong, strTitle) VALUES (NULL, 'second')");
+  EXPECT_EQ(1, CountSongs());
+  writerDS->exec("COMMIT");
+  EXPECT_EQ(2, CountSongs());
+
+  // the reader can not write
+  EXPECT_THROW(readerDS->exec("INSERT INTO song (idSong, strTitle) VALUES (NULL, 'third')"),
+               DbErrors);
+}
+
+TEST_F(TestSqliteWal, ReadDuringCommits)
+{
+  constexpr int BATCHES = 20;
+  constexpr int BATCH_SIZE = 50;
+  std::atomic<bool> writing{true};
+
+  std::thread scanner(
+      [&]
+      {
+        for (int batch = 0; batch < BATCHES; ++batch)
+        {
+          writer.start_transaction();
+          for (int i = 0; i < BATCH_SIZE; ++i)
+            writerDS->exec(writer.prepare("INSERT INTO song (idSong, strTitle) VALUES (NULL, '%s')",
+                                          ("title " + std::to_string(i)).c_str()));
+          writer.commit_transaction();
+        }
+        writing = false;
+      });
+
+  int last = 1;
+  do
+  {
+    // only whole batches are seen, and never fewer than before
+    const int count = CountSongs();
+    EXPECT_EQ(1, count % BATCH_SIZE);
+    EXPECT_GE(count, last);
+    last = count;
+  } while (writing);
+  scanner.join();
+  EXPECT_EQ(1 + BATCHES * BATCH_SIZE, CountSongs());
+}
+
+TEST(TestSqliteWalPool, GetReadDataset)
+{
+  for (const char* suffix : {"", "-wal", "-shm"})
+    std::remove(CTestDatabase::GetPath(suffix).c_str());
+
+  CTestDatabase writer;
+  ASSERT_TRUE(writer.Connect(true));
+  writer.AddSong("first");
+
+  // a scan writing in a transaction reads its own writes on the writer connection
+  writer.BeginTransaction();
+  writer.AddSong("second");
+  EXPECT_TRUE(writer.ReadsOnWriter());
+  EXPECT_EQ(2, writer.CountSongs());
+
+  // while listings on other threads read the last commit on read-only connections of the pool
+  std::vector<int> counts(2, 0);
+  std::vector<char> onWriter(2, true);
+  std::vector<char> readOnly(2, false);
+  std::vector<std::thread> listings;
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    listings.emplace_back(
+        [&counts, &onWriter, &readOnly, i]
+        {
+          CTestDatabase reader;
+          if (!reader.Connect(false))
+            return;
+          onWriter[i] = reader.ReadsOnWriter();
+          for (int read = 0; read < 10; ++read)
+            counts[i] = reader.CountSongs();
+          try
+          {
+            reader.ReadDataset()->exec("INSERT INTO song (idSong, strTitle) VALUES (NULL, 'x')");
+          }
+          catch (const DbErrors&)
+          {
+            readOnly[i] = true;
+          }
+          reader.Close();
+        });
+  }
+  for (auto& listing : listings)
+    listing.join();
+
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    EXPECT_FALSE(onWriter[i]) << "listing " << i;
+    EXPECT_TRUE(readOnly[i]) << "listing " << i;
+    EXPECT_EQ(1, counts[i]) << "listing " << i;
+  }
+
+  writer.CommitTransaction();
+  EXPECT_FALSE(writer.ReadsOnWriter());
+  EXPECT_EQ(2, writer.CountSongs());
+  writer.Close();
+
+  for (const char* suffix : {"", "-wal", "-shm"})
+    std::remove(CTestDatabase::GetPath(suffix).c_str());
+}
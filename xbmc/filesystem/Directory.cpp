@@ -9,10 +9,12 @@
 #include "Directory.h"
 
 #include "DirectoryCache.h"
+#include "DirectoryChecker.h"
 #include "DirectoryFactory.h"
 #include "FileDirectoryFactory.h"
 #include "FileItem.h"
 #include "PasswordManager.h"
+#include "PersistentDirectoryCache.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "commons/Exception.h"
@@ -181,6 +183,22 @@ bool CDirectory::GetDirectory(const CURL& url,
       bool result = false;
       CURL authUrl = realURL;
 
+      // check the listing kept on disk, as long as the directory did not change since. Listings
+      // with explicit credentials are not kept as they would be stored with their items.
+      const bool persistent = !(hints.flags & DIR_FLAG_BYPASS_CACHE) &&
+                              g_persistentDirectoryCache.IsEnabled() &&
+                              realURL.GetUserName().empty() &&
+                              CPersistentDirectoryCache::IsCacheable(realURL.Get());
+      int64_t mtime = 0;
+      if (persistent)
+      {
+        mtime = CDirectoryChecker::GetMTime(realURL.Get());
+        result = g_persistentDirectoryCache.GetDirectory(realURL.Get(), hints.flags, mtime, items);
+        if (result)
+          items.SetURL(url);
+      }
+      const bool listed = !result;
+
       while (!result)
       {
         const std::string pathToUrl(url.Get());
@@ -247,6 +265,9 @@ bool CDirectory::GetDirectory(const CURL& url,
         }
       }
 
+      if (persistent && listed)
+        g_persistentDirectoryCache.SetDirectory(realURL.Get(), hints.flags, mtime, items);
+
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
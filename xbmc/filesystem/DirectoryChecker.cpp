@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryChecker.h"
+
+#include "FileItem.h"
+#include "URL.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+
+using namespace XFILE;
+using namespace std::chrono_literals;
+
+bool CDirectoryChecker::Check(
+    std::vector<Directory>& directories,
+    const std::function<bool(size_t checked, size_t total)>& progress /* = {} */) const
+{
+  // the directories of each server, local ones share the empty host name
+  std::map<std::string, std::vector<size_t>> servers;
+  for (size_t i = 0; i < directories.size(); i++)
+  {
+    const CURL url(directories[i].path);
+    servers[url.GetProtocol() + "://" + url.GetHostName()].push_back(i);
+  }
+
+  std::atomic<size_t> checked{0};
+  std::atomic<bool> canceled{false};
+  std::vector<std::future<void>> tasks;
+  for (const auto& server : servers)
+  {
+    const std::vector<size_t>& indexes = server.second;
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+    const size_t workers = std::min<size_t>(std::max(m_perServer, 1u), indexes.size());
+    for (size_t worker = 0; worker < workers; worker++)
+    {
+      tasks.push_back(std::async(std::launch::async,
+                                 [&directories, &indexes, &checked, &canceled, next]()
+                                 {
+                                   size_t n;
+                                   while (!canceled && (n = (*next)++) < indexes.size())
+                                   {
+                                     CheckDirectory(directories[indexes[n]]);
+                                     checked++;
+                                   }
+                                 }));
+    }
+  }
+
+  for (auto& task : tasks)
+  {
+    while (task.wait_for(100ms) != std::future_status::ready)
+    {
+      if (progress && !canceled && !progress(checked, directories.size()))
+        canceled = true;
+    }
+  }
+  return !canceled;
+}
+
+bool CDirectoryChecker::Exists(const Directory& directory, const std::string& file)
+{
+  if (directory.unchanged)
+    return true;
+  if (!directory.listed)
+    return false;
+  return directory.files.find(file) != directory.files.end() || CFile::Exists(file, true);
+}
+
+int64_t CDirectoryChecker::GetMTime(const std::string& path)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(path, &buffer) != 0)
+    return 0;
+  return buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+}
+
+void CDirectoryChecker::CheckDirectory(Directory& directory)
+{
+  directory.mtime = GetMTime(directory.path);
+  if (directory.mtime != 0 && directory.mtime == directory.knownMTime)
+  {
+    directory.unchanged = true;
+    return;
+  }
+
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(directory.path, items, "",
+                                DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO))
+    return;
+
+  directory.listed = true;
+  for (const auto& item : items)
+    directory.files.insert(item->GetPath());
+}
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+/*!
+ \brief Checks which files of the library directories still exist while touching each directory
+ at most twice, with a stat and a listing. A directory whose modification time is the one
+ recorded at a recent check is trusted without listing it, removing a file changes the time.
+
+ Directories are checked in parallel, with a bounded number at a time per server so network
+ shares are not flooded.
+ */
+class CDirectoryChecker
+{
+public:
+  struct Directory
+  {
+    std::string path;
+    int64_t knownMTime = 0; ///< modification time at the last check, 0 if not checked recently
+
+    int64_t mtime = 0; ///< modification time now, 0 if it can not be read
+    bool unchanged = false; ///< modified at knownMTime, the files were not listed
+    bool listed = false; ///< the files were listed
+    std::set<std::string> files; ///< paths of the listed files
+  };
+
+  explicit CDirectoryChecker(unsigned int perServer = 4) : m_perServer(perServer) {}
+
+  /*!
+   \brief Check the directories.
+   \param directories [in/out] the directories to check
+   \param progress called on the calling thread with the number of checked directories, returns
+   false to cancel
+   \return false if canceled, true otherwise
+   */
+  bool Check(std::vector<Directory>& directories,
+             const std::function<bool(size_t checked, size_t total)>& progress = {}) const;
+
+  /*!
+   \brief Whether a file of a checked directory exists. The files of unchanged directories are
+   assumed to exist, missing files of listed directories are checked on their own as the paths
+   of a listing may be spelled differently.
+   */
+  static bool Exists(const Directory& directory, const std::string& file);
+
+  /*!
+   \brief Get the modification time of a directory, 0 if it can not be read.
+   */
+  static int64_t GetMTime(const std::string& path);
+
+private:
+  static void CheckDirectory(Directory& directory);
+
+  unsigned int m_perServer;
+};
+} // namespace XFILE
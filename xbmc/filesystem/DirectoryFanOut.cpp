@@ -0,0 +1,214 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryFanOut.h"
+
+#include "PathTaskQueue.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "utils/log.h"
+
+#include <mutex>
+
+using namespace XFILE;
+using namespace std::chrono_literals;
+
+namespace
+{
+//! Whether the current thread is one of the workers
+thread_local bool isWorker = false;
+
+struct SState
+{
+  using Clock = std::chrono::steady_clock;
+
+  explicit SState(size_t count)
+    : started(count), running(count), done(count), givenUp(count), lastDone(Clock::now())
+  {
+  }
+
+  CCriticalSection critSection;
+  XbmcThreads::ConditionVariable changed;
+  std::vector<Clock::time_point> started;
+  std::vector<char> running;
+  std::vector<char> done;
+  std::vector<char> givenUp;
+  Clock::time_point lastDone; ///< when a task last completed
+};
+
+CPathTaskQueue& GetQueue()
+{
+  // never destroyed, so exiting does not wait for workers blocked by a server that does not
+  // respond: CDirectoryFanOut::Stop() ends the others
+  static CPathTaskQueue* queue = []()
+  {
+    const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+    if (!settingsComponent)
+      return new CPathTaskQueue(8, 2);
+    const auto advancedSettings = settingsComponent->GetAdvancedSettings();
+    return new CPathTaskQueue(advancedSettings->m_iDirectoryFanOutWorkers,
+                              advancedSettings->m_iDirectoryFanOutWorkersPerHost);
+  }();
+  return *queue;
+}
+} // namespace
+
+std::vector<std::shared_ptr<CDirectoryFanOut::Listing>> CDirectoryFanOut::GetDirectories(
+    const std::vector<std::string>& paths,
+    const CDirectory::CHints& hints,
+    std::chrono::milliseconds timeout,
+    const std::function<void(size_t)>& progress /* = nullptr */)
+{
+  // the listings are shared with the workers, which may still list the ones left out
+  auto listings = std::make_shared<std::vector<std::shared_ptr<Listing>>>();
+  for (size_t i = 0; i < paths.size(); i++)
+    listings->push_back(std::make_shared<Listing>());
+
+  const std::vector<bool> completed = Run(
+      paths,
+      [listings, paths, hints](size_t i)
+      {
+        Listing& listing = *(*listings)[i];
+        listing.listed = CDirectory::GetDirectory(paths[i], listing.items, hints);
+      },
+      timeout, progress);
+
+  std::vector<std::shared_ptr<Listing>> result;
+  for (size_t i = 0; i < paths.size(); i++)
+  {
+    if (completed[i])
+      result.push_back((*listings)[i]);
+    else
+    {
+      auto listing = std::make_shared<Listing>();
+      listing->timedOut = true;
+      result.push_back(std::move(listing));
+    }
+  }
+  return result;
+}
+
+std::vector<bool> CDirectoryFanOut::Exists(const std::vector<std::string>& paths,
+                                           std::chrono::milliseconds timeout)
+{
+  auto exists = std::make_shared<std::vector<char>>(paths.size());
+  const std::vector<bool> completed = Run(
+      paths, [exists, paths](size_t i) { (*exists)[i] = CDirectory::Exists(paths[i]); }, timeout);
+
+  std::vector<bool> result;
+  for (size_t i = 0; i < paths.size(); i++)
+    result.push_back(completed[i] && (*exists)[i]);
+  return result;
+}
+
+std::vector<bool> CDirectoryFanOut::Run(const std::vector<std::string>& paths,
+                                        const std::function<void(size_t)>& task,
+                                        std::chrono::milliseconds timeout,
+                                        const std::function<void(size_t)>& progress /* = nullptr */)
+{
+  // a single path gains nothing from the workers, and workers waiting for the others could
+  // leave none to run the tasks
+  if (paths.size() < 2 || isWorker)
+  {
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+      task(i);
+      if (progress)
+        progress(i + 1);
+    }
+    return std::vector<bool>(paths.size(), true);
+  }
+
+  auto state = std::make_shared<SState>(paths.size());
+  CPathTaskQueue& queue = GetQueue();
+  for (size_t i = 0; i < paths.size(); i++)
+  {
+    auto run = [state, task, i]()
+    {
+      {
+        std::unique_lock<CCriticalSection> lock(state->critSection);
+        if (state->givenUp[i])
+          return;
+        state->started[i] = SState::Clock::now();
+        state->running[i] = true;
+      }
+
+      isWorker = true;
+      task(i);
+      isWorker = false;
+
+      std::unique_lock<CCriticalSection> lock(state->critSection);
+      state->done[i] = true;
+      state->lastDone = SState::Clock::now();
+      state->changed.notifyAll();
+    };
+
+    // the queue is stopped on exit
+    if (!queue.Add(paths[i], std::move(run)))
+    {
+      std::unique_lock<CCriticalSection> lock(state->critSection);
+      state->givenUp[i] = true;
+    }
+  }
+
+  std::unique_lock<CCriticalSection> lock(state->critSection);
+  while (true)
+  {
+    const auto now = SState::Clock::now();
+    size_t finished = 0;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+      if (state->done[i] || state->givenUp[i])
+      {
+        finished++;
+        continue;
+      }
+
+      // paths waiting for a worker are left out once the others stopped completing
+      const auto since = state->running[i] ? state->started[i] : state->lastDone;
+      if (now - since >= timeout)
+      {
+        CLog::Log(LOGWARNING, "CDirectoryFanOut::{} - leaving out {}, it took too long",
+                  __FUNCTION__, CURL::GetRedacted(paths[i]));
+        state->givenUp[i] = true;
+        finished++;
+      }
+    }
+
+    if (progress)
+    {
+      lock.unlock();
+      progress(finished);
+      lock.lock();
+    }
+    if (finished == paths.size())
+      break;
+
+    state->changed.wait(lock, 100ms);
+  }
+
+  std::vector<bool> completed;
+  for (size_t i = 0; i < paths.size(); i++)
+    completed.push_back(state->done[i] && !state->givenUp[i]);
+  return completed;
+}
+
+std::chrono::milliseconds CDirectoryFanOut::GetTimeout()
+{
+  return std::chrono::seconds(
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iDirectoryFanOutTimeout);
+}
+
+void CDirectoryFanOut::Stop()
+{
+  GetQueue().Stop();
+}
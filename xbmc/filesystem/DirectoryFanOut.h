@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+/*!
+ \brief Accesses several paths at a time, so the latency of their servers does not add up path
+ after path.
+
+ The paths are accessed on a pool of workers shared by all callers, with a bounded number of paths
+ of one server at a time. A path that takes longer than the timeout is left out, the others are
+ still returned. Paths accessed from the workers themselves, like sources of sources, are accessed
+ in turn on the calling worker.
+ */
+class CDirectoryFanOut
+{
+public:
+  struct Listing
+  {
+    CFileItemList items;
+    bool listed = false; ///< whether the directory was listed
+    bool timedOut = false; ///< whether the directory was left out as it took too long
+  };
+
+  /*!
+   \brief List directories.
+   \param paths the directories
+   \param hints the mask and flags the directories are listed with
+   \param timeout the time a directory is waited for once listing it started, or while no other
+   directory is listed before it started
+   \param progress called on the calling thread while waiting, with the number of paths done
+   \return the listings, in the order of the paths
+   */
+  static std::vector<std::shared_ptr<Listing>> GetDirectories(
+      const std::vector<std::string>& paths,
+      const CDirectory::CHints& hints,
+      std::chrono::milliseconds timeout,
+      const std::function<void(size_t)>& progress = nullptr);
+
+  /*!
+   \brief Check whether directories exist.
+   \return whether each directory exists, false for those that took too long
+   */
+  static std::vector<bool> Exists(const std::vector<std::string>& paths,
+                                  std::chrono::milliseconds timeout);
+
+  /*!
+   \brief Run a task per path.
+   \param paths the paths, the task of a path runs with the other tasks of its server
+   \param task the task, called with the index of the path. Tasks left out may still run after
+   this returned, they must not refer to the caller's variables.
+   \param timeout the time a task is waited for once it started, or while no other task completes
+   before it started
+   \param progress called on the calling thread while waiting, with the number of tasks done
+   \return whether each task completed in time
+   */
+  static std::vector<bool> Run(const std::vector<std::string>& paths,
+                               const std::function<void(size_t)>& task,
+                               std::chrono::milliseconds timeout,
+                               const std::function<void(size_t)>& progress = nullptr);
+
+  //! Get the time a path is waited for, as set in the advanced settings
+  static std::chrono::milliseconds GetTimeout();
+
+  /*!
+   \brief Stop accessing paths, on exit. The tasks not started are left out, the running ones
+   are not waited for as they may be blocked by a server that does not respond.
+   */
+  static void Stop();
+};
+} // namespace XFILE
@@ -0,0 +1,224 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryWatcher.h"
+
+#include "utils/log.h"
+
+#include <vector>
+
+#if defined(HAVE_INOTIFY)
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#endif
+
+using namespace XFILE;
+
+#if defined(HAVE_INOTIFY)
+namespace
+{
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM |
+                                IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+}
+#endif
+
+CDirectoryWatcher::CDirectoryWatcher() = default;
+
+CDirectoryWatcher::~CDirectoryWatcher()
+{
+  Clear();
+}
+
+bool CDirectoryWatcher::IsSupported(const std::string& path)
+{
+#if defined(HAVE_INOTIFY)
+  // local paths only, network shares are not notified of the changes made by other clients
+  return !path.empty() && path[0] == '/';
+#else
+  return false;
+#endif
+}
+
+bool CDirectoryWatcher::Watch(const std::string& path)
+{
+  if (!IsSupported(path))
+    return false;
+
+#if defined(HAVE_INOTIFY)
+  if (m_fd < 0)
+  {
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+    {
+      CLog::Log(LOGERROR, "CDirectoryWatcher::{} - inotify not available (error {})", __FUNCTION__,
+                errno);
+      return false;
+    }
+  }
+
+  std::set<int> added;
+  if (!WatchTree(path, added))
+  {
+    for (int wd : added)
+    {
+      inotify_rm_watch(m_fd, wd);
+      m_watches.erase(wd);
+    }
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CDirectoryWatcher::Clear()
+{
+#if defined(HAVE_INOTIFY)
+  if (m_fd >= 0)
+    close(m_fd);
+#endif
+  m_fd = -1;
+  m_watches.clear();
+}
+
+bool CDirectoryWatcher::ReadChanges(std::chrono::milliseconds timeout,
+                                    std::set<std::string>& directories)
+{
+#if defined(HAVE_INOTIFY)
+  if (m_fd < 0)
+    return true;
+
+  struct pollfd pollFd = {m_fd, POLLIN, 0};
+  if (poll(&pollFd, 1, static_cast<int>(timeout.count())) <= 0)
+    return true;
+
+  bool complete = true;
+  alignas(struct inotify_event) char buffer[64 * 1024];
+  ssize_t length;
+  while ((length = read(m_fd, buffer, sizeof(buffer))) > 0)
+  {
+    for (ssize_t pos = 0; pos < length;)
+    {
+      const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + pos);
+      pos += sizeof(struct inotify_event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        complete = false;
+        continue;
+      }
+
+      const auto watch = m_watches.find(event->wd);
+      if (watch == m_watches.end())
+        continue;
+      if (event->mask & IN_IGNORED)
+      {
+        m_watches.erase(watch);
+        continue;
+      }
+
+      const std::string directory = watch->second;
+      directories.insert(directory);
+      if (!(event->mask & IN_ISDIR))
+        continue;
+
+      const std::string subdirectory = directory + event->name + "/";
+      if (event->mask & (IN_CREATE | IN_MOVED_TO))
+      {
+        // directories moved in may already have files and subdirectories
+        std::set<int> added;
+        WatchTree(subdirectory, added);
+        directories.insert(subdirectory);
+      }
+      else if (event->mask & IN_MOVED_FROM)
+      {
+        // the watches follow the directories moved, they are added again where they are moved to
+        for (auto it = m_watches.begin(); it != m_watches.end();)
+        {
+          if (it->second.compare(0, subdirectory.size(), subdirectory) == 0)
+          {
+            inotify_rm_watch(m_fd, it->first);
+            it = m_watches.erase(it);
+          }
+          else
+            ++it;
+        }
+      }
+    }
+  }
+  return complete;
+#else
+  return true;
+#endif
+}
+
+bool CDirectoryWatcher::WatchTree(const std::string& path, std::set<int>& added)
+{
+#if defined(HAVE_INOTIFY)
+  std::string root = path;
+  if (root.back() != '/')
+    root += '/';
+
+  std::vector<std::string> directories{root};
+
+  while (!directories.empty())
+  {
+    const std::string directory = std::move(directories.back());
+    directories.pop_back();
+
+    const int wd = inotify_add_watch(m_fd, directory.c_str(), WATCH_MASK);
+    if (wd < 0)
+    {
+      if (errno == ENOSPC)
+      {
+        CLog::Log(LOGWARNING,
+                  "CDirectoryWatcher::{} - too many directories to watch {}, raise "
+                  "fs.inotify.max_user_watches",
+                  __FUNCTION__, path);
+        return false;
+      }
+      // directories removed meanwhile or not readable are not scanned either
+      if (directory == root)
+        return false;
+      continue;
+    }
+    // directories of other trees watched already are left to them
+    if (m_watches.find(wd) == m_watches.end())
+      added.insert(wd);
+    m_watches[wd] = directory;
+
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+      continue;
+    while (const struct dirent* entry = readdir(dir))
+    {
+      const std::string name = entry->d_name;
+      if (name == "." || name == "..")
+        continue;
+
+      bool isDirectory = entry->d_type == DT_DIR;
+      if (entry->d_type == DT_UNKNOWN)
+      {
+        struct stat buffer;
+        isDirectory = lstat((directory + name).c_str(), &buffer) == 0 && S_ISDIR(buffer.st_mode);
+      }
+      if (isDirectory)
+        directories.push_back(directory + name + "/");
+    }
+    closedir(dir);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+
+namespace XFILE
+{
+/*!
+ \brief Watches trees of local directories for changes using the change notifications of the
+ system (inotify), so the directories that changed are known without listing every directory.
+
+ Only local paths can be watched, the changes made through network shares exported from the local
+ file system are seen too. Where the notifications are not available nothing can be watched and
+ the directories have to be checked some other way.
+ */
+class CDirectoryWatcher
+{
+public:
+  CDirectoryWatcher();
+  ~CDirectoryWatcher();
+
+  CDirectoryWatcher(const CDirectoryWatcher&) = delete;
+  CDirectoryWatcher& operator=(const CDirectoryWatcher&) = delete;
+
+  //! Whether the changes in a path can be watched
+  static bool IsSupported(const std::string& path);
+
+  /*!
+   \brief Watch a directory and all its subdirectories, the subdirectories created later included.
+   \param path the directory
+   \return false if the directory can not be watched, nothing of it is watched then
+   */
+  bool Watch(const std::string& path);
+
+  //! Stop watching all directories
+  void Clear();
+
+  /*!
+   \brief Wait for changes and get the directories that changed.
+   The directories created and the ones with files created, changed, moved or removed are
+   returned. A directory is given for the removal or the move of one of its subdirectories.
+   \param timeout the time to wait for a first change
+   \param directories [out] the directories that changed are added to it
+   \return false if changes were missed, all the watched directories may have changed then
+   */
+  bool ReadChanges(std::chrono::milliseconds timeout, std::set<std::string>& directories);
+
+  //! Get the number of watched directories
+  size_t Size() const { return m_watches.size(); }
+
+private:
+  bool WatchTree(const std::string& path, std::set<int>& added);
+
+  int m_fd = -1;
+  std::map<int, std::string> m_watches; ///< watched directories by watch descriptor
+};
+} // namespace XFILE
@@ -27,8 +27,86 @@
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#endif
+
+#include <future>
+#include <system_error>
+
 using namespace XFILE;
 
+namespace
+{
+//! Size of the blocks files are copied in, a multiple of the chunk size of the source
+constexpr size_t COPY_BLOCK_SIZE = 4 * 1024 * 1024;
+
+/*!
+ \brief Reads the next block of a file on a thread of its own while the caller writes the previous
+ one, so reading and writing overlap.
+ */
+class CReadAhead
+{
+public:
+  CReadAhead(CFile& file, size_t blockSize, bool async)
+    : m_file(file), m_blockSize(blockSize), m_async(async)
+  {
+  }
+
+  ~CReadAhead()
+  {
+    if (m_pending.valid())
+      m_pending.wait();
+  }
+
+  /*!
+   \brief Get the next block of the file.
+   \param data set to the block, valid until the next call
+   \return the size of the block, 0 at the end of the file, negative on error
+   */
+  ssize_t Next(const char*& data)
+  {
+    if (m_blocks[0].empty())
+    {
+      m_blocks[0].resize(m_blockSize);
+      if (m_async)
+        m_blocks[1].resize(m_blockSize);
+    }
+
+    std::vector<char>& block = m_blocks[m_current];
+    const ssize_t size =
+        m_pending.valid() ? m_pending.get() : m_file.Read(block.data(), block.size());
+    data = block.data();
+
+    if (size > 0 && m_async)
+    {
+      m_current ^= 1;
+      std::vector<char>& next = m_blocks[m_current];
+      try
+      {
+        m_pending = std::async(std::launch::async,
+                               [this, &next]() { return m_file.Read(next.data(), next.size()); });
+      }
+      catch (const std::system_error&)
+      {
+        // read the rest in turn
+        m_async = false;
+        m_current ^= 1;
+      }
+    }
+    return size;
+  }
+
+private:
+  CFile& m_file;
+  const size_t m_blockSize;
+  bool m_async;
+  std::vector<char> m_blocks[2];
+  int m_current = 0;
+  std::future<ssize_t> m_pending;
+};
+} // namespace
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -66,9 +144,9 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
   CURL url(url2);
   if (StringUtils::StartsWith(url.Get(), "zip://") || URIUtils::IsInAPK(url.Get()))
     url.SetOptions("?cache=no");
-  if (file.Open(url.Get(), READ_TRUNCATED | READ_CHUNKED))
+  // the blocks are larger than any stream buffer, read them straight into place
+  if (file.Open(url.Get(), READ_NO_BUFFER))
   {
-
     CFile newFile;
     if (URIUtils::IsHD(pathToUrl)) // create possible missing dirs
     {
@@ -116,68 +194,101 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
       return false;
     }
 
-    int iBufferSize = DetermineChunkSize(file.GetChunkSize(), 128 * 1024);
-
-    std::vector<char> buffer(iBufferSize);
-    ssize_t iRead, iWrite;
-
     unsigned long long llFileSize = file.GetLength();
     unsigned long long llPos = 0;
 
+    // whole blocks of the source's chunks, no larger than needed for small files
+    const size_t chunkSize = DetermineChunkSize(file.GetChunkSize(), 128 * 1024);
+    size_t blockSize = COPY_BLOCK_SIZE;
+    if (llFileSize > 0 && llFileSize < blockSize)
+      blockSize = static_cast<size_t>(llFileSize) + 1;
+    blockSize = (blockSize + chunkSize - 1) / chunkSize * chunkSize;
+
+#if defined(TARGET_POSIX)
+    // between local files the system copies without passing the data through here. Files of
+    // unknown size, like those of /proc, can't be copied that way.
+    CPosixFile* kernelSource = dynamic_cast<CPosixFile*>(file.GetImplementation());
+    CPosixFile* kernelDest = dynamic_cast<CPosixFile*>(newFile.GetImplementation());
+    bool kernelCopy = kernelSource && kernelDest && llFileSize > 0;
+#else
+    bool kernelCopy = false;
+#endif
+
     CStopWatch timer;
     timer.StartZero();
     float start = 0.0f;
     auto& components = CServiceBroker::GetAppComponents();
     const auto appPower = components.GetComponent<CApplicationPowerHandling>();
-    while (true)
     {
-      appPower->ResetScreenSaver();
-
-      iRead = file.Read(buffer.data(), buffer.size());
-      if (iRead == 0) break;
-      else if (iRead < 0)
-      {
-        CLog::Log(LOGERROR, "{} - Failed read from file {}", __FUNCTION__, url.GetRedacted());
-        llFileSize = (uint64_t)-1;
-        break;
-      }
-
-      /* write data and make sure we managed to write it all */
-      iWrite = 0;
-      while(iWrite < iRead)
+      CReadAhead readAhead(file, blockSize, llFileSize == 0 || llFileSize >= blockSize);
+      while (true)
       {
-        ssize_t iWrite2 = newFile.Write(buffer.data() + iWrite, iRead - iWrite);
-        if(iWrite2 <=0)
-          break;
-        iWrite+=iWrite2;
-      }
+        appPower->ResetScreenSaver();
 
-      if (iWrite != iRead)
-      {
-        CLog::Log(LOGERROR, "{} - Failed write to file {}", __FUNCTION__, dest.GetRedacted());
-        llFileSize = (uint64_t)-1;
-        break;
-      }
+        ssize_t iRead = -1;
+#if defined(TARGET_POSIX)
+        if (kernelCopy)
+        {
+          iRead = kernelSource->CopyTo(*kernelDest, blockSize);
+          if (iRead < 0 || (iRead == 0 && llPos < llFileSize))
+          {
+            CLog::Log(LOGDEBUG, "{} - Copying {} through a buffer", __FUNCTION__,
+                      url.GetRedacted());
+            kernelCopy = false;
+          }
+        }
+#endif
+        if (!kernelCopy)
+        {
+          const char* data = nullptr;
+          iRead = readAhead.Next(data);
+          if (iRead < 0)
+          {
+            CLog::Log(LOGERROR, "{} - Failed read from file {}", __FUNCTION__, url.GetRedacted());
+            llFileSize = (uint64_t)-1;
+            break;
+          }
 
-      llPos += iRead;
+          /* write data and make sure we managed to write it all */
+          ssize_t iWrite = 0;
+          while (iWrite < iRead)
+          {
+            ssize_t iWrite2 = newFile.Write(data + iWrite, iRead - iWrite);
+            if (iWrite2 <= 0)
+              break;
+            iWrite += iWrite2;
+          }
 
-      // calculate the current and average speeds
-      float end = timer.GetElapsedSeconds();
+          if (iWrite != iRead)
+          {
+            CLog::Log(LOGERROR, "{} - Failed write to file {}", __FUNCTION__, dest.GetRedacted());
+            llFileSize = (uint64_t)-1;
+            break;
+          }
+        }
+        if (iRead == 0)
+          break;
 
-      if (pCallback && end - start > 0.5f && end)
-      {
-        start = end;
+        llPos += iRead;
 
-        float averageSpeed = llPos / end;
-        int ipercent = 0;
-        if(llFileSize)
-          ipercent = 100 * llPos / llFileSize;
+        // calculate the current and average speeds
+        float end = timer.GetElapsedSeconds();
 
-        if(!pCallback->OnFileCallback(pContext, ipercent, averageSpeed))
+        if (pCallback && end - start > 0.5f && end)
         {
-          CLog::Log(LOGERROR, "{} - User aborted copy", __FUNCTION__);
-          llFileSize = (uint64_t)-1;
-          break;
+          start = end;
+
+          float averageSpeed = llPos / end;
+          int ipercent = 0;
+          if (llFileSize)
+            ipercent = 100 * llPos / llFileSize;
+
+          if (!pCallback->OnFileCallback(pContext, ipercent, averageSpeed))
+          {
+            CLog::Log(LOGERROR, "{} - User aborted copy", __FUNCTION__);
+            llFileSize = (uint64_t)-1;
+            break;
+          }
         }
       }
     }
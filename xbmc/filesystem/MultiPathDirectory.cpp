@@ -9,6 +9,7 @@
 #include "MultiPathDirectory.h"
 
 #include "Directory.h"
+#include "DirectoryFanOut.h"
 #include "FileItem.h"
 #include "ServiceBroker.h"
 #include "URL.h"
@@ -16,6 +17,7 @@
 #include "dialogs/GUIDialogProgress.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
+#include "messaging/ApplicationMessenger.h"
 #include "threads/SystemClock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -47,54 +49,72 @@ bool CMultiPathDirectory::GetDirectory(const CURL& url, CFileItemList &items)
 
   XbmcThreads::EndTime<> progressTime(3000ms); // 3 seconds before showing progress bar
   CGUIDialogProgress* dlgProgress = NULL;
+  size_t shown = 0;
+
+  // list the paths at a time, so the servers answer together rather than one after another
+  CDirectory::CHints hints;
+  hints.mask = m_strFileMask;
+  hints.flags = m_flags;
+  const auto listings = CDirectoryFanOut::GetDirectories(
+      vecPaths, hints, CDirectoryFanOut::GetTimeout(),
+      [&](size_t done)
+      {
+        // show the progress dialog if we have passed our time limit
+        if (progressTime.IsTimePast() && !dlgProgress)
+        {
+          dlgProgress = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogProgress>(
+              WINDOW_DIALOG_PROGRESS);
+          if (dlgProgress)
+          {
+            dlgProgress->SetHeading(CVariant{15310});
+            dlgProgress->SetLine(0, CVariant{15311});
+            dlgProgress->SetLine(1, CVariant{""});
+            dlgProgress->SetLine(2, CVariant{""});
+            dlgProgress->Open();
+            dlgProgress->ShowProgressBar(true);
+            dlgProgress->SetProgressMax((int)vecPaths.size());
+          }
+        }
+        if (dlgProgress)
+        {
+          if (done < vecPaths.size())
+          {
+            CURL url(vecPaths[done]);
+            dlgProgress->SetLine(1, CVariant{url.GetWithoutUserDetails()});
+          }
+          dlgProgress->SetProgressAdvance(static_cast<int>(done - shown));
+          shown = done;
+          dlgProgress->Progress();
+        }
+      });
+
+  if (dlgProgress)
+    dlgProgress->Close();
 
   unsigned int iFailures = 0;
   for (unsigned int i = 0; i < vecPaths.size(); ++i)
   {
-    // show the progress dialog if we have passed our time limit
-    if (progressTime.IsTimePast() && !dlgProgress)
-    {
-      dlgProgress = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogProgress>(WINDOW_DIALOG_PROGRESS);
-      if (dlgProgress)
-      {
-        dlgProgress->SetHeading(CVariant{15310});
-        dlgProgress->SetLine(0, CVariant{15311});
-        dlgProgress->SetLine(1, CVariant{""});
-        dlgProgress->SetLine(2, CVariant{""});
-        dlgProgress->Open();
-        dlgProgress->ShowProgressBar(true);
-        dlgProgress->SetProgressMax((int)vecPaths.size()*2);
-        dlgProgress->Progress();
-      }
-    }
-    if (dlgProgress)
+    CFileItemList& tempItems = listings[i]->items;
+    bool listed = listings[i]->listed;
+
+    // the workers cannot ask for credentials, the paths they failed to list are listed again here
+    if (!listed && !listings[i]->timedOut && vecPaths.size() > 1 &&
+        (m_flags & DIR_FLAG_ALLOW_PROMPT) && CServiceBroker::GetAppMessenger()->IsProcessThread())
     {
-      CURL url(vecPaths[i]);
-      dlgProgress->SetLine(1, CVariant{url.GetWithoutUserDetails()});
-      dlgProgress->SetProgressAdvance();
-      dlgProgress->Progress();
+      tempItems.Clear();
+      listed = CDirectory::GetDirectory(vecPaths[i], tempItems, m_strFileMask, m_flags);
     }
 
-    CFileItemList tempItems;
-    CLog::Log(LOGDEBUG, "Getting Directory ({})", CURL::GetRedacted(vecPaths[i]));
-    if (CDirectory::GetDirectory(vecPaths[i], tempItems, m_strFileMask, m_flags))
+    if (listed)
       items.Append(tempItems);
     else
     {
-      CLog::Log(LOGERROR, "Error Getting Directory ({})", CURL::GetRedacted(vecPaths[i]));
+      CLog::Log(LOGERROR, "Error Getting Directory ({}){}", CURL::GetRedacted(vecPaths[i]),
+                listings[i]->timedOut ? ", it took too long" : "");
       iFailures++;
     }
-
-    if (dlgProgress)
-    {
-      dlgProgress->SetProgressAdvance();
-      dlgProgress->Progress();
-    }
   }
 
-  if (dlgProgress)
-    dlgProgress->Close();
-
   if (iFailures == vecPaths.size())
     return false;
 
@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PathTaskQueue.h"
+
+#include "URL.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+using namespace XFILE;
+
+CPathTaskQueue::CPathTaskQueue(unsigned int workers, unsigned int perHost)
+  : m_workers(std::max(workers, 1u)), m_perHost(std::max(perHost, 1u))
+{
+}
+
+CPathTaskQueue::~CPathTaskQueue()
+{
+  Stop();
+
+  for (auto& thread : m_threads)
+    thread.wait();
+}
+
+bool CPathTaskQueue::Add(const std::string& path, std::function<void()> task)
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  if (m_stopping)
+    return false;
+
+  m_hosts[GetHost(path)].tasks.push_back(std::move(task));
+  m_pending++;
+
+  if (m_threads.size() < m_workers)
+    m_threads.push_back(std::async(std::launch::async, [this]() { Run(); }));
+  m_changed.notifyAll();
+  return true;
+}
+
+void CPathTaskQueue::Wait()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  m_changed.wait(lock, [this]() { return m_pending == 0; });
+}
+
+void CPathTaskQueue::Clear()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  for (auto& host : m_hosts)
+  {
+    m_pending -= host.second.tasks.size();
+    host.second.tasks.clear();
+  }
+  m_changed.notifyAll();
+}
+
+void CPathTaskQueue::Stop()
+{
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    m_stopping = true;
+  }
+  Clear();
+}
+
+std::string CPathTaskQueue::GetHost(const std::string& path)
+{
+  const CURL url(path);
+  return url.GetProtocol() + "://" + url.GetHostName();
+}
+
+void CPathTaskQueue::Run()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  while (true)
+  {
+    Host* host = nullptr;
+    m_changed.wait(lock, [this, &host]() { return m_stopping || (host = NextHost()) != nullptr; });
+    if (m_stopping)
+      return;
+
+    std::function<void()> task = std::move(host->tasks.front());
+    host->tasks.pop_front();
+    host->running++;
+
+    lock.unlock();
+    task();
+    lock.lock();
+
+    // the servers are never removed, so the host is still valid
+    host->running--;
+    m_pending--;
+    m_changed.notifyAll();
+  }
+}
+
+CPathTaskQueue::Host* CPathTaskQueue::NextHost()
+{
+  // take turns between the servers, starting after the one of the last task
+  auto start = m_hosts.upper_bound(m_lastHost);
+  for (size_t i = 0; i < m_hosts.size(); i++, start++)
+  {
+    if (start == m_hosts.end())
+      start = m_hosts.begin();
+
+    Host& host = start->second;
+    if (!host.tasks.empty() && host.running < m_perHost)
+    {
+      m_lastHost = start->first;
+      return &host;
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+/*!
+ \brief Runs tasks accessing paths on a pool of workers, with a bounded number of tasks at a time
+ per server so a slow server does not hold up the others and network shares are not flooded.
+
+ Idle workers take the next task of the servers in turn, tasks of the same server run in the
+ order they were added. Tasks may add further tasks.
+ */
+class CPathTaskQueue
+{
+public:
+  /*!
+   \param workers the number of workers, started with the first task
+   \param perHost the maximum number of tasks of one server running at a time
+   */
+  CPathTaskQueue(unsigned int workers, unsigned int perHost);
+
+  //! Discards the tasks not started yet and waits for the running ones
+  ~CPathTaskQueue();
+
+  /*!
+   \brief Add a task.
+   \param path the path accessed by the task, local paths share one server
+   \param task the task
+   \return false if the queue is stopped, the task is discarded then
+   */
+  bool Add(const std::string& path, std::function<void()> task);
+
+  //! Wait until all the tasks added so far have run
+  void Wait();
+
+  //! Discard the tasks not started yet
+  void Clear();
+
+  /*!
+   \brief Discard the tasks not started yet and the ones added later, without waiting for the
+   running ones. The workers end once their running task returned.
+   */
+  void Stop();
+
+  //! Get the server of a path, its protocol and host name
+  static std::string GetHost(const std::string& path);
+
+private:
+  struct Host
+  {
+    std::deque<std::function<void()>> tasks;
+    unsigned int running = 0;
+  };
+
+  void Run();
+  Host* NextHost();
+
+  const unsigned int m_workers;
+  const unsigned int m_perHost;
+
+  CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_changed;
+  std::map<std::string, Host> m_hosts;
+  std::string m_lastHost; ///< the server of the last started task
+  size_t m_pending = 0; ///< tasks queued or running
+  bool m_stopping = false;
+  std::vector<std::future<void>> m_threads;
+};
+} // namespace XFILE
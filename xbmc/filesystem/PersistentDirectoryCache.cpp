@@ -0,0 +1,451 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentDirectoryCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "IDirectory.h"
+#include "URL.h"
+#include "XBDateTime.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XTimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr uint32_t MAGIC = 0x3143444b; // "KDC1"
+constexpr uint32_t VERSION = 1;
+
+//! The flags that change what a directory lists
+constexpr int KEY_FLAGS = DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO;
+
+//! Seconds a directory may still change without changing its modification time
+constexpr int64_t RACY_INTERVAL = 2;
+
+enum Attributes : uint32_t
+{
+  ATTRIBUTE_FOLDER = 1 << 0,
+  ATTRIBUTE_HIDDEN = 1 << 1,
+  ATTRIBUTE_DATE = 1 << 2, ///< the date is valid
+  ATTRIBUTE_RELATIVE = 1 << 3, ///< the path is the one of the directory followed by the string
+  ATTRIBUTE_LABEL_IS_NAME = 1 << 4, ///< the label is the path string without a trailing slash
+};
+
+/*!
+ The header of a listing, followed by the records of the items, then the strings: the key of the
+ listing first and the paths and labels of the items.
+ */
+struct Header
+{
+  uint32_t magic;
+  uint32_t version;
+  int64_t mtime;
+  uint32_t flags;
+  uint32_t count;
+  uint32_t keyLength;
+  uint32_t stringsSize;
+};
+
+struct Record
+{
+  int64_t size;
+  uint32_t dateLow;
+  uint32_t dateHigh;
+  uint32_t pathOffset;
+  uint32_t pathLength;
+  uint32_t labelOffset;
+  uint32_t labelLength;
+  uint32_t attributes;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 32, "the header is stored as is");
+static_assert(sizeof(Record) == 40, "the records are stored as is");
+
+uint32_t AddString(std::string& strings, const std::string& value)
+{
+  const auto offset = static_cast<uint32_t>(strings.size());
+  strings += value;
+  return offset;
+}
+} // namespace
+
+CPersistentDirectoryCache::CPersistentDirectoryCache() = default;
+
+CPersistentDirectoryCache::~CPersistentDirectoryCache() = default;
+
+void CPersistentDirectoryCache::Initialize(const std::string& folder,
+                                           uint64_t diskBudget,
+                                           uint64_t memoryBudget)
+{
+  Deinitialize();
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  m_folder = folder;
+  m_diskBudget = diskBudget;
+  m_memoryBudget = memoryBudget;
+  if (!CDirectory::Exists(m_folder) && !CDirectory::Create(m_folder))
+  {
+    CLog::Log(LOGERROR, "CPersistentDirectoryCache::{} - unable to create {}", __FUNCTION__,
+              m_folder);
+    return;
+  }
+
+  CFileItemList items;
+  CDirectory::GetDirectory(m_folder, items, "",
+                           DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE | DIR_FLAG_GET_HIDDEN);
+
+  // the listings written last are taken as the ones used last
+  std::vector<CFileItemPtr> files(items.begin(), items.end());
+  std::sort(files.begin(), files.end(), [](const CFileItemPtr& a, const CFileItemPtr& b) {
+    return a->m_dateTime < b->m_dateTime;
+  });
+  for (const auto& file : files)
+  {
+    if (file->m_bIsFolder)
+      continue;
+    if (!URIUtils::HasExtension(file->GetPath(), ".dir"))
+    {
+      // left over by a write that did not complete
+      CFile::Delete(file->GetPath());
+      continue;
+    }
+
+    Entry& entry = m_entries[URIUtils::GetFileName(file->GetPath())];
+    entry.size = file->m_dwSize;
+    m_diskSize += entry.size;
+    Use(entry, URIUtils::GetFileName(file->GetPath()));
+  }
+  CheckBudgets();
+
+  m_enabled = true;
+  CLog::Log(LOGINFO, "CPersistentDirectoryCache: {} listings ({} kB) in {}", m_entries.size(),
+            m_diskSize / 1024, m_folder);
+}
+
+void CPersistentDirectoryCache::Deinitialize()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  m_enabled = false;
+  m_entries.clear();
+  m_leastUsed.clear();
+  m_diskSize = 0;
+  m_memorySize = 0;
+}
+
+bool CPersistentDirectoryCache::IsCacheable(const std::string& path)
+{
+  const CURL url(path);
+  return url.GetProtocol().empty() || url.IsProtocol("file") || url.IsProtocol("smb") ||
+         url.IsProtocol("nfs") || url.IsProtocol("ftp") || url.IsProtocol("ftps") ||
+         url.IsProtocol("dav") || url.IsProtocol("davs") || url.IsProtocol("sftp");
+}
+
+bool CPersistentDirectoryCache::GetDirectory(const std::string& path,
+                                             int flags,
+                                             int64_t mtime,
+                                             CFileItemList& items)
+{
+  if (mtime == 0)
+    return false;
+
+  const std::string name = GetFileName(GetKey(path, flags));
+  Data data;
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    if (!m_enabled)
+      return false;
+    const auto entry = m_entries.find(name);
+    if (entry == m_entries.end())
+      return false;
+    data = entry->second.data;
+    Use(entry->second, name);
+  }
+
+  const bool loaded = !data;
+  if (loaded)
+  {
+    auto buffer = std::make_shared<std::vector<uint8_t>>();
+    CFile file;
+    if (file.LoadFile(URIUtils::AddFileToFolder(m_folder, name), *buffer) <= 0)
+    {
+      std::unique_lock<CCriticalSection> lock(m_critSection);
+      const auto entry = m_entries.find(name);
+      if (entry != m_entries.end())
+        Remove(entry);
+      return false;
+    }
+    data = std::move(buffer);
+  }
+
+  if (!Decode(*data, path, flags, mtime, items))
+    return false;
+
+  if (loaded)
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    const auto entry = m_entries.find(name);
+    if (entry != m_entries.end())
+    {
+      Keep(entry->second, name, data);
+      CheckBudgets();
+    }
+  }
+  return true;
+}
+
+void CPersistentDirectoryCache::SetDirectory(const std::string& path,
+                                             int flags,
+                                             int64_t mtime,
+                                             const CFileItemList& items)
+{
+  if (!m_enabled || mtime == 0 || mtime > static_cast<int64_t>(time(nullptr)) - RACY_INTERVAL)
+    return;
+
+  const auto data = std::make_shared<const std::vector<uint8_t>>(
+      Encode(path, flags, mtime, items));
+  const std::string name = GetFileName(GetKey(path, flags));
+  const std::string file = URIUtils::AddFileToFolder(m_folder, name);
+  std::string temp;
+  {
+    std::unique_lock<CCriticalSection> lock(m_critSection);
+    temp = StringUtils::Format("{}.{}.tmp", file, ++m_tempCounter);
+  }
+
+  // written aside and renamed so readers never see a partial listing
+  CFile out;
+  if (!out.OpenForWrite(temp, true) ||
+      out.Write(data->data(), data->size()) != static_cast<ssize_t>(data->size()))
+  {
+    out.Close();
+    CFile::Delete(temp);
+    return;
+  }
+  out.Close();
+  if (!CFile::Rename(temp, file) && !(CFile::Delete(file) && CFile::Rename(temp, file)))
+  {
+    CFile::Delete(temp);
+    return;
+  }
+
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  if (!m_enabled)
+    return;
+  Entry& entry = m_entries[name];
+  m_diskSize -= entry.size;
+  entry.size = data->size();
+  m_diskSize += entry.size;
+  Keep(entry, name, data);
+  CheckBudgets();
+}
+
+void CPersistentDirectoryCache::Clear()
+{
+  std::unique_lock<CCriticalSection> lock(m_critSection);
+  while (!m_entries.empty())
+    Remove(m_entries.begin());
+}
+
+std::vector<uint8_t> CPersistentDirectoryCache::Encode(const std::string& path,
+                                                       int flags,
+                                                       int64_t mtime,
+                                                       const CFileItemList& items)
+{
+  const std::string key = GetKey(path, flags);
+  std::string strings = key;
+  std::vector<Record> records;
+  records.reserve(items.Size());
+  for (const auto& item : items)
+  {
+    Record record = {};
+    record.size = item->m_dwSize;
+    if (item->m_dateTime.IsValid())
+    {
+      const KODI::TIME::FileTime date = item->m_dateTime;
+      record.dateLow = date.lowDateTime;
+      record.dateHigh = date.highDateTime;
+      record.attributes |= ATTRIBUTE_DATE;
+    }
+    if (item->m_bIsFolder)
+      record.attributes |= ATTRIBUTE_FOLDER;
+    if (item->GetProperty("file:hidden").asBoolean())
+      record.attributes |= ATTRIBUTE_HIDDEN;
+
+    // the items of a directory mostly start with its path and are labelled with their name
+    std::string itemPath = item->GetPath();
+    if (itemPath.size() > path.size() && StringUtils::StartsWith(itemPath, path))
+    {
+      itemPath.erase(0, path.size());
+      record.attributes |= ATTRIBUTE_RELATIVE;
+
+      std::string name = itemPath;
+      URIUtils::RemoveSlashAtEnd(name);
+      if (name == item->GetLabel())
+        record.attributes |= ATTRIBUTE_LABEL_IS_NAME;
+    }
+    record.pathOffset = AddString(strings, itemPath);
+    record.pathLength = static_cast<uint32_t>(itemPath.size());
+    if (!(record.attributes & ATTRIBUTE_LABEL_IS_NAME))
+    {
+      record.labelOffset = AddString(strings, item->GetLabel());
+      record.labelLength = static_cast<uint32_t>(item->GetLabel().size());
+    }
+    records.push_back(record);
+  }
+
+  Header header = {};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.mtime = mtime;
+  header.flags = static_cast<uint32_t>(flags & KEY_FLAGS);
+  header.count = static_cast<uint32_t>(records.size());
+  header.keyLength = static_cast<uint32_t>(key.size());
+  header.stringsSize = static_cast<uint32_t>(strings.size());
+
+  std::vector<uint8_t> data(sizeof(Header) + records.size() * sizeof(Record) + strings.size());
+  uint8_t* pos = data.data();
+  std::memcpy(pos, &header, sizeof(Header));
+  pos += sizeof(Header);
+  if (!records.empty())
+    std::memcpy(pos, records.data(), records.size() * sizeof(Record));
+  pos += records.size() * sizeof(Record);
+  if (!strings.empty())
+    std::memcpy(pos, strings.data(), strings.size());
+  return data;
+}
+
+bool CPersistentDirectoryCache::Decode(const std::vector<uint8_t>& data,
+                                       const std::string& path,
+                                       int flags,
+                                       int64_t mtime,
+                                       CFileItemList& items)
+{
+  Header header;
+  if (data.size() < sizeof(Header))
+    return false;
+  std::memcpy(&header, data.data(), sizeof(Header));
+  if (header.magic != MAGIC || header.version != VERSION || header.mtime != mtime ||
+      header.flags != static_cast<uint32_t>(flags & KEY_FLAGS) ||
+      data.size() != sizeof(Header) + static_cast<uint64_t>(header.count) * sizeof(Record) +
+                         header.stringsSize ||
+      header.keyLength > header.stringsSize)
+    return false;
+
+  const auto* strings = reinterpret_cast<const char*>(data.data()) + sizeof(Header) +
+                        static_cast<size_t>(header.count) * sizeof(Record);
+  // another path with the same file name
+  if (std::string(strings, header.keyLength) != GetKey(path, flags))
+    return false;
+
+  std::vector<CFileItemPtr> decoded;
+  decoded.reserve(header.count);
+  for (uint32_t i = 0; i < header.count; ++i)
+  {
+    Record record;
+    std::memcpy(&record, data.data() + sizeof(Header) + i * sizeof(Record), sizeof(Record));
+    if (static_cast<uint64_t>(record.pathOffset) + record.pathLength > header.stringsSize ||
+        static_cast<uint64_t>(record.labelOffset) + record.labelLength > header.stringsSize)
+      return false;
+
+    std::string itemPath(strings + record.pathOffset, record.pathLength);
+    std::string label;
+    if (record.attributes & ATTRIBUTE_LABEL_IS_NAME)
+    {
+      label = itemPath;
+      URIUtils::RemoveSlashAtEnd(label);
+    }
+    else
+      label.assign(strings + record.labelOffset, record.labelLength);
+    if (record.attributes & ATTRIBUTE_RELATIVE)
+      itemPath.insert(0, path);
+
+    CFileItemPtr item(new CFileItem(label));
+    item->SetPath(itemPath);
+    item->m_bIsFolder = (record.attributes & ATTRIBUTE_FOLDER) != 0;
+    item->m_dwSize = record.size;
+    if (record.attributes & ATTRIBUTE_DATE)
+    {
+      KODI::TIME::FileTime date;
+      date.lowDateTime = record.dateLow;
+      date.highDateTime = record.dateHigh;
+      item->m_dateTime = CDateTime(date);
+    }
+    if (record.attributes & ATTRIBUTE_HIDDEN)
+      item->SetProperty("file:hidden", true);
+    decoded.push_back(std::move(item));
+  }
+
+  for (auto& item : decoded)
+    items.Add(std::move(item));
+  return true;
+}
+
+std::string CPersistentDirectoryCache::GetKey(const std::string& path, int flags)
+{
+  return StringUtils::Format("{}|{}", path, flags & KEY_FLAGS);
+}
+
+std::string CPersistentDirectoryCache::GetFileName(const std::string& key) const
+{
+  return StringUtils::Format("{:08x}.dir", Crc32::Compute(key));
+}
+
+void CPersistentDirectoryCache::Use(Entry& entry, const std::string& name)
+{
+  if (entry.lastUse)
+    m_leastUsed.erase(entry.lastUse);
+  entry.lastUse = ++m_useCounter;
+  m_leastUsed[entry.lastUse] = name;
+}
+
+void CPersistentDirectoryCache::Keep(Entry& entry, const std::string& name, const Data& data)
+{
+  if (entry.data)
+    m_memorySize -= entry.data->size();
+  entry.data = data;
+  m_memorySize += data->size();
+  Use(entry, name);
+}
+
+void CPersistentDirectoryCache::Remove(std::map<std::string, Entry>::iterator entry)
+{
+  m_leastUsed.erase(entry->second.lastUse);
+  m_diskSize -= entry->second.size;
+  if (entry->second.data)
+    m_memorySize -= entry->second.data->size();
+  CFile::Delete(URIUtils::AddFileToFolder(m_folder, entry->first));
+  m_entries.erase(entry);
+}
+
+void CPersistentDirectoryCache::CheckBudgets()
+{
+  while (m_diskSize > m_diskBudget && !m_leastUsed.empty())
+    Remove(m_entries.find(m_leastUsed.begin()->second));
+
+  for (auto it = m_leastUsed.begin(); m_memorySize > m_memoryBudget && it != m_leastUsed.end();
+       ++it)
+  {
+    Entry& entry = m_entries[it->second];
+    if (entry.data)
+    {
+      m_memorySize -= entry.data->size();
+      entry.data.reset();
+    }
+  }
+}
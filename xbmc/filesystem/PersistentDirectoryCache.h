@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CFileItemList;
+
+namespace XFILE
+{
+/*!
+ \brief Keeps directory listings on disk across restarts, so listing large network shares does not
+ have to wait for the servers while their directories did not change.
+
+ A listing is stored with the modification time of its directory and only used while the directory
+ has the same one. Each listing is a file of the cache folder named after its path, with a header,
+ fixed size records of the items and the strings they point to, so it can be read with a single
+ read or mapped as is. The least recently used listings are removed when the cache grows over its
+ size on disk, the recently used ones are kept in memory within a budget.
+ */
+class CPersistentDirectoryCache
+{
+public:
+  CPersistentDirectoryCache();
+  ~CPersistentDirectoryCache();
+
+  /*!
+   \brief Set the cache up, listings are neither read nor stored before.
+   \param folder the folder of the listings, created if missing
+   \param diskBudget the size of the listings on disk in bytes
+   \param memoryBudget the size of the listings kept in memory in bytes
+   */
+  void Initialize(const std::string& folder, uint64_t diskBudget, uint64_t memoryBudget);
+
+  //! Stop reading and storing listings, the ones stored are kept for the next run
+  void Deinitialize();
+
+  bool IsEnabled() const { return m_enabled; }
+
+  //! Whether the listings of a path can be kept, those of local and network file systems
+  static bool IsCacheable(const std::string& path);
+
+  /*!
+   \brief Get the stored listing of a directory, if the directory did not change since.
+   \param path the directory
+   \param flags the flags the directory is listed with
+   \param mtime the modification time of the directory, 0 when unknown
+   \param items [out] the items of the directory
+   \return true if the listing was stored with the same modification time
+   */
+  bool GetDirectory(const std::string& path, int flags, int64_t mtime, CFileItemList& items);
+
+  /*!
+   \brief Store the listing of a directory, unless its modification time is unknown or so recent
+   that the directory may still change within the same second.
+   */
+  void SetDirectory(const std::string& path, int flags, int64_t mtime, const CFileItemList& items);
+
+  //! Remove all stored listings
+  void Clear();
+
+  /*!
+   \brief Get the binary form of a listing.
+   \sa Decode
+   */
+  static std::vector<uint8_t> Encode(const std::string& path,
+                                  int flags,
+                                  int64_t mtime,
+                                  const CFileItemList& items);
+
+  /*!
+   \brief Get the items of the binary form of a listing.
+   \return false if the data is not a listing of the path with these flags and modification time
+   */
+  static bool Decode(const std::vector<uint8_t>& data,
+                     const std::string& path,
+                     int flags,
+                     int64_t mtime,
+                     CFileItemList& items);
+
+private:
+  using Data = std::shared_ptr<const std::vector<uint8_t>>;
+
+  struct Entry
+  {
+    uint64_t size = 0; ///< size on disk
+    uint64_t lastUse = 0;
+    Data data; ///< the listing when kept in memory
+  };
+
+  static std::string GetKey(const std::string& path, int flags);
+  std::string GetFileName(const std::string& key) const;
+  void Use(Entry& entry, const std::string& name);
+  void Keep(Entry& entry, const std::string& name, const Data& data);
+  void Remove(std::map<std::string, Entry>::iterator entry);
+  void CheckBudgets();
+
+  CCriticalSection m_critSection;
+  std::atomic<bool> m_enabled{false};
+  std::string m_folder;
+  uint64_t m_diskBudget = 0;
+  uint64_t m_memoryBudget = 0;
+  uint64_t m_diskSize = 0;
+  uint64_t m_memorySize = 0;
+  uint64_t m_useCounter = 0;
+  unsigned int m_tempCounter = 0;
+  std::map<std::string, Entry> m_entries; ///< listings by file name
+  std::map<uint64_t, std::string> m_leastUsed; ///< file names of the listings by last use
+};
+} // namespace XFILE
+
+extern XFILE::CPersistentDirectoryCache g_persistentDirectoryCache;
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryChecker.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+class TestDirectoryChecker : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                     "TestDirectoryChecker");
+    URIUtils::AddSlashAtEnd(path);
+    ASSERT_TRUE(CDirectory::Create(path));
+    for (const char* name : {"movie1.mkv", "movie2.mkv"})
+    {
+      CFile file;
+      ASSERT_TRUE(file.OpenForWrite(URIUtils::AddFileToFolder(path, name), true));
+      file.Close();
+    }
+  }
+
+  void TearDown() override { CDirectory::RemoveRecursive(path); }
+
+  std::string path;
+};
+
+TEST_F(TestDirectoryChecker, ListsChangedDirectories)
+{
+  std::vector<CDirectoryChecker::Directory> directories(2);
+  directories[0].path = path;
+  directories[1].path = URIUtils::AddFileToFolder(path, "missing/");
+
+  CFile::Delete(URIUtils::AddFileToFolder(path, "movie2.mkv"));
+  EXPECT_TRUE(CDirectoryChecker().Check(directories));
+
+  EXPECT_TRUE(directories[0].listed);
+  EXPECT_FALSE(directories[0].unchanged);
+  EXPECT_NE(0, directories[0].mtime);
+  EXPECT_TRUE(
+      CDirectoryChecker::Exists(directories[0], URIUtils::AddFileToFolder(path, "movie1.mkv")));
+  EXPECT_FALSE(
+      CDirectoryChecker::Exists(directories[0], URIUtils::AddFileToFolder(path, "movie2.mkv")));
+
+  // the files of a directory that can not be read are missing
+  EXPECT_FALSE(directories[1].listed);
+  EXPECT_EQ(0, directories[1].mtime);
+  EXPECT_FALSE(CDirectoryChecker::Exists(
+      directories[1], URIUtils::AddFileToFolder(directories[1].path, "movie3.mkv")));
+}
+
+TEST_F(TestDirectoryChecker, TrustsUnchangedDirectories)
+{
+  std::vector<CDirectoryChecker::Directory> directories(1);
+  directories[0].path = path;
+  directories[0].knownMTime = CDirectoryChecker::GetMTime(path);
+  ASSERT_NE(0, directories[0].knownMTime);
+
+  EXPECT_TRUE(CDirectoryChecker(1).Check(directories));
+
+  EXPECT_TRUE(directories[0].unchanged);
+  EXPECT_FALSE(directories[0].listed);
+  EXPECT_TRUE(directories[0].files.empty());
+  EXPECT_TRUE(
+      CDirectoryChecker::Exists(directories[0], URIUtils::AddFileToFolder(path, "movie2.mkv")));
+}
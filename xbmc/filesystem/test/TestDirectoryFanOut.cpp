@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryFanOut.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/Event.h"
+#include "utils/URIUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+using namespace std::chrono_literals;
+
+TEST(TestDirectoryFanOut, RunsServersAtATime)
+{
+  const std::vector<std::string> paths{"smb://nas1/movies/", "smb://nas2/movies/",
+                                       "nfs://nas3/movies/", "smb://nas4/movies/"};
+  auto started = std::make_shared<std::atomic<int>>(0);
+  auto together = std::make_shared<std::atomic<int>>(0);
+
+  // each task waits for the others to start, which they only do if they run at once
+  const std::vector<bool> completed = CDirectoryFanOut::Run(
+      paths,
+      [started, together](size_t)
+      {
+        (*started)++;
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (*started < 4 && std::chrono::steady_clock::now() < deadline)
+          std::this_thread::sleep_for(1ms);
+        if (*started == 4)
+          (*together)++;
+      },
+      10s);
+
+  EXPECT_EQ(4, *together);
+  EXPECT_EQ(std::vector<bool>(4, true), completed);
+}
+
+TEST(TestDirectoryFanOut, LeavesOutSlowPaths)
+{
+  const std::vector<std::string> paths{"smb://fast/movies/", "smb://slow/movies/",
+                                       "smb://fast/tv/"};
+  size_t lastProgress = 0;
+  auto release = std::make_shared<CEvent>();
+
+  // the slow task only completes once Run returned
+  const std::vector<bool> completed = CDirectoryFanOut::Run(
+      paths,
+      [release](size_t i)
+      {
+        if (i == 1)
+          release->Wait(10s);
+      },
+      300ms, [&lastProgress](size_t done) { lastProgress = done; });
+  release->Set();
+
+  EXPECT_TRUE(completed[0]);
+  EXPECT_FALSE(completed[1]);
+  EXPECT_TRUE(completed[2]);
+  EXPECT_EQ(3u, lastProgress);
+}
+
+TEST(TestDirectoryFanOut, GetDirectories)
+{
+  const std::string root = URIUtils::AddFileToFolder(
+      CSpecialProtocol::TranslatePath("special://temp/"), "TestDirectoryFanOut/");
+  std::vector<std::string> paths;
+  for (const char* name : {"a/", "b/", "missing/", "c/"})
+    paths.push_back(URIUtils::AddFileToFolder(root, name));
+  for (const char* name : {"a/1/", "b/1/", "b/2/", "c/1/"})
+    ASSERT_TRUE(CDirectory::Create(URIUtils::AddFileToFolder(root, name)));
+
+  const auto listings = CDirectoryFanOut::GetDirectories(paths, {}, 10s);
+  ASSERT_EQ(4u, listings.size());
+  EXPECT_TRUE(listings[0]->listed);
+  EXPECT_EQ(1, listings[0]->items.Size());
+  EXPECT_TRUE(listings[1]->listed);
+  EXPECT_EQ(2, listings[1]->items.Size());
+  EXPECT_FALSE(listings[2]->listed);
+  EXPECT_FALSE(listings[2]->timedOut);
+  EXPECT_TRUE(listings[3]->listed);
+  EXPECT_EQ(1, listings[3]->items.Size());
+
+  EXPECT_EQ(std::vector<bool>({true, true, false, true}), CDirectoryFanOut::Exists(paths, 10s));
+
+  CDirectory::RemoveRecursive(root);
+}
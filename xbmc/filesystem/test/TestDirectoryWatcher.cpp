@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryWatcher.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+using namespace std::chrono_literals;
+
+class TestDirectoryWatcher : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                     "TestDirectoryWatcher/");
+    ASSERT_TRUE(CDirectory::Create(path));
+    ASSERT_TRUE(CDirectory::Create(path + "movies/"));
+  }
+
+  void TearDown() override { CDirectory::RemoveRecursive(path); }
+
+  static void CreateFile(const std::string& file)
+  {
+    CFile out;
+    ASSERT_TRUE(out.OpenForWrite(file, true));
+    out.Close();
+  }
+
+  static std::set<std::string> ReadChanges(CDirectoryWatcher& watcher)
+  {
+    std::set<std::string> changed;
+    EXPECT_TRUE(watcher.ReadChanges(1000ms, changed));
+    // collect the events still on their way
+    size_t size;
+    do
+    {
+      size = changed.size();
+      EXPECT_TRUE(watcher.ReadChanges(100ms, changed));
+    } while (changed.size() != size);
+    return changed;
+  }
+
+  std::string path;
+};
+
+TEST_F(TestDirectoryWatcher, ReportsChangedDirectories)
+{
+  CDirectoryWatcher watcher;
+  ASSERT_TRUE(watcher.Watch(path));
+  EXPECT_EQ(2u, watcher.Size());
+
+  CreateFile(path + "movies/movie1.mkv");
+  EXPECT_EQ(std::set<std::string>{path + "movies/"}, ReadChanges(watcher));
+
+  // new directories are watched with what they hold
+  ASSERT_TRUE(CDirectory::Create(path + "movies/movie2/"));
+  EXPECT_EQ((std::set<std::string>{path + "movies/", path + "movies/movie2/"}),
+            ReadChanges(watcher));
+  EXPECT_EQ(3u, watcher.Size());
+  CreateFile(path + "movies/movie2/movie2.mkv");
+  EXPECT_EQ(std::set<std::string>{path + "movies/movie2/"}, ReadChanges(watcher));
+
+  // moved directories are watched where they are moved to
+  ASSERT_TRUE(CFile::Rename(path + "movies/movie2/", path + "movie2/"));
+  EXPECT_EQ((std::set<std::string>{path, path + "movies/", path + "movie2/"}),
+            ReadChanges(watcher));
+  CreateFile(path + "movie2/movie2.nfo");
+  EXPECT_EQ(std::set<std::string>{path + "movie2/"}, ReadChanges(watcher));
+
+  CFile::Delete(path + "movies/movie1.mkv");
+  EXPECT_EQ(std::set<std::string>{path + "movies/"}, ReadChanges(watcher));
+}
+
+TEST_F(TestDirectoryWatcher, OnlyLocalPaths)
+{
+  EXPECT_TRUE(CDirectoryWatcher::IsSupported(path));
+  EXPECT_FALSE(CDirectoryWatcher::IsSupported("smb://nas/movies/"));
+  EXPECT_FALSE(CDirectoryWatcher::IsSupported("nfs://nas/export/movies/"));
+
+  CDirectoryWatcher watcher;
+  EXPECT_FALSE(watcher.Watch("smb://nas/movies/"));
+  EXPECT_FALSE(watcher.Watch(path + "missing/"));
+  EXPECT_EQ(0u, watcher.Size());
+}
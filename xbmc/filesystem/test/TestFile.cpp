@@ -7,10 +7,15 @@
  */
 
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "test/TestUtils.h"
+#include "utils/URIUtils.h"
 
+#include <chrono>
+#include <cstdlib>
 #include <errno.h>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -194,6 +199,114 @@ TEST(TestFile, Copy)
   EXPECT_FALSE(XBMC_DELETETEMPFILE(file2));
 }
 
+namespace
+{
+std::vector<char> MakeContent(size_t size)
+{
+  std::vector<char> content(size);
+  for (size_t i = 0; i < size; i++)
+    content[i] = static_cast<char>((i * 2654435761u) >> 13);
+  return content;
+}
+
+bool WriteContent(const std::string& path, const std::vector<char>& content)
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+    return false;
+  return file.Write(content.data(), content.size()) == static_cast<ssize_t>(content.size());
+}
+
+std::vector<char> ReadContent(const std::string& path)
+{
+  XFILE::CFile file;
+  std::vector<char> content;
+  if (file.Open(path))
+  {
+    content.resize(file.GetLength());
+    if (file.Read(content.data(), content.size()) != static_cast<ssize_t>(content.size()))
+      content.clear();
+  }
+  return content;
+}
+} // namespace
+
+TEST(TestFile, CopyLarge)
+{
+  const std::string folder = CSpecialProtocol::TranslatePath("special://temp/");
+  const std::string source = URIUtils::AddFileToFolder(folder, "TestFileCopySource.bin");
+  const std::string dest = URIUtils::AddFileToFolder(folder, "TestFileCopyDest.bin");
+  // several blocks and a partial one
+  const std::vector<char> content = MakeContent(9 * 1024 * 1024 + 123);
+  ASSERT_TRUE(WriteContent(source, content));
+
+  // between local files, and through a buffer from a file system of its own
+  for (const std::string& from : {source, std::string("special://temp/TestFileCopySource.bin")})
+  {
+    EXPECT_TRUE(XFILE::CFile::Copy(from, dest));
+    EXPECT_TRUE(content == ReadContent(dest));
+    EXPECT_TRUE(XFILE::CFile::Delete(dest));
+  }
+
+  // small files too
+  const std::vector<char> small = MakeContent(1000);
+  ASSERT_TRUE(WriteContent(source, small));
+  EXPECT_TRUE(XFILE::CFile::Copy(source, dest));
+  EXPECT_TRUE(small == ReadContent(dest));
+
+  EXPECT_TRUE(XFILE::CFile::Delete(dest));
+  EXPECT_TRUE(XFILE::CFile::Delete(source));
+}
+
+#if defined(TARGET_POSIX)
+// the copy rate between local files, through a buffer and of cp, run with
+// --gtest_also_run_disabled_tests
+TEST(TestFile, DISABLED_Copy_Benchmark)
+{
+  const std::string folder = CSpecialProtocol::TranslatePath("special://temp/");
+  const std::string source = URIUtils::AddFileToFolder(folder, "TestFileCopySource.bin");
+  const std::string dest = URIUtils::AddFileToFolder(folder, "TestFileCopyDest.bin");
+  const size_t size = 256 * 1024 * 1024;
+
+  // the files are deleted however the test ends
+  struct SDeleteFiles
+  {
+    ~SDeleteFiles()
+    {
+      for (const std::string& path : paths)
+        XFILE::CFile::Delete(path);
+    }
+    std::vector<std::string> paths;
+  } files{{source, dest}};
+
+  ASSERT_TRUE(WriteContent(source, MakeContent(size)));
+
+  const auto megabytesPerSecond = [size](const std::chrono::steady_clock::time_point& start)
+  {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<int>(size / elapsed.count() / (1024 * 1024));
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(0, std::system(("cp '" + source + "' '" + dest + "'").c_str()));
+  RecordProperty("cp_mb_per_second", megabytesPerSecond(start));
+  XFILE::CFile::Delete(dest);
+
+  start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(XFILE::CFile::Copy(source, dest));
+  RecordProperty("local_mb_per_second", megabytesPerSecond(start));
+  XFILE::CFile::Delete(dest);
+
+  start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(XFILE::CFile::Copy("special://temp/TestFileCopySource.bin", dest));
+  RecordProperty("buffered_mb_per_second", megabytesPerSecond(start));
+
+  struct __stat64 buffer;
+  ASSERT_EQ(0, XFILE::CFile::Stat(dest, &buffer));
+  EXPECT_EQ(static_cast<int64_t>(size), buffer.st_size);
+}
+#endif
+
 TEST(TestFile, SetHidden)
 {
   XFILE::CFile *file;
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "XBDateTime.h"
+#include "filesystem/Directory.h"
+#include "filesystem/IDirectory.h"
+#include "filesystem/PersistentDirectoryCache.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <ctime>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr int64_t MTIME = 1700000000;
+
+void AddItems(CFileItemList& items, const std::string& path, int count)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    CFileItemPtr item(new CFileItem("movie" + std::to_string(i) + ".mkv"));
+    item->SetPath(path + item->GetLabel());
+    item->m_dwSize = 1000 + i;
+    item->m_dateTime = CDateTime(2023, 11, 14, 12, 0, i);
+    items.Add(item);
+  }
+}
+} // namespace
+
+class TestPersistentDirectoryCache : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    folder = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                       "TestPersistentDirectoryCache/");
+  }
+
+  void TearDown() override { CDirectory::RemoveRecursive(folder); }
+
+  std::string folder;
+};
+
+TEST_F(TestPersistentDirectoryCache, EncodesListings)
+{
+  const std::string path = "smb://nas/movies/";
+  CFileItemList items;
+  AddItems(items, path, 3);
+  CFileItemPtr folderItem(new CFileItem("Extras"));
+  folderItem->SetPath(path + "extras/");
+  folderItem->m_bIsFolder = true;
+  folderItem->SetProperty("file:hidden", true);
+  items.Add(folderItem);
+  CFileItemPtr other(new CFileItem("elsewhere"));
+  other->SetPath("nfs://nas/export/elsewhere.mkv");
+  items.Add(other);
+
+  const auto data = CPersistentDirectoryCache::Encode(path, DIR_FLAG_NO_FILE_DIRS, MTIME, items);
+
+  CFileItemList decoded;
+  ASSERT_TRUE(
+      CPersistentDirectoryCache::Decode(data, path, DIR_FLAG_NO_FILE_DIRS, MTIME, decoded));
+  ASSERT_EQ(items.Size(), decoded.Size());
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    EXPECT_EQ(items[i]->GetPath(), decoded[i]->GetPath());
+    EXPECT_EQ(items[i]->GetLabel(), decoded[i]->GetLabel());
+    EXPECT_EQ(items[i]->m_bIsFolder, decoded[i]->m_bIsFolder);
+    EXPECT_EQ(items[i]->m_dwSize, decoded[i]->m_dwSize);
+    EXPECT_EQ(items[i]->m_dateTime.IsValid(), decoded[i]->m_dateTime.IsValid());
+    if (items[i]->m_dateTime.IsValid())
+    {
+      EXPECT_EQ(items[i]->m_dateTime, decoded[i]->m_dateTime);
+    }
+    EXPECT_EQ(items[i]->GetProperty("file:hidden").asBoolean(),
+              decoded[i]->GetProperty("file:hidden").asBoolean());
+  }
+
+  // listings of another directory, time or kind, and damaged ones, are not used
+  CFileItemList rejected;
+  EXPECT_FALSE(CPersistentDirectoryCache::Decode(data, path, DIR_FLAG_NO_FILE_DIRS, MTIME + 1,
+                                                 rejected));
+  EXPECT_FALSE(CPersistentDirectoryCache::Decode(data, path, DIR_FLAG_NO_FILE_INFO, MTIME,
+                                                 rejected));
+  EXPECT_FALSE(CPersistentDirectoryCache::Decode(data, "smb://nas/music/", DIR_FLAG_NO_FILE_DIRS,
+                                                 MTIME, rejected));
+  auto truncated = data;
+  truncated.pop_back();
+  EXPECT_FALSE(CPersistentDirectoryCache::Decode(truncated, path, DIR_FLAG_NO_FILE_DIRS, MTIME,
+                                                 rejected));
+  EXPECT_EQ(0, rejected.Size());
+}
+
+TEST_F(TestPersistentDirectoryCache, KeepsListingsAcrossRestarts)
+{
+  const std::string path = "smb://nas/movies/";
+  CFileItemList items;
+  AddItems(items, path, 10);
+
+  {
+    CPersistentDirectoryCache cache;
+    cache.Initialize(folder, 1024 * 1024, 1024 * 1024);
+    ASSERT_TRUE(cache.IsEnabled());
+    cache.SetDirectory(path, 0, MTIME, items);
+
+    CFileItemList cached;
+    EXPECT_TRUE(cache.GetDirectory(path, 0, MTIME, cached));
+    EXPECT_EQ(10, cached.Size());
+    // the directory changed since
+    EXPECT_FALSE(cache.GetDirectory(path, 0, MTIME + 1, cached));
+    EXPECT_FALSE(cache.GetDirectory(path, 0, 0, cached));
+
+    // directories that may still change within the second are not kept
+    cache.SetDirectory("smb://nas/music/", 0, time(nullptr), items);
+    EXPECT_FALSE(cache.GetDirectory("smb://nas/music/", 0, time(nullptr), cached));
+  }
+
+  CPersistentDirectoryCache cache;
+  cache.Initialize(folder, 1024 * 1024, 0);
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory(path, 0, MTIME, cached));
+  ASSERT_EQ(10, cached.Size());
+  EXPECT_EQ(path + "movie9.mkv", cached[9]->GetPath());
+
+  cache.Clear();
+  EXPECT_FALSE(cache.GetDirectory(path, 0, MTIME, cached));
+}
+
+TEST_F(TestPersistentDirectoryCache, RemovesLeastRecentlyUsed)
+{
+  CFileItemList items[3];
+  for (int i = 0; i < 3; ++i)
+    AddItems(items[i], "smb://nas/movies/" + std::to_string(i) + "/", 100);
+  const size_t size =
+      CPersistentDirectoryCache::Encode("smb://nas/movies/0/", 0, MTIME, items[0]).size();
+
+  // room for two listings on disk and one in memory
+  CPersistentDirectoryCache cache;
+  cache.Initialize(folder, size * 2 + size / 2, size);
+  cache.SetDirectory("smb://nas/movies/0/", 0, MTIME, items[0]);
+  cache.SetDirectory("smb://nas/movies/1/", 0, MTIME, items[1]);
+
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory("smb://nas/movies/0/", 0, MTIME, cached));
+  cache.SetDirectory("smb://nas/movies/2/", 0, MTIME, items[2]);
+
+  EXPECT_TRUE(cache.GetDirectory("smb://nas/movies/0/", 0, MTIME, cached));
+  EXPECT_FALSE(cache.GetDirectory("smb://nas/movies/1/", 0, MTIME, cached));
+  EXPECT_TRUE(cache.GetDirectory("smb://nas/movies/2/", 0, MTIME, cached));
+}
+
+TEST_F(TestPersistentDirectoryCache, OnlyFileSystems)
+{
+  EXPECT_TRUE(CPersistentDirectoryCache::IsCacheable("/home/user/movies/"));
+  EXPECT_TRUE(CPersistentDirectoryCache::IsCacheable("smb://nas/movies/"));
+  EXPECT_TRUE(CPersistentDirectoryCache::IsCacheable("nfs://nas/export/movies/"));
+  EXPECT_FALSE(CPersistentDirectoryCache::IsCacheable("plugin://plugin.video.example/"));
+  EXPECT_FALSE(CPersistentDirectoryCache::IsCacheable("zip://%2fmovies%2fa.zip/"));
+  EXPECT_FALSE(CPersistentDirectoryCache::IsCacheable("videodb://movies/titles/"));
+}
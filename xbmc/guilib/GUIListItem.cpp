@@ -14,6 +14,7 @@
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
 #include <utility>
 
 bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
@@ -21,6 +22,53 @@ bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string
   return StringUtils::CompareNoCase(s1, s2) < 0;
 }
 
+bool CGUIListItem::PropertyMap::empty() const
+{
+  return m_values.empty();
+}
+
+size_t CGUIListItem::PropertyMap::size() const
+{
+  return m_values.size();
+}
+
+void CGUIListItem::PropertyMap::clear()
+{
+  m_values.clear();
+}
+
+CGUIListItem::PropertyMap::iterator CGUIListItem::PropertyMap::find(const std::string& key)
+{
+  const auto it = std::lower_bound(m_values.begin(), m_values.end(), key,
+                                   [](const value_type& value, const std::string& key) {
+                                     return icompare()(value.first, key);
+                                   });
+  return it != m_values.end() && !icompare()(key, it->first) ? it : m_values.end();
+}
+
+CGUIListItem::PropertyMap::const_iterator CGUIListItem::PropertyMap::find(
+    const std::string& key) const
+{
+  return const_cast<PropertyMap*>(this)->find(key);
+}
+
+std::pair<CGUIListItem::PropertyMap::iterator, bool> CGUIListItem::PropertyMap::insert(
+    value_type value)
+{
+  const auto it = std::lower_bound(m_values.begin(), m_values.end(), value.first,
+                                   [](const value_type& value, const std::string& key) {
+                                     return icompare()(value.first, key);
+                                   });
+  if (it != m_values.end() && !icompare()(value.first, it->first))
+    return {it, false};
+  return {m_values.insert(it, std::move(value)), true};
+}
+
+CGUIListItem::PropertyMap::iterator CGUIListItem::PropertyMap::erase(const_iterator position)
+{
+  return m_values.erase(position);
+}
+
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
   *this = item;
@@ -16,6 +16,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
@@ -188,7 +190,35 @@ protected:
     bool operator()(const std::string &s1, const std::string &s2) const;
   };
 
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
+  /*!
+   \brief The properties of an item sorted by key without regard to case, in one allocation as
+   items mostly have a few of them.
+   */
+  class PropertyMap
+  {
+  public:
+    typedef std::pair<std::string, CVariant> value_type;
+    typedef std::vector<value_type>::iterator iterator;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+    bool empty() const;
+    size_t size() const;
+    void clear();
+
+    iterator find(const std::string& key);
+    const_iterator find(const std::string& key) const;
+    //! Insert a property unless one has the same key, like std::map::insert
+    std::pair<iterator, bool> insert(value_type value);
+    iterator erase(const_iterator position);
+
+  private:
+    std::vector<value_type> m_values;
+  };
+
   PropertyMap m_mapProperties;
 private:
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
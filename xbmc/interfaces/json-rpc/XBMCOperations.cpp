@@ -9,6 +9,7 @@
 #include "XBMCOperations.h"
 
 #include "ServiceBroker.h"
+#include "dbwrappers/QueryProfiler.h"
 #include "messaging/ApplicationMessenger.h"
 #include "powermanagement/PowerManager.h"
 #include "utils/Variant.h"
@@ -86,3 +87,35 @@ JSONRPC_STATUS CXBMCOperations::GetInfoBooleans(const std::string &method, ITran
 
   return OK;
 }
+
+JSONRPC_STATUS CXBMCOperations::GetQueryProfile(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CQueryProfiler& profiler = CQueryProfiler::GetInstance();
+
+  result["enabled"] = profiler.IsEnabled();
+  result["slowthreshold"] = static_cast<int64_t>(profiler.GetSlowThreshold().count());
+  result["buckets"] = CVariant(CVariant::VariantTypeArray);
+  for (unsigned int limit : CQueryProfiler::BUCKET_LIMITS)
+    result["buckets"].push_back(limit);
+  result["untracked"] = profiler.GetUntracked();
+
+  result["queries"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto& entry : profiler.GetEntries(static_cast<size_t>(parameterObject["limit"].asUnsignedInteger())))
+  {
+    CVariant query;
+    query["query"] = entry.sql;
+    query["count"] = entry.count;
+    query["totaltime"] = entry.total.count() / 1000.0;
+    query["maxtime"] = entry.max.count() / 1000.0;
+    query["histogram"] = CVariant(CVariant::VariantTypeArray);
+    for (unsigned int count : entry.histogram)
+      query["histogram"].push_back(count);
+    query["plan"] = entry.plan;
+    result["queries"].push_back(query);
+  }
+
+  if (parameterObject["reset"].asBoolean())
+    profiler.Reset();
+
+  return OK;
+}
@@ -31,6 +31,7 @@
 #include "events/NotificationEvent.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryChecker.h"
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "guilib/GUIComponent.h"
@@ -61,7 +62,10 @@
 #include "utils/XMLUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <cmath>
 #include <inttypes.h>
+#include <map>
 
 using namespace XFILE;
 using namespace MUSICDATABASEDIRECTORY;
@@ -240,6 +244,15 @@ void CMusicDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create removed_link table");
   m_pDS->exec("CREATE TABLE removed_link (idArtist INTEGER, idMedia INTEGER, idRole INTEGER)");
+
+  CLog::Log(LOGINFO, "create sortkey table");
+  CreateSortKeyTable();
+
+  CLog::Log(LOGINFO, "create searchindex table");
+  CreateSearchIndexTable();
+
+  CLog::Log(LOGINFO, "create pathcheck table");
+  CreatePathCheckTable();
 }
 
 void CMusicDatabase::CreateAnalytics()
@@ -291,24 +304,28 @@ void CMusicDatabase::CreateAnalytics()
 
   m_pDS->exec("CREATE INDEX ix_art ON art(media_id, media_type(20), type(20))");
 
+  m_pDS->exec("CREATE UNIQUE INDEX ix_sortkey ON sortkey (media_id, media_type(20))");
+  CreateSearchIndexAnalytics();
+
   CLog::Log(LOGINFO, "create triggers");
   m_pDS->exec("CREATE TRIGGER tgrDeleteAlbum AFTER delete ON album FOR EACH ROW BEGIN"
               "  DELETE FROM song WHERE song.idAlbum = old.idAlbum;"
               "  DELETE FROM album_artist WHERE album_artist.idAlbum = old.idAlbum;"
               "  DELETE FROM album_source WHERE album_source.idAlbum = old.idAlbum;"
-              "  DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album';"
-              " END");
+              "  DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album';" +
+              GetSearchIndexDeleteSQL("old.idAlbum", MediaTypeAlbum) + " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteArtist AFTER delete ON artist FOR EACH ROW BEGIN"
               "  DELETE FROM album_artist WHERE album_artist.idArtist = old.idArtist;"
               "  DELETE FROM song_artist WHERE song_artist.idArtist = old.idArtist;"
               "  DELETE FROM discography WHERE discography.idArtist = old.idArtist;"
-              "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist';"
-              " END");
+              "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist';" +
+              GetSearchIndexDeleteSQL("old.idArtist", MediaTypeArtist) + " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSong AFTER delete ON song FOR EACH ROW BEGIN"
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
               "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
-              " END");
+              "  DELETE FROM sortkey WHERE media_id=old.idSong AND media_type='song';" +
+              GetSearchIndexDeleteSQL("old.idSong", MediaTypeSong) + " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSource AFTER delete ON source FOR EACH ROW BEGIN"
               "  DELETE FROM source_path WHERE source_path.idSource = old.idSource;"
               "  DELETE FROM album_source WHERE album_source.idSource = old.idSource;"
@@ -1042,25 +1059,43 @@ int CMusicDatabase::AddSong(const int idSong,
     SplitPath(strPathAndFileName, strPath, strFileName);
     int idPath = AddPath(strPath);
 
+    bool found = false;
     if (idSong <= 1)
     {
+      std::unique_ptr<dbiplus::Statement> select;
       if (!strMusicBrainzTrackID.empty())
-        strSQL = PrepareSQL("SELECT idSong FROM song WHERE "
-                            "idAlbum = %i AND iTrack=%i AND strMusicBrainzTrackID = '%s'",
-                            idAlbum, iTrack, strMusicBrainzTrackID.c_str());
+      {
+        strSQL = "SELECT idSong FROM song WHERE "
+                 "idAlbum=? AND iTrack=? AND strMusicBrainzTrackID=?";
+        select = PrepareStatement(strSQL);
+        if (!select)
+          return -1;
+        select->bind(0, idAlbum);
+        select->bind(1, iTrack);
+        select->bind(2, strMusicBrainzTrackID);
+      }
       else
-        strSQL = PrepareSQL("SELECT idSong FROM song WHERE "
-                            "idAlbum=%i AND strFileName='%s' AND strTitle='%s' AND iTrack=%i "
-                            "AND strMusicBrainzTrackID IS NULL",
-                            idAlbum, strFileName.c_str(), strTitle.c_str(), iTrack);
+      {
+        strSQL = "SELECT idSong FROM song WHERE "
+                 "idAlbum=? AND strFileName=? AND strTitle=? AND iTrack=? "
+                 "AND strMusicBrainzTrackID IS NULL";
+        select = PrepareStatement(strSQL);
+        if (!select)
+          return -1;
+        select->bind(0, idAlbum);
+        select->bind(1, strFileName);
+        select->bind(2, strTitle);
+        select->bind(3, iTrack);
+      }
 
-      if (!m_pDS->query(strSQL))
-        return -1;
+      if (select->step())
+      {
+        found = true;
+        idNew = select->get_asInt(0);
+      }
     }
-    if (m_pDS->num_rows() == 0)
+    if (!found)
     {
-      m_pDS->close();
-
       // As all discs in a boxset have to have a title, generate one in the form of 'Disc N'
       bool isBoxset = IsAlbumBoxset(idAlbum);
       if (isBoxset && strDiscSubtitle.empty())
@@ -1085,51 +1120,73 @@ int CMusicDatabase::AddSong(const int idSong,
                "strDiscSubtitle, strFileName, dateAdded,  "
                "strMusicBrainzTrackID, strArtistSort, "
                "iTimesPlayed, iStartOffset, iEndOffset, "
-               "lastplayed, rating, userrating, votes, comment, mood, strReplayGain) ";
+               "lastplayed, rating, userrating, votes, comment, mood, strReplayGain) "
+               "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+               "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+      const auto insert = PrepareStatement(strSQL);
+      if (!insert)
+        return -1;
 
+      int param = 0;
       if (idSong <= 0)
+      {
         // Song ID is autoincremented and dateNew set by trigger
-        strSQL += PrepareSQL("VALUES (NULL, NULL, ");
+        insert->bind_null(param++);
+        insert->bind_null(param++);
+      }
       else
+      {
         //Reuse song Id and original date when the Id added
-        strSQL += PrepareSQL("VALUES (%i, '%s', ", idSong, dtDateNew.GetAsDBDateTime().c_str());
-
-      strSQL +=
-          PrepareSQL("%i, %i, '%s', '%s', %i, %i, '%s', '%s', %i, %i, %i, %i,'%s', '%s', '%s' ",
-                     idAlbum, idPath, artistDisp.c_str(), strTitle.c_str(), iTrack, iDuration,
-                     strRelease.c_str(), strOriginal.c_str(), iBPM, iBitRate, iSampleRate,
-                     iChannels, strDiscSubtitle.c_str(), strFileName.c_str(), strDateMedia.c_str());
-
+        insert->bind(param++, idSong);
+        insert->bind(param++, dtDateNew.GetAsDBDateTime());
+      }
+      insert->bind(param++, idAlbum);
+      insert->bind(param++, idPath);
+      insert->bind(param++, artistDisp);
+      insert->bind(param++, strTitle);
+      insert->bind(param++, iTrack);
+      insert->bind(param++, iDuration);
+      insert->bind(param++, strRelease);
+      insert->bind(param++, strOriginal);
+      insert->bind(param++, iBPM);
+      insert->bind(param++, iBitRate);
+      insert->bind(param++, iSampleRate);
+      insert->bind(param++, iChannels);
+      insert->bind(param++, strDiscSubtitle);
+      insert->bind(param++, strFileName);
+      insert->bind(param++, strDateMedia);
       if (strMusicBrainzTrackID.empty())
-        strSQL += PrepareSQL(",NULL");
+        insert->bind_null(param++);
       else
-        strSQL += PrepareSQL(",'%s'", strMusicBrainzTrackID.c_str());
+        insert->bind(param++, strMusicBrainzTrackID);
       if (artistSort.empty() || artistSort.compare(artistDisp) == 0)
-        strSQL += PrepareSQL(",NULL");
+        insert->bind_null(param++);
       else
-        strSQL += PrepareSQL(",'%s'", artistSort.c_str());
-
+        insert->bind(param++, artistSort);
+      insert->bind(param++, iTimesPlayed);
+      insert->bind(param++, iStartOffset);
+      insert->bind(param++, iEndOffset);
       if (dtLastPlayed.IsValid())
-        strSQL += PrepareSQL(",%i,%i,%i,'%s', %.1f, %i, %i, '%s','%s', '%s')", //
-                             iTimesPlayed, iStartOffset, iEndOffset,
-                             dtLastPlayed.GetAsDBDateTime().c_str(), //
-                             static_cast<double>(rating), userrating, votes, //
-                             strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
+        insert->bind(param++, dtLastPlayed.GetAsDBDateTime());
       else
-        strSQL += PrepareSQL(",%i,%i,%i,NULL, %.1f, %i, %i,'%s', '%s', '%s')", //
-                             iTimesPlayed, iStartOffset, iEndOffset, //
-                             static_cast<double>(rating), userrating, votes, //
-                             strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
-      m_pDS->exec(strSQL);
+        insert->bind_null(param++);
+      // stored with one decimal, as it was formatted into the query before
+      insert->bind(param++, std::nearbyint(static_cast<double>(rating) * 10.0) / 10.0);
+      insert->bind(param++, userrating);
+      insert->bind(param++, votes);
+      insert->bind(param++, strComment);
+      insert->bind(param++, strMood);
+      insert->bind(param++, replayGain.Get());
+      insert->execute();
       if (idSong <= 0)
-        idNew = (int)m_pDS->lastinsertid();
+        idNew = static_cast<int>(insert->lastinsertid());
       else
         idNew = idSong;
+      SetSortKey(idNew, MediaTypeSong, strTitle);
+      UpdateSearchIndex(MediaTypeSong, idNew);
     }
     else
     {
-      idNew = m_pDS->fv("idSong").get_asInt();
-      m_pDS->close();
       UpdateSong(idNew, //
                  strTitle, //
                  strMusicBrainzTrackID, //
@@ -1361,7 +1418,11 @@ int CMusicDatabase::UpdateSong(int idSong,
   bool status = ExecuteQuery(strSQL);
 
   if (status)
+  {
+    SetSortKey(idSong, MediaTypeSong, strTitle);
+    UpdateSearchIndex(MediaTypeSong, idSong);
     AnnounceUpdate(MediaTypeSong, idSong);
+  }
   return idSong;
 }
 
@@ -1432,7 +1493,9 @@ int CMusicDatabase::AddAlbum(const std::string& strAlbum,
       strSQL += ")";
       m_pDS->exec(strSQL);
 
-      return (int)m_pDS->lastinsertid();
+      const int idAlbum = static_cast<int>(m_pDS->lastinsertid());
+      UpdateSearchIndex(MediaTypeAlbum, idAlbum);
+      return idAlbum;
     }
     else
     {
@@ -1472,6 +1535,7 @@ int CMusicDatabase::AddAlbum(const std::string& strAlbum,
                      bCompilation, CAlbum::ReleaseTypeToString(releaseType).c_str(), //
                      idAlbum);
       m_pDS->exec(strSQL);
+      UpdateSearchIndex(MediaTypeAlbum, idAlbum);
       DeleteAlbumArtistsByAlbum(idAlbum);
       DeleteAlbumSources(idAlbum);
       return idAlbum;
@@ -1556,7 +1620,10 @@ int CMusicDatabase::UpdateAlbum(int idAlbum,
 
   bool status = ExecuteQuery(strSQL);
   if (status)
+  {
+    UpdateSearchIndex(MediaTypeAlbum, idAlbum);
     AnnounceUpdate(MediaTypeAlbum, idAlbum);
+  }
   return idAlbum;
 }
 
@@ -1861,6 +1928,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
                               strArtist.c_str(), idArtist);
           m_pDS->exec(strSQL);
           m_pDS->close();
+          UpdateSearchIndex(MediaTypeArtist, idArtist);
         }
         return idArtist;
       }
@@ -1883,6 +1951,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
                        "bScrapedMBID = %i WHERE idArtist = %i",
                        strArtist.c_str(), strMusicBrainzArtistID.c_str(), bScrapedMBID, idArtist);
         m_pDS->exec(strSQL);
+        UpdateSearchIndex(MediaTypeArtist, idArtist);
         return idArtist;
       }
 
@@ -1919,6 +1988,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
 
     m_pDS->exec(strSQL);
     int idArtist = (int)m_pDS->lastinsertid();
+    UpdateSearchIndex(MediaTypeArtist, idArtist);
     return idArtist;
   }
   catch (...)
@@ -2004,7 +2074,10 @@ int CMusicDatabase::UpdateArtist(int idArtist,
 
   bool status = ExecuteQuery(strSQL);
   if (status)
+  {
+    UpdateSearchIndex(MediaTypeArtist, idArtist);
     AnnounceUpdate(MediaTypeArtist, idArtist);
+  }
   return idArtist;
 }
 
@@ -3035,26 +3108,31 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL = PrepareSQL("SELECT * FROM path WHERE strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL);
-    if (m_pDS->num_rows() == 0)
+    strSQL = "SELECT idPath FROM path WHERE strPath=?";
+    const auto select = PrepareStatement(strSQL);
+    if (!select)
+      return -1;
+
+    select->bind(0, strPath);
+    if (!select->step())
     {
-      m_pDS->close();
       // doesn't exists, add it
-      strSQL = PrepareSQL("INSERT INTO path (idPath, strPath) "
-                          "VALUES(NULL, '%s')",
-                          strPath.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "INSERT INTO path (idPath, strPath) VALUES(NULL, ?)";
+      const auto insert = PrepareStatement(strSQL);
+      if (!insert)
+        return -1;
 
-      int idPath = (int)m_pDS->lastinsertid();
+      insert->bind(0, strPath);
+      insert->execute();
+
+      int idPath = static_cast<int>(insert->lastinsertid());
       m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
       return idPath;
     }
     else
     {
-      int idPath = m_pDS->fv("idPath").get_asInt();
+      int idPath = select->get_asInt(0);
       m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
-      m_pDS->close();
       return idPath;
     }
   }
@@ -3477,7 +3555,12 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList& art
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    std::string order;
+    const std::string match = GetSearchIndexFilter(search, MediaTypeArtist, "idArtist", order);
+    if (!match.empty())
+      strSQL = PrepareSQL("SELECT * FROM artist WHERE %s AND strArtist <> '%s' ORDER BY %s",
+                          match.c_str(), strVariousArtists.c_str(), order.c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM artist "
                           "WHERE (strArtist LIKE '%s%%' OR strArtist LIKE '%% %s%%') "
                           "AND strArtist <> '%s' ",
@@ -4124,7 +4207,11 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList& items
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    std::string order;
+    const std::string match = GetSearchIndexFilter(search, MediaTypeSong, "idSong", order);
+    if (!match.empty())
+      strSQL = "SELECT * FROM songview WHERE " + match + " ORDER BY " + order;
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM songview "
                           "WHERE strTitle LIKE '%s%%' or strTitle LIKE '%% %s%%' LIMIT 1000",
                           search.c_str(), search.c_str());
@@ -4167,7 +4254,11 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList& albu
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    std::string order;
+    const std::string match = GetSearchIndexFilter(search, MediaTypeAlbum, "idAlbum", order);
+    if (!match.empty())
+      strSQL = "SELECT * FROM albumview WHERE " + match + " ORDER BY " + order;
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM albumview "
                           "WHERE strAlbum LIKE '%s%%' OR strAlbum LIKE '%% %s%%'",
                           search.c_str(), search.c_str());
@@ -4203,7 +4294,7 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList& albu
   return false;
 }
 
-bool CMusicDatabase::CleanupSongsByIds(const std::string& strSongIds)
+bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr*/)
 {
   try
   {
@@ -4211,23 +4302,29 @@ bool CMusicDatabase::CleanupSongsByIds(const std::string& strSongIds)
       return false;
     if (nullptr == m_pDS)
       return false;
-    // ok, now find all idSong's
-    std::string strSQL = PrepareSQL("SELECT * FROM song JOIN path ON song.idPath = path.idPath "
-                                    "WHERE song.idSong IN %s",
-                                    strSongIds.c_str());
-    if (!m_pDS->query(strSQL))
-      return false;
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
+
+    // Only the directories changed since the last clean found all of their songs are listed,
+    // the others are trusted after a stat
+    const std::map<int, int64_t> pathChecks = GetPathChecks(PATH_CHECK_MAX_AGE);
+    std::vector<CDirectoryChecker::Directory> directories;
+    std::map<std::string, size_t> directoryIndexes;
+    std::map<size_t, int> directoryPathIds;
+    struct PendingSong
     {
-      m_pDS->close();
-      return true;
-    }
-    std::vector<std::string> songsToDelete;
+      std::string idSong;
+      std::string path;
+      size_t directory;
+    };
+    std::vector<PendingSong> pendingSongs;
+
+    if (!m_pDS->query("SELECT song.idSong, song.strFileName, path.idPath, path.strPath "
+                      "FROM song JOIN path ON song.idPath = path.idPath"))
+      return false;
     while (!m_pDS->eof())
     { // get the full song path
-      std::string strFileName = URIUtils::AddFileToFolder(
-          m_pDS->fv("path.strPath").get_asString(), m_pDS->fv("song.strFileName").get_asString());
+      const std::string strPath = m_pDS->fv("path.strPath").get_asString();
+      std::string strFileName =
+          URIUtils::AddFileToFolder(strPath, m_pDS->fv("song.strFileName").get_asString());
 
       //  Special case for streams inside an audio decoder package file.
       //  The last dir in the path is the audio file that
@@ -4240,85 +4337,82 @@ bool CMusicDatabase::CleanupSongsByIds(const std::string& strSongIds)
         URIUtils::RemoveSlashAtEnd(strFileName);
       }
 
-      if (!CFile::Exists(strFileName, false))
-      { // file no longer exists, so add to deletion list
-        songsToDelete.push_back(m_pDS->fv("song.idSong").get_asString());
+      const std::string strDirectory = URIUtils::GetDirectory(strFileName);
+      auto directory = directoryIndexes.find(strDirectory);
+      if (directory == directoryIndexes.end())
+      {
+        CDirectoryChecker::Directory checked;
+        checked.path = strDirectory;
+        // the modification time is only tracked for the directories of the path table
+        if (URIUtils::PathEquals(strDirectory, strPath))
+        {
+          const int idPath = m_pDS->fv("path.idPath").get_asInt();
+          const auto pathCheck = pathChecks.find(idPath);
+          if (pathCheck != pathChecks.end())
+            checked.knownMTime = pathCheck->second;
+          directoryPathIds[directories.size()] = idPath;
+        }
+        directory = directoryIndexes.emplace(strDirectory, directories.size()).first;
+        directories.push_back(std::move(checked));
       }
+      pendingSongs.push_back(
+          {m_pDS->fv("song.idSong").get_asString(), strFileName, directory->second});
       m_pDS->next();
     }
     m_pDS->close();
-
-    if (!songsToDelete.empty())
-    {
-      std::string strSongsToDelete = "(" + StringUtils::Join(songsToDelete, ",") + ")";
-      // ok, now delete these songs + all references to them from the linked tables
-      strSQL = "delete from song where idSong in " + strSongsToDelete;
-      m_pDS->exec(strSQL);
-      m_pDS->close();
-    }
-    return true;
-  }
-  catch (...)
-  {
-    CLog::Log(LOGERROR, "Exception in CMusicDatabase::CleanupSongsFromPaths()");
-  }
-  return false;
-}
-
-bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr*/)
-{
-  try
-  {
-    int total;
-    // Count total number of songs
-    total = GetSingleValueInt("SELECT COUNT(1) FROM song", m_pDS);
     // No songs to clean
-    if (total == 0)
+    if (pendingSongs.empty())
       return true;
 
-    // run through all songs and get all unique path ids
-    int iLIMIT = 1000;
-    for (int i = 0;; i += iLIMIT)
+    CLog::Log(LOGDEBUG, "Checking {} songs in {} directories", pendingSongs.size(),
+              directories.size());
+    const bool checked = CDirectoryChecker().Check(
+        directories,
+        [progressDialog](size_t current, size_t total)
+        {
+          if (!progressDialog)
+            return true;
+          int percentage = current * 100 / total;
+          if (percentage > progressDialog->GetPercentage())
+          {
+            progressDialog->SetPercentage(percentage);
+            progressDialog->Progress();
+          }
+          return !progressDialog->IsCanceled();
+        });
+    if (!checked)
+      return false;
+
+    std::vector<std::string> songsToDelete;
+    std::vector<bool> directoryComplete(directories.size(), true);
+    for (const auto& song : pendingSongs)
     {
-      std::string strSQL = PrepareSQL("SELECT song.idSong FROM song "
-                                      "ORDER BY song.idSong LIMIT %i OFFSET %i",
-                                      iLIMIT, i);
-      if (!m_pDS->query(strSQL))
-        return false;
-      int iRowsFound = m_pDS->num_rows();
-      // keep going until no rows are left!
-      if (iRowsFound == 0)
-      {
-        m_pDS->close();
-        return true;
+      if (!CDirectoryChecker::Exists(directories[song.directory], song.path))
+      { // file no longer exists, so add to deletion list
+        songsToDelete.push_back(song.idSong);
+        directoryComplete[song.directory] = false;
       }
+    }
 
-      std::vector<std::string> songIds;
-      while (!m_pDS->eof())
-      {
-        songIds.push_back(m_pDS->fv("song.idSong").get_asString());
-        m_pDS->next();
-      }
-      m_pDS->close();
-      std::string strSongIds = "(" + StringUtils::Join(songIds, ",") + ")";
-      CLog::Log(LOGDEBUG, "Checking songs from song ID list: {}", strSongIds);
-      if (progressDialog)
-      {
-        int percentage = i * 100 / total;
-        if (percentage > progressDialog->GetPercentage())
-        {
-          progressDialog->SetPercentage(percentage);
-          progressDialog->Progress();
-        }
-        if (progressDialog->IsCanceled())
-        {
-          m_pDS->close();
-          return false;
-        }
-      }
-      if (!CleanupSongsByIds(strSongIds))
-        return false;
+    // ok, now delete these songs + all references to them from the linked tables
+    const size_t iLIMIT = 1000;
+    for (size_t i = 0; i < songsToDelete.size(); i += iLIMIT)
+    {
+      const std::vector<std::string> songIds(
+          songsToDelete.begin() + i,
+          songsToDelete.begin() + std::min(i + iLIMIT, songsToDelete.size()));
+      m_pDS->exec("DELETE FROM song WHERE idSong IN (" + StringUtils::Join(songIds, ",") + ")");
+    }
+
+    std::map<int, int64_t> completePaths;
+    for (const auto& directoryPathId : directoryPathIds)
+    {
+      const CDirectoryChecker::Directory& directory = directories[directoryPathId.first];
+      if ((directory.unchanged || directory.listed) && directory.mtime != 0 &&
+          directoryComplete[directoryPathId.first])
+        completePaths[directoryPathId.second] = directory.mtime;
     }
+    SetPathChecks(completePaths);
     return true;
   }
   catch (...)
@@ -4622,6 +4716,7 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress* progressDialog /*= nullptr*/)
     ret = ERROR_REORG_PATH;
     goto error;
   }
+  CleanPathChecks();
   // and finally artists + genres
   if (progressDialog)
   {
@@ -5513,6 +5608,9 @@ bool CMusicDatabase::GetArtistsByWhere(
   if (nullptr == m_pDS)
     return false;
 
+  // listings read the last commit of the scanner without waiting for the next one
+  const std::unique_ptr<dbiplus::Dataset>& pDS = GetReadDataset();
+
   try
   {
     auto start = std::chrono::steady_clock::now();
@@ -5564,10 +5662,10 @@ bool CMusicDatabase::GetArtistsByWhere(
         if (!BuildSQL(strSQLWhere, countFilter, strSQLWhere))
           return false;
         total = GetSingleValueInt(
-            "SELECT COUNT(DISTINCT artistview.idArtist) FROM artistview " + strSQLWhere, m_pDS);
+            "SELECT COUNT(DISTINCT artistview.idArtist) FROM artistview " + strSQLWhere, pDS);
       }
       else
-        total = GetSingleValueInt("SELECT COUNT(1) FROM artistview " + strSQLExtra, m_pDS);
+        total = GetSingleValueInt("SELECT COUNT(1) FROM artistview " + strSQLExtra, pDS);
     }
     if (countOnly)
     {
@@ -5575,12 +5673,17 @@ bool CMusicDatabase::GetArtistsByWhere(
       pItem->SetProperty("total", total);
       items.Add(pItem);
 
-      m_pDS->close();
+      pDS->close();
       return true;
     }
 
     // Apply any limiting directly in SQL and so sort as well
-    if (limitedInSQL)
+    if (limitedInSQL && sorting.sortBy == SortByRandom)
+    {
+      if (!SetRandomLimitFilter("artistview.idArtist", strSQLExtra, sorting, extFilter))
+        return false;
+    }
+    else if (limitedInSQL)
     {
       extFilter.limit = DatabaseUtils::BuildLimitClauseOnly(sorting.limitEnd, sorting.limitStart);
     }
@@ -5607,12 +5710,12 @@ bool CMusicDatabase::GetArtistsByWhere(
     // run query
     CLog::Log(LOGDEBUG, "{} query: {}", __FUNCTION__, strSQL);
     auto queryStart = std::chrono::steady_clock::now();
-    if (!m_pDS->query(strSQL))
+    if (!pDS->query(strSQL))
       return false;
-    int iRowsFound = m_pDS->num_rows();
+    int iRowsFound = pDS->num_rows();
     if (iRowsFound == 0)
     {
-      m_pDS->close();
+      pDS->close();
       return true;
     }
 
@@ -5629,7 +5732,7 @@ bool CMusicDatabase::GetArtistsByWhere(
     results.reserve(iRowsFound);
     // Populate results field vector from dataset
     FieldList fields;
-    if (!DatabaseUtils::GetDatabaseResults(MediaTypeArtist, fields, m_pDS, results))
+    if (!DatabaseUtils::GetDatabaseResults(MediaTypeArtist, fields, pDS, results))
       return false;
     // Store item list sort order
     items.SetSortMethod(sortDescription.sortBy);
@@ -5637,7 +5740,7 @@ bool CMusicDatabase::GetArtistsByWhere(
 
     // Get Artists from returned rows
     items.Reserve(results.size());
-    const dbiplus::query_data& data = m_pDS->get_result_set().records;
+    const dbiplus::query_data& data = pDS->get_result_set().records;
     for (const auto& i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
@@ -5663,13 +5766,13 @@ bool CMusicDatabase::GetArtistsByWhere(
       }
       catch (...)
       {
-        m_pDS->close();
+        pDS->close();
         CLog::Log(LOGERROR, "{} - out of memory getting listing (got {})", __FUNCTION__,
                   items.Size());
       }
     }
     // cleanup
-    m_pDS->close();
+    pDS->close();
 
     auto end = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -5681,7 +5784,7 @@ bool CMusicDatabase::GetArtistsByWhere(
   }
   catch (...)
   {
-    m_pDS->close();
+    pDS->close();
     CLog::Log(LOGERROR, "{} failed", __FUNCTION__);
   }
   return false;
@@ -5753,6 +5856,8 @@ bool CMusicDatabase::GetAlbumsByWhere(
   if (m_pDB == nullptr || m_pDS == nullptr)
     return false;
 
+  const std::unique_ptr<dbiplus::Dataset>& pDS = GetReadDataset();
+
   try
   {
     auto start = std::chrono::steady_clock::now();
@@ -5793,10 +5898,10 @@ bool CMusicDatabase::GetAlbumsByWhere(
         if (!BuildSQL(strSQLWhere, countFilter, strSQLWhere))
           return false;
         total = GetSingleValueInt(
-            "SELECT COUNT(DISTINCT albumview.idAlbum) FROM albumview " + strSQLWhere, m_pDS);
+            "SELECT COUNT(DISTINCT albumview.idAlbum) FROM albumview " + strSQLWhere, pDS);
       }
       else
-        total = GetSingleValueInt("SELECT COUNT(1) FROM albumview " + strSQLExtra, m_pDS);
+        total = GetSingleValueInt("SELECT COUNT(1) FROM albumview " + strSQLExtra, pDS);
     }
     if (countOnly)
     {
@@ -5804,12 +5909,17 @@ bool CMusicDatabase::GetAlbumsByWhere(
       pItem->SetProperty("total", total);
       items.Add(pItem);
 
-      m_pDS->close();
+      pDS->close();
       return true;
     }
 
     // Apply any limiting directly in SQL
-    if (limitedInSQL)
+    if (limitedInSQL && sorting.sortBy == SortByRandom)
+    {
+      if (!SetRandomLimitFilter("albumview.idAlbum", strSQLExtra, sorting, extFilter))
+        return false;
+    }
+    else if (limitedInSQL)
     {
       extFilter.limit = DatabaseUtils::BuildLimitClauseOnly(sorting.limitEnd, sorting.limitStart);
     }
@@ -5842,12 +5952,12 @@ bool CMusicDatabase::GetAlbumsByWhere(
     // run query
     CLog::Log(LOGDEBUG, "{} query: {}", __FUNCTION__, strSQL);
     auto querytime = std::chrono::steady_clock::now();
-    if (!m_pDS->query(strSQL))
+    if (!pDS->query(strSQL))
       return false;
-    int iRowsFound = m_pDS->num_rows();
+    int iRowsFound = pDS->num_rows();
     if (iRowsFound == 0)
     {
-      m_pDS->close();
+      pDS->close();
       return true;
     }
 
@@ -5864,7 +5974,7 @@ bool CMusicDatabase::GetAlbumsByWhere(
     results.reserve(iRowsFound);
     // Populate results field vector from dataset
     FieldList fields;
-    if (!DatabaseUtils::GetDatabaseResults(MediaTypeAlbum, fields, m_pDS, results))
+    if (!DatabaseUtils::GetDatabaseResults(MediaTypeAlbum, fields, pDS, results))
       return false;
     // Store item list sort order
     items.SetSortMethod(sorting.sortBy);
@@ -5872,7 +5982,7 @@ bool CMusicDatabase::GetAlbumsByWhere(
 
     // Get albums from returned rows
     items.Reserve(results.size());
-    const dbiplus::query_data& data = m_pDS->get_result_set().records;
+    const dbiplus::query_data& data = pDS->get_result_set().records;
     for (const auto& i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
@@ -5892,13 +6002,13 @@ bool CMusicDatabase::GetAlbumsByWhere(
       }
       catch (...)
       {
-        m_pDS->close();
+        pDS->close();
         CLog::Log(LOGERROR, "{} - out of memory getting listing (got {})", __FUNCTION__,
                   items.Size());
       }
     }
     // cleanup
-    m_pDS->close();
+    pDS->close();
 
     auto end = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -5910,7 +6020,7 @@ bool CMusicDatabase::GetAlbumsByWhere(
   }
   catch (...)
   {
-    m_pDS->close();
+    pDS->close();
     CLog::Log(LOGERROR, "{} ({}) failed", __FUNCTION__, filter.where);
   }
   return false;
@@ -6152,6 +6262,8 @@ bool CMusicDatabase::GetSongsFullByWhere(
   if (m_pDB == nullptr || m_pDS == nullptr)
     return false;
 
+  const std::unique_ptr<dbiplus::Dataset>& pDS = GetReadDataset();
+
   try
   {
     auto start = std::chrono::steady_clock::now();
@@ -6187,19 +6299,24 @@ bool CMusicDatabase::GetSongsFullByWhere(
                                       extFilter.where.find("strPath") != std::string::npos ||
                                       extFilter.where.find("bCompilation") != std::string::npos ||
                                       extFilter.where.find("bBoxedset") != std::string::npos)))
-      total = GetSingleValueInt("SELECT COUNT(1) FROM songview " + strSQLExtra, m_pDS);
+      total = GetSingleValueInt("SELECT COUNT(1) FROM songview " + strSQLExtra, pDS);
     else
     {
       std::string strSQLsong = strSQLExtra;
       StringUtils::Replace(strSQLsong, "songview", "song");
-      total = GetSingleValueInt("SELECT COUNT(1) FROM song " + strSQLsong, m_pDS);
+      total = GetSingleValueInt("SELECT COUNT(1) FROM song " + strSQLsong, pDS);
     }
 
     if (extended)
       extFilter.AppendGroup("songview.idSong");
 
     // Apply any limiting directly in SQL
-    if (limitedInSQL)
+    if (limitedInSQL && sorting.sortBy == SortByRandom)
+    {
+      if (!SetRandomLimitFilter("songview.idSong", strSQLExtra, sorting, extFilter))
+        return false;
+    }
+    else if (limitedInSQL)
     {
       extFilter.limit = DatabaseUtils::BuildLimitClauseOnly(sorting.limitEnd, sorting.limitStart);
     }
@@ -6277,13 +6394,13 @@ bool CMusicDatabase::GetSongsFullByWhere(
     CLog::Log(LOGDEBUG, "{} query = {}", __FUNCTION__, strSQL);
     auto queryStart = std::chrono::steady_clock::now();
     // run query
-    if (!m_pDS->query(strSQL))
+    if (!pDS->query(strSQL))
       return false;
 
-    int iRowsFound = m_pDS->num_rows();
+    int iRowsFound = pDS->num_rows();
     if (iRowsFound == 0)
     {
-      m_pDS->close();
+      pDS->close();
       return true;
     }
 
@@ -6298,7 +6415,7 @@ bool CMusicDatabase::GetSongsFullByWhere(
     results.reserve(iRowsFound);
     // Populate results field vector from dataset
     FieldList fields;
-    if (!DatabaseUtils::GetDatabaseResults(MediaTypeSong, fields, m_pDS, results))
+    if (!DatabaseUtils::GetDatabaseResults(MediaTypeSong, fields, pDS, results))
       return false;
     // Store item list sort order
     items.SetSortMethod(sorting.sortBy);
@@ -6309,7 +6426,7 @@ bool CMusicDatabase::GetSongsFullByWhere(
     int songArtistOffset = song_enumCount;
     int songId = -1;
     VECARTISTCREDITS artistCredits;
-    const dbiplus::query_data& data = m_pDS->get_result_set().records;
+    const dbiplus::query_data& data = pDS->get_result_set().records;
     int count = 0;
     for (const auto& i : results)
     {
@@ -6349,7 +6466,7 @@ bool CMusicDatabase::GetSongsFullByWhere(
       }
       catch (...)
       {
-        m_pDS->close();
+        pDS->close();
         CLog::Log(LOGERROR, "{}: out of memory loading query: {}", __FUNCTION__, filter.where);
         return (items.Size() > 0);
       }
@@ -6361,7 +6478,7 @@ bool CMusicDatabase::GetSongsFullByWhere(
       artistCredits.clear();
     }
     // cleanup
-    m_pDS->close();
+    pDS->close();
 
     // Ensure random order of item list when results set sorted by idSong for artist processing
     // Note while smartplaylists and xml nodes provide sort order, sort is not passed in from node
@@ -6383,7 +6500,7 @@ bool CMusicDatabase::GetSongsFullByWhere(
   catch (...)
   {
     // cleanup
-    m_pDS->close();
+    pDS->close();
     CLog::Log(LOGERROR, "{}({}) failed", __FUNCTION__, filter.where);
   }
   return false;
@@ -6398,6 +6515,8 @@ bool CMusicDatabase::GetSongsByWhere(
   if (m_pDB == nullptr || m_pDS == nullptr)
     return false;
 
+  const std::unique_ptr<dbiplus::Dataset>& pDS = GetReadDataset();
+
   try
   {
     int total = -1;
@@ -6423,12 +6542,39 @@ bool CMusicDatabase::GetSongsByWhere(
       return false;
 
     // Apply the limiting directly here if there's no special sorting but limiting
+    Filter sortFilter = extFilter;
+    bool sortedInSQL = false;
     if (extFilter.limit.empty() && sorting.sortBy == SortByNone &&
         (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
-      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS);
+      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    // Sort and limit in the query with the sort keys if only a part of the songs is requested
+    else if (extFilter.limit.empty() && extFilter.order.empty() && extFilter.group.empty() &&
+             (sorting.limitStart > 0 || sorting.limitEnd > 0) &&
+             GetSortKeyOrder(MediaTypeSong, sorting, sortFilter) &&
+             UpdateSortKeys(MediaTypeSong, "song", "idSong", "strTitle"))
+    {
+      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS);
+      strSQLExtra.clear();
+      if (!BuildSQL(strSQLExtra, sortFilter, strSQLExtra))
+        return false;
+      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      sortedInSQL = true;
+    }
+    // Pick the random songs by id instead of ordering every song by RANDOM()
+    else if (extFilter.limit.empty() && extFilter.group.empty() && sorting.sortBy == SortByRandom &&
+             (sorting.limitStart > 0 || sorting.limitEnd > 0))
+    {
+      total = GetSingleValueInt(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS);
+      if (!SetRandomLimitFilter("songview.idSong", strSQLExtra, sorting, sortFilter))
+        return false;
+      strSQLExtra.clear();
+      if (!BuildSQL(strSQLExtra, sortFilter, strSQLExtra))
+        return false;
+      sortedInSQL = true;
+    }
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0
                                     ? filter.fields.c_str()
@@ -6437,13 +6583,13 @@ bool CMusicDatabase::GetSongsByWhere(
 
     CLog::Log(LOGDEBUG, "{} query = {}", __FUNCTION__, strSQL);
     // run query
-    if (!m_pDS->query(strSQL))
+    if (!pDS->query(strSQL))
       return false;
 
-    int iRowsFound = m_pDS->num_rows();
+    int iRowsFound = pDS->num_rows();
     if (iRowsFound == 0)
     {
-      m_pDS->close();
+      pDS->close();
       return true;
     }
 
@@ -6454,12 +6600,20 @@ bool CMusicDatabase::GetSongsByWhere(
 
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
+    if (sortedInSQL)
+    {
+      for (int row = 0; row < iRowsFound; row++)
+        results.push_back({{FieldRow, CVariant(row)}});
+      // the picked songs are returned in the order of the table
+      if (sorting.sortBy == SortByRandom)
+        KODI::UTILS::RandomShuffle(results.begin(), results.end());
+    }
+    else if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, pDS, results))
       return false;
 
     // get data from returned rows
     items.Reserve(results.size());
-    const dbiplus::query_data& data = m_pDS->get_result_set().records;
+    const dbiplus::query_data& data = pDS->get_result_set().records;
     int count = 0;
     for (const auto& i : results)
     {
@@ -6476,20 +6630,20 @@ bool CMusicDatabase::GetSongsByWhere(
       }
       catch (...)
       {
-        m_pDS->close();
+        pDS->close();
         CLog::Log(LOGERROR, "{}: out of memory loading query: {}", __FUNCTION__, filter.where);
         return (items.Size() > 0);
       }
     }
 
     // cleanup
-    m_pDS->close();
+    pDS->close();
     return true;
   }
   catch (...)
   {
     // cleanup
-    m_pDS->close();
+    pDS->close();
     CLog::Log(LOGERROR, "{}({}) failed", __FUNCTION__, filter.where);
   }
   return false;
@@ -9421,6 +9575,21 @@ void CMusicDatabase::UpdateTables(int version)
   if (version < 83)
     m_pDS->exec("ALTER TABLE song ADD strVideoURL TEXT");
 
+  // Keys of existing songs are added the first time they are sorted by
+  if (version < 84)
+    CreateSortKeyTable();
+
+  if (version < 85)
+  {
+    CreateSearchIndexTable();
+    UpdateSearchIndex(MediaTypeArtist);
+    UpdateSearchIndex(MediaTypeAlbum);
+    UpdateSearchIndex(MediaTypeSong);
+  }
+
+  if (version < 86)
+    CreatePathCheckTable();
+
   // Set the version of tag scanning required.
   // Not every schema change requires the tags to be rescanned, set to the highest schema version
   // that needs this. Forced rescanning (of music files that have not changed since they were
@@ -9441,7 +9610,21 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 83;
+  return 86;
+}
+
+bool CMusicDatabase::GetSearchIndexSource(const std::string& mediaType,
+                                          SearchIndexSource& source) const
+{
+  if (mediaType == MediaTypeArtist)
+    source = {"artist", "idArtist", "strArtist", "strSortName", "strGenres", "strBiography"};
+  else if (mediaType == MediaTypeAlbum)
+    source = {"album", "idAlbum", "strAlbum", "strArtistDisp", "strGenres", "strReview"};
+  else if (mediaType == MediaTypeSong)
+    source = {"song", "idSong", "strTitle", "strArtistDisp", "", ""};
+  else
+    return false;
+  return true;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -9561,6 +9744,23 @@ std::string CMusicDatabase::GetArtistsLastModified()
   return GetSingleValue("SELECT MAX(dateModified) FROM artist");
 }
 
+bool CMusicDatabase::SetRandomLimitFilter(const std::string& idField,
+                                          const std::string& strSQLExtra,
+                                          const SortDescription& sorting,
+                                          Filter& filter)
+{
+  const std::string view = idField.substr(0, idField.find('.'));
+  std::vector<int> ids;
+  if (GetRandomIds("SELECT " + idField + " FROM " + view + " " + strSQLExtra,
+                   GetRandomLimit(sorting), ids) < 0)
+    return false;
+
+  // The few picked items are still ordered by RANDOM()
+  filter.where = GetIdFilter(idField, ids);
+  filter.limit.clear();
+  return true;
+}
+
 unsigned int CMusicDatabase::GetRandomSongIDs(const Filter& filter,
                                               std::vector<std::pair<int, int>>& songIDs)
 {
@@ -9574,23 +9774,15 @@ unsigned int CMusicDatabase::GetRandomSongIDs(const Filter& filter,
     std::string strSQL = "SELECT idSong FROM songview ";
     if (!CDatabase::BuildSQL(strSQL, filter, strSQL))
       return false;
-    strSQL += PrepareSQL(" ORDER BY RANDOM()");
 
-    if (!m_pDS->query(strSQL))
-      return 0;
+    // shuffled here, ordering by RANDOM() would sort every song
+    std::vector<int> ids;
     songIDs.clear();
-    if (m_pDS->num_rows() == 0)
-    {
-      m_pDS->close();
+    if (GetRandomIds(strSQL, 0, ids) <= 0)
       return 0;
-    }
-    songIDs.reserve(m_pDS->num_rows());
-    while (!m_pDS->eof())
-    {
-      songIDs.push_back(std::make_pair<int, int>(1, m_pDS->fv(song_idSong).get_asInt()));
-      m_pDS->next();
-    } // cleanup
-    m_pDS->close();
+    songIDs.reserve(ids.size());
+    for (const int id : ids)
+      songIDs.emplace_back(1, id);
     return static_cast<unsigned int>(songIDs.size());
   }
   catch (...)
@@ -11553,6 +11745,9 @@ bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so reset the infomanager cache
+    // the counts are updated when the batch is committed
+    if (IsBatchActive())
+      return true;
     CGUIComponent* gui = CServiceBroker::GetGUI();
     if (gui)
     {
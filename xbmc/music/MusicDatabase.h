@@ -29,8 +29,7 @@ class CMusicDbUrl;
 
 namespace dbiplus
 {
-class field_value;
-typedef std::vector<field_value> sql_record;
+class sql_record;
 } // namespace dbiplus
 
 #include <set>
@@ -890,6 +889,8 @@ protected:
   void CreateAnalytics() override;
   int GetMinSchemaVersion() const override { return 32; }
   int GetSchemaVersion() const override;
+  bool GetSearchIndexSource(const std::string& mediaType,
+                            SearchIndexSource& source) const override;
 
   const char* GetBaseDBName() const override { return "MyMusic"; }
 
@@ -923,10 +924,22 @@ private:
                               const CMusicDbUrl& baseUrl);
   void GetFileItemFromArtistCredits(VECARTISTCREDITS& artistCredits, CFileItem* item);
 
+  /*! \brief Limit a filter to randomly picked items
+   The ids are picked up front instead of ordering every item by RANDOM() to apply the limit.
+   \param idField the id field of the view, e.g. "albumview.idAlbum"
+   \param strSQLExtra the FROM part of the query after the view, with the filter applied
+   \param sorting the sort description with the limits
+   \param filter [in/out] the filter, its condition and limit are replaced
+   \return true on success
+   */
+  bool SetRandomLimitFilter(const std::string& idField,
+                            const std::string& strSQLExtra,
+                            const SortDescription& sorting,
+                            Filter& filter);
+
   bool DeleteRemovedLinks();
 
   bool CleanupSongs(CGUIDialogProgress* progressDialog = nullptr);
-  bool CleanupSongsByIds(const std::string& strSongIds);
   bool CleanupPaths();
   bool CleanupAlbums();
   bool CleanupArtists();
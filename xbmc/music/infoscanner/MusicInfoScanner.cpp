@@ -28,7 +28,9 @@
 #include "events/EventLog.h"
 #include "events/MediaLibraryEvent.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryFanOut.h"
 #include "filesystem/MusicDatabaseDirectory.h"
+#include "filesystem/PathTaskQueue.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "filesystem/SmartPlaylistDirectory.h"
 #include "guilib/GUIComponent.h"
@@ -41,6 +43,7 @@
 #include "music/MusicUtils.h"
 #include "music/tags/MusicInfoTag.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/TagLoaderTagLib.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -53,7 +56,10 @@
 #include "utils/log.h"
 
 #include <algorithm>
+#include <future>
+#include <memory>
 #include <utility>
+#include <vector>
 
 using namespace MUSIC_INFO;
 using namespace XFILE;
@@ -122,10 +128,32 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      // Read the tags of a few files of each server at a time, so the latency of the servers
+      // does not add up file after file
+      const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+      const unsigned int workers = advancedSettings->m_iMusicScannerWorkers;
+      if (workers > 0)
+        m_tagQueue = std::make_unique<XFILE::CPathTaskQueue>(
+            workers, advancedSettings->m_iMusicScannerWorkersPerHost);
+
+      // check the sources at a time, so the ones offline do not wait for each other
+      std::set<std::string> missing;
+      if (!m_bClean)
+      {
+        const std::vector<std::string> paths(m_pathsToScan.begin(), m_pathsToScan.end());
+        const std::vector<bool> exists =
+            XFILE::CDirectoryFanOut::Exists(paths, XFILE::CDirectoryFanOut::GetTimeout());
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+          if (!exists[i])
+            missing.insert(paths[i]);
+        }
+      }
+
       bool commit = true;
       for (const auto& it : m_pathsToScan)
       {
-        if (!CDirectory::Exists(it) && !m_bClean)
+        if (missing.find(it) != missing.end())
         {
           /*
            * Note that this will skip scanning (if m_bClean is disabled) if the directory really
@@ -141,7 +169,10 @@ void CMusicInfoScanner::Process()
 
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
+        // Write the folders in a few large transactions, committed before reading remote folders
+        m_musicDatabase.BeginBatch();
         bool scancomplete = DoScan(it);
+        m_musicDatabase.CommitBatch();
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -166,6 +197,9 @@ void CMusicInfoScanner::Process()
         }
       }
 
+      // discard the tags queued by a canceled scan
+      m_tagQueue.reset();
+
       if (commit)
       {
         CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().ResetLibraryBools();
@@ -485,6 +519,10 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
     return true;
 
+  // listing the folder over the network mustn't hold the write lock of the batch
+  if (URIUtils::IsRemote(strDirectory))
+    m_musicDatabase.CommitBatchWrites();
+
   if (HasNoMedia(strDirectory))
     return true;
 
@@ -526,6 +564,7 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 
     // save information about this folder
     m_musicDatabase.SetPathHash(strDirectory, hash);
+    m_musicDatabase.BatchItemDone();
   }
   else
   { // path is the same - no need to rescan
@@ -567,11 +606,12 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  // Queue the reads of the tags loaded by TagLib first, the other loaders load on this thread
+  std::vector<CFileItemPtr> files;
+  std::vector<std::unique_ptr<IMusicInfoTagLoader>> loaders;
+  std::vector<std::future<void>> loads;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -580,16 +620,46 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
-    m_currentItem++;
+    files.push_back(pItem);
+    loaders.emplace_back();
+    loads.emplace_back();
+    if (pItem->GetMusicInfoTag()->Loaded())
+      continue;
 
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
+    std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
+    if (m_tagQueue && dynamic_cast<CTagLoaderTagLib*>(pLoader.get()))
     {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (nullptr != pLoader)
-        pLoader->Load(pItem->GetPath(), tag);
+      // the loader and the item are shared with the task, the queue may outlive this scan
+      auto load = std::make_shared<std::packaged_task<void()>>(
+          [pItem, loader = std::shared_ptr<IMusicInfoTagLoader>(std::move(pLoader))]()
+          { loader->Load(pItem->GetPath(), *pItem->GetMusicInfoTag()); });
+      loads.back() = load->get_future();
+      m_tagQueue->Add(pItem->GetPath(), [load]() { (*load)(); });
+    }
+    else
+      loaders.back() = std::move(pLoader);
+  }
+
+  // Then add the files in their order, whatever the order the reads complete in
+  for (size_t i = 0; i < files.size(); ++i)
+  {
+    if (m_bStop)
+    {
+      if (m_tagQueue)
+        m_tagQueue->Clear();
+      return INFO_CANCELLED;
     }
 
+    CFileItemPtr pItem = files[i];
+
+    m_currentItem++;
+
+    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
+    if (loads[i].valid())
+      loads[i].wait();
+    else if (loaders[i])
+      loaders[i]->Load(pItem->GetPath(), tag);
+
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
 
@@ -913,6 +983,9 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
     m_needsCleanup = true;
 
+  if (URIUtils::IsRemote(strDirectory))
+    m_musicDatabase.CommitBatchWrites();
+
   CFileItemList scannedItems;
   if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
     return 0;
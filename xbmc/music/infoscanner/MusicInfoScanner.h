@@ -16,10 +16,17 @@
 #include "threads/Thread.h"
 #include "utils/ScraperUrl.h"
 
+#include <memory>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
 
+namespace XFILE
+{
+class CPathTaskQueue;
+}
+
 namespace MUSIC_INFO
 {
 
@@ -227,6 +234,8 @@ protected:
     Given a list of FileItems, scan in the tags for those FileItems
    and populate a new FileItemList with the files that were successfully scanned.
    Any files which couldn't be scanned (no/bad tags) are discarded in the process.
+   The tags read by TagLib are read on the workers of the tag queue, the scanned items keep the
+   order of the items whatever the order the reads complete in.
    \param items [in] list of FileItems to scan
    \param scannedItems [in] list to populate with the scannedItems
    */
@@ -261,5 +270,6 @@ protected:
   std::set<std::string> m_seenPaths;
   int m_flags;
   CThread m_fileCountReader;
+  std::unique_ptr<XFILE::CPathTaskQueue> m_tagQueue; ///< reads the tags of a scan, null for none
 };
 }
@@ -9,6 +9,7 @@
 
 #include "filesystem/File.h"
 
+#include <algorithm>
 #include <limits.h>
 
 #include <taglib/taglib.h>
@@ -37,6 +38,11 @@ TagLibVFSStream::TagLibVFSStream(const std::string& strFileName, bool readOnly)
   }
   m_strFileName = strFileName;
   m_bIsReadOnly = readOnly || !m_bIsOpen;
+  if (readOnly && m_bIsOpen)
+  {
+    m_length = m_file.GetLength();
+    m_bBuffered = m_length > 0;
+  }
 }
 
 /*!
@@ -64,6 +70,9 @@ ByteVector TagLibVFSStream::readBlock(unsigned long length)
 ByteVector TagLibVFSStream::readBlock(TagLib::ulong length)
 #endif
 {
+  if (m_bBuffered)
+    return readBuffered(length);
+
 #if (TAGLIB_MAJOR_VERSION >= 2)
   ByteVector byteVector(static_cast<unsigned int>(length));
 #else
@@ -78,6 +87,51 @@ ByteVector TagLibVFSStream::readBlock(TagLib::ulong length)
   return byteVector;
 }
 
+ByteVector TagLibVFSStream::readBuffered(size_t length)
+{
+  if (m_position >= m_length || length == 0)
+    return ByteVector();
+  length = static_cast<size_t>(std::min<int64_t>(length, m_length - m_position));
+
+  if (m_position < m_bufferStart ||
+      m_position + static_cast<int64_t>(length) >
+          m_bufferStart + static_cast<int64_t>(m_buffer.size()))
+  {
+    // Read a whole block from the position, or the last block of the file
+    // when the position is close to the end, where the ID3v1 and APE tags
+    // and the last audio frames are.
+    const size_t size = std::max(length, READ_AHEAD_SIZE);
+    int64_t start = m_position;
+    if (start + static_cast<int64_t>(size) > m_length)
+      start = std::max<int64_t>(0, m_length - size);
+
+    m_buffer.resize(size);
+    size_t filled = 0;
+    if (m_file.Seek(start, SEEK_SET) == start)
+    {
+      while (filled < size)
+      {
+        ssize_t read = m_file.Read(m_buffer.data() + filled, size - filled);
+        if (read <= 0)
+          break;
+        filled += read;
+      }
+    }
+    m_buffer.resize(filled);
+    m_bufferStart = start;
+  }
+
+  const int64_t available = m_bufferStart + static_cast<int64_t>(m_buffer.size()) - m_position;
+  if (m_position < m_bufferStart || available <= 0)
+    return ByteVector();
+
+  length = static_cast<size_t>(std::min<int64_t>(length, available));
+  ByteVector byteVector(m_buffer.data() + (m_position - m_bufferStart),
+                        static_cast<unsigned int>(length));
+  m_position += length;
+  return byteVector;
+}
+
 /*!
  * Attempts to write the block \a data at the current get pointer.  If the
  * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -297,6 +351,13 @@ void TagLibVFSStream::seek(long offset, Position p)
     else
       return; // wrong Position value
 
+    // the reads are buffered, only the position moves, within the file
+    if (m_bBuffered)
+    {
+      m_position = std::clamp<int64_t>(static_cast<int64_t>(startPos) + offset, 0, fileLen);
+      return;
+    }
+
     // When parsing some broken files, taglib may try to seek above end of file.
     // If underlying VFS does not move I/O pointer in this case, taglib will parse
     // same part of file several times and ends with error. To prevent this
@@ -342,7 +403,7 @@ void TagLibVFSStream::clear()
  */
 long TagLibVFSStream::tell() const
 {
-  int64_t pos = m_file.GetPosition();
+  int64_t pos = m_bBuffered ? m_position : m_file.GetPosition();
   if(pos > LONG_MAX)
     return -1;
   else
@@ -354,6 +415,8 @@ long TagLibVFSStream::tell() const
  */
 long TagLibVFSStream::length()
 {
+  if (m_bBuffered)
+    return (long)m_length;
   return (long)m_file.GetLength();
 }
 
@@ -10,6 +10,9 @@
 
 #include "filesystem/File.h"
 
+#include <stdint.h>
+#include <vector>
+
 #include <taglib/taglib.h>
 #include <taglib/tiostream.h>
 
@@ -36,6 +39,10 @@ namespace MUSIC_INFO
 
     /*!
      * Reads a block of size \a length at the current get pointer.
+     *
+     * \note A file opened read only is read in large blocks, so the tag at
+     * the start or at the end of the file is fetched by a single read of the
+     * file rather than by many small ones.
      */
 #if (TAGLIB_MAJOR_VERSION >= 2)
     TagLib::ByteVector readBlock(unsigned long length) override;
@@ -132,10 +139,24 @@ namespace MUSIC_INFO
 #endif
 
   private:
+    /*!
+     * Reads the block at the current position from the read ahead buffer,
+     * filling it with the read ahead size or \a length bytes if larger.
+     */
+    TagLib::ByteVector readBuffered(size_t length);
+
+    //! Size of the reads of a file opened read only
+    static constexpr size_t READ_AHEAD_SIZE = 256 * 1024;
+
     std::string   m_strFileName;
     XFILE::CFile  m_file;
     bool          m_bIsReadOnly;
     bool          m_bIsOpen;
+    bool          m_bBuffered = false; ///< read only with a known length, reads are buffered
+    int64_t       m_length = 0; ///< length of a buffered file
+    int64_t       m_position = 0; ///< position in a buffered file
+    int64_t       m_bufferStart = 0; ///< position of the start of the buffer in the file
+    std::vector<char> m_buffer;
   };
 }
 
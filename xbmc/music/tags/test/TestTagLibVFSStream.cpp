@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/tags/TagLibVFSStream.h"
+#include "utils/URIUtils.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace MUSIC_INFO;
+using namespace XFILE;
+
+class TestTagLibVFSStream : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                     "TestTagLibVFSStream.mp3");
+    // larger than a read ahead block, so reads near the end and in the middle fill other blocks
+    content.resize(600 * 1024);
+    for (size_t i = 0; i < content.size(); i++)
+      content[i] = static_cast<char>(i * 7 + i / 251);
+
+    CFile file;
+    ASSERT_TRUE(file.OpenForWrite(path, true));
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), file.Write(content.data(), content.size()));
+    file.Close();
+  }
+
+  void TearDown() override { CFile::Delete(path); }
+
+  std::string Expected(size_t offset, size_t length) const
+  {
+    return content.substr(offset, length);
+  }
+
+  static std::string Read(TagLibVFSStream& stream, size_t length)
+  {
+    const TagLib::ByteVector block = stream.readBlock(length);
+    return std::string(block.data(), block.size());
+  }
+
+  std::string path;
+  std::string content;
+};
+
+TEST_F(TestTagLibVFSStream, ReadsBlocks)
+{
+  TagLibVFSStream stream(path, true);
+  ASSERT_TRUE(stream.isOpen());
+  EXPECT_EQ(static_cast<long>(content.size()), stream.length());
+
+  // an ID3v2 header and its frames
+  EXPECT_EQ(Expected(0, 10), Read(stream, 10));
+  EXPECT_EQ(10, stream.tell());
+  EXPECT_EQ(Expected(10, 4000), Read(stream, 4000));
+
+  // an ID3v1 tag and an APE footer
+  stream.seek(-128, TagLib::IOStream::End);
+  EXPECT_EQ(Expected(content.size() - 128, 128), Read(stream, 128));
+  stream.seek(-160, TagLib::IOStream::End);
+  EXPECT_EQ(Expected(content.size() - 160, 32), Read(stream, 32));
+
+  // a read across the blocks and a read larger than a block
+  stream.seek(250 * 1024);
+  EXPECT_EQ(Expected(250 * 1024, 20 * 1024), Read(stream, 20 * 1024));
+  stream.seek(-1024, TagLib::IOStream::Current);
+  EXPECT_EQ(Expected(269 * 1024, 300 * 1024), Read(stream, 300 * 1024));
+}
+
+TEST_F(TestTagLibVFSStream, StopsAtEndOfFile)
+{
+  TagLibVFSStream stream(path, true);
+  stream.seek(-100, TagLib::IOStream::End);
+  EXPECT_EQ(Expected(content.size() - 100, 100), Read(stream, 1000));
+  EXPECT_TRUE(Read(stream, 10).empty());
+
+  // seeks out of the file stop at its ends
+  stream.seek(1000, TagLib::IOStream::End);
+  EXPECT_EQ(static_cast<long>(content.size()), stream.tell());
+  stream.seek(-1000);
+  EXPECT_EQ(0, stream.tell());
+  EXPECT_EQ(Expected(0, 16), Read(stream, 16));
+}
@@ -21,6 +21,9 @@
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#if defined(TARGET_LINUX)
+#include <sys/sendfile.h>
+#endif
 #include <sys/stat.h>
 
 #if defined(HAVE_STATX) // use statx if available to get file birth date
@@ -161,6 +164,41 @@ ssize_t CPosixFile::Write(const void* lpBuf, size_t uiBufSize)
   return res;
 }
 
+ssize_t CPosixFile::CopyTo(CPosixFile& dest, size_t size)
+{
+  if (m_fd < 0 || dest.m_fd < 0 || !dest.m_allowWrite)
+    return -1;
+
+  if (size > SSIZE_MAX)
+    size = SSIZE_MAX;
+
+#if defined(HAVE_COPY_FILE_RANGE)
+  // lets the file system clone or copy server side, e.g. on btrfs, xfs or nfs 4.2
+  ssize_t res = copy_file_range(m_fd, nullptr, dest.m_fd, nullptr, size, 0);
+  // not supported across file systems on older kernels
+  if (res < 0 && (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP))
+    res = sendfile(dest.m_fd, m_fd, nullptr, size);
+#elif defined(TARGET_LINUX)
+  ssize_t res = sendfile(dest.m_fd, m_fd, nullptr, size);
+#else
+  ssize_t res = -1;
+#endif
+  if (res < 0)
+  {
+    // force update file positions
+    Seek(0, SEEK_CUR);
+    dest.Seek(0, SEEK_CUR);
+    return -1;
+  }
+
+  if (m_filePos >= 0)
+    m_filePos += res;
+  if (dest.m_filePos >= 0)
+    dest.m_filePos += res;
+
+  return res;
+}
+
 int64_t CPosixFile::Seek(int64_t iFilePosition, int iWhence /* = SEEK_SET*/)
 {
   if (m_fd < 0)
@@ -37,6 +37,16 @@ namespace XFILE
     int Stat(const CURL& url, struct __stat64* buffer) override;
     int Stat(struct __stat64* buffer) override;
 
+    /*!
+     \brief Copy data from the current position to the current position of another file, without
+     passing it through user space.
+     \param dest the file to write to, opened for writing
+     \param size the most bytes to copy
+     \return the bytes copied, 0 at the end of the file, or -1 if the system can't copy between
+     these files
+     */
+    ssize_t CopyTo(CPosixFile& dest, size_t size);
+
   protected:
     int     m_fd = -1;
     int64_t m_filePos = -1;
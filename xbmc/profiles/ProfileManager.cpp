@@ -445,6 +445,7 @@ void CProfileManager::LogOff()
   CNetworkBase &networkManager = CServiceBroker::GetNetwork();
 
   g_application.StopPlaying();
+  g_application.StopLibraryWatcher();
 
   if (CMusicLibraryQueue::GetInstance().IsScanningLibrary())
     CMusicLibraryQueue::GetInstance().StopLibraryScanning();
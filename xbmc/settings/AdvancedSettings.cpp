@@ -157,6 +157,7 @@ void CAdvancedSettings::Initialize()
   m_videoIgnoreSecondsAtStart = 3*60;
   m_videoIgnorePercentAtEnd   = 8.0f;
   m_videoPlayCountMinimumPercent = 90.0f;
+  m_videoThumbnailJobs = 0;
   m_videoVDPAUScaling = -1;
   m_videoNonLinStretchRatio = 0.5f;
   m_videoAutoScaleMaxFps = 30.0f;
@@ -318,14 +319,31 @@ void CAdvancedSettings::Initialize()
   m_iMusicLibraryDateAdded = 1; // prefer mtime over ctime and current time
   m_bMusicLibraryUseISODates = false;
   m_bMusicLibraryArtistNavigatesToSongs = false;
+  m_iMusicScannerWorkers = 8;
+  m_iMusicScannerWorkersPerHost = 4;
 
   m_bVideoLibraryAllItemsOnBottom = false;
   m_iVideoLibraryRecentlyAddedItems = 25;
   m_bVideoLibraryCleanOnUpdate = false;
   m_bVideoLibraryUseFastHash = true;
   m_bVideoScannerIgnoreErrors = false;
+  m_iVideoScannerWorkers = 8;
+  m_iVideoScannerWorkersPerHost = 2;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
+  m_bLibraryWatcher = false;
+  m_iLibraryWatcherDelay = 5;
+  m_iLibraryWatcherPollInterval = 60;
+
+  m_bPersistentDirectoryCache = false;
+  m_iPersistentDirectoryCacheSize = 256;
+  m_iPersistentDirectoryCacheMemorySize = 16;
+  m_iDirectoryFanOutWorkers = 8;
+  m_iDirectoryFanOutWorkersPerHost = 2;
+  m_iDirectoryFanOutTimeout = 30;
+  m_iFileCopyStreams = 4;
+  m_iFileCopyStreamsPerHost = 2;
+
   m_iEpgUpdateCheckInterval = 300; /* Check every X seconds, if EPG data need to be updated. This does not mean that
                                       every X seconds an EPG update is actually triggered, it's just the interval how
                                       often to check whether an update should be triggered. If this value is greater
@@ -613,6 +631,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "playcountminimumpercent", m_videoPlayCountMinimumPercent, 0.0f, 101.0f);
     XMLUtils::GetInt(pElement, "ignoresecondsatstart", m_videoIgnoreSecondsAtStart, 0, 900);
     XMLUtils::GetFloat(pElement, "ignorepercentatend", m_videoIgnorePercentAtEnd, 0, 100.0f);
+    XMLUtils::GetInt(pElement, "thumbnailjobs", m_videoThumbnailJobs, 0, 16);
 
     XMLUtils::GetBoolean(pElement, "usetimeseeking", m_videoUseTimeSeeking);
     XMLUtils::GetInt(pElement, "timeseekforward", m_videoTimeSeekForward, 0, 6000);
@@ -813,6 +832,13 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     }
   }
 
+  pElement = pRootElement->FirstChildElement("musicscanner");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "workers", m_iMusicScannerWorkers, 0, 64);
+    XMLUtils::GetInt(pElement, "workersperhost", m_iMusicScannerWorkersPerHost, 1, 64);
+  }
+
   pElement = pRootElement->FirstChildElement("videolibrary");
   if (pElement)
   {
@@ -830,6 +856,39 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetInt(pElement, "workers", m_iVideoScannerWorkers, 0, 64);
+    XMLUtils::GetInt(pElement, "workersperhost", m_iVideoScannerWorkersPerHost, 1, 64);
+  }
+
+  pElement = pRootElement->FirstChildElement("librarywatcher");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "enabled", m_bLibraryWatcher);
+    XMLUtils::GetInt(pElement, "delay", m_iLibraryWatcherDelay, 1, 3600);
+    XMLUtils::GetInt(pElement, "pollinterval", m_iLibraryWatcherPollInterval, 0, 10080);
+  }
+
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "persistent", m_bPersistentDirectoryCache);
+    XMLUtils::GetInt(pElement, "size", m_iPersistentDirectoryCacheSize, 1, 65536);
+    XMLUtils::GetInt(pElement, "memorysize", m_iPersistentDirectoryCacheMemorySize, 0, 4096);
+  }
+
+  pElement = pRootElement->FirstChildElement("directoryfanout");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "workers", m_iDirectoryFanOutWorkers, 1, 64);
+    XMLUtils::GetInt(pElement, "workersperhost", m_iDirectoryFanOutWorkersPerHost, 1, 64);
+    XMLUtils::GetInt(pElement, "timeout", m_iDirectoryFanOutTimeout, 1, 3600);
+  }
+
+  pElement = pRootElement->FirstChildElement("filecopy");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "streams", m_iFileCopyStreams, 1, 16);
+    XMLUtils::GetInt(pElement, "streamsperhost", m_iFileCopyStreamsPerHost, 1, 16);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -1160,6 +1219,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseVideo.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseVideo.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseVideo.compression);
+    XMLUtils::GetString(pDatabase, "journalmode", m_databaseVideo.journalmode);
+    XMLUtils::GetInt(pDatabase, "readconnections", m_databaseVideo.readconnections, 0, 16);
   }
 
   pDatabase = pRootElement->FirstChildElement("musicdatabase");
@@ -1177,6 +1238,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseMusic.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseMusic.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseMusic.compression);
+    XMLUtils::GetString(pDatabase, "journalmode", m_databaseMusic.journalmode);
+    XMLUtils::GetInt(pDatabase, "readconnections", m_databaseMusic.readconnections, 0, 16);
   }
 
   pDatabase = pRootElement->FirstChildElement("tvdatabase");
@@ -47,6 +47,8 @@ public:
     capath.clear();
     ciphers.clear();
     compression = false;
+    journalmode = "wal";
+    readconnections = 4;
   };
   std::string type;
   std::string host;
@@ -60,6 +62,8 @@ public:
   std::string capath;
   std::string ciphers;
   bool compression;
+  std::string journalmode; ///< sqlite journal mode, empty to keep the mode of the database file
+  int readconnections; ///< idle sqlite read-only connections kept for listings, 0 to read on the writer connection
 };
 
 struct TVShowRegexp
@@ -172,6 +176,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     std::string m_videoDefaultPlayer;
     float m_videoPlayCountMinimumPercent;
+    int m_videoThumbnailJobs; ///< thumbnails extracted at a time, 0 for half the processors
 
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
@@ -248,6 +253,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryUseISODates;
     bool m_bMusicLibraryArtistNavigatesToSongs;
     std::string m_strMusicLibraryAlbumFormat;
+    int m_iMusicScannerWorkers; ///< tags read at a time by the scan, 0 to read them on its thread
+    int m_iMusicScannerWorkersPerHost; ///< tags of one server read at a time
     bool m_prioritiseAPEv2tags;
     std::string m_musicItemSeparator;
     std::vector<std::string> m_musicArtistSeparators;
@@ -262,8 +269,23 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryImportResumePoint{true};
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_iVideoScannerWorkers; ///< directories listed at a time ahead of the scan, 0 for none
+    int m_iVideoScannerWorkersPerHost; ///< directories of one server listed at a time
     int m_iVideoLibraryDateAdded;
 
+    bool m_bLibraryWatcher; ///< scan the directories of the local sources as they change
+    int m_iLibraryWatcherDelay; ///< seconds without changes before scanning a changed directory
+    int m_iLibraryWatcherPollInterval; ///< minutes between the scans of the unwatched sources
+
+    bool m_bPersistentDirectoryCache; ///< keep the directory listings on disk across restarts
+    int m_iPersistentDirectoryCacheSize; ///< MB of listings kept on disk
+    int m_iPersistentDirectoryCacheMemorySize; ///< MB of those listings also kept in memory
+    int m_iDirectoryFanOutWorkers; ///< directories of multipath sources listed at a time
+    int m_iDirectoryFanOutWorkersPerHost; ///< directories of one server listed at a time
+    int m_iDirectoryFanOutTimeout; ///< seconds a directory is waited for before it is left out
+    int m_iFileCopyStreams; ///< files copied at a time by the file manager
+    int m_iFileCopyStreamsPerHost; ///< files of one server copied at a time
+
     std::set<std::string> m_vecTokens;
 
     int m_iEpgUpdateCheckInterval;  // seconds
@@ -9,10 +9,20 @@
 #include "FileItem.h"
 #include "ServiceBroker.h"
 #include "URL.h"
+#include "music/tags/MusicInfoTag.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/SettingsManager.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 #include <gtest/gtest.h>
 
@@ -130,3 +140,126 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_SUITE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+TEST(TestFileItem, Properties)
+{
+  CFileItem item;
+  item.SetProperty("TotalSeasons", 3);
+  item.SetProperty("artist_sortname", "Beatles, The");
+  item.SetProperty("WatchedEpisodes", 10);
+
+  // keys are not case sensitive
+  EXPECT_TRUE(item.HasProperty("totalseasons"));
+  EXPECT_EQ(3, item.GetProperty("TOTALSEASONS").asInteger());
+  item.SetProperty("totalseasons", 4);
+  EXPECT_EQ(4, item.GetProperty("TotalSeasons").asInteger());
+  item.IncrementProperty("watchedepisodes", 2);
+  EXPECT_EQ(12, item.GetProperty("WatchedEpisodes").asInteger());
+
+  CVariant value;
+  item.Serialize(value);
+  std::vector<std::string> keys;
+  for (auto it = value["properties"].begin_map(); it != value["properties"].end_map(); ++it)
+    keys.push_back(it->first);
+  EXPECT_EQ((std::vector<std::string>{"TotalSeasons", "WatchedEpisodes", "artist_sortname"}),
+            keys);
+
+  CFileItem copy(item);
+  item.ClearProperty("ARTIST_SORTNAME");
+  EXPECT_FALSE(item.HasProperty("artist_sortname"));
+  EXPECT_TRUE(item.GetProperty("artist_sortname").isNull());
+  EXPECT_EQ("Beatles, The", copy.GetProperty("artist_sortname").asString());
+
+  item.ClearProperties();
+  EXPECT_FALSE(item.HasProperties());
+}
+
+TEST(TestFileItem, ExtraInfo)
+{
+  CFileItem item("song.flac", false);
+  EXPECT_EQ("", item.GetExtraInfo());
+  EXPECT_FALSE(item.HasPVRRecordingInfoTag());
+  EXPECT_FALSE(item.HasEPGInfoTag());
+
+  item.SetExtraInfo("extra");
+  CFileItem copy(item);
+  item.Reset();
+  EXPECT_EQ("", item.GetExtraInfo());
+  EXPECT_EQ("extra", copy.GetExtraInfo());
+}
+
+TEST(TestFileItemList, BuildList)
+{
+  constexpr int SONGS = 1000;
+
+  CFileItemList items;
+  for (int i = 0; i < SONGS; ++i)
+  {
+    const std::string album = "Album " + std::to_string(i / 12);
+    const std::string title = "Track " + std::to_string(i % 12 + 1);
+    CFileItemPtr item(new CFileItem(title));
+    item->SetPath("/music/Artist " + std::to_string(i / 120) + "/" + album + "/" + title + ".flac");
+    MUSIC_INFO::CMusicInfoTag* tag = item->GetMusicInfoTag();
+    tag->SetTitle(title);
+    tag->SetAlbum(album);
+    tag->SetTrackNumber(i % 12 + 1);
+    tag->SetDatabaseId(i + 1, "song");
+    item->SetProperty("audio_channels", 2);
+    item->SetArt("thumb", "image://music@%2fmusic%2f" + album + "%2fcover.jpg/");
+    items.Add(std::move(item));
+  }
+  ASSERT_EQ(SONGS, items.Size());
+
+  const CFileItemPtr last = items.Get(SONGS - 1);
+  EXPECT_EQ("/music/Artist 8/Album 83/Track 4.flac", last->GetPath());
+  EXPECT_EQ("Track 4", last->GetLabel());
+  EXPECT_EQ("Album 83", last->GetMusicInfoTag()->GetAlbum());
+  EXPECT_EQ(SONGS, last->GetMusicInfoTag()->GetDatabaseId());
+  EXPECT_EQ(2, last->GetProperty("audio_channels").asInteger());
+  EXPECT_EQ("image://music@%2fmusic%2fAlbum 83%2fcover.jpg/", last->GetArt("thumb"));
+  EXPECT_EQ(last, items.Get(last->GetPath()));
+}
+
+// the time to build a list of songs and the memory per song, run with
+// --gtest_also_run_disabled_tests
+TEST(TestFileItemList, DISABLED_BuildLargeList_Benchmark)
+{
+  constexpr int SONGS = 100000;
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  const size_t heapBefore = mallinfo2().uordblks;
+#endif
+  const auto start = std::chrono::steady_clock::now();
+  CFileItemList items;
+  for (int i = 0; i < SONGS; ++i)
+  {
+    const std::string album = "Album " + std::to_string(i / 12);
+    const std::string title = "Track " + std::to_string(i % 12 + 1);
+    CFileItemPtr item(new CFileItem(title));
+    item->SetPath("/music/Artist " + std::to_string(i / 120) + "/" + album + "/" + title + ".flac");
+    item->m_dwSize = 30000000 + i;
+    item->m_dateTime = CDateTime(2024, 1, 1, 0, 0, 0);
+    MUSIC_INFO::CMusicInfoTag* tag = item->GetMusicInfoTag();
+    tag->SetTitle(title);
+    tag->SetAlbum(album);
+    tag->SetArtist("Artist " + std::to_string(i / 120));
+    tag->SetTrackNumber(i % 12 + 1);
+    tag->SetDatabaseId(i + 1, "song");
+    tag->SetLoaded(true);
+    item->SetProperty("item_start", 0);
+    item->SetProperty("audio_codec", "flac");
+    item->SetProperty("audio_channels", 2);
+    item->SetArt("thumb", "image://music@%2fmusic%2f" + album + "%2fcover.jpg/");
+    items.Add(std::move(item));
+  }
+  const auto build = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  EXPECT_EQ(SONGS, items.Size());
+
+  RecordProperty("build_ms", static_cast<int>(build.count()));
+  RecordProperty("bytes_per_CFileItem", static_cast<int>(sizeof(CFileItem)));
+  // the item with its tag, properties, art and path, as allocated on the heap
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  RecordProperty("bytes_per_song", static_cast<int>((mallinfo2().uordblks - heapBefore) / SONGS));
+#endif
+}
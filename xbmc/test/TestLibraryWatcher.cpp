@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibraryWatcher.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Library = CLibraryWatcher::Library;
+
+TEST(TestLibraryWatcher, GetScanPaths)
+{
+  const std::vector<CLibraryWatcher::Source> sources = {
+      {"/media/movies/", Library::VIDEO},
+      {"/media/tv/", Library::VIDEO, true},
+      {"/media/music/", Library::MUSIC},
+      {"/media/mixed/", Library::VIDEO},
+      {"/media/mixed/", Library::MUSIC},
+  };
+
+  const std::set<std::string> changed = {
+      "/media/movies/New Movie (2024)/",
+      "/media/movies/New Movie (2024)/extras/",
+      "/media/tv/Show/Season 1/",
+      "/media/tv/Show/",
+      "/media/tv/Other Show/",
+      "/media/tv/",
+      "/media/music/Artist/Album/",
+      "/media/mixed/clips/",
+      "/media/downloads/incomplete/",
+  };
+
+  const auto paths = CLibraryWatcher::GetScanPaths(changed, sources);
+  const std::map<Library, std::set<std::string>> expected = {
+      {Library::VIDEO, {"/media/movies/New Movie (2024)/", "/media/tv/", "/media/mixed/clips/"}},
+      {Library::MUSIC, {"/media/music/Artist/Album/", "/media/mixed/clips/"}},
+  };
+  EXPECT_EQ(expected, paths);
+}
+
+TEST(TestLibraryWatcher, GetScanPathsOfShows)
+{
+  const std::vector<CLibraryWatcher::Source> sources = {{"/media/tv/", Library::VIDEO, true}};
+
+  const auto paths = CLibraryWatcher::GetScanPaths(
+      {"/media/tv/Show/Season 1/", "/media/tv/Show/Season 2/", "/media/tv/Other Show/"}, sources);
+  const std::map<Library, std::set<std::string>> expected = {
+      {Library::VIDEO, {"/media/tv/Other Show/", "/media/tv/Show/"}},
+  };
+  EXPECT_EQ(expected, paths);
+}
+
+TEST(TestLibraryWatcher, GetScanPathsOfSingleShow)
+{
+  const std::vector<CLibraryWatcher::Source> sources = {
+      {"/media/tv/Show/", Library::VIDEO, true, true}};
+
+  const auto paths = CLibraryWatcher::GetScanPaths(
+      {"/media/tv/Show/Season 1/", "/media/tv/Show/Season 2/extras/"}, sources);
+  const std::map<Library, std::set<std::string>> expected = {
+      {Library::VIDEO, {"/media/tv/Show/"}},
+  };
+  EXPECT_EQ(expected, paths);
+}
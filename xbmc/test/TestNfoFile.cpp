@@ -0,0 +1,226 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "NfoFile.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/XBMCTinyXML.h"
+#include "video/VideoInfoTag.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+std::string GetEpisode(int episode)
+{
+  const std::string number = std::to_string(episode);
+  std::string nfo = "<episodedetails>\n"
+                    "  <title>Episode " + number + "</title>\n"
+                    "  <showtitle>The Show &amp; Friends</showtitle>\n"
+                    "  <ratings><rating name=\"tvdb\" max=\"10\" default=\"true\">"
+                    "<value>8.1</value><votes>1,024</votes></rating></ratings>\n"
+                    "  <season>1</season>\n"
+                    "  <episode>" + number + "</episode>\n"
+                    "  <plot>What happens in episode " + number + ".</plot>\n"
+                    "  <runtime>42</runtime>\n"
+                    "  <uniqueid type=\"tvdb\" default=\"true\">" + std::to_string(1000 + episode) +
+                    "</uniqueid>\n"
+                    "  <genre>Drama</genre>\n"
+                    "  <credits>Writer " + number + "</credits>\n"
+                    "  <director>Director " + number + "</director>\n"
+                    "  <aired>2020-01-0" + std::to_string(1 + episode % 9) + "</aired>\n"
+                    "  <thumb aspect=\"thumb\">https://example.com/" + number + ".jpg</thumb>\n"
+                    "  <fileinfo><streamdetails><video><codec>h264</codec><width>1920</width>"
+                    "<height>1080</height></video><audio><codec>ac3</codec><language>eng</language>"
+                    "<channels>6</channels></audio></streamdetails></fileinfo>\n";
+  for (int i = 0; i < 20; i++)
+    nfo += "  <actor><name>Actor " + std::to_string(i) + "</name><role>Role " + number +
+           "</role><order>" + std::to_string(i) + "</order></actor>\n";
+  return nfo + "</episodedetails>\n";
+}
+
+std::string GetNfo(int episodes)
+{
+  std::string nfo = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n";
+  for (int episode = 1; episode <= episodes; episode++)
+    nfo += GetEpisode(episode);
+  return nfo;
+}
+
+// find an episode by parsing the rest of the nfo from each episode on
+size_t FindEpisodeInRest(const std::string& nfo, CVideoInfoTag& details, int episode)
+{
+  size_t pos = 0;
+  while (pos != std::string::npos)
+  {
+    CXBMCTinyXML doc;
+    doc.Parse(nfo.substr(pos), TIXML_ENCODING_UNKNOWN);
+    if (!details.Load(doc.RootElement(), true))
+      return std::string::npos;
+    if (details.m_iEpisode == episode)
+      return pos;
+    pos = nfo.find("<episodedetails", pos + 1);
+  }
+  return std::string::npos;
+}
+
+std::string Save(CVideoInfoTag& details)
+{
+  CXBMCTinyXML doc;
+  details.Save(&doc, "episodedetails");
+  std::string saved;
+  saved << doc;
+  return saved;
+}
+} // namespace
+
+class TestNfoFile : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path = CSpecialProtocol::TranslatePath("special://temp/TestNfoFile.nfo");
+  }
+
+  void TearDown() override { CFile::Delete(path); }
+
+  void Write(const std::string& nfo)
+  {
+    CFile file;
+    ASSERT_TRUE(file.OpenForWrite(path, true));
+    ASSERT_EQ(static_cast<ssize_t>(nfo.size()), file.Write(nfo.data(), nfo.size()));
+  }
+
+  std::string path;
+};
+
+TEST_F(TestNfoFile, GetEpisodeDetails)
+{
+  const std::string nfo = GetNfo(5);
+  Write(nfo);
+
+  for (int episode = 1; episode <= 5; episode++)
+  {
+    CNfoFile nfoFile;
+    ASSERT_EQ(0, nfoFile.Load(path));
+    CVideoInfoTag details;
+    ASSERT_TRUE(nfoFile.GetEpisodeDetails(details, episode));
+
+    CVideoInfoTag expected;
+    const size_t pos = FindEpisodeInRest(nfo, expected, episode);
+    ASSERT_NE(std::string::npos, pos);
+    EXPECT_EQ(Save(expected), Save(details)) << "episode " << episode;
+    EXPECT_EQ(episode, details.m_iEpisode);
+
+    // the details are then those of the episode found
+    CVideoInfoTag found;
+    ASSERT_TRUE(nfoFile.GetDetails(found));
+    CXBMCTinyXML doc;
+    doc.Parse(nfo.substr(pos), TIXML_ENCODING_UNKNOWN);
+    CVideoInfoTag expectedFound;
+    ASSERT_TRUE(expectedFound.Load(doc.RootElement(), true));
+    EXPECT_EQ(Save(expectedFound), Save(found)) << "episode " << episode;
+    EXPECT_EQ(episode, found.m_iEpisode);
+    EXPECT_EQ(20u, found.m_cast.size());
+  }
+
+  // the details of a single episode are used whatever its number
+  Write(GetNfo(1));
+  CNfoFile nfoFile;
+  ASSERT_EQ(0, nfoFile.Load(path));
+  CVideoInfoTag details;
+  EXPECT_TRUE(nfoFile.GetEpisodeDetails(details, 4));
+  EXPECT_EQ(1, details.m_iEpisode);
+
+  // but not those of other episodes
+  Write(GetNfo(3));
+  ASSERT_EQ(0, nfoFile.Load(path));
+  CVideoInfoTag missing;
+  EXPECT_FALSE(nfoFile.GetEpisodeDetails(missing, 4));
+}
+
+TEST_F(TestNfoFile, GetDetails)
+{
+  // an nfo is read in one pass, or parsed if it isn't UTF-8, to the details of the parsed nfo
+  std::vector<std::string> nfos = {GetEpisode(1), GetEpisode(2),
+                                   "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>"
+                                   "<episodedetails><title>Caf\xE9</title></episodedetails>"};
+  for (const auto& nfo : nfos)
+  {
+    CVideoInfoTag details;
+    CNfoFile nfoFile;
+    ASSERT_TRUE(nfoFile.GetDetails(details, nfo.c_str()));
+
+    CXBMCTinyXML doc;
+    doc.Parse(nfo, TIXML_ENCODING_UNKNOWN);
+    CVideoInfoTag expected;
+    ASSERT_TRUE(expected.Load(doc.RootElement(), true));
+    EXPECT_EQ(Save(expected), Save(details)) << nfo;
+  }
+}
+
+TEST_F(TestNfoFile, GetDetails_Loaded)
+{
+  // the tags read once are loaded by each call, added to or prioritised over the details
+  const std::string nfo = GetNfo(1);
+  Write(nfo);
+  CNfoFile nfoFile;
+  ASSERT_EQ(0, nfoFile.Load(path));
+
+  CXBMCTinyXML doc;
+  doc.Parse(nfo, TIXML_ENCODING_UNKNOWN);
+  for (const bool prioritise : {false, true, false})
+  {
+    CVideoInfoTag details;
+    ASSERT_TRUE(details.Load(doc.RootElement(), true));
+    ASSERT_TRUE(nfoFile.GetDetails(details, nullptr, prioritise));
+
+    CVideoInfoTag expected;
+    ASSERT_TRUE(expected.Load(doc.RootElement(), true));
+    ASSERT_TRUE(expected.Load(doc.RootElement(), true, prioritise));
+    EXPECT_EQ(Save(expected), Save(details)) << "prioritise " << prioritise;
+  }
+}
+
+// the nfos read per second, run with --gtest_also_run_disabled_tests
+TEST_F(TestNfoFile, DISABLED_GetDetails_Benchmark)
+{
+  const int nfos = 1000;
+  const std::string nfo = GetNfo(1);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nfos; i++)
+  {
+    CNfoFile nfoFile;
+    CVideoInfoTag details;
+    ASSERT_TRUE(nfoFile.GetDetails(details, nfo.c_str()));
+  }
+  const auto read = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nfos; i++)
+  {
+    CXBMCTinyXML doc;
+    doc.Parse(nfo, TIXML_ENCODING_UNKNOWN);
+    CVideoInfoTag details;
+    ASSERT_TRUE(details.Load(doc.RootElement(), true));
+  }
+  const auto parsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  RecordProperty("read_nfos_per_second", static_cast<int>(nfos * 1000000LL / (read.count() + 1)));
+  RecordProperty("parsed_nfos_per_second",
+                 static_cast<int>(nfos * 1000000LL / (parsed.count() + 1)));
+}
@@ -0,0 +1,38 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextureCache.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(TestTextureCache, GetContentCacheFile)
+{
+  // 4x2 pixels, padded to 6 pixels per row
+  std::vector<uint8_t> pixels(6 * 4 * 2, 0x10);
+  const std::string file = CTextureCache::GetContentCacheFile(pixels.data(), 4, 2, 24, "thumb");
+  EXPECT_EQ(18u, file.size());
+  EXPECT_EQ(file[0], file[2]);
+  EXPECT_EQ('/', file[1]);
+
+  // the same pixels are the same file, whatever the padding
+  std::vector<uint8_t> other(6 * 4 * 2, 0x10);
+  other[16] = other[40] = 0xff;
+  EXPECT_EQ(file, CTextureCache::GetContentCacheFile(other.data(), 4, 2, 24, "thumb"));
+  std::vector<uint8_t> unpadded(4 * 4 * 2, 0x10);
+  EXPECT_EQ(file, CTextureCache::GetContentCacheFile(unpadded.data(), 4, 2, 16, "thumb"));
+
+  // other pixels, shapes or options are other files
+  other[0] = 0x11;
+  EXPECT_NE(file, CTextureCache::GetContentCacheFile(other.data(), 4, 2, 24, "thumb"));
+  EXPECT_NE(file, CTextureCache::GetContentCacheFile(pixels.data(), 2, 4, 8, "thumb"));
+  EXPECT_NE(file, CTextureCache::GetContentCacheFile(pixels.data(), 4, 2, 24, "fanart"));
+}
@@ -57,13 +57,7 @@ bool Message::Reply(int sig, void *data /* = NULL*/, size_t size /* = 0 */)
     msg->isOut = !isOut;
     replyMessage = msg;
     if (data)
-    {
-      if (size > sizeof(msg->buffer))
-        msg->data = new uint8_t[size];
-      else
-        msg->data = msg->buffer;
-      memcpy(msg->data, data, size);
-    }
+      msg->CopyPayload(data, size);
   }
 
   origin.Unlock();
@@ -74,28 +68,44 @@ bool Message::Reply(int sig, void *data /* = NULL*/, size_t size /* = 0 */)
   return true;
 }
 
+void Message::CopyPayload(const void* payload, size_t size)
+{
+  if (size > sizeof(buffer))
+    data = new uint8_t[size];
+  else
+    data = buffer;
+  memcpy(data, payload, size);
+  payloadSize = size;
+}
+
 Protocol::~Protocol()
 {
   Message *msg;
   Purge();
-  while (!freeMessageQueue.empty())
+  while (!freeMessages.empty())
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    msg = freeMessages.back();
+    freeMessages.pop_back();
     delete msg;
   }
 }
 
 Message *Protocol::GetMessage()
 {
-  Message *msg;
-
   std::unique_lock<CCriticalSection> lock(criticalSection);
 
-  if (!freeMessageQueue.empty())
+  return GetMessageLocked();
+}
+
+Message* Protocol::GetMessageLocked()
+{
+  Message *msg;
+
+  // most recently returned message first, it is most likely still in cache
+  if (!freeMessages.empty())
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    msg = freeMessages.back();
+    freeMessages.pop_back();
   }
   else
     msg = new Message(*this);
@@ -115,7 +125,7 @@ void Protocol::ReturnMessage(Message *msg)
 {
   std::unique_lock<CCriticalSection> lock(criticalSection);
 
-  freeMessageQueue.push(msg);
+  freeMessages.push_back(msg);
 }
 
 bool Protocol::SendOutMessage(int signal,
@@ -133,13 +143,7 @@ bool Protocol::SendOutMessage(int signal,
   msg->isOut = true;
 
   if (data)
-  {
-    if (size > sizeof(msg->buffer))
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->CopyPayload(data, size);
 
   {
     std::unique_lock<CCriticalSection> lock(criticalSection);
@@ -189,13 +193,7 @@ bool Protocol::SendInMessage(int signal,
   msg->isOut = false;
 
   if (data)
-  {
-    if (size > sizeof(msg->data))
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->CopyPayload(data, size);
 
   {
     std::unique_lock<CCriticalSection> lock(criticalSection);
@@ -230,6 +228,50 @@ bool Protocol::SendInMessage(int signal, CPayloadWrapBase *payload, Message *out
   return true;
 }
 
+bool Protocol::SendOutMessages(int signal, const void* data, size_t size, size_t count)
+{
+  const uint8_t* payload = static_cast<const uint8_t*>(data);
+
+  {
+    std::unique_lock<CCriticalSection> lock(criticalSection);
+    for (size_t i = 0; i < count; ++i)
+    {
+      Message* msg = GetMessageLocked();
+      msg->signal = signal;
+      msg->isOut = true;
+      if (payload)
+        msg->CopyPayload(payload + i * size, size);
+      outMessages.push(msg);
+    }
+  }
+  if (count && containerOutEvent)
+    containerOutEvent->Set();
+
+  return true;
+}
+
+bool Protocol::SendInMessages(int signal, const void* data, size_t size, size_t count)
+{
+  const uint8_t* payload = static_cast<const uint8_t*>(data);
+
+  {
+    std::unique_lock<CCriticalSection> lock(criticalSection);
+    for (size_t i = 0; i < count; ++i)
+    {
+      Message* msg = GetMessageLocked();
+      msg->signal = signal;
+      msg->isOut = false;
+      if (payload)
+        msg->CopyPayload(payload + i * size, size);
+      inMessages.push(msg);
+    }
+  }
+  if (count && containerInEvent)
+    containerInEvent->Set();
+
+  return true;
+}
+
 bool Protocol::SendOutMessageSync(int signal,
                                   Message** retMsg,
                                   std::chrono::milliseconds timeout,
@@ -15,6 +15,7 @@
 #include <queue>
 #include <string>
 #include <utility>
+#include <vector>
 
 class CEvent;
 
@@ -34,6 +35,7 @@ public:
   ~CPayloadWrap() override = default;
   CPayloadWrap(Payload* data) { m_pPayload.reset(data); }
   CPayloadWrap(Payload& data) { m_pPayload.reset(new Payload(data)); }
+  CPayloadWrap(Payload&& data) { m_pPayload.reset(new Payload(std::move(data))); }
   Payload* GetPlayload() { return m_pPayload.get(); }
 
 protected:
@@ -68,6 +70,8 @@ public:
 private:
   explicit Message(Protocol &_origin) noexcept
     :origin(_origin) {}
+
+  void CopyPayload(const void* payload, size_t size);
 };
 
 class Protocol
@@ -91,6 +95,12 @@ public:
                      size_t size = 0,
                      Message* outMsg = nullptr);
   bool SendInMessage(int signal, CPayloadWrapBase *payload, Message *outMsg = nullptr);
+  /*!
+   * \brief Queue count messages of the same signal under a single lock and wake the
+   * receiver once. data points to count consecutive payloads of size bytes each.
+   */
+  bool SendOutMessages(int signal, const void* data, size_t size, size_t count);
+  bool SendInMessages(int signal, const void* data, size_t size, size_t count);
   bool SendOutMessageSync(int signal,
                           Message** retMsg,
                           std::chrono::milliseconds timeout,
@@ -112,11 +122,13 @@ public:
   std::string portName;
 
 protected:
+  Message* GetMessageLocked();
+
   CEvent *containerInEvent, *containerOutEvent;
   CCriticalSection criticalSection;
   std::queue<Message*> outMessages;
   std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
+  std::vector<Message*> freeMessages;
   bool inDefered = false, outDefered = false;
 };
 
@@ -381,7 +381,10 @@ bool DatabaseUtils::GetSelectFields(const Fields &fields, const MediaType &media
   return !selectFields.empty();
 }
 
-bool DatabaseUtils::GetFieldValue(const dbiplus::field_value &fieldValue, CVariant &variantValue)
+namespace
+{
+template<typename T>
+bool GetVariantValue(const T& fieldValue, CVariant& variantValue)
 {
   if (fieldValue.get_isNull())
   {
@@ -429,6 +432,17 @@ bool DatabaseUtils::GetFieldValue(const dbiplus::field_value &fieldValue, CVaria
 
   return false;
 }
+} // namespace
+
+bool DatabaseUtils::GetFieldValue(const dbiplus::field_value &fieldValue, CVariant &variantValue)
+{
+  return GetVariantValue(fieldValue, variantValue);
+}
+
+bool DatabaseUtils::GetFieldValue(const dbiplus::field_ref &fieldValue, CVariant &variantValue)
+{
+  return GetVariantValue(fieldValue, variantValue);
+}
 
 bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldList &fields, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results)
 {
@@ -22,6 +22,7 @@ enum class VideoDbContentType;
 namespace dbiplus
 {
   class Dataset;
+  class field_ref;
   class field_value;
 }
 
@@ -177,6 +178,7 @@ public:
   static bool GetSelectFields(const Fields &fields, const MediaType &mediaType, FieldList &selectFields);
 
   static bool GetFieldValue(const dbiplus::field_value &fieldValue, CVariant &variantValue);
+  static bool GetFieldValue(const dbiplus::field_ref &fieldValue, CVariant &variantValue);
   static bool GetDatabaseResults(const MediaType &mediaType, const FieldList &fields, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results);
 
   static std::string BuildLimitClause(int end, int start = 0);
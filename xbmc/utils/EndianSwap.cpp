@@ -8,12 +8,40 @@
 
 #include "EndianSwap.h"
 
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 /* based on libavformat/spdif.c */
-void Endian_Swap16_buf(uint16_t *dst, uint16_t *src, int w)
+void Endian_Swap16_buf(uint16_t *dst, const uint16_t *src, int w)
 {
-  int i;
+  int i = 0;
+
+  /* dst and src may be unaligned and may be equal, but must not overlap otherwise */
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  for (; i + 16 <= w; i += 16)
+  {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+    b = _mm_or_si128(_mm_slli_epi16(b, 8), _mm_srli_epi16(b, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), b);
+  }
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+  for (; i + 16 <= w; i += 16)
+  {
+    const uint8x16_t a = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    const uint8x16_t b = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i + 8));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), vrev16q_u8(a));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i + 8), vrev16q_u8(b));
+  }
+#endif
 
-  for (i = 0; i + 8 <= w; i += 8) {
+  for (; i + 8 <= w; i += 8) {
     dst[i + 0] = Endian_Swap16(src[i + 0]);
     dst[i + 1] = Endian_Swap16(src[i + 1]);
     dst[i + 2] = Endian_Swap16(src[i + 2]);
@@ -27,4 +55,3 @@ void Endian_Swap16_buf(uint16_t *dst, uint16_t *src, int w)
   for (; i < w; i++)
     dst[i + 0] = Endian_Swap16(src[i + 0]);
 }
-
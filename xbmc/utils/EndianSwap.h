@@ -65,7 +65,7 @@ static __inline__ uint64_t Endian_Swap64(uint64_t x) {
 
 }
 
-void Endian_Swap16_buf(uint16_t *dst, uint16_t *src, int w);
+void Endian_Swap16_buf(uint16_t *dst, const uint16_t *src, int w);
 
 #ifndef WORDS_BIGENDIAN
 #define Endian_SwapLE16(X) (X)
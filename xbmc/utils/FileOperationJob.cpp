@@ -15,14 +15,19 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "filesystem/FileDirectoryFactory.h"
+#include "filesystem/PathTaskQueue.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 using namespace XFILE;
 
@@ -82,8 +87,21 @@ bool CFileOperationJob::DoWork()
   double opWeight = 100.0 / totalTime;
   double current = 0.0;
 
-  for (unsigned int i = 0; i < size && success; i++)
-    success &= ops[i].ExecuteOperation(this, current, opWeight);
+  for (size_t i = 0; i < size && success;)
+  {
+    // copies in a row run at a time, the other operations wait for them
+    size_t last = i;
+    while (last < size && ops[last].IsCopy())
+      last++;
+
+    if (last - i > 1)
+    {
+      success = ExecuteCopies(ops, i, last, current, opWeight);
+      i = last;
+    }
+    else
+      success &= ops[i++].ExecuteOperation(this, current, opWeight);
+  }
 
   MarkFinished();
 
@@ -108,6 +126,47 @@ bool CFileOperationJob::DoProcessFile(FileAction action, const std::string& strF
   return true;
 }
 
+bool CFileOperationJob::ExecuteCopies(FileOperationList& fileOperations,
+                                      size_t first,
+                                      size_t last,
+                                      double& current,
+                                      double opWeight)
+{
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  CPathTaskQueue queue(advancedSettings->m_iFileCopyStreams,
+                       advancedSettings->m_iFileCopyStreamsPerHost);
+
+  {
+    std::unique_lock<CCriticalSection> lock(m_progressSection);
+    m_copies.assign(last - first, CopyProgress());
+  }
+
+  // copies not started yet are skipped once one failed or was cancelled
+  std::atomic<bool> success(true);
+  for (size_t i = first; i < last; i++)
+  {
+    CFileOperation& operation = fileOperations[i];
+    const int copy = static_cast<int>(i - first);
+    queue.Add(operation.GetServerPath(),
+              [this, &operation, &success, copy, current, opWeight]()
+              {
+                if (!success)
+                  return;
+                double done = current;
+                if (!operation.ExecuteOperation(this, done, opWeight, copy))
+                  success = false;
+              });
+  }
+  queue.Wait();
+
+  std::unique_lock<CCriticalSection> lock(m_progressSection);
+  for (const CopyProgress& progress : m_copies)
+    current += progress.done;
+  m_copies.clear();
+
+  return success;
+}
+
 bool CFileOperationJob::DoProcessFolder(FileAction action, const std::string& strPath, const std::string& strDestFile, FileOperationList &fileOperations, double &totalTime)
 {
   // check whether this folder is a filedirectory - if so, we don't process it's contents
@@ -216,6 +275,7 @@ struct DataHolder
   CFileOperationJob *base;
   double current;
   double opWeight;
+  int copy = -1;
 };
 
 std::string CFileOperationJob::GetActionString(FileAction action)
@@ -248,19 +308,28 @@ std::string CFileOperationJob::GetActionString(FileAction action)
   return result;
 }
 
-bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base, double &current, double opWeight)
+bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob* base,
+                                                         double& current,
+                                                         double opWeight,
+                                                         int copy /* = -1 */)
 {
   bool bResult = true;
 
-  base->m_currentFile = CURL(m_strFileA).GetFileNameWithoutPath();
-  base->m_currentOperation = GetActionString(m_action);
-
-  if (base->ShouldCancel((unsigned int)current, 100))
-    return false;
+  {
+    std::unique_lock<CCriticalSection> lock(base->m_progressSection);
+    base->m_currentFile = CURL(m_strFileA).GetFileNameWithoutPath();
+    base->m_currentOperation = GetActionString(m_action);
+
+    double progress = current;
+    for (const CopyProgress& running : base->m_copies)
+      progress += running.done;
+    if (base->ShouldCancel((unsigned int)progress, 100))
+      return false;
 
-  base->SetText(base->GetCurrentFile());
+    base->SetText(base->GetCurrentFile());
+  }
 
-  DataHolder data = {base, current, opWeight};
+  DataHolder data = {base, current, opWeight, copy};
 
   switch (m_action)
   {
@@ -296,11 +365,29 @@ bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base
       break;
   }
 
-  current += (double)m_time * opWeight;
+  if (copy >= 0)
+  {
+    std::unique_lock<CCriticalSection> lock(base->m_progressSection);
+    base->m_copies[copy].done = (double)m_time * opWeight;
+    base->m_copies[copy].speed = 0.0f;
+  }
+  else
+    current += (double)m_time * opWeight;
 
   return bResult;
 }
 
+bool CFileOperationJob::CFileOperation::IsCopy() const
+{
+  return m_action == ActionCopy || m_action == ActionReplace ||
+         (m_action == ActionMove && !CanBeRenamed(m_strFileA, m_strFileB));
+}
+
+const std::string& CFileOperationJob::CFileOperation::GetServerPath() const
+{
+  return URIUtils::IsHD(m_strFileA) ? m_strFileB : m_strFileA;
+}
+
 inline bool CFileOperationJob::CanBeRenamed(const std::string &strFileA, const std::string &strFileB)
 {
 #ifndef TARGET_POSIX
@@ -323,6 +410,24 @@ bool CFileOperationJob::CFileOperation::OnFileCallback(void* pContext, int iperc
   DataHolder *data = static_cast<DataHolder*>(pContext);
   double current = data->current + ((double)ipercent * data->opWeight * (double)m_time)/ 100.0;
 
+  std::unique_lock<CCriticalSection> lock(data->base->m_progressSection);
+  if (data->copy >= 0)
+  {
+    // the progress and speed of all the copies running at a time
+    CopyProgress& progress = data->base->m_copies[data->copy];
+    progress.done = current - data->current;
+    progress.speed = avgSpeed;
+
+    current = data->current;
+    avgSpeed = 0.0f;
+    for (const CopyProgress& running : data->base->m_copies)
+    {
+      current += running.done;
+      avgSpeed += running.speed;
+    }
+    data->base->m_currentFile = CURL(m_strFileA).GetFileNameWithoutPath();
+  }
+
   if (avgSpeed > 1000000.0f)
     data->base->m_avgSpeed = StringUtils::Format("{:.1f} MB/s", avgSpeed / 1000000.0f);
   else
@@ -10,6 +10,7 @@
 
 #include "FileItem.h"
 #include "filesystem/IFileTypes.h"
+#include "threads/CriticalSection.h"
 #include "utils/ProgressJob.h"
 
 #include <string>
@@ -61,7 +62,17 @@ private:
 
     bool OnFileCallback(void* pContext, int ipercent, float avgSpeed) override;
 
-    bool ExecuteOperation(CFileOperationJob *base, double &current, double opWeight);
+    /*!
+     \brief Execute the operation.
+     \param copy the index of the copy among those running at a time, -1 if it runs on its own
+     */
+    bool ExecuteOperation(CFileOperationJob* base, double& current, double opWeight, int copy = -1);
+
+    //! Whether the operation copies the data of the file
+    bool IsCopy() const;
+
+    //! Get the path of the server the data is copied from or to, the local end is left out
+    const std::string& GetServerPath() const;
 
   private:
     FileAction m_action;
@@ -78,6 +89,11 @@ private:
                  double& totalTime);
   bool DoProcessFolder(FileAction action, const std::string& strPath, const std::string& strDestFile, FileOperationList &fileOperations, double &totalTime);
   bool DoProcessFile(FileAction action, const std::string& strFileA, const std::string& strFileB, FileOperationList &fileOperations, double &totalTime);
+  bool ExecuteCopies(FileOperationList& fileOperations,
+                     size_t first,
+                     size_t last,
+                     double& current,
+                     double opWeight);
 
   static inline bool CanBeRenamed(const std::string &strFileA, const std::string &strFileB);
 
@@ -88,4 +104,12 @@ private:
   bool m_displayProgress = false;
   int m_heading = 0;
   int m_line = 0;
+
+  struct CopyProgress
+  {
+    double done = 0.0;
+    float speed = 0.0f;
+  };
+  CCriticalSection m_progressSection;
+  std::vector<CopyProgress> m_copies; ///< progress of the copies running at a time
 };
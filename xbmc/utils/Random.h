@@ -22,5 +22,22 @@ void RandomShuffle(TIterator begin, TIterator end)
   std::mt19937 mt(rd());
   std::shuffle(begin, end, mt);
 }
+
+// Moves count randomly chosen elements, in random order, to the front of the range and returns
+// the end of them. Only count swaps are done, unlike shuffling the whole range.
+template<class TIterator>
+TIterator RandomSample(TIterator begin, TIterator end, size_t count)
+{
+  std::random_device rd;
+  std::mt19937 mt(rd());
+  const size_t size = static_cast<size_t>(std::distance(begin, end));
+  count = std::min(count, size);
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::uniform_int_distribution<size_t> pick(i, size - 1);
+    std::iter_swap(begin + i, begin + pick(mt));
+  }
+  return begin + count;
+}
 }
 }
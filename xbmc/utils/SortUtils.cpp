@@ -984,6 +984,74 @@ void SortUtils::GetFieldsForSQLSort(const MediaType& mediaType,
 }
 
 
+namespace
+{
+typedef std::vector<std::pair<std::string, size_t>> SortKeys;
+
+/*!
+ \brief Get the key an item sorts with, so the items sort with a byte comparison of their keys
+ the way the sorters above compare them: the special sort and the folder ranks, followed by the
+ key of the label with its bytes inverted when descending.
+ */
+std::string GetSortKey(const SortItem& item,
+                       const std::string& label,
+                       SortOrder sortOrder,
+                       SortAttribute attributes)
+{
+  SortSpecial sortSpecial = SortSpecialNone;
+  const auto itSortSpecial = item.find(FieldSortSpecial);
+  if (itSortSpecial != item.end() &&
+      itSortSpecial->second.asInteger() <= static_cast<int64_t>(SortSpecialOnBottom))
+    sortSpecial = static_cast<SortSpecial>(itSortSpecial->second.asInteger());
+
+  // the items sorted on top or on bottom keep their order
+  if (sortSpecial == SortSpecialOnTop)
+    return std::string(1, '\x01');
+  if (sortSpecial == SortSpecialOnBottom)
+    return std::string(1, '\x03');
+
+  std::string key(1, '\x02');
+  if (!(attributes & SortAttributeIgnoreFolders))
+  {
+    const auto itFolder = item.find(FieldFolder);
+    key += itFolder != item.end() && itFolder->second.asBoolean() ? '\x01' : '\x02';
+  }
+
+  const std::string labelKey = StringUtils::AlphaNumericSortKey(label);
+  if (sortOrder != SortOrderDescending)
+    return key + labelKey;
+
+  // the keys have no zero bytes so the end sorts below any byte of a longer key
+  for (const char c : labelKey)
+    key += static_cast<char>(~static_cast<unsigned char>(c));
+  key += '\xff';
+  return key;
+}
+
+//! Get the label an item is sorted with, the one it already had if any
+std::string GetKeyLabel(const std::pair<SortItem::iterator, bool>& sort, const std::string& label)
+{
+  if (sort.second)
+    return label;
+  std::string sortLabel;
+  g_charsetConverter.wToUTF8(sort.first->second.asWideString(), sortLabel);
+  return sortLabel;
+}
+
+template<typename T>
+void SortByKeys(std::vector<T>& items, SortKeys& keys)
+{
+  // the positions keep the order of the items with the same key
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<T> sorted;
+  sorted.reserve(items.size());
+  for (const auto& key : keys)
+    sorted.push_back(std::move(items[key.second]));
+  items = std::move(sorted);
+}
+} // namespace
+
 void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, DatabaseResults& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
 {
   if (sortBy != SortByNone)
@@ -994,6 +1062,12 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
 
+      // the keys do not follow the locale collation, the sorters compare with it
+      const bool useKeys = !g_langInfo.UseLocaleCollation();
+      SortKeys keys;
+      if (useKeys)
+        keys.reserve(items.size());
+
       // Prepare the string used for sorting and store it under FieldSort
       for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
       {
@@ -1004,13 +1078,20 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
             item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
         }
 
+        const std::string label = preparator(attributes, *item);
         std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        g_charsetConverter.utf8ToW(label, sortLabel, false);
+        const auto sort = item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        if (useKeys)
+          keys.emplace_back(GetSortKey(*item, GetKeyLabel(sort, label), sortOrder, attributes),
+                            keys.size());
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      if (useKeys)
+        SortByKeys(items, keys);
+      else
+        std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
     }
   }
 
@@ -1033,6 +1114,12 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
 
+      // the keys do not follow the locale collation, the sorters compare with it
+      const bool useKeys = !g_langInfo.UseLocaleCollation();
+      SortKeys keys;
+      if (useKeys)
+        keys.reserve(items.size());
+
       // Prepare the string used for sorting and store it under FieldSort
       for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
       {
@@ -1043,13 +1130,21 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
             (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
         }
 
+        const std::string label = preparator(attributes, **item);
         std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        g_charsetConverter.utf8ToW(label, sortLabel, false);
+        const auto sort =
+            (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        if (useKeys)
+          keys.emplace_back(GetSortKey(**item, GetKeyLabel(sort, label), sortOrder, attributes),
+                            keys.size());
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
+      if (useKeys)
+        SortByKeys(items, keys);
+      else
+        std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
     }
   }
 
@@ -1397,6 +1397,92 @@ int StringUtils::AlphaNumericCollation(int nKey1, const void* pKey1, int nKey2,
   return (nKey1 - nKey2);
 }
 
+/*
+  Build a key that sorts with a plain byte comparison (memcmp, or BINARY collation in SQL) in
+  the same order as AlphaNumericCollation() without locale collation:
+  - ascii symbols are mapped below the digits, keeping their order
+  - runs of up to 15 digits become their length followed by the digits without leading zeros
+  - letters are accent folded and ascii is lower cased, then encoded as UTF8 again
+  Control characters are dropped. Numbers that only differ in leading zeros get the same key,
+  the collation orders those by length.
+*/
+std::string StringUtils::AlphaNumericSortKey(const std::string& str)
+{
+  std::string key;
+  key.reserve(str.size() + 4);
+  const unsigned char* z = reinterpret_cast<const unsigned char*>(str.data());
+  const int n = static_cast<int>(str.size());
+  unsigned char bytes;
+  int i = 0;
+  while (i < n)
+  {
+    const unsigned char c = z[i];
+    if (isdigit(c))
+    {
+      int end = i;
+      while (end < n && isdigit(z[end]) && end < i + 15)
+        end++;
+      int start = i;
+      while (start < end - 1 && z[start] == '0')
+        start++;
+      key += static_cast<char>('0' + (end - start));
+      key.append(reinterpret_cast<const char*>(z + start), end - start);
+      i = end;
+      continue;
+    }
+    if (c < 32)
+    {
+      i++;
+      continue;
+    }
+    if (c < 128 && !isalpha(c))
+    {
+      // rank the 34 symbols in ascii order from 0x0E up to 0x2F
+      int rank;
+      if (c < '0')
+        rank = c - ' ';
+      else if (c < 'A')
+        rank = 16 + c - ':';
+      else if (c < 'a')
+        rank = 23 + c - '[';
+      else
+        rank = 29 + c - '{';
+      key += static_cast<char>(0x0E + rank);
+      i++;
+      continue;
+    }
+
+    uint32_t u = UTF8ToUnicode(&z[i], n - i, bytes);
+    i += bytes + 1;
+    if (u > 128)
+      u = GetCollationWeight(static_cast<wchar_t>(u));
+    if (u >= 'A' && u <= 'Z')
+      u += 'a' - 'A';
+
+    if (u < 0x80)
+      key += static_cast<char>(u);
+    else if (u < 0x800)
+    {
+      key += static_cast<char>(0xC0 | (u >> 6));
+      key += static_cast<char>(0x80 | (u & 0x3F));
+    }
+    else if (u < 0x10000)
+    {
+      key += static_cast<char>(0xE0 | (u >> 12));
+      key += static_cast<char>(0x80 | ((u >> 6) & 0x3F));
+      key += static_cast<char>(0x80 | (u & 0x3F));
+    }
+    else
+    {
+      key += static_cast<char>(0xF0 | (u >> 18));
+      key += static_cast<char>(0x80 | ((u >> 12) & 0x3F));
+      key += static_cast<char>(0x80 | ((u >> 6) & 0x3F));
+      key += static_cast<char>(0x80 | (u & 0x3F));
+    }
+  }
+  return key;
+}
+
 int StringUtils::DateStringToYYYYMMDD(const std::string &dateString)
 {
   std::vector<std::string> days = StringUtils::Split(dateString, '-');
@@ -248,6 +248,12 @@ public:
   static int FindNumber(const std::string& strInput, const std::string &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
   static int AlphaNumericCollation(int nKey1, const void* pKey1, int nKey2, const void* pKey2);
+  /*! \brief Get a key that sorts with a byte comparison like AlphaNumericCollation() does
+   without locale collation, e.g. to store in a database column with binary collation.
+   \param str UTF8 string to get the key of
+   \return the sort key, a UTF8 string
+   */
+  static std::string AlphaNumericSortKey(const std::string& str);
   static long TimeStringToSeconds(const std::string &timeString);
   static void RemoveCRLF(std::string& strLine);
 
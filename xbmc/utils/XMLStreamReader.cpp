@@ -0,0 +1,658 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XMLStreamReader.h"
+
+#include "utils/XBMCTinyXML.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+
+namespace
+{
+// white space as TinyXML skips and condenses it
+bool IsWhiteSpace(char c)
+{
+  return isspace(static_cast<unsigned char>(c)) || c == '\n' || c == '\r';
+}
+
+// TinyXML also takes any non-ASCII character in names, which are not read here
+bool IsNameStart(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool IsNameChar(char c)
+{
+  return IsNameStart(c) || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == ':';
+}
+
+bool IsHexDigit(char c)
+{
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+size_t GetUtf8Length(unsigned char lead)
+{
+  if (lead < 0x80)
+    return 1;
+  if (lead < 0xE0)
+    return 2;
+  if (lead < 0xF0)
+    return 3;
+  return 4;
+}
+
+/*!
+ \brief Whether text is valid UTF-8 TinyXML reads as it is
+ NUL ends the document TinyXML parses, and U+FEFF, U+FFFE and U+FFFF are skipped as white space.
+ */
+bool IsSupportedUtf8(std::string_view text)
+{
+  const auto* p = reinterpret_cast<const unsigned char*>(text.data());
+  const auto* end = p + text.size();
+  while (p < end)
+  {
+    const unsigned char lead = *p;
+    if (lead < 0x80)
+    {
+      if (lead == 0)
+        return false;
+      ++p;
+      continue;
+    }
+
+    uint32_t codePoint;
+    uint32_t min;
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+      codePoint = lead & 0x1F;
+      min = 0x80;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+      codePoint = lead & 0x0F;
+      min = 0x800;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+      codePoint = lead & 0x07;
+      min = 0x10000;
+    }
+    else
+      return false;
+
+    const size_t length = GetUtf8Length(lead);
+    if (static_cast<size_t>(end - p) < length)
+      return false;
+    for (size_t i = 1; i < length; i++)
+    {
+      if ((p[i] & 0xC0) != 0x80)
+        return false;
+      codePoint = (codePoint << 6) | (p[i] & 0x3F);
+    }
+    if (codePoint < min || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF) ||
+        codePoint == 0xFEFF || codePoint == 0xFFFE || codePoint == 0xFFFF)
+      return false;
+    p += length;
+  }
+  return true;
+}
+
+/*!
+ \brief Get the length of the entity at p
+ CXBMCTinyXML escapes every '&' not starting an entity matched by
+ "&(amp|lt|gt|quot|apos|#x[a-fA-F0-9]{1,4}|#[0-9]{1,5});" before TinyXML parses the document.
+ \return the length of the entity, 0 if the '&' is escaped
+ */
+size_t GetEntityLength(const char* p, const char* end)
+{
+  const std::string_view entity(p, std::min<size_t>(end - p, 8));
+  for (const std::string_view name : {"&amp;", "&lt;", "&gt;", "&quot;", "&apos;"})
+  {
+    if (entity.compare(0, name.size(), name) == 0)
+      return name.size();
+  }
+
+  if (entity.size() < 3 || entity[1] != '#')
+    return 0;
+
+  const bool hex = entity[2] == 'x';
+  const size_t start = hex ? 3 : 2;
+  size_t i = start;
+  while (i < entity.size() && (hex ? IsHexDigit(entity[i]) : IsDigit(entity[i])))
+    i++;
+  if (i == start || i - start > (hex ? 4 : 5) || i == entity.size() || entity[i] != ';')
+    return 0;
+  return i + 1;
+}
+
+// as TinyXML converts character references, which are at most U+1869F here
+void AppendCodePoint(std::string& value, uint32_t codePoint)
+{
+  if (codePoint < 0x80)
+    value += static_cast<char>(codePoint);
+  else if (codePoint < 0x800)
+  {
+    value += static_cast<char>(0xC0 | (codePoint >> 6));
+    value += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+  else if (codePoint < 0x10000)
+  {
+    value += static_cast<char>(0xE0 | (codePoint >> 12));
+    value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    value += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+  else
+  {
+    value += static_cast<char>(0xF0 | (codePoint >> 18));
+    value += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    value += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+}
+
+bool IsBlank(const std::string& value)
+{
+  return std::all_of(value.begin(), value.end(), IsWhiteSpace);
+}
+
+void SetAttributes(TiXmlElement& element, const CXMLStreamReader::Attributes& attributes)
+{
+  for (const auto& [name, value] : attributes)
+    element.SetAttribute(name, value);
+}
+} // namespace
+
+CXMLStreamReader::CXMLStreamReader(std::string_view document)
+  : m_pos(document.data()),
+    m_end(document.data() + document.size()),
+    m_condenseWhiteSpace(TiXmlBase::IsWhiteSpaceCondensed())
+{
+  // byte order mark
+  if (StartsWith("\xEF\xBB\xBF"))
+    m_pos += 3;
+
+  if (!IsSupportedUtf8(std::string_view(m_pos, m_end - m_pos)))
+    m_state = State::UNSUPPORTED;
+}
+
+const std::string* CXMLStreamReader::Attribute(std::string_view name) const
+{
+  const auto it = std::find_if(m_attributes.begin(), m_attributes.end(),
+                               [name](const auto& attribute) { return attribute.first == name; });
+  return it != m_attributes.end() ? &it->second : nullptr;
+}
+
+CXMLStreamReader::Node CXMLStreamReader::Next()
+{
+  if (m_emptyElement)
+  {
+    m_emptyElement = false;
+    return EndElement();
+  }
+
+  switch (m_state)
+  {
+    case State::PROLOG:
+      return ReadProlog();
+    case State::CONTENT:
+      return ReadContent();
+    case State::EPILOG:
+      return ReadEpilog();
+    case State::END:
+      return Node::END_DOCUMENT;
+    default:
+      return Node::UNSUPPORTED;
+  }
+}
+
+bool CXMLStreamReader::SkipElement()
+{
+  const size_t depth = m_elements.size();
+  if (depth == 0)
+    return false;
+
+  while (true)
+  {
+    const Node node = Next();
+    if (node == Node::UNSUPPORTED)
+      return false;
+    if (node == Node::END_ELEMENT && m_elements.size() < depth)
+      return true;
+  }
+}
+
+std::unique_ptr<TiXmlElement> CXMLStreamReader::ReadElement()
+{
+  auto element = std::make_unique<TiXmlElement>(std::string(m_name));
+  SetAttributes(*element, m_attributes);
+
+  std::vector<TiXmlElement*> parents{element.get()};
+  while (!parents.empty())
+  {
+    switch (Next())
+    {
+      case Node::START_ELEMENT:
+      {
+        auto* child = new TiXmlElement(std::string(m_name));
+        SetAttributes(*child, m_attributes);
+        parents.back()->LinkEndChild(child);
+        parents.push_back(child);
+        break;
+      }
+      case Node::END_ELEMENT:
+        parents.pop_back();
+        break;
+      case Node::CHARACTERS:
+        parents.back()->LinkEndChild(new TiXmlText(m_value));
+        break;
+      case Node::CDATA:
+      {
+        auto* text = new TiXmlText(m_value);
+        text->SetCDATA(true);
+        parents.back()->LinkEndChild(text);
+        break;
+      }
+      case Node::COMMENT:
+      {
+        auto* comment = new TiXmlComment();
+        comment->SetValue(m_value);
+        parents.back()->LinkEndChild(comment);
+        break;
+      }
+      default:
+        return nullptr;
+    }
+  }
+  return element;
+}
+
+CXMLStreamReader::Node CXMLStreamReader::Fail()
+{
+  m_state = State::UNSUPPORTED;
+  m_emptyElement = false;
+  return Node::UNSUPPORTED;
+}
+
+CXMLStreamReader::Node CXMLStreamReader::ReadProlog()
+{
+  while (true)
+  {
+    SkipWhiteSpace();
+    if (Peek(0) != '<')
+      return Fail();
+
+    if (StartsWith("<?xml", true))
+    {
+      if (!ReadDeclaration())
+        return Fail();
+    }
+    else if (StartsWith("<!--"))
+      return ReadComment() ? Node::COMMENT : Fail();
+    else if (IsNameStart(Peek(1)))
+    {
+      m_state = State::CONTENT;
+      return ReadStartTag();
+    }
+    else
+      return Fail();
+  }
+}
+
+CXMLStreamReader::Node CXMLStreamReader::ReadContent()
+{
+  // TinyXML keeps the white space before text unless it condenses white space
+  const char* textStart = m_pos;
+  while (true)
+  {
+    SkipWhiteSpace();
+    if (m_pos == m_end)
+      return Fail();
+
+    if (*m_pos != '<')
+    {
+      if (!ReadText(m_condenseWhiteSpace ? m_pos : textStart))
+        return Fail();
+      if (!IsBlank(m_value))
+        return Node::CHARACTERS;
+      textStart = m_pos;
+    }
+    else if (Peek(1) == '/')
+      return ReadEndTag();
+    else if (StartsWith("<!--"))
+      return ReadComment() ? Node::COMMENT : Fail();
+    else if (StartsWith("<![CDATA["))
+      return ReadCData() ? Node::CDATA : Fail();
+    else if (IsNameStart(Peek(1)))
+      return ReadStartTag();
+    else
+      return Fail();
+  }
+}
+
+CXMLStreamReader::Node CXMLStreamReader::ReadEpilog()
+{
+  while (true)
+  {
+    SkipWhiteSpace();
+    // TinyXML stops at text after the root element
+    if (Peek(0) != '<')
+    {
+      m_state = State::END;
+      return Node::END_DOCUMENT;
+    }
+
+    if (StartsWith("<!--"))
+    {
+      if (!ReadComment())
+        return Fail();
+    }
+    else if (IsNameStart(Peek(1)))
+    {
+      // TinyXML parses the elements after the root element too, as the episodes of an nfo
+      m_state = State::CONTENT;
+      if (ReadStartTag() == Node::UNSUPPORTED || !SkipElement())
+        return Fail();
+    }
+    else
+      return Fail();
+  }
+}
+
+CXMLStreamReader::Node CXMLStreamReader::ReadStartTag()
+{
+  ++m_pos;
+  std::string_view name;
+  ReadName(name);
+  m_name = name;
+  m_attributes.clear();
+
+  while (true)
+  {
+    SkipWhiteSpace();
+    if (m_pos == m_end)
+      return Fail();
+
+    if (*m_pos == '/')
+    {
+      if (Peek(1) != '>')
+        return Fail();
+      m_pos += 2;
+      m_elements.push_back(name);
+      m_emptyElement = true;
+      return Node::START_ELEMENT;
+    }
+
+    if (*m_pos == '>')
+    {
+      ++m_pos;
+      m_elements.push_back(name);
+      return Node::START_ELEMENT;
+    }
+
+    std::string_view attribute;
+    if (!ReadName(attribute))
+      return Fail();
+    SkipWhiteSpace();
+    if (Peek(0) != '=')
+      return Fail();
+    ++m_pos;
+    SkipWhiteSpace();
+    const char quote = Peek(0);
+    if (quote != '"' && quote != '\'')
+      return Fail();
+    ++m_pos;
+
+    std::string value;
+    while (m_pos < m_end && *m_pos != quote)
+    {
+      if (!AppendChar(value))
+        return Fail();
+    }
+    if (m_pos == m_end || Attribute(attribute))
+      return Fail();
+    ++m_pos;
+    m_attributes.emplace_back(attribute, std::move(value));
+  }
+}
+
+CXMLStreamReader::Node CXMLStreamReader::ReadEndTag()
+{
+  const std::string_view name = m_elements.back();
+  m_pos += 2;
+  if (!StartsWith(name))
+    return Fail();
+  m_pos += name.size();
+  SkipWhiteSpace();
+  if (Peek(0) != '>')
+    return Fail();
+  ++m_pos;
+  return EndElement();
+}
+
+CXMLStreamReader::Node CXMLStreamReader::EndElement()
+{
+  m_name = m_elements.back();
+  m_elements.pop_back();
+  if (m_elements.empty())
+    m_state = State::EPILOG;
+  return Node::END_ELEMENT;
+}
+
+bool CXMLStreamReader::ReadDeclaration()
+{
+  // read over the declaration as TinyXML does, its encoding was detected before
+  m_pos += 5;
+  while (m_pos < m_end)
+  {
+    if (*m_pos == '>')
+    {
+      ++m_pos;
+      return true;
+    }
+
+    SkipWhiteSpace();
+    if (StartsWith("version", true) || StartsWith("encoding", true) ||
+        StartsWith("standalone", true))
+    {
+      std::string_view name;
+      ReadName(name);
+      SkipWhiteSpace();
+      if (Peek(0) != '=')
+        return false;
+      ++m_pos;
+      SkipWhiteSpace();
+      const char quote = Peek(0);
+      if (quote != '"' && quote != '\'')
+        return false;
+      m_pos = std::find(m_pos + 1, m_end, quote);
+      if (m_pos == m_end)
+        return false;
+      ++m_pos;
+    }
+    else
+    {
+      while (m_pos < m_end && *m_pos != '>' && !IsWhiteSpace(*m_pos))
+        ++m_pos;
+    }
+  }
+  return false;
+}
+
+bool CXMLStreamReader::ReadComment()
+{
+  const char* start = m_pos + 4;
+  const size_t length = std::string_view(start, m_end - start).find("-->");
+  if (length == std::string_view::npos)
+    return false;
+
+  m_value.clear();
+  AppendRaw(m_value, start, start + length);
+  m_pos = start + length + 3;
+  return true;
+}
+
+bool CXMLStreamReader::ReadCData()
+{
+  const char* start = m_pos + 9;
+  const size_t length = std::string_view(start, m_end - start).find("]]>");
+  if (length == std::string_view::npos)
+    return false;
+
+  m_value.clear();
+  AppendRaw(m_value, start, start + length);
+  m_pos = start + length + 3;
+  return true;
+}
+
+bool CXMLStreamReader::ReadText(const char* start)
+{
+  m_pos = start;
+  m_value.clear();
+  if (m_condenseWhiteSpace)
+  {
+    // white space is skipped before the text, dropped after it and a single space within it
+    bool whiteSpace = false;
+    while (m_pos < m_end && *m_pos != '<')
+    {
+      if (IsWhiteSpace(*m_pos))
+      {
+        whiteSpace = true;
+        ++m_pos;
+        continue;
+      }
+      if (whiteSpace)
+      {
+        m_value += ' ';
+        whiteSpace = false;
+      }
+      if (!AppendChar(m_value))
+        return false;
+    }
+  }
+  else
+  {
+    while (m_pos < m_end && *m_pos != '<')
+    {
+      if (*m_pos == '&')
+      {
+        if (!AppendChar(m_value))
+          return false;
+        continue;
+      }
+      const char* run = m_pos;
+      while (m_pos < m_end && *m_pos != '<' && *m_pos != '&')
+        ++m_pos;
+      m_value.append(run, m_pos);
+    }
+  }
+  return m_pos < m_end;
+}
+
+bool CXMLStreamReader::ReadName(std::string_view& name)
+{
+  if (m_pos == m_end || !IsNameStart(*m_pos))
+    return false;
+
+  const char* start = m_pos;
+  while (m_pos < m_end && IsNameChar(*m_pos))
+    ++m_pos;
+  name = std::string_view(start, m_pos - start);
+  return true;
+}
+
+bool CXMLStreamReader::AppendChar(std::string& value)
+{
+  if (*m_pos != '&')
+  {
+    const size_t length = GetUtf8Length(static_cast<unsigned char>(*m_pos));
+    value.append(m_pos, length);
+    m_pos += length;
+    return true;
+  }
+
+  const size_t length = GetEntityLength(m_pos, m_end);
+  if (length == 0)
+    value += '&';
+  else if (m_pos[1] != '#')
+  {
+    switch (m_pos[1])
+    {
+      case 'a':
+        value += m_pos[2] == 'm' ? '&' : '\'';
+        break;
+      case 'l':
+        value += '<';
+        break;
+      case 'g':
+        value += '>';
+        break;
+      default:
+        value += '"';
+        break;
+    }
+  }
+  else
+  {
+    const bool hex = m_pos[2] == 'x';
+    uint32_t codePoint = 0;
+    for (const char* digit = m_pos + (hex ? 3 : 2); *digit != ';'; ++digit)
+    {
+      if (!hex)
+        codePoint = codePoint * 10 + (*digit - '0');
+      else if (IsDigit(*digit))
+        codePoint = codePoint * 16 + (*digit - '0');
+      else
+        codePoint = codePoint * 16 + (tolower(*digit) - 'a' + 10);
+    }
+    // TinyXML would put a NUL in the value, which ends it when read as a C string
+    if (codePoint == 0)
+      return false;
+    AppendCodePoint(value, codePoint);
+  }
+  m_pos += std::max<size_t>(length, 1);
+  return true;
+}
+
+void CXMLStreamReader::AppendRaw(std::string& value, const char* start, const char* end) const
+{
+  // comments and CDATA sections keep their entities, and the '&' CXBMCTinyXML escapes
+  while (start < end)
+  {
+    const char* ampersand = std::find(start, end, '&');
+    value.append(start, ampersand);
+    if (ampersand == end)
+      break;
+    value += GetEntityLength(ampersand, m_end) > 0 ? "&" : "&amp;";
+    start = ampersand + 1;
+  }
+}
+
+void CXMLStreamReader::SkipWhiteSpace()
+{
+  while (m_pos < m_end && IsWhiteSpace(*m_pos))
+    ++m_pos;
+}
+
+bool CXMLStreamReader::StartsWith(std::string_view tag, bool ignoreCase) const
+{
+  if (static_cast<size_t>(m_end - m_pos) < tag.size())
+    return false;
+  if (!ignoreCase)
+    return std::string_view(m_pos, tag.size()) == tag;
+  return std::equal(tag.begin(), tag.end(), m_pos, [](char a, char b) {
+    return tolower(static_cast<unsigned char>(a)) == tolower(static_cast<unsigned char>(b));
+  });
+}
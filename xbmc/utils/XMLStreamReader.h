@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class TiXmlElement;
+
+/*!
+ \brief Reads the nodes of an XML document one after another, without building the document.
+
+ The nodes are read the way CXBMCTinyXML parses a UTF-8 document: entities, white space and
+ invalid '&' are handled alike, so the values read are those of the nodes of the parsed document.
+
+ Only the XML written by Kodi, scrapers and media managers is read. A document using anything
+ else (a DOCTYPE, processing instructions, unquoted attribute values, ...), a malformed document
+ or a document that is not valid UTF-8 makes Next() return UNSUPPORTED: the document should then
+ be parsed with CXBMCTinyXML instead.
+ */
+class CXMLStreamReader
+{
+public:
+  enum class Node
+  {
+    START_ELEMENT, ///< the start of an element, see Name() and GetAttributes()
+    END_ELEMENT, ///< the end of the element started last
+    CHARACTERS, ///< text, see Value()
+    CDATA, ///< a CDATA section, see Value()
+    COMMENT, ///< a comment in or before the root element, see Value()
+    END_DOCUMENT, ///< the end of the document, once the nodes after the root element are checked
+    UNSUPPORTED, ///< the document can't be read
+  };
+
+  using Attributes = std::vector<std::pair<std::string, std::string>>;
+
+  explicit CXMLStreamReader(std::string_view document);
+
+  /*! \brief Read the next node of the document
+   \return the type of the node, UNSUPPORTED from then on if the document can't be read
+   */
+  Node Next();
+
+  //! The name of the element read last
+  std::string_view Name() const { return m_name; }
+
+  //! The attributes of the element read last, in document order
+  const Attributes& GetAttributes() const { return m_attributes; }
+
+  //! The value of an attribute of the element read last, nullptr if it has none of that name
+  const std::string* Attribute(std::string_view name) const;
+
+  //! The value of the text, CDATA section or comment read last
+  const std::string& Value() const { return m_value; }
+
+  //! The number of elements open, including the element read last
+  size_t Depth() const { return m_elements.size(); }
+
+  /*! \brief Read the rest of the innermost open element
+   \return false if the document can't be read
+   */
+  bool SkipElement();
+
+  /*! \brief Read the element started last into TinyXML nodes
+   \return the element with its attributes and children, nullptr if the document can't be read
+   */
+  std::unique_ptr<TiXmlElement> ReadElement();
+
+private:
+  enum class State
+  {
+    PROLOG,
+    CONTENT,
+    EPILOG,
+    END,
+    UNSUPPORTED,
+  };
+
+  Node Fail();
+  Node ReadProlog();
+  Node ReadContent();
+  Node ReadEpilog();
+  Node ReadStartTag();
+  Node ReadEndTag();
+  Node EndElement();
+
+  bool ReadDeclaration();
+  bool ReadComment();
+  bool ReadCData();
+  bool ReadText(const char* start);
+  bool ReadName(std::string_view& name);
+  bool AppendChar(std::string& value);
+  void AppendRaw(std::string& value, const char* start, const char* end) const;
+  void SkipWhiteSpace();
+  bool StartsWith(std::string_view tag, bool ignoreCase = false) const;
+  char Peek(size_t offset) const { return m_pos + offset < m_end ? m_pos[offset] : '\0'; }
+
+  const char* m_pos;
+  const char* m_end;
+  State m_state = State::PROLOG;
+  bool m_condenseWhiteSpace;
+  bool m_emptyElement = false;
+  std::vector<std::string_view> m_elements;
+  std::string_view m_name;
+  Attributes m_attributes;
+  std::string m_value;
+};
@@ -229,6 +229,7 @@ void CLog::SettingOptionsLoggingComponentsFiller(const SettingConstPtr& setting,
   list.emplace_back(g_localizeStrings.Get(679), LOGCEC);
 #endif
   list.emplace_back(g_localizeStrings.Get(682), LOGDATABASE);
+  list.emplace_back(g_localizeStrings.Get(39126), LOGDATABASEPROFILER);
 #if defined(HAS_FILESYSTEM_SMB)
   list.emplace_back(g_localizeStrings.Get(37050), LOGWSDISCOVERY);
 #endif
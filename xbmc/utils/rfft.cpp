@@ -8,15 +8,325 @@
 
 #include "rfft.h"
 
+#include <algorithm>
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+#include <xmmintrin.h>
+#define RFFT_SIMD
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RFFT_SIMD
+#endif
+
 #if defined(TARGET_WINDOWS) && !defined(_USE_MATH_DEFINES)
 #define _USE_MATH_DEFINES
 #endif
 #include <math.h>
 
+namespace
+{
+#if defined(HAVE_SSE) && defined(__SSE__)
+using Vec = __m128;
+inline Vec Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+inline Vec Set(float f) { return _mm_set1_ps(f); }
+inline Vec Add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+inline Vec Sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+inline Vec Mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+inline Vec Reverse(Vec v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+inline void Transpose(Vec& r0, Vec& r1, Vec& r2, Vec& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+inline Vec Magnitude(Vec re, Vec im)
+{
+  return _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)));
+}
+#elif defined(HAS_NEON) && defined(__ARM_NEON)
+using Vec = float32x4_t;
+inline Vec Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, Vec v) { vst1q_f32(p, v); }
+inline Vec Set(float f) { return vdupq_n_f32(f); }
+inline Vec Add(Vec a, Vec b) { return vaddq_f32(a, b); }
+inline Vec Sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+inline Vec Mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+inline Vec Reverse(Vec v)
+{
+  v = vrev64q_f32(v);
+  return vcombine_f32(vget_high_f32(v), vget_low_f32(v));
+}
+inline void Transpose(Vec& r0, Vec& r1, Vec& r2, Vec& r3)
+{
+  const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+  const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+  r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+  r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+  r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+  r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+inline Vec Magnitude(Vec re, Vec im)
+{
+  const Vec sq = vmlaq_f32(vmulq_f32(re, re), im, im);
+  // sqrt(x) = x * rsqrt(x), refined by two newton steps, zero stays zero
+  Vec est = vrsqrteq_f32(sq);
+  est = vmulq_f32(est, vrsqrtsq_f32(vmulq_f32(sq, est), est));
+  est = vmulq_f32(est, vrsqrtsq_f32(vmulq_f32(sq, est), est));
+  const uint32x4_t zero = vceqq_f32(sq, vdupq_n_f32(0.0f));
+  return vbslq_f32(zero, sq, vmulq_f32(sq, est));
+}
+#endif
+
+inline float Add(float a, float b) { return a + b; }
+inline float Sub(float a, float b) { return a - b; }
+inline float Mul(float a, float b) { return a * b; }
+
+// radix-4 decimation in frequency butterfly on split complex values, the
+// outputs are multiplied by the twiddles w1..w3
+template<typename T>
+inline void Butterfly(const T (&xr)[4], const T (&xi)[4], const T (&wr)[3], const T (&wi)[3], T (&yr)[4], T (&yi)[4])
+{
+  const T apcr = Add(xr[0], xr[2]), apci = Add(xi[0], xi[2]);
+  const T amcr = Sub(xr[0], xr[2]), amci = Sub(xi[0], xi[2]);
+  const T bpdr = Add(xr[1], xr[3]), bpdi = Add(xi[1], xi[3]);
+  const T bmdr = Sub(xr[1], xr[3]), bmdi = Sub(xi[1], xi[3]);
+
+  yr[0] = Add(apcr, bpdr);
+  yi[0] = Add(apci, bpdi);
+
+  // (a - c) - j(b - d), (a + c) - (b + d), (a - c) + j(b - d)
+  const T tr[3] = {Add(amcr, bmdi), Sub(apcr, bpdr), Sub(amcr, bmdi)};
+  const T ti[3] = {Sub(amci, bmdr), Sub(apci, bpdi), Add(amci, bmdr)};
+  for (int k = 0; k < 3; ++k)
+  {
+    yr[k + 1] = Sub(Mul(tr[k], wr[k]), Mul(ti[k], wi[k]));
+    yi[k + 1] = Add(Mul(tr[k], wi[k]), Mul(ti[k], wr[k]));
+  }
+}
+} // unnamed namespace
+
+//! \brief Stockham autosort FFT of size m_size/2 on split complex data, the
+//! real transform is computed from it by packing even and odd samples.
+struct RFFT::Plan
+{
+  struct Stage
+  {
+    size_t n; //!< length of the sub transforms
+    size_t s; //!< stride between them
+    std::vector<float> twiddles; //!< w1re, w1im, w2re, w2im, w3re, w3im, n/4 each
+  };
+
+  explicit Plan(size_t size);
+
+  //! \brief Forward complex transform, returns the buffer index holding the result.
+  int Transform(float* re, float* im);
+
+  void Radix4(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi) const;
+  void Radix2(size_t s, const float* xr, const float* xi, float* yr, float* yi) const;
+
+  size_t half;
+  std::vector<Stage> stages;
+  bool finalRadix2 = false;
+  std::vector<float> wr, wi; //!< exp(-2 pi i k / size) for the real transform
+  std::vector<float> bufRe[2], bufIm[2];
+};
+
+RFFT::Plan::Plan(size_t size) : half(size / 2)
+{
+  size_t n = half;
+  size_t s = 1;
+  for (; n >= 4; n /= 4, s *= 4)
+  {
+    Stage stage{n, s, {}};
+    const size_t m = n / 4;
+    stage.twiddles.resize(6 * m);
+    for (size_t p = 0; p < m; ++p)
+    {
+      for (size_t k = 1; k <= 3; ++k)
+      {
+        const double theta = -2.0 * M_PI * static_cast<double>(k * p) / static_cast<double>(n);
+        stage.twiddles[(2 * k - 2) * m + p] = static_cast<float>(cos(theta));
+        stage.twiddles[(2 * k - 1) * m + p] = static_cast<float>(sin(theta));
+      }
+    }
+    stages.push_back(std::move(stage));
+  }
+  finalRadix2 = n == 2;
+
+  wr.resize(half);
+  wi.resize(half);
+  for (size_t k = 0; k < half; ++k)
+  {
+    const double theta = -M_PI * static_cast<double>(k) / static_cast<double>(half);
+    wr[k] = static_cast<float>(cos(theta));
+    wi[k] = static_cast<float>(sin(theta));
+  }
+
+  for (int i = 0; i < 2; ++i)
+  {
+    bufRe[i].resize(half);
+    bufIm[i].resize(half);
+  }
+}
+
+void RFFT::Plan::Radix4(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi) const
+{
+  const size_t s = stage.s;
+  const size_t m = stage.n / 4;
+  const float* tw = stage.twiddles.data();
+
+  if (s == 1)
+  {
+    // first stage, vectorize over p and transpose the results into place
+    size_t p = 0;
+#ifdef RFFT_SIMD
+    for (; p + 4 <= m; p += 4)
+    {
+      const Vec ar[4] = {Load(xr + p), Load(xr + p + m), Load(xr + p + 2 * m), Load(xr + p + 3 * m)};
+      const Vec ai[4] = {Load(xi + p), Load(xi + p + m), Load(xi + p + 2 * m), Load(xi + p + 3 * m)};
+      const Vec wr[3] = {Load(tw + p), Load(tw + 2 * m + p), Load(tw + 4 * m + p)};
+      const Vec wi[3] = {Load(tw + m + p), Load(tw + 3 * m + p), Load(tw + 5 * m + p)};
+      Vec br[4], bi[4];
+      Butterfly(ar, ai, wr, wi, br, bi);
+      Transpose(br[0], br[1], br[2], br[3]);
+      Transpose(bi[0], bi[1], bi[2], bi[3]);
+      for (int k = 0; k < 4; ++k)
+      {
+        Store(yr + 4 * p + 4 * k, br[k]);
+        Store(yi + 4 * p + 4 * k, bi[k]);
+      }
+    }
+#endif
+    for (; p < m; ++p)
+    {
+      const float ar[4] = {xr[p], xr[p + m], xr[p + 2 * m], xr[p + 3 * m]};
+      const float ai[4] = {xi[p], xi[p + m], xi[p + 2 * m], xi[p + 3 * m]};
+      const float wr[3] = {tw[p], tw[2 * m + p], tw[4 * m + p]};
+      const float wi[3] = {tw[m + p], tw[3 * m + p], tw[5 * m + p]};
+      float br[4], bi[4];
+      Butterfly(ar, ai, wr, wi, br, bi);
+      for (int k = 0; k < 4; ++k)
+      {
+        yr[4 * p + k] = br[k];
+        yi[4 * p + k] = bi[k];
+      }
+    }
+    return;
+  }
+
+  // later stages, s is a multiple of 4 so the inner loop is contiguous
+  for (size_t p = 0; p < m; ++p)
+  {
+    const float* x0r = xr + s * p;
+    const float* x0i = xi + s * p;
+    float* y0r = yr + s * 4 * p;
+    float* y0i = yi + s * 4 * p;
+    size_t q = 0;
+#ifdef RFFT_SIMD
+    const Vec wr[3] = {Set(tw[p]), Set(tw[2 * m + p]), Set(tw[4 * m + p])};
+    const Vec wi[3] = {Set(tw[m + p]), Set(tw[3 * m + p]), Set(tw[5 * m + p])};
+    for (; q + 4 <= s; q += 4)
+    {
+      const Vec ar[4] = {Load(x0r + q), Load(x0r + q + s * m), Load(x0r + q + 2 * s * m),
+                         Load(x0r + q + 3 * s * m)};
+      const Vec ai[4] = {Load(x0i + q), Load(x0i + q + s * m), Load(x0i + q + 2 * s * m),
+                         Load(x0i + q + 3 * s * m)};
+      Vec br[4], bi[4];
+      Butterfly(ar, ai, wr, wi, br, bi);
+      for (size_t k = 0; k < 4; ++k)
+      {
+        Store(y0r + q + s * k, br[k]);
+        Store(y0i + q + s * k, bi[k]);
+      }
+    }
+#endif
+    const float swr[3] = {tw[p], tw[2 * m + p], tw[4 * m + p]};
+    const float swi[3] = {tw[m + p], tw[3 * m + p], tw[5 * m + p]};
+    for (; q < s; ++q)
+    {
+      const float ar[4] = {x0r[q], x0r[q + s * m], x0r[q + 2 * s * m], x0r[q + 3 * s * m]};
+      const float ai[4] = {x0i[q], x0i[q + s * m], x0i[q + 2 * s * m], x0i[q + 3 * s * m]};
+      float br[4], bi[4];
+      Butterfly(ar, ai, swr, swi, br, bi);
+      for (size_t k = 0; k < 4; ++k)
+      {
+        y0r[q + s * k] = br[k];
+        y0i[q + s * k] = bi[k];
+      }
+    }
+  }
+}
+
+void RFFT::Plan::Radix2(size_t s, const float* xr, const float* xi, float* yr, float* yi) const
+{
+  size_t q = 0;
+#ifdef RFFT_SIMD
+  for (; q + 4 <= s; q += 4)
+  {
+    const Vec ar = Load(xr + q), ai = Load(xi + q);
+    const Vec br = Load(xr + q + s), bi = Load(xi + q + s);
+    Store(yr + q, Add(ar, br));
+    Store(yi + q, Add(ai, bi));
+    Store(yr + q + s, Sub(ar, br));
+    Store(yi + q + s, Sub(ai, bi));
+  }
+#endif
+  for (; q < s; ++q)
+  {
+    const float ar = xr[q], ai = xi[q];
+    const float br = xr[q + s], bi = xi[q + s];
+    yr[q] = ar + br;
+    yi[q] = ai + bi;
+    yr[q + s] = ar - br;
+    yi[q + s] = ai - bi;
+  }
+}
+
+int RFFT::Plan::Transform(float* re, float* im)
+{
+  // re/im alias buffer 0 or are copied there by the caller
+  const float* xr = re;
+  const float* xi = im;
+  int current = 0;
+  for (const auto& stage : stages)
+  {
+    const int next = current ^ 1;
+    Radix4(stage, xr, xi, bufRe[next].data(), bufIm[next].data());
+    current = next;
+    xr = bufRe[current].data();
+    xi = bufIm[current].data();
+  }
+  if (finalRadix2)
+  {
+    const int next = current ^ 1;
+    Radix2(half / 2, xr, xi, bufRe[next].data(), bufIm[next].data());
+    current = next;
+  }
+  return current;
+}
+
 RFFT::RFFT(int size, bool windowed) :
   m_size(size), m_windowed(windowed)
 {
-  m_cfg = kiss_fftr_alloc(m_size,0,nullptr,nullptr);
+  // power of two sizes use the vectorized plan, scalar builds are faster with kissfft
+#ifdef RFFT_SIMD
+  if (m_size >= 4 && (m_size & (m_size - 1)) == 0)
+    m_plan = std::make_unique<Plan>(m_size);
+  else
+#endif
+  {
+    m_cfg = kiss_fftr_alloc(m_size,0,nullptr,nullptr);
+    m_spectrum.resize(m_size / 2 + 1);
+  }
+
+  // the window carries the normalization of the magnitudes
+  m_window.assign(m_size, 2.0f / m_size);
+  if (m_windowed)
+  {
+    hann(m_window);
+    for (auto& w : m_window)
+      w *= static_cast<float>(sqrt(8.0 / 3.0));
+  }
+
+  m_input.resize(m_size);
+  m_re.resize(m_size / 2 + 1);
+  m_im.resize(m_size / 2 + 1);
 }
 
 RFFT::~RFFT()
@@ -26,45 +336,173 @@ RFFT::~RFFT()
   // to SIMD (which might be used during kiss_fftr_alloc
   //in the C'tor).
   KISS_FFT_FREE(m_cfg);
+  KISS_FFT_FREE(m_icfg);
 }
 
 void RFFT::calc(const float* input, float* output)
 {
-  // temporary buffers
-  std::vector<kiss_fft_scalar> linput(m_size), rinput(m_size);
-  std::vector<kiss_fft_cpx> loutput(m_size), routput(m_size);
+  calc(input, 2, output);
+}
 
-  for (size_t i=0;i<m_size;++i)
+void RFFT::calc(const float* input, int channels, float* output, bool decibel)
+{
+  const size_t bins = m_size / 2;
+  for (int c = 0; c < channels; ++c)
   {
-    linput[i] = input[2*i];
-    rinput[i] = input[2*i+1];
+    for (size_t i = 0; i < m_size; ++i)
+      m_input[i] = input[i * channels + c] * m_window[i];
+
+    forward(m_input.data(), m_re.data(), m_im.data());
+
+    // interleave while taking magnitudes
+    size_t i = 0;
+#ifdef RFFT_SIMD
+    float mag[4];
+    for (; i + 4 <= bins; i += 4)
+    {
+      Store(mag, Magnitude(Load(m_re.data() + i), Load(m_im.data() + i)));
+      for (int k = 0; k < 4; ++k)
+        output[(i + k) * channels + c] = mag[k];
+    }
+#endif
+    for (; i < bins; ++i)
+      output[i * channels + c] = sqrtf(m_re[i] * m_re[i] + m_im[i] * m_im[i]);
+
+    if (decibel)
+    {
+      for (i = 0; i < bins; ++i)
+      {
+        float& value = output[i * channels + c];
+        value = 20.0f * log10f(std::max(value, 1e-6f));
+      }
+    }
   }
+}
 
-  if (m_windowed)
+void RFFT::forward(const float* input, float* re, float* im)
+{
+  if (!m_plan)
   {
-    hann(linput);
-    hann(rinput);
+    kiss_fftr(m_cfg, input, m_spectrum.data());
+    for (size_t k = 0; k <= m_size / 2; ++k)
+    {
+      re[k] = m_spectrum[k].r;
+      im[k] = m_spectrum[k].i;
+    }
+    return;
   }
 
-  // transform channels
-  kiss_fftr(m_cfg, &linput[0], &loutput[0]);
-  kiss_fftr(m_cfg, &rinput[0], &routput[0]);
+  Plan& plan = *m_plan;
+  const size_t half = plan.half;
 
-  auto&& filter = [&](kiss_fft_cpx& data)
+  // pack even and odd samples as one complex sequence of half the size
+  float* zr = plan.bufRe[0].data();
+  float* zi = plan.bufIm[0].data();
+  for (size_t n = 0; n < half; ++n)
   {
-    return static_cast<double>(sqrt(data.r * data.r + data.i * data.i)) * 2.0 / m_size *
-           (m_windowed ? sqrt(8.0 / 3.0) : 1.0);
-  };
+    zr[n] = input[2 * n];
+    zi[n] = input[2 * n + 1];
+  }
 
-  // interleave while taking magnitudes and normalizing
-  for (size_t i=0;i<m_size/2;++i)
+  const int result = plan.Transform(zr, zi);
+  zr = plan.bufRe[result].data();
+  zi = plan.bufIm[result].data();
+
+  // X[k] = E[k] + W^k O[k] with E = (Z[k] + Z*[half-k]) / 2, O = -j (Z[k] - Z*[half-k]) / 2
+  re[0] = zr[0] + zi[0];
+  im[0] = 0.0f;
+  re[half] = zr[0] - zi[0];
+  im[half] = 0.0f;
+
+  const float* wr = plan.wr.data();
+  const float* wi = plan.wi.data();
+  size_t k = 1;
+#ifdef RFFT_SIMD
+  const Vec h = Set(0.5f);
+  for (; k + 4 <= half; k += 4)
+  {
+    const Vec ar = Load(zr + k), ai = Load(zi + k);
+    const Vec br = Reverse(Load(zr + half - k - 3));
+    const Vec bi = Reverse(Load(zi + half - k - 3)); // conjugate folded in below
+    const Vec er = Mul(h, Add(ar, br)), ei = Mul(h, Sub(ai, bi));
+    const Vec orr = Mul(h, Add(ai, bi)), oi = Mul(h, Sub(br, ar));
+    const Vec twr = Load(wr + k), twi = Load(wi + k);
+    Store(re + k, Add(er, Sub(Mul(twr, orr), Mul(twi, oi))));
+    Store(im + k, Add(ei, Add(Mul(twr, oi), Mul(twi, orr))));
+  }
+#endif
+  for (; k < half; ++k)
   {
-    output[2*i] = filter(loutput[i]);
-    output[2*i+1] = filter(routput[i]);
+    const float ar = zr[k], ai = zi[k];
+    const float br = zr[half - k], bi = zi[half - k];
+    const float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+    const float orr = 0.5f * (ai + bi), oi = 0.5f * (br - ar);
+    re[k] = er + wr[k] * orr - wi[k] * oi;
+    im[k] = ei + wr[k] * oi + wi[k] * orr;
   }
 }
 
-#include <iostream>
+void RFFT::inverse(const float* re, const float* im, float* output)
+{
+  if (!m_plan)
+  {
+    if (!m_icfg)
+      m_icfg = kiss_fftr_alloc(m_size, 1, nullptr, nullptr);
+    for (size_t k = 0; k <= m_size / 2; ++k)
+    {
+      m_spectrum[k].r = re[k];
+      m_spectrum[k].i = im[k];
+    }
+    kiss_fftri(m_icfg, m_spectrum.data(), output);
+    return;
+  }
+
+  Plan& plan = *m_plan;
+  const size_t half = plan.half;
+
+  // Z[k] = E[k] + j O[k] with E = X[k] + X*[half-k], O = (X[k] - X*[half-k]) W^-k,
+  // the real and imaginary parts are swapped to run the inverse as forward transform
+  float* zr = plan.bufIm[0].data();
+  float* zi = plan.bufRe[0].data();
+  const float* wr = plan.wr.data();
+  const float* wi = plan.wi.data();
+  size_t k = 0;
+#ifdef RFFT_SIMD
+  for (; k + 4 <= half; k += 4)
+  {
+    const Vec ar = Load(re + k), ai = Load(im + k);
+    const Vec br = Reverse(Load(re + half - k - 3));
+    const Vec bi = Reverse(Load(im + half - k - 3));
+    const Vec er = Add(ar, br), ei = Sub(ai, bi);
+    const Vec dr = Sub(ar, br), di = Add(ai, bi);
+    const Vec twr = Load(wr + k), twi = Load(wi + k);
+    const Vec orr = Add(Mul(dr, twr), Mul(di, twi));
+    const Vec oi = Sub(Mul(di, twr), Mul(dr, twi));
+    Store(zr + k, Sub(er, oi));
+    Store(zi + k, Add(ei, orr));
+  }
+#endif
+  for (; k < half; ++k)
+  {
+    const float ar = re[k], ai = im[k];
+    const float br = re[half - k], bi = im[half - k];
+    const float er = ar + br, ei = ai - bi;
+    const float dr = ar - br, di = ai + bi;
+    const float orr = dr * wr[k] + di * wi[k];
+    const float oi = di * wr[k] - dr * wi[k];
+    zr[k] = er - oi;
+    zi[k] = ei + orr;
+  }
+
+  const int result = plan.Transform(zi, zr);
+  const float* xr = plan.bufIm[result].data();
+  const float* xi = plan.bufRe[result].data();
+  for (size_t n = 0; n < half; ++n)
+  {
+    output[2 * n] = xr[n];
+    output[2 * n + 1] = xi[n];
+  }
+}
 
 void RFFT::hann(std::vector<kiss_fft_scalar>& data)
 {
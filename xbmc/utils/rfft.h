@@ -8,11 +8,16 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include <kissfft/kiss_fftr.h>
 
 //! \brief Class performing a RFFT of interleaved stereo data.
+//!
+//! Power of two sizes use a radix-4 transform vectorized with SSE or NEON,
+//! other sizes and builds without SIMD fall back to kissfft. An instance keeps
+//! scratch buffers and must not be used by several threads at the same time.
 class RFFT
 {
 public:
@@ -28,12 +33,38 @@ public:
   //! \param input Input data of size 2*m_size
   //! \param output Output data of size m_size.
   void calc(const float* input, float* output);
+
+  //! \brief Calculate magnitude spectra of all channels of interleaved data.
+  //! \param input Input data of size channels*m_size.
+  //! \param channels Number of interleaved channels.
+  //! \param output Output data of size channels*m_size/2, interleaved like the input.
+  //! \param decibel Whether to return levels in dB (floored at -120 dB) instead of magnitudes.
+  void calc(const float* input, int channels, float* output, bool decibel = false);
+
+  //! \brief Calculate the complex spectrum of a single channel.
+  //! \param input Input data of size m_size.
+  //! \param re Real parts of size m_size/2+1, not normalized.
+  //! \param im Imaginary parts of size m_size/2+1.
+  void forward(const float* input, float* re, float* im);
+
+  //! \brief Calculate the inverse transform of a single channel.
+  //! \param re Real parts of the spectrum, size m_size/2+1.
+  //! \param im Imaginary parts of the spectrum, size m_size/2+1.
+  //! \param output Output data of size m_size, scaled by m_size.
+  void inverse(const float* re, const float* im, float* output);
 protected:
+  struct Plan;
+
   //! \brief Apply a Hann window to a buffer.
   //! \param data Vector with data to apply window to.
   static void hann(std::vector<kiss_fft_scalar>& data);
 
   size_t m_size;       //!< Size for a single channel.
   bool m_windowed;     //!< Whether or not a Hann window is applied.
-  kiss_fftr_cfg m_cfg; //!< FFT plan
+  kiss_fftr_cfg m_cfg = nullptr; //!< FFT plan for sizes that are not a power of two
+  kiss_fftr_cfg m_icfg = nullptr; //!< Inverse FFT plan, created on first use
+  std::unique_ptr<Plan> m_plan; //!< Vectorized plan for power of two sizes
+  std::vector<float> m_window; //!< Precomputed window including normalization
+  std::vector<float> m_input, m_re, m_im; //!< Scratch buffers
+  std::vector<kiss_fft_cpx> m_spectrum; //!< Scratch buffer for kissfft
 };
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/Event.h"
+#include "utils/ActorProtocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Actor;
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr int SIGNAL_DATA = 1;
+constexpr int SIGNAL_PING = 2;
+constexpr int SIGNAL_PONG = 3;
+constexpr int SIGNAL_QUIT = 4;
+
+struct SmallPayload
+{
+  int64_t a;
+  int64_t b;
+};
+
+struct LargePayload
+{
+  uint8_t bytes[128];
+};
+} // namespace
+
+TEST(TestActorProtocol, InlinePayload)
+{
+  CEvent inEvent;
+  Protocol port("test", &inEvent, nullptr);
+
+  SmallPayload small{1, 2};
+  port.SendInMessage(SIGNAL_DATA, &small, sizeof(small));
+
+  Message* msg = nullptr;
+  ASSERT_TRUE(port.ReceiveInMessage(&msg));
+  EXPECT_EQ(SIGNAL_DATA, msg->signal);
+  EXPECT_EQ(msg->buffer, msg->data);
+  EXPECT_EQ(sizeof(small), msg->payloadSize);
+  EXPECT_EQ(0, memcmp(&small, msg->data, sizeof(small)));
+  msg->Release();
+
+  LargePayload large;
+  memset(large.bytes, 0xA5, sizeof(large.bytes));
+  port.SendOutMessage(SIGNAL_DATA, &large, sizeof(large));
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_NE(msg->buffer, msg->data);
+  EXPECT_EQ(0, memcmp(&large, msg->data, sizeof(large)));
+  msg->Release();
+}
+
+TEST(TestActorProtocol, BatchedMessages)
+{
+  CEvent inEvent;
+  Protocol port("test", &inEvent, nullptr);
+
+  std::vector<int> values{10, 20, 30, 40};
+  port.SendInMessages(SIGNAL_DATA, values.data(), sizeof(int), values.size());
+  EXPECT_TRUE(inEvent.Wait(0ms));
+
+  Message* msg = nullptr;
+  for (int value : values)
+  {
+    ASSERT_TRUE(port.ReceiveInMessage(&msg));
+    EXPECT_EQ(SIGNAL_DATA, msg->signal);
+    EXPECT_FALSE(msg->isOut);
+    EXPECT_EQ(value, *reinterpret_cast<int*>(msg->data));
+    msg->Release();
+  }
+  EXPECT_FALSE(port.ReceiveInMessage(&msg));
+}
+
+// the round trip time and batched throughput, run with --gtest_also_run_disabled_tests
+TEST(TestActorProtocol, DISABLED_RoundTripBenchmark)
+{
+  CEvent outEvent;
+  Protocol port("bench", nullptr, &outEvent);
+  std::atomic<bool> stop{false};
+
+  std::thread worker([&]() {
+    Message* msg = nullptr;
+    while (!stop)
+    {
+      if (!port.ReceiveOutMessage(&msg))
+      {
+        outEvent.Wait(10ms);
+        continue;
+      }
+      if (msg->signal == SIGNAL_PING)
+        msg->Reply(SIGNAL_PONG, msg->data, msg->payloadSize);
+      else if (msg->signal == SIGNAL_QUIT)
+        stop = true;
+      msg->Release();
+    }
+  });
+
+  constexpr int ROUNDTRIPS = 2000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ROUNDTRIPS; ++i)
+  {
+    Message* reply = nullptr;
+    if (!port.SendOutMessageSync(SIGNAL_PING, &reply, 1s, &i, sizeof(i)))
+    {
+      ADD_FAILURE() << "no reply for round trip " << i;
+      break;
+    }
+    EXPECT_EQ(SIGNAL_PONG, reply->signal);
+    EXPECT_EQ(i, *reinterpret_cast<int*>(reply->data));
+    reply->Release();
+  }
+  const auto roundTrip = std::chrono::steady_clock::now() - start;
+
+  constexpr int MESSAGES = 100000;
+  std::vector<int> batch(64);
+  const auto batchStart = std::chrono::steady_clock::now();
+  for (int sent = 0; sent < MESSAGES; sent += static_cast<int>(batch.size()))
+    port.SendOutMessages(SIGNAL_DATA, batch.data(), sizeof(int), batch.size());
+  port.SendOutMessage(SIGNAL_QUIT);
+  worker.join();
+  const auto throughput = std::chrono::steady_clock::now() - batchStart;
+
+  const double usPerRoundTrip =
+      std::chrono::duration<double, std::micro>(roundTrip).count() / ROUNDTRIPS;
+  const double msgsPerSecond = MESSAGES / std::chrono::duration<double>(throughput).count();
+  RecordProperty("ns_per_round_trip", static_cast<int>(usPerRoundTrip * 1000));
+  RecordProperty("msgs_per_second", static_cast<int>(msgsPerSecond));
+}
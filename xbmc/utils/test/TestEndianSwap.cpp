@@ -8,6 +8,8 @@
 
 #include "utils/EndianSwap.h"
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(TestEndianSwap, Endian_Swap16)
@@ -34,6 +36,34 @@ TEST(TestEndianSwap, Endian_Swap64)
   EXPECT_EQ(ref, var);
 }
 
+TEST(TestEndianSwap, Endian_Swap16_buf)
+{
+  // covers the vector loop, the unrolled loop and the tail, unaligned and in place
+  std::vector<uint8_t> src(2 * 100 + 1);
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = static_cast<uint8_t>(i * 7 + 1);
+
+  for (int offset = 0; offset < 2; ++offset)
+  {
+    for (int words = 0; words <= 99; ++words)
+    {
+      const uint16_t* in = reinterpret_cast<const uint16_t*>(src.data() + offset);
+      std::vector<uint8_t> dst(src.size(), 0);
+      uint16_t* out = reinterpret_cast<uint16_t*>(dst.data() + offset);
+      Endian_Swap16_buf(out, in, words);
+      for (int i = 0; i < 2 * words; ++i)
+        ASSERT_EQ(src[offset + (i ^ 1)], dst[offset + i]) << "words " << words << " byte " << i;
+      ASSERT_EQ(0, dst[offset + 2 * words]);
+
+      std::vector<uint8_t> inplace(src);
+      uint16_t* buf = reinterpret_cast<uint16_t*>(inplace.data() + offset);
+      Endian_Swap16_buf(buf, buf, words);
+      for (int i = 0; i < 2 * words; ++i)
+        ASSERT_EQ(dst[offset + i], inplace[offset + i]);
+    }
+  }
+}
+
 #ifndef WORDS_BIGENDIAN
 TEST(TestEndianSwap, Endian_SwapLE16)
 {
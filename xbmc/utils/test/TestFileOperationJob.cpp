@@ -8,6 +8,7 @@
 
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "test/TestUtils.h"
 #include "utils/FileOperationJob.h"
 #include "utils/URIUtils.h"
@@ -48,6 +49,43 @@ TEST(TestFileOperationJob, ActionCopy)
   EXPECT_TRUE(XFILE::CDirectory::Remove(destpath));
 }
 
+TEST(TestFileOperationJob, ActionCopyFolder)
+{
+  const std::string root = URIUtils::AddFileToFolder(
+      CSpecialProtocol::TranslatePath("special://temp/"), "TestFileOperationJob/");
+  const std::string source = URIUtils::AddFileToFolder(root, "source/");
+  const std::string destpath = URIUtils::AddFileToFolder(root, "dest/");
+  ASSERT_TRUE(XFILE::CDirectory::Create(source));
+
+  // the files are copied at a time
+  const int FILES = 8;
+  for (int i = 0; i < FILES; i++)
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(URIUtils::AddFileToFolder(source, std::to_string(i)), true));
+    const std::string content(100000 * (i + 1), static_cast<char>('a' + i));
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), file.Write(content.data(), content.size()));
+  }
+
+  CFileItemList items;
+  CFileItemPtr item(new CFileItem(source, true));
+  item->Select(true);
+  items.Add(item);
+
+  CFileOperationJob job(CFileOperationJob::ActionCopy, items, destpath);
+  EXPECT_TRUE(job.DoWork());
+
+  for (int i = 0; i < FILES; i++)
+  {
+    const std::string copy = URIUtils::AddFileToFolder(destpath, "source", std::to_string(i));
+    struct __stat64 buffer;
+    ASSERT_EQ(0, XFILE::CFile::Stat(copy, &buffer));
+    EXPECT_EQ(100000 * (i + 1), buffer.st_size);
+  }
+
+  XFILE::CDirectory::RemoveRecursive(root);
+}
+
 TEST(TestFileOperationJob, ActionMove)
 {
   XFILE::CFile *tmpfile;
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/Random.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(TestRandom, RandomSample)
+{
+  std::vector<int> values(1000);
+  std::iota(values.begin(), values.end(), 0);
+
+  auto end = KODI::UTILS::RandomSample(values.begin(), values.end(), 10);
+  EXPECT_EQ(values.begin() + 10, end);
+
+  // the picked values are distinct and the range keeps all values
+  std::vector<int> picked(values.begin(), end);
+  std::sort(picked.begin(), picked.end());
+  EXPECT_EQ(picked.end(), std::adjacent_find(picked.begin(), picked.end()));
+  std::vector<int> all = values;
+  std::sort(all.begin(), all.end());
+  for (int i = 0; i < 1000; i++)
+    ASSERT_EQ(i, all[i]);
+
+  // asking for more values than there are shuffles all of them
+  end = KODI::UTILS::RandomSample(values.begin(), values.end(), 5000);
+  EXPECT_EQ(values.end(), end);
+  EXPECT_EQ(values.begin(), KODI::UTILS::RandomSample(values.begin(), values.end(), 0));
+
+  // every value can be picked
+  std::vector<int> small = {1, 2, 3};
+  std::vector<int> seen(4, 0);
+  for (int i = 0; i < 300; i++)
+  {
+    KODI::UTILS::RandomSample(small.begin(), small.end(), 1);
+    seen[small[0]]++;
+  }
+  EXPECT_GT(seen[1], 0);
+  EXPECT_GT(seen[2], 0);
+  EXPECT_GT(seen[3], 0);
+}
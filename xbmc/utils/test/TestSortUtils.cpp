@@ -6,11 +6,80 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "utils/CharsetConverter.h"
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+namespace
+{
+struct Labelled
+{
+  std::wstring label;
+  bool folder;
+  SortSpecial special;
+  size_t index;
+};
+
+SortItems GetLabelledItems(size_t count, std::vector<Labelled>& labelled)
+{
+  static const char* const WORDS[] = {"the", "Abba", "abba", "Zoë", "Éclair", "eclair", "ß",
+                                      "a-ha", "a.ha", "(a)", "track", "Track", "_x", "Ω", ""};
+  std::mt19937 random(42);
+  SortItems items;
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::string label = WORDS[random() % (sizeof(WORDS) / sizeof(WORDS[0]))];
+    if (random() % 2)
+      label += " " + std::string(random() % 3, '0') + std::to_string(random() % 120);
+    if (random() % 3 == 0)
+      label += WORDS[random() % (sizeof(WORDS) / sizeof(WORDS[0]))];
+    const bool folder = random() % 4 == 0;
+    const SortSpecial special = random() % 20 == 0   ? SortSpecialOnTop
+                                : random() % 20 == 0 ? SortSpecialOnBottom
+                                                     : SortSpecialNone;
+
+    SortItemPtr item(new SortItem());
+    (*item)[FieldLabel] = label;
+    (*item)[FieldFolder] = folder;
+    (*item)[FieldSortSpecial] = special;
+    (*item)[FieldSize] = static_cast<uint64_t>(i);
+    items.push_back(item);
+
+    std::wstring wideLabel;
+    g_charsetConverter.utf8ToW(label, wideLabel, false);
+    labelled.push_back({wideLabel, folder, special, i});
+  }
+  return items;
+}
+
+//! Sort the items the way the sorters compare them, to check the order of the sort keys
+void SortLabelled(std::vector<Labelled>& labelled, SortOrder sortOrder, bool handleFolder)
+{
+  std::stable_sort(labelled.begin(), labelled.end(),
+                   [sortOrder, handleFolder](const Labelled& left, const Labelled& right) {
+                     if (left.special != right.special)
+                       return left.special == SortSpecialOnTop ||
+                              right.special == SortSpecialOnBottom;
+                     if (left.special != SortSpecialNone)
+                       return false;
+                     if (handleFolder && left.folder != right.folder)
+                       return left.folder;
+                     const int64_t result =
+                         StringUtils::AlphaNumericCompare(left.label.c_str(), right.label.c_str());
+                     return sortOrder == SortOrderDescending ? result > 0 : result < 0;
+                   });
+}
+} // namespace
+
 TEST(TestSortUtils, Sort_SortBy)
 {
   SortItems items;
@@ -121,3 +190,48 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)5, fields.size());
 }
+
+TEST(TestSortUtils, Sort_SameOrderAsSorters)
+{
+  for (const SortOrder sortOrder : {SortOrderAscending, SortOrderDescending})
+  {
+    for (const SortAttribute attributes : {SortAttributeNone, SortAttributeIgnoreFolders})
+    {
+      std::vector<Labelled> labelled;
+      SortItems items = GetLabelledItems(2000, labelled);
+      SortUtils::Sort(SortByLabel, sortOrder, attributes, items);
+      SortLabelled(labelled, sortOrder, !(attributes & SortAttributeIgnoreFolders));
+
+      ASSERT_EQ(labelled.size(), items.size());
+      for (size_t i = 0; i < items.size(); ++i)
+        ASSERT_EQ(labelled[i].index, (*items[i])[FieldSize].asUnsignedInteger())
+            << "at " << i << " sorting " << sortOrder << " with " << attributes;
+    }
+  }
+}
+
+// the time to sort items by their keys and by comparing them, run with
+// --gtest_also_run_disabled_tests
+TEST(TestSortUtils, DISABLED_Sort_Benchmark)
+{
+  for (const size_t count : {10000, 100000})
+  {
+    std::vector<Labelled> labelled;
+    SortItems items = GetLabelledItems(count, labelled);
+
+    auto start = std::chrono::steady_clock::now();
+    SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+    const auto keys = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    SortLabelled(labelled, SortOrderAscending, true);
+    const auto compare = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(count, items.size());
+
+    const std::string suffix = std::to_string(count) + "_items";
+    RecordProperty("keys_ms_" + suffix, static_cast<int>(keys.count()));
+    RecordProperty("compare_ms_" + suffix, static_cast<int>(compare.count()));
+  }
+}
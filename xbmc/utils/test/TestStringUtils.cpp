@@ -9,6 +9,8 @@
 #include "utils/StringUtils.h"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 enum class ECG
@@ -356,6 +358,38 @@ TEST(TestStringUtils, AlphaNumericCompare)
   EXPECT_LT(var, ref);
 }
 
+TEST(TestStringUtils, AlphaNumericSortKey)
+{
+  const std::vector<std::string> words = {"",          "!bang",     "(500) Days", "10 Things",
+                                          "12 Monkeys", "101 Dalmatians", "Alien", "alien 3",
+                                          "Alien 20",  "Aliens",    "\xc3\x89t\xc3\xa9", "Matrix",
+                                          "matrix 2",  "Matrix 10", "Matrix: 3",  "Matrix-A",
+                                          "se7en",     "seven",     "Zoo",        "zoo [2]",
+                                          "zoo {2}",   "~tilde"};
+  const auto sign = [](int value) { return (value > 0) - (value < 0); };
+
+  // both agree on the order of every pair, equal ones included
+  for (const auto& left : words)
+  {
+    for (const auto& right : words)
+    {
+      const int collation = StringUtils::AlphaNumericCollation(
+          static_cast<int>(left.size()), left.data(), static_cast<int>(right.size()),
+          right.data());
+      const int key = StringUtils::AlphaNumericSortKey(left).compare(
+          StringUtils::AlphaNumericSortKey(right));
+      EXPECT_EQ(sign(collation), sign(key)) << "'" << left << "' vs '" << right << "'";
+    }
+  }
+
+  // numbers are prefixed with their length, symbols sort below digits and letters
+  EXPECT_EQ("alien\x0e" "11", StringUtils::AlphaNumericSortKey("Alien 1"));
+  EXPECT_EQ("ete", StringUtils::AlphaNumericSortKey("\xc3\x89t\xc3\xa9"));
+  // leading zeros only change the order of otherwise equal strings
+  EXPECT_EQ(StringUtils::AlphaNumericSortKey("7"), StringUtils::AlphaNumericSortKey("007"));
+  EXPECT_LT(StringUtils::AlphaNumericSortKey("007"), StringUtils::AlphaNumericSortKey("10"));
+}
+
 TEST(TestStringUtils, TimeStringToSeconds)
 {
   EXPECT_EQ(77455, StringUtils::TimeStringToSeconds("21:30:55"));
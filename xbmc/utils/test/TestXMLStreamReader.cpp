@@ -0,0 +1,287 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLStreamReader.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Node = CXMLStreamReader::Node;
+
+namespace
+{
+// the nodes read from a document, one per line
+std::string Read(const std::string& document)
+{
+  CXMLStreamReader reader(document);
+  std::string nodes;
+  while (true)
+  {
+    switch (reader.Next())
+    {
+      case Node::START_ELEMENT:
+        nodes += std::string(reader.Depth(), ' ') + "<" + std::string(reader.Name());
+        for (const auto& [name, value] : reader.GetAttributes())
+          nodes += " " + name + "=[" + value + "]";
+        nodes += ">\n";
+        break;
+      case Node::END_ELEMENT:
+        nodes += std::string(reader.Depth() + 1, ' ') + "</" + std::string(reader.Name()) + ">\n";
+        break;
+      case Node::CHARACTERS:
+        nodes += "text[" + reader.Value() + "]\n";
+        break;
+      case Node::CDATA:
+        nodes += "cdata[" + reader.Value() + "]\n";
+        break;
+      case Node::COMMENT:
+        nodes += "comment[" + reader.Value() + "]\n";
+        break;
+      case Node::END_DOCUMENT:
+        return nodes;
+      case Node::UNSUPPORTED:
+        return nodes + "unsupported\n";
+    }
+  }
+}
+
+bool IsSupported(const std::string& document)
+{
+  const std::string nodes = Read(document);
+  return nodes.find("unsupported") == std::string::npos;
+}
+
+// compare the nodes read with those of the document parsed by CXBMCTinyXML
+void ExpectSameNodes(const TiXmlNode* parent, CXMLStreamReader& reader)
+{
+  for (const TiXmlNode* node = parent->FirstChild(); node; node = node->NextSibling())
+  {
+    if (node->ToDeclaration())
+      continue;
+
+    const Node read = reader.Next();
+    if (const TiXmlElement* element = node->ToElement())
+    {
+      ASSERT_EQ(Node::START_ELEMENT, read);
+      EXPECT_EQ(element->ValueStr(), reader.Name());
+      CXMLStreamReader::Attributes attributes;
+      for (const TiXmlAttribute* attribute = element->FirstAttribute(); attribute;
+           attribute = attribute->Next())
+        attributes.emplace_back(attribute->Name(), attribute->ValueStr());
+      EXPECT_EQ(attributes, reader.GetAttributes());
+      ExpectSameNodes(element, reader);
+      ASSERT_EQ(Node::END_ELEMENT, reader.Next());
+      EXPECT_EQ(element->ValueStr(), reader.Name());
+      // only the root element is read
+      if (parent->ToDocument())
+        return;
+    }
+    else if (const TiXmlText* text = node->ToText())
+    {
+      ASSERT_EQ(text->CDATA() ? Node::CDATA : Node::CHARACTERS, read);
+      EXPECT_EQ(text->ValueStr(), reader.Value());
+    }
+    else
+    {
+      ASSERT_NE(nullptr, node->ToComment());
+      ASSERT_EQ(Node::COMMENT, read);
+      EXPECT_EQ(node->ValueStr(), reader.Value());
+    }
+  }
+}
+
+class CondenseWhiteSpace
+{
+public:
+  explicit CondenseWhiteSpace(bool condense) : m_condense(TiXmlBase::IsWhiteSpaceCondensed())
+  {
+    TiXmlBase::SetCondenseWhiteSpace(condense);
+  }
+  ~CondenseWhiteSpace() { TiXmlBase::SetCondenseWhiteSpace(m_condense); }
+
+private:
+  bool m_condense;
+};
+
+const std::vector<std::string> documents = {
+    "<movie><title>Title</title></movie>",
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+    "<!-- created by a media manager -->\n"
+    "<movie>\n"
+    "  <title>  The   Title\n of it </title>\n"
+    "  <plot>Line one.\r\n\r\nLine two &amp; three, &lt;four&gt; &quot;five&quot; "
+    "&apos;six&apos;</plot>\n"
+    "  <outline>A &B; &#x41;&#66;&#x3f;&#x003F;&#0063; &#x12345; &#123456; &foo &#; & end</outline>\n"
+    "  <thumb aspect=\"poster\" preview='https://example.com/a?b=1&amp;c=2&d=3'>"
+    "https://example.com/poster.jpg</thumb>\n"
+    "  <empty/>\n"
+    "  <empty2 a = \"1\"b=\"2\" ></empty2 >\n"
+    "  <mixed>before <b>bold</b> after<!-- note & &amp; --><![CDATA[ <raw> &amp; & ]]></mixed>\n"
+    "  <space>   </space>\n"
+    "  <entityspace>&#32;</entityspace>\n"
+    "  <unicode>Ünïcødé – 日本語 😀</unicode>\n"
+    "  <actor><name>Actor</name><role>Role</role><thumb>https://example.com/a.jpg</thumb></actor>\n"
+    "</movie>\n"
+    "https://www.themoviedb.org/movie/1\n",
+    "\xEF\xBB\xBF<episodedetails><title>1</title></episodedetails>\n"
+    "<episodedetails><title>2</title></episodedetails>\n"
+    "<!-- end -->",
+    "<?xml-stylesheet href=\"a.xsl\"?><details>\t<a:b c.d=\"e\"/>\n<_x-y.z>1</_x-y.z></details>",
+};
+} // namespace
+
+TEST(TestXMLStreamReader, Nodes)
+{
+  CondenseWhiteSpace condense(true);
+  EXPECT_EQ("comment[ comment ]\n"
+            " <movie a=[1] b=[2]>\n"
+            "  <title>\n"
+            "text[Title]\n"
+            "  </title>\n"
+            "  <empty>\n"
+            "  </empty>\n"
+            "  <set>\n"
+            "   <name>\n"
+            "text[Set]\n"
+            "   </name>\n"
+            "  </set>\n"
+            " </movie>\n",
+            Read("<!-- comment -->\n"
+                 "<movie a=\"1\" b='2'>\n"
+                 "  <title>Title</title>\n"
+                 "  <empty/>\n"
+                 "  <set><name>Set</name></set>\n"
+                 "</movie>"));
+}
+
+TEST(TestXMLStreamReader, Entities)
+{
+  CondenseWhiteSpace condense(true);
+  EXPECT_EQ(" <a v=[<&>]>\n"
+            "text[&<>\"' AB?? &foo; & &#x12345; &#123456; &#;]\n"
+            " </a>\n",
+            Read("<a v=\"&lt;&amp;&gt;\">&amp;&lt;&gt;&quot;&apos; &#x41;&#66;&#x3f;&#0063; "
+                 "&foo; & &#x12345; &#123456; &#;</a>"));
+
+  // comments and CDATA sections keep their entities, but not an invalid '&'
+  EXPECT_EQ(" <a>\n"
+            "comment[ &amp; &amp; &#65; ]\n"
+            "cdata[ &lt; &amp; ]\n"
+            " </a>\n",
+            Read("<a><!-- &amp; & &#65; --><![CDATA[ &lt; & ]]></a>"));
+}
+
+TEST(TestXMLStreamReader, WhiteSpace)
+{
+  const std::string document = "<a>\n  <b>  one \r\n two  </b>  three  <c/>\n \n</a>";
+  {
+    CondenseWhiteSpace condense(true);
+    EXPECT_EQ(" <a>\n"
+              "  <b>\n"
+              "text[one two]\n"
+              "  </b>\n"
+              "text[three]\n"
+              "  <c>\n"
+              "  </c>\n"
+              " </a>\n",
+              Read(document));
+  }
+  {
+    CondenseWhiteSpace condense(false);
+    EXPECT_EQ(" <a>\n"
+              "  <b>\n"
+              "text[  one \r\n two  ]\n"
+              "  </b>\n"
+              "text[  three  ]\n"
+              "  <c>\n"
+              "  </c>\n"
+              " </a>\n",
+              Read(document));
+  }
+}
+
+TEST(TestXMLStreamReader, Epilog)
+{
+  // the elements after the root element are checked but not read
+  EXPECT_EQ(" <a>\n </a>\n", Read("<a/><b><c>text</c></b><!-- comment -->"));
+  EXPECT_EQ(" <a>\n </a>\nunsupported\n", Read("<a/><b><c>text</b>"));
+
+  // TinyXML stops at text after the root element
+  EXPECT_EQ(" <a>\n </a>\n", Read("<a/>\nhttps://example.com/<b>"));
+}
+
+TEST(TestXMLStreamReader, Unsupported)
+{
+  EXPECT_TRUE(IsSupported("<?xml version=\"1.0\"?><a/>"));
+  EXPECT_TRUE(IsSupported("\xEF\xBB\xBF<a>\xC3\xA9</a>"));
+
+  EXPECT_FALSE(IsSupported(""));
+  EXPECT_FALSE(IsSupported("https://example.com/"));
+  EXPECT_FALSE(IsSupported("<!DOCTYPE a><a/>"));
+  EXPECT_FALSE(IsSupported("<a><?pi?></a>"));
+  EXPECT_FALSE(IsSupported("<a b=c/>"));
+  EXPECT_FALSE(IsSupported("<a b=\"1\" b=\"2\"/>"));
+  EXPECT_FALSE(IsSupported("<a><b></a>"));
+  EXPECT_FALSE(IsSupported("<a>"));
+  EXPECT_FALSE(IsSupported("<a><!-- comment </a>"));
+  EXPECT_FALSE(IsSupported("<a><![CDATA[ text </a>"));
+  EXPECT_FALSE(IsSupported("<a>&#0;</a>"));
+  EXPECT_FALSE(IsSupported("<\xC3\xA9/>"));
+  EXPECT_FALSE(IsSupported("<a>\xE9</a>"));
+  EXPECT_FALSE(IsSupported("<a>\xEF\xBB\xBF</a>"));
+  EXPECT_FALSE(IsSupported(std::string("<a>\0</a>", 8)));
+}
+
+TEST(TestXMLStreamReader, SkipElement)
+{
+  CXMLStreamReader reader("<a><b><c>text</c><d/></b><e>text</e></a>");
+  ASSERT_EQ(Node::START_ELEMENT, reader.Next());
+  ASSERT_EQ(Node::START_ELEMENT, reader.Next());
+  EXPECT_TRUE(reader.SkipElement());
+  ASSERT_EQ(Node::START_ELEMENT, reader.Next());
+  EXPECT_EQ("e", reader.Name());
+  ASSERT_EQ(Node::CHARACTERS, reader.Next());
+  EXPECT_TRUE(reader.SkipElement());
+  EXPECT_EQ("e", reader.Name());
+  ASSERT_EQ(Node::END_ELEMENT, reader.Next());
+  EXPECT_EQ("a", reader.Name());
+  EXPECT_EQ(Node::END_DOCUMENT, reader.Next());
+}
+
+TEST(TestXMLStreamReader, ReadElement)
+{
+  CXMLStreamReader reader("<a><thumb aspect=\"poster\">url<!--c--><b/><![CDATA[x]]></thumb></a>");
+  ASSERT_EQ(Node::START_ELEMENT, reader.Next());
+  ASSERT_EQ(Node::START_ELEMENT, reader.Next());
+  const auto thumb = reader.ReadElement();
+  ASSERT_NE(nullptr, thumb);
+  std::string xml;
+  xml << *thumb;
+  EXPECT_EQ("<thumb aspect=\"poster\">url<!--c--><b /><![CDATA[x]]></thumb>", xml);
+  ASSERT_EQ(Node::END_ELEMENT, reader.Next());
+  EXPECT_EQ(Node::END_DOCUMENT, reader.Next());
+}
+
+TEST(TestXMLStreamReader, SameAsTinyXML)
+{
+  for (const bool condense : {true, false})
+  {
+    CondenseWhiteSpace condenseWhiteSpace(condense);
+    for (const auto& document : documents)
+    {
+      CXBMCTinyXML doc;
+      ASSERT_TRUE(doc.Parse(document, TIXML_ENCODING_UTF8)) << document;
+      CXMLStreamReader reader(document);
+      ExpectSameNodes(&doc, reader);
+      EXPECT_EQ(Node::END_DOCUMENT, reader.Next()) << document;
+    }
+  }
+}
@@ -8,6 +8,10 @@
 
 #include "utils/rfft.h"
 
+#include <algorithm>
+#include <chrono>
+#include <random>
+
 #include <gtest/gtest.h>
 
 #if defined(TARGET_WINDOWS) && !defined(_USE_MATH_DEFINES)
@@ -39,3 +43,146 @@ TEST(TestRFFT, SimpleSignal)
     EXPECT_NEAR(output[2*i+1], ((i==freq2[0]||i==freq2[1])?1.0:0.0), 1e-7);
   }
 }
+
+namespace
+{
+// reference DFT in double precision
+void ReferenceDFT(const std::vector<float>& input, std::vector<double>& re, std::vector<double>& im)
+{
+  const size_t size = input.size();
+  re.assign(size / 2 + 1, 0.0);
+  im.assign(size / 2 + 1, 0.0);
+  for (size_t k = 0; k <= size / 2; ++k)
+  {
+    for (size_t n = 0; n < size; ++n)
+    {
+      const double theta = -2.0 * M_PI * static_cast<double>((k * n) % size) / size;
+      re[k] += input[n] * cos(theta);
+      im[k] += input[n] * sin(theta);
+    }
+  }
+}
+} // namespace
+
+TEST(TestRFFT, ForwardInverse)
+{
+  std::mt19937 rng(17);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+  // power of two sizes with even and odd numbers of radix-4 stages, and kissfft sizes
+  for (int size : {4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 12, 100})
+  {
+    std::vector<float> input(size);
+    for (auto& sample : input)
+      sample = dist(rng);
+
+    std::vector<double> refRe, refIm;
+    ReferenceDFT(input, refRe, refIm);
+
+    RFFT transform(size);
+    std::vector<float> re(size / 2 + 1), im(size / 2 + 1);
+    transform.forward(input.data(), re.data(), im.data());
+
+    const double tolerance = 1e-6 * size;
+    for (int k = 0; k <= size / 2; ++k)
+    {
+      EXPECT_NEAR(refRe[k], re[k], tolerance) << "size " << size << " bin " << k;
+      EXPECT_NEAR(refIm[k], im[k], tolerance) << "size " << size << " bin " << k;
+    }
+
+    std::vector<float> output(size);
+    transform.inverse(re.data(), im.data(), output.data());
+    for (int n = 0; n < size; ++n)
+      EXPECT_NEAR(input[n], output[n] / size, 1e-5) << "size " << size << " sample " << n;
+  }
+}
+
+TEST(TestRFFT, MultiChannel)
+{
+  const int size = 256;
+  const int channels = 6;
+  std::vector<float> input(size * channels);
+  for (int i = 0; i < size; ++i)
+  {
+    for (int c = 0; c < channels; ++c)
+      input[i * channels + c] = static_cast<float>(0.5 * cos((c + 3) * 2.0 * M_PI * i / size));
+  }
+
+  RFFT transform(size, true);
+  std::vector<float> output(size / 2 * channels);
+  transform.calc(input.data(), channels, output.data());
+
+  std::vector<float> decibel(size / 2 * channels);
+  transform.calc(input.data(), channels, decibel.data(), true);
+
+  for (int c = 0; c < channels; ++c)
+  {
+    for (int i = 0; i < size / 2; ++i)
+    {
+      const float value = output[i * channels + c];
+      // the Hann window spreads a tone over three bins, halving it in the centre
+      if (i == c + 3)
+      {
+        EXPECT_NEAR(0.5 * sqrt(8.0 / 3.0) / 2.0, value, 5e-3);
+      }
+      else if (abs(i - (c + 3)) > 1)
+      {
+        EXPECT_NEAR(0.0, value, 1e-3);
+      }
+      EXPECT_NEAR(20.0 * log10(std::max(value, 1e-6f)), decibel[i * channels + c], 1e-3);
+    }
+  }
+
+  // the stereo call is the two channel case
+  std::vector<float> stereo(size * 2);
+  for (int i = 0; i < size; ++i)
+  {
+    stereo[2 * i] = input[i * channels];
+    stereo[2 * i + 1] = input[i * channels + 1];
+  }
+  std::vector<float> stereoOutput(size);
+  transform.calc(stereo.data(), stereoOutput.data());
+  for (int i = 0; i < size / 2; ++i)
+  {
+    EXPECT_FLOAT_EQ(output[i * channels], stereoOutput[2 * i]);
+    EXPECT_FLOAT_EQ(output[i * channels + 1], stereoOutput[2 * i + 1]);
+  }
+}
+
+// the time of a forward transform against kissfft, run with --gtest_also_run_disabled_tests
+TEST(TestRFFT, DISABLED_Benchmark)
+{
+  const int size = 1024;
+  const int rounds = 20000;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> input(size);
+  for (auto& sample : input)
+    sample = dist(rng);
+
+  RFFT transform(size);
+  std::vector<float> re(size / 2 + 1), im(size / 2 + 1);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i)
+    transform.forward(input.data(), re.data(), im.data());
+  const double rfftSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  kiss_fftr_cfg cfg = kiss_fftr_alloc(size, 0, nullptr, nullptr);
+  std::vector<kiss_fft_cpx> spectrum(size / 2 + 1);
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i)
+    kiss_fftr(cfg, input.data(), spectrum.data());
+  const double kissSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  KISS_FFT_FREE(cfg);
+
+  for (int k = 0; k <= size / 2; ++k)
+  {
+    EXPECT_NEAR(spectrum[k].r, re[k], 1e-3);
+    EXPECT_NEAR(spectrum[k].i, im[k], 1e-3);
+  }
+
+  RecordProperty("forward_ns", static_cast<int>(rfftSeconds * 1e9 / rounds));
+  RecordProperty("kissfft_ns", static_cast<int>(kissSeconds * 1e9 / rounds));
+}
@@ -24,6 +24,7 @@
 #include "dialogs/GUIDialogProgress.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryChecker.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/PluginDirectory.h"
@@ -46,6 +47,7 @@
 #include "utils/FileUtils.h"
 #include "utils/GroupUtils.h"
 #include "utils/LabelFormatter.h"
+#include "utils/Random.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
@@ -58,6 +60,7 @@
 #include "video/VideoThumbLoader.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -208,6 +211,75 @@ void CVideoDatabase::CreateTables()
   CLog::Log(LOGINFO, "create videoversion table");
   m_pDS->exec("CREATE TABLE videoversion (idFile INTEGER PRIMARY KEY, idMedia INTEGER, media_type "
               "TEXT, itemType INTEGER, idType INTEGER)");
+
+  CLog::Log(LOGINFO, "create sortkey table");
+  CreateSortKeyTable();
+
+  CLog::Log(LOGINFO, "create searchindex table");
+  CreateSearchIndexTable();
+
+  CLog::Log(LOGINFO, "create pathcheck table");
+  CreatePathCheckTable();
+
+  CLog::Log(LOGINFO, "create tvshowcounts and seasoncounts tables");
+  CreateTvShowCountsTables();
+}
+
+void CVideoDatabase::CreateTvShowCountsTables()
+{
+  m_pDS->exec("CREATE TABLE tvshowcounts (idShow INTEGER PRIMARY KEY, lastPlayed TEXT, "
+              "totalCount INTEGER, watchedcount INTEGER, totalSeasons INTEGER, dateAdded TEXT, "
+              "inProgressCount INTEGER)");
+  m_pDS->exec("CREATE TABLE seasoncounts (idSeason INTEGER PRIMARY KEY, idShow INTEGER, "
+              "episodes INTEGER, playCount INTEGER, aired TEXT, inProgressCount INTEGER)");
+}
+
+std::vector<std::string> CVideoDatabase::GetTvShowCountsSQL(const std::string& idShows) const
+{
+  // clang-format off
+  return {
+      "DELETE FROM seasoncounts WHERE idShow IN (" + idShows + ")",
+      PrepareSQL("INSERT INTO seasoncounts "
+                 "  (idSeason, idShow, episodes, playCount, aired, inProgressCount) "
+                 "SELECT"
+                 "  seasons.idSeason,"
+                 "  seasons.idShow,"
+                 "  COUNT(DISTINCT episode.idEpisode),"
+                 "  COUNT(files.playCount),"
+                 "  MIN(episode.c%02d),"
+                 "  COUNT(bookmark.type) "
+                 "FROM seasons"
+                 "  JOIN episode ON"
+                 "    episode.idShow = seasons.idShow AND episode.c%02d = seasons.season"
+                 "  JOIN files ON"
+                 "    files.idFile = episode.idFile"
+                 "  LEFT JOIN bookmark ON"
+                 "    bookmark.idFile = files.idFile AND bookmark.type = 1 "
+                 "WHERE seasons.idShow IN (",
+                 VIDEODB_ID_EPISODE_AIRED, VIDEODB_ID_EPISODE_SEASON) +
+          idShows + ") GROUP BY seasons.idSeason, seasons.idShow",
+      PrepareSQL("REPLACE INTO tvshowcounts "
+                 "  (idShow, lastPlayed, totalCount, watchedcount, totalSeasons, dateAdded,"
+                 "   inProgressCount) "
+                 "SELECT"
+                 "  tvshow.idShow,"
+                 "  MAX(files.lastPlayed),"
+                 "  NULLIF(COUNT(episode.c%02d), 0),"
+                 "  COUNT(files.playCount),"
+                 "  NULLIF(COUNT(DISTINCT(episode.c%02d)), 0),"
+                 "  MAX(files.dateAdded),"
+                 "  COUNT(bookmark.type) "
+                 "FROM tvshow"
+                 "  LEFT JOIN episode ON"
+                 "    episode.idShow = tvshow.idShow"
+                 "  LEFT JOIN files ON"
+                 "    files.idFile = episode.idFile"
+                 "  LEFT JOIN bookmark ON"
+                 "    bookmark.idFile = files.idFile AND bookmark.type = 1 "
+                 "WHERE tvshow.idShow IN (",
+                 VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_EPISODE_SEASON) +
+          idShows + ") GROUP BY tvshow.idShow"};
+  // clang-format on
 }
 
 void CVideoDatabase::CreateLinkIndex(const char *table)
@@ -275,6 +347,7 @@ void CVideoDatabase::CreateAnalytics()
 
   m_pDS->exec("CREATE INDEX ix_streamdetails ON streamdetails (idFile)");
   m_pDS->exec("CREATE INDEX ix_seasons ON seasons (idShow, season)");
+  m_pDS->exec("CREATE INDEX ix_seasoncounts ON seasoncounts (idShow)");
   m_pDS->exec("CREATE INDEX ix_art ON art(media_id, media_type(20), type(20))");
 
   m_pDS->exec("CREATE INDEX ix_rating ON rating(media_id, media_type(20))");
@@ -290,6 +363,8 @@ void CVideoDatabase::CreateAnalytics()
   m_pDS->exec("CREATE INDEX ix_actor_link_3 ON actor_link (media_type(20))");
 
   m_pDS->exec("CREATE INDEX ix_videoversion ON videoversion (idMedia, media_type(20))");
+  m_pDS->exec("CREATE UNIQUE INDEX ix_sortkey ON sortkey (media_id, media_type(20))");
+  CreateSearchIndexAnalytics();
 
   m_pDS->exec(PrepareSQL("CREATE INDEX ix_movie_title ON movie (c%02d(255))", VIDEODB_ID_TITLE));
 
@@ -301,6 +376,8 @@ void CVideoDatabase::CreateAnalytics()
   CreateLinkIndex("country");
 
   CLog::Log(LOGINFO, "{} - creating triggers", __FUNCTION__);
+  const auto tvShowCounts = [this](const std::string& idShows)
+  { return StringUtils::Join(GetTvShowCountsSQL(idShows), "; ") + "; "; };
   m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN "
               "DELETE FROM genre_link WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM actor_link WHERE media_id=old.idMovie AND media_type='movie'; "
@@ -315,7 +392,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM uniqueid WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM videoversion "
               "WHERE idFile=old.idFile AND idMedia=old.idMovie AND media_type='movie'; "
-              "END");
+              "DELETE FROM sortkey WHERE media_id=old.idMovie AND media_type='movie'; " +
+              GetSearchIndexDeleteSQL("old.idMovie", MediaTypeMovie) + "END");
   m_pDS->exec("CREATE TRIGGER delete_tvshow AFTER DELETE ON tvshow FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM director_link WHERE media_id=old.idShow AND media_type='tvshow'; "
@@ -328,7 +406,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM tag_link WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM rating WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM uniqueid WHERE media_id=old.idShow AND media_type='tvshow'; "
-              "END");
+              "DELETE FROM tvshowcounts WHERE idShow=old.idShow; " +
+              GetSearchIndexDeleteSQL("old.idShow", MediaTypeTvShow) + "END");
   m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM director_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
@@ -336,8 +415,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM studio_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM art WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM tag_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
-              "DELETE FROM uniqueid WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
-              "END");
+              "DELETE FROM uniqueid WHERE media_id=old.idMVideo AND media_type='musicvideo'; " +
+              GetSearchIndexDeleteSQL("old.idMVideo", MediaTypeMusicVideo) + "END");
   m_pDS->exec("CREATE TRIGGER delete_episode AFTER DELETE ON episode FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM director_link WHERE media_id=old.idEpisode AND media_type='episode'; "
@@ -345,9 +424,12 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM art WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM rating WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM uniqueid WHERE media_id=old.idEpisode AND media_type='episode'; "
-              "END");
+              "DELETE FROM sortkey WHERE media_id=old.idEpisode AND media_type='episode'; " +
+              GetSearchIndexDeleteSQL("old.idEpisode", MediaTypeEpisode) +
+              tvShowCounts("old.idShow") + "END");
   m_pDS->exec("CREATE TRIGGER delete_season AFTER DELETE ON seasons FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.idSeason AND media_type='season'; "
+              "DELETE FROM seasoncounts WHERE idSeason=old.idSeason; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_set AFTER DELETE ON sets FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.idSet AND media_type='set'; "
@@ -364,8 +446,37 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM stacktimes WHERE idFile=old.idFile; "
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "DELETE FROM videoversion WHERE idFile=old.idFile; "
-              "DELETE FROM art WHERE media_id=old.idFile AND media_type='videoversion'; "
+              "DELETE FROM art WHERE media_id=old.idFile AND media_type='videoversion'; " +
+              tvShowCounts("SELECT idShow FROM episode WHERE idFile=old.idFile") + "END");
+
+  // Keep the episode counts of the shows and seasons up to date, a show is recounted whenever
+  // one of its seasons, episodes, their files or resume points change
+  m_pDS->exec("CREATE TRIGGER insert_tvshow AFTER INSERT ON tvshow FOR EACH ROW BEGIN " +
+              tvShowCounts("new.idShow") + "END");
+  m_pDS->exec("CREATE TRIGGER insert_season AFTER INSERT ON seasons FOR EACH ROW BEGIN " +
+              tvShowCounts("new.idShow") + "END");
+  m_pDS->exec("CREATE TRIGGER update_season AFTER UPDATE ON seasons FOR EACH ROW BEGIN " +
+              tvShowCounts("old.idShow, new.idShow") + "END");
+  m_pDS->exec("CREATE TRIGGER insert_episode AFTER INSERT ON episode FOR EACH ROW BEGIN " +
+              tvShowCounts("new.idShow") + "END");
+  m_pDS->exec("CREATE TRIGGER update_episode AFTER UPDATE ON episode FOR EACH ROW BEGIN " +
+              tvShowCounts("old.idShow, new.idShow") + "END");
+  m_pDS->exec("CREATE TRIGGER update_file AFTER UPDATE ON files FOR EACH ROW BEGIN " +
+              tvShowCounts("SELECT idShow FROM episode WHERE idFile=new.idFile") + "END");
+  m_pDS->exec("CREATE TRIGGER insert_bookmark AFTER INSERT ON bookmark FOR EACH ROW BEGIN " +
+              tvShowCounts("SELECT idShow FROM episode WHERE idFile=new.idFile") + "END");
+  m_pDS->exec("CREATE TRIGGER update_bookmark AFTER UPDATE ON bookmark FOR EACH ROW BEGIN " +
+              tvShowCounts("SELECT idShow FROM episode WHERE idFile IN (old.idFile, new.idFile)") +
               "END");
+  m_pDS->exec("CREATE TRIGGER delete_bookmark AFTER DELETE ON bookmark FOR EACH ROW BEGIN " +
+              tvShowCounts("SELECT idShow FROM episode WHERE idFile=old.idFile") + "END");
+
+  // the triggers were dropped while updating the tables, count all the shows again
+  CLog::Log(LOGINFO, "{} - counting episodes of tvshows", __FUNCTION__);
+  m_pDS->exec("DELETE FROM tvshowcounts");
+  m_pDS->exec("DELETE FROM seasoncounts");
+  for (const auto& sql : GetTvShowCountsSQL("SELECT idShow FROM tvshow"))
+    m_pDS->exec(sql);
 
   CreateViews();
 }
@@ -414,27 +525,6 @@ void CVideoDatabase::CreateViews()
                                       VIDEODB_ID_EPISODE_IDENT_ID);
   m_pDS->exec(episodeview);
 
-  CLog::Log(LOGINFO, "create tvshowcounts");
-  // clang-format off
-  std::string tvshowcounts = PrepareSQL("CREATE VIEW tvshowcounts AS SELECT "
-                                       "      tvshow.idShow AS idShow,"
-                                       "      MAX(files.lastPlayed) AS lastPlayed,"
-                                       "      NULLIF(COUNT(episode.c12), 0) AS totalCount,"
-                                       "      COUNT(files.playCount) AS watchedcount,"
-                                       "      NULLIF(COUNT(DISTINCT(episode.c12)), 0) AS totalSeasons, "
-                                       "      MAX(files.dateAdded) as dateAdded, "
-                                       "      COUNT(bookmark.type) AS inProgressCount "
-                                       "    FROM tvshow"
-                                       "      LEFT JOIN episode ON"
-                                       "        episode.idShow=tvshow.idShow"
-                                       "      LEFT JOIN files ON"
-                                       "        files.idFile=episode.idFile "
-                                       "      LEFT JOIN bookmark ON"
-                                       "        bookmark.idFile=files.idFile AND bookmark.type=1 "
-                                       "GROUP BY tvshow.idShow");
-  // clang-format on
-  m_pDS->exec(tvshowcounts);
-
   CLog::Log(LOGINFO, "create tvshowlinkpath_minview");
   // This view only exists to workaround a limitation in MySQL <5.7 which is not able to
   // perform subqueries in joins.
@@ -493,34 +583,15 @@ void CVideoDatabase::CreateViews()
                                      "  tvshow_view.c%02d AS genre,"
                                      "  tvshow_view.c%02d AS studio,"
                                      "  tvshow_view.c%02d AS mpaa,"
-                                     "  count(DISTINCT episode.idEpisode) AS episodes,"
-                                     "  count(files.playCount) AS playCount,"
-                                     "  min(episode.c%02d) AS aired, "
-                                     "  count(bookmark.type) AS inProgressCount "
+                                     "  seasoncounts.episodes AS episodes,"
+                                     "  seasoncounts.playCount AS playCount,"
+                                     "  seasoncounts.aired AS aired, "
+                                     "  seasoncounts.inProgressCount AS inProgressCount "
                                      "FROM seasons"
                                      "  JOIN tvshow_view ON"
                                      "    tvshow_view.idShow = seasons.idShow"
-                                     "  JOIN episode ON"
-                                     "    episode.idShow = seasons.idShow AND episode.c%02d = seasons.season"
-                                     "  JOIN files ON"
-                                     "    files.idFile = episode.idFile "
-                                     "  LEFT JOIN bookmark ON"
-                                     "    bookmark.idFile = files.idFile AND bookmark.type = 1 "
-                                     "GROUP BY seasons.idSeason,"
-                                     "         seasons.idShow,"
-                                     "         seasons.season,"
-                                     "         seasons.name,"
-                                     "         seasons.userrating,"
-                                     "         tvshow_view.strPath,"
-                                     "         tvshow_view.c%02d,"
-                                     "         tvshow_view.c%02d,"
-                                     "         tvshow_view.c%02d,"
-                                     "         tvshow_view.c%02d,"
-                                     "         tvshow_view.c%02d,"
-                                     "         tvshow_view.c%02d ",
-                                     VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_PLOT, VIDEODB_ID_TV_PREMIERED,
-                                     VIDEODB_ID_TV_GENRE, VIDEODB_ID_TV_STUDIOS, VIDEODB_ID_TV_MPAA,
-                                     VIDEODB_ID_EPISODE_AIRED, VIDEODB_ID_EPISODE_SEASON,
+                                     "  JOIN seasoncounts ON"
+                                     "    seasoncounts.idSeason = seasons.idSeason",
                                      VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_PLOT, VIDEODB_ID_TV_PREMIERED,
                                      VIDEODB_ID_TV_GENRE, VIDEODB_ID_TV_STUDIOS, VIDEODB_ID_TV_MPAA);
   // clang-format on
@@ -635,12 +706,15 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
-    if (!m_pDS->eof())
-      idPath = m_pDS->fv("path.idPath").get_asInt();
+    strSQL = "SELECT idPath FROM path WHERE strPath=?";
+    const auto stmt = PrepareStatement(strSQL);
+    if (!stmt)
+      return -1;
+
+    stmt->bind(0, strPath1);
+    if (stmt->step())
+      idPath = stmt->get_asInt(0);
 
-    m_pDS->close();
     return idPath;
   }
   catch (...)
@@ -777,15 +851,20 @@ bool CVideoDatabase::GetPathsForTvShow(int idShow, std::set<int>& paths)
 }
 
 int CVideoDatabase::RunQuery(const std::string &sql)
+{
+  return RunQuery(sql, m_pDS);
+}
+
+int CVideoDatabase::RunQuery(const std::string& sql, const std::unique_ptr<Dataset>& pDS)
 {
   auto start = std::chrono::steady_clock::now();
 
   int rows = -1;
-  if (m_pDS->query(sql))
+  if (pDS->query(sql))
   {
-    rows = m_pDS->num_rows();
+    rows = pDS->num_rows();
     if (rows == 0)
-      m_pDS->close();
+      pDS->close();
   }
 
   auto end = std::chrono::steady_clock::now();
@@ -1006,29 +1085,35 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath,
     if (idPath < 0)
       return -1;
 
-    std::string strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
+    strSQL = "SELECT idFile FROM files WHERE strFileName=? AND idPath=?";
+    const auto select = PrepareStatement(strSQL);
+    if (!select)
+      return -1;
 
-    m_pDS->query(strSQL);
-    if (m_pDS->num_rows() > 0)
-    {
-      idFile = m_pDS->fv("idFile").get_asInt() ;
-      m_pDS->close();
-      return idFile;
-    }
-    m_pDS->close();
+    select->bind(0, strFileName);
+    select->bind(1, idPath);
+    if (select->step())
+      return select->get_asInt(0);
 
-    std::string strPlaycount = "NULL";
+    strSQL = "INSERT INTO files (idFile, idPath, strFileName, playCount, lastPlayed, dateAdded) "
+             "VALUES(NULL, ?, ?, ?, ?, ?)";
+    const auto insert = PrepareStatement(strSQL);
+    if (!insert)
+      return -1;
+
+    insert->bind(0, idPath);
+    insert->bind(1, strFileName);
     if (playcount > 0)
-      strPlaycount = std::to_string(playcount);
-    std::string strLastPlayed = "NULL";
+      insert->bind(2, playcount);
+    else
+      insert->bind_null(2);
     if (lastPlayed.IsValid())
-      strLastPlayed = "'" + lastPlayed.GetAsDBDateTime() + "'";
-
-    strSQL = PrepareSQL("INSERT INTO files (idFile, idPath, strFileName, playCount, lastPlayed, dateAdded) "
-                        "VALUES(NULL, %i, '%s', " + strPlaycount + ", " + strLastPlayed + ", '%s')",
-                        idPath, strFileName.c_str(), finalDateAdded.GetAsDBDateTime().c_str());
-    m_pDS->exec(strSQL);
-    idFile = (int)m_pDS->lastinsertid();
+      insert->bind(3, lastPlayed.GetAsDBDateTime());
+    else
+      insert->bind_null(3);
+    insert->bind(4, finalDateAdded.GetAsDBDateTime());
+    insert->execute();
+    idFile = static_cast<int>(insert->lastinsertid());
     return idFile;
   }
   catch (...)
@@ -2711,6 +2796,8 @@ int CVideoDatabase::SetDetailsForMovie(CVideoInfoTag& details,
       sql += PrepareSQL(", premiered = '%i'", details.GetYear());
     sql += PrepareSQL(" where idMovie=%i", idMovie);
     m_pDS->exec(sql);
+    SetSortKey(idMovie, MediaTypeMovie, details.m_strTitle, details.m_strSortTitle);
+    UpdateSearchIndex(MediaTypeMovie, idMovie);
     CommitTransaction();
 
     return idMovie;
@@ -2804,6 +2891,8 @@ int CVideoDatabase::UpdateDetailsForMovie(int idMovie, CVideoInfoTag& details, c
       sql += PrepareSQL(", premiered = '%i'", details.GetYear());
     sql += PrepareSQL(" where idMovie=%i", idMovie);
     m_pDS->exec(sql);
+    SetSortKey(idMovie, MediaTypeMovie, details.m_strTitle, details.m_strSortTitle);
+    UpdateSearchIndex(MediaTypeMovie, idMovie);
 
     CommitTransaction();
 
@@ -2964,6 +3053,7 @@ bool CVideoDatabase::UpdateDetailsForTvShow(int idTvShow, CVideoInfoTag &details
   sql += PrepareSQL(" WHERE idShow=%i", idTvShow);
   if (ExecuteQuery(sql))
   {
+    UpdateSearchIndex(MediaTypeTvShow, idTvShow);
     CommitTransaction();
     return true;
   }
@@ -3099,6 +3189,8 @@ int CVideoDatabase::SetDetailsForEpisode(CVideoInfoTag& details,
     sql += PrepareSQL(", idSeason = %i", idSeason);
     sql += PrepareSQL(" where idEpisode=%i", idEpisode);
     m_pDS->exec(sql);
+    SetSortKey(idEpisode, MediaTypeEpisode, details.m_strTitle);
+    UpdateSearchIndex(MediaTypeEpisode, idEpisode);
     CommitTransaction();
 
     return idEpisode;
@@ -3191,6 +3283,7 @@ int CVideoDatabase::SetDetailsForMusicVideo(CVideoInfoTag& details,
       sql += PrepareSQL(", premiered = '%i'", details.GetYear());
     sql += PrepareSQL(" where idMVideo=%i", idMVideo);
     m_pDS->exec(sql);
+    UpdateSearchIndex(MediaTypeMusicVideo, idMVideo);
     CommitTransaction();
 
     return idMVideo;
@@ -6392,11 +6485,101 @@ void CVideoDatabase::UpdateTables(int iVersion)
     }
     m_pDS->close();
   }
+
+  if (iVersion < 132)
+  {
+    // keys of existing items are added the first time they are sorted by
+    CreateSortKeyTable();
+  }
+
+  if (iVersion < 133)
+  {
+    CreateSearchIndexTable();
+    for (const auto& mediaType :
+         {MediaTypeMovie, MediaTypeTvShow, MediaTypeEpisode, MediaTypeMusicVideo})
+      UpdateSearchIndex(mediaType);
+  }
+
+  if (iVersion < 134)
+    CreatePathCheckTable();
+
+  // the counts are filled in when the triggers are created
+  if (iVersion < 135)
+    CreateTvShowCountsTables();
+
+  // the original titles of movies and tv shows are indexed with their titles
+  if (iVersion >= 133 && iVersion < 136)
+  {
+    UpdateSearchIndex(MediaTypeMovie);
+    UpdateSearchIndex(MediaTypeTvShow);
+  }
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 131;
+  return 136;
+}
+
+bool CVideoDatabase::GetSearchIndexSource(const std::string& mediaType,
+                                          SearchIndexSource& source) const
+{
+  std::string table;
+  std::string idField;
+  int plot;
+  int originalTitle = -1;
+  if (mediaType == MediaTypeMovie)
+  {
+    table = "movie";
+    idField = "idMovie";
+    plot = VIDEODB_ID_PLOT;
+    originalTitle = VIDEODB_ID_ORIGINALTITLE;
+  }
+  else if (mediaType == MediaTypeTvShow)
+  {
+    table = "tvshow";
+    idField = "idShow";
+    plot = VIDEODB_ID_TV_PLOT;
+    originalTitle = VIDEODB_ID_TV_ORIGINALTITLE;
+  }
+  else if (mediaType == MediaTypeEpisode)
+  {
+    table = "episode";
+    idField = "idEpisode";
+    plot = VIDEODB_ID_EPISODE_PLOT;
+  }
+  else if (mediaType == MediaTypeMusicVideo)
+  {
+    table = "musicvideo";
+    idField = "idMVideo";
+    plot = VIDEODB_ID_MUSICVIDEO_PLOT;
+  }
+  else
+    return false;
+
+  // names of the linked actors (the artists of music videos) and tags
+  const std::string concat =
+      m_sqlite ? "group_concat(%s.name, ' ')" : "GROUP_CONCAT(%s.name SEPARATOR ' ')";
+  auto links = [&](const char* link, const char* foreignKey) {
+    return PrepareSQL("(SELECT " + concat +
+                          " FROM %s_link JOIN %s ON %s.%s = %s_link.%s "
+                          "WHERE %s_link.media_id = %s.%s AND %s_link.media_type = '%s')",
+                      link, link, link, link, foreignKey, link, foreignKey, link, table.c_str(),
+                      idField.c_str(), link, mediaType.c_str());
+  };
+
+  source.table = table;
+  source.idField = idField;
+  source.title = StringUtils::Format("{}.c{:02}", table, VIDEODB_ID_TITLE);
+  // titles are searched by their original title too
+  if (originalTitle >= 0)
+    source.title = m_sqlite ? StringUtils::Format("ifnull({}, '') || ' ' || ifnull({}.c{:02}, '')",
+                                                  source.title, table, originalTitle)
+                            : StringUtils::Format("CONCAT_WS(' ', {}, {}.c{:02})", source.title,
+                                                  table, originalTitle);
+  source.people = links("actor", "actor_id");
+  source.tags = mediaType != MediaTypeEpisode ? links("tag", "tag_id") : "";
+  source.text = StringUtils::Format("{}.c{:02}", table, plot);
+  return true;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -8183,6 +8366,9 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     if (nullptr == m_pDS)
       return false;
 
+    // listings do not wait for the scanners to commit
+    const std::unique_ptr<Dataset>& pDS = GetReadDataset();
+
     // parse the base path to get additional filters
     CVideoDbUrl videoUrl;
     Filter extFilter = filter;
@@ -8198,17 +8384,51 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
       return false;
 
     // Apply the limiting directly here if there's no special sorting but limiting
+    Filter sortFilter = extFilter;
+    bool sortedInSQL = false;
     if (extFilter.limit.empty() && sorting.sortBy == SortByNone &&
         (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
          (sorting.limitStart == 0 && sorting.limitEnd == 0)))
     {
-      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    // Sort and limit in the query with the sort keys if only a part of the items is requested
+    else if (extFilter.limit.empty() && extFilter.order.empty() && extFilter.group.empty() &&
+             (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0) &&
+             GetSortKeyOrder(MediaTypeMovie, sortDescription, sortFilter) &&
+             UpdateSortKeys(MediaTypeMovie, "movie", "idMovie",
+                            StringUtils::Format("c{:02}", VIDEODB_ID_TITLE),
+                            StringUtils::Format("c{:02}", VIDEODB_ID_SORTTITLE)))
+    {
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS).c_str(), NULL, 10);
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, sortFilter, strSQLExtra))
+        return false;
+      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      extFilter.fields = sortFilter.fields;
+      sortedInSQL = true;
+    }
+    // Pick the random movies by id instead of ordering every movie by RANDOM()
+    else if (extFilter.limit.empty() && extFilter.group.empty() &&
+             sortDescription.sortBy == SortByRandom &&
+             (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
+    {
+      std::vector<int> ids;
+      total = GetRandomIds(PrepareSQL(strSQL, "movie_view.idMovie") + strSQLExtra,
+                           GetRandomLimit(sortDescription), ids);
+      if (total < 0)
+        return false;
+      sortFilter.where = GetIdFilter("movie_view.idMovie", ids);
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, sortFilter, strSQLExtra))
+        return false;
+      sortedInSQL = true;
+    }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, pDS);
 
     // store the total value of items as a property
     if (total < iRowsFound)
@@ -8221,12 +8441,20 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     DatabaseResults results;
     results.reserve(iRowsFound);
 
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
+    if (sortedInSQL)
+    {
+      for (int row = 0; row < iRowsFound; row++)
+        results.push_back({{FieldRow, CVariant(row)}});
+      // the picked items are returned in the order of the table
+      if (sortDescription.sortBy == SortByRandom)
+        KODI::UTILS::RandomShuffle(results.begin(), results.end());
+    }
+    else if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, pDS, results))
       return false;
 
     // get data from returned rows
     items.Reserve(results.size());
-    const query_data &data = m_pDS->get_result_set().records;
+    const query_data &data = pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
@@ -8271,7 +8499,7 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     }
 
     // cleanup
-    m_pDS->close();
+    pDS->close();
     return true;
   }
   catch (...)
@@ -8317,6 +8545,8 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
     if (nullptr == m_pDS)
       return false;
 
+    const std::unique_ptr<Dataset>& pDS = GetReadDataset();
+
     int total = -1;
 
     std::string strSQL = "SELECT %s FROM tvshow_view ";
@@ -8332,13 +8562,13 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
         (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
          (sorting.limitStart == 0 && sorting.limitEnd == 0)))
     {
-      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, pDS);
 
     // store the total value of items as a property
     if (total < iRowsFound)
@@ -8350,12 +8580,12 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeTvShow, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeTvShow, pDS, results))
       return false;
 
     // get data from returned rows
     items.Reserve(results.size());
-    const query_data &data = m_pDS->get_result_set().records;
+    const query_data &data = pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
@@ -8383,7 +8613,7 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
     }
 
     // cleanup
-    m_pDS->close();
+    pDS->close();
     return true;
   }
   catch (...)
@@ -8445,6 +8675,8 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     if (nullptr == m_pDS)
       return false;
 
+    const std::unique_ptr<Dataset>& pDS = GetReadDataset();
+
     int total = -1;
 
     std::string strSQL = "select %s from episode_view ";
@@ -8456,17 +8688,49 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
       return false;
 
     // Apply the limiting directly here if there's no special sorting but limiting
+    Filter sortFilter = extFilter;
+    bool sortedInSQL = false;
     if (extFilter.limit.empty() && sorting.sortBy == SortByNone &&
         (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
          (sorting.limitStart == 0 && sorting.limitEnd == 0)))
     {
-      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS).c_str(), NULL, 10);
+      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+    }
+    // Sort and limit in the query with the sort keys if only a part of the items is requested
+    else if (extFilter.limit.empty() && extFilter.order.empty() && extFilter.group.empty() &&
+             (sorting.limitStart > 0 || sorting.limitEnd > 0) &&
+             GetSortKeyOrder(MediaTypeEpisode, sorting, sortFilter) &&
+             UpdateSortKeys(MediaTypeEpisode, "episode", "idEpisode",
+                            StringUtils::Format("c{:02}", VIDEODB_ID_EPISODE_TITLE)))
+    {
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS).c_str(), NULL, 10);
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, sortFilter, strSQLExtra))
+        return false;
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      extFilter.fields = sortFilter.fields;
+      sortedInSQL = true;
+    }
+    // Pick the random episodes by id instead of ordering every episode by RANDOM()
+    else if (extFilter.limit.empty() && extFilter.group.empty() && sorting.sortBy == SortByRandom &&
+             (sorting.limitStart > 0 || sorting.limitEnd > 0))
+    {
+      std::vector<int> ids;
+      total = GetRandomIds(PrepareSQL(strSQL, "episode_view.idEpisode") + strSQLExtra,
+                           GetRandomLimit(sorting), ids);
+      if (total < 0)
+        return false;
+      sortFilter.where = GetIdFilter("episode_view.idEpisode", ids);
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, sortFilter, strSQLExtra))
+        return false;
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, pDS);
 
     // store the total value of items as a property
     if (total < iRowsFound)
@@ -8478,14 +8742,22 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
 
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
+    if (sortedInSQL)
+    {
+      for (int row = 0; row < iRowsFound; row++)
+        results.push_back({{FieldRow, CVariant(row)}});
+      // the picked items are returned in the order of the table
+      if (sortDescription.sortBy == SortByRandom)
+        KODI::UTILS::RandomShuffle(results.begin(), results.end());
+    }
+    else if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, pDS, results))
       return false;
 
     // get data from returned rows
     items.Reserve(results.size());
     CLabelFormatter formatter("%H. %T", "");
 
-    const query_data &data = m_pDS->get_result_set().records;
+    const query_data &data = pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
@@ -8521,7 +8793,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     }
 
     // cleanup
-    m_pDS->close();
+    pDS->close();
     return true;
   }
   catch (...)
@@ -9347,6 +9619,8 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     if (nullptr == m_pDS)
       return false;
 
+    const std::unique_ptr<Dataset>& pDS = GetReadDataset();
+
     int total = -1;
 
     std::string strSQL = "select %s from musicvideo_view ";
@@ -9365,7 +9639,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     {
       idArtist = option->second.asInteger();
       strArtist = GetSingleValue(
-                      PrepareSQL("SELECT name FROM actor where actor_id = '%i'", idArtist), m_pDS)
+                      PrepareSQL("SELECT name FROM actor where actor_id = '%i'", idArtist), pDS)
                       .c_str();
     }
     Filter extFilter = filter;
@@ -9378,13 +9652,13 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
         (sorting.limitStart > 0 || sorting.limitEnd > 0 ||
          (sorting.limitStart == 0 && sorting.limitEnd == 0)))
     {
-      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
+    int iRowsFound = RunQuery(strSQL, pDS);
 
     // store the total value of items as a property
     if (total < iRowsFound)
@@ -9396,13 +9670,13 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
 
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeMusicVideo, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sorting, MediaTypeMusicVideo, pDS, results))
       return false;
 
     // get data from returned rows
     items.Reserve(results.size());
     // get songs from returned subtable
-    const query_data &data = m_pDS->get_result_set().records;
+    const query_data &data = pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
@@ -9427,7 +9701,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     }
 
     // cleanup
-    m_pDS->close();
+    pDS->close();
     if (!strArtist.empty())
       items.SetProperty("customtitle", strArtist);
     return true;
@@ -9451,22 +9725,15 @@ unsigned int CVideoDatabase::GetRandomMusicVideoIDs(const std::string& strWhere,
     std::string strSQL = "select distinct idMVideo from musicvideo_view";
     if (!strWhere.empty())
       strSQL += " where " + strWhere;
-    strSQL += PrepareSQL(" ORDER BY RANDOM()");
 
-    if (!m_pDS->query(strSQL)) return 0;
+    // shuffled here, ordering by RANDOM() would sort every music video
+    std::vector<int> ids;
     songIDs.clear();
-    if (m_pDS->num_rows() == 0)
-    {
-      m_pDS->close();
+    if (GetRandomIds(strSQL, 0, ids) <= 0)
       return 0;
-    }
-    songIDs.reserve(m_pDS->num_rows());
-    while (!m_pDS->eof())
-    {
-      songIDs.push_back(std::make_pair<int,int>(2,m_pDS->fv(0).get_asInt()));
-      m_pDS->next();
-    }    // cleanup
-    m_pDS->close();
+    songIDs.reserve(ids.size());
+    for (const int id : ids)
+      songIDs.emplace_back(2, id);
     return songIDs.size();
   }
   catch (...)
@@ -9534,18 +9801,26 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    std::string order;
+    std::string where =
+        GetSearchIndexFilter(strSearch, MediaTypeMovie, "movie.idMovie", order, true);
+    if (where.empty())
+      where = PrepareSQL("movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
+                         VIDEODB_ID_TITLE, strSearch.c_str(), VIDEODB_ID_ORIGINALTITLE,
+                         strSearch.c_str());
+    else
+      where += " ORDER BY " + order;
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
       strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie "
                           "INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON "
-                          "path.idPath=files.idPath "
-                          "WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+                          "path.idPath=files.idPath WHERE ",
+                          VIDEODB_ID_TITLE) +
+               where;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie WHERE "
-                          "movie.c%02d like '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie WHERE ",
+                          VIDEODB_ID_TITLE) +
+               where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9589,10 +9864,19 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (nullptr == m_pDS)
       return;
 
+    // by title only, the scanner links movies to the first show found for their showlink
+    std::string order;
+    std::string where =
+        GetSearchIndexFilter(strSearch, MediaTypeTvShow, "tvshow.idShow", order, true);
+    if (where.empty())
+      where = PrepareSQL("tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, strSearch.c_str());
+    else
+      where += " ORDER BY " + order;
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE ", VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where ",VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9633,10 +9917,18 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    std::string order;
+    std::string where =
+        GetSearchIndexFilter(strSearch, MediaTypeEpisode, "episode.idEpisode", order, true);
+    if (where.empty())
+      where = PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+    else
+      where += " ORDER BY " + order;
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9680,10 +9972,19 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (nullptr == m_pDS)
       return;
 
+    std::string order;
+    std::string where =
+        GetSearchIndexFilter(strSearch, MediaTypeMusicVideo, "musicvideo.idMVideo", order, true);
+    if (where.empty())
+      where = PrepareSQL("musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE,
+                         strSearch.c_str());
+    else
+      where += " ORDER BY " + order;
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_MUSICVIDEO_TITLE) + where;
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where ",VIDEODB_ID_MUSICVIDEO_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9979,8 +10280,8 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
     BeginTransaction();
 
     // find all the files
-    std::string sql = "SELECT files.idFile, files.strFileName, path.strPath FROM files "
-                      "INNER JOIN path ON path.idPath=files.idPath";
+    std::string sql = "SELECT files.idFile, files.strFileName, path.strPath, path.idPath "
+                      "FROM files INNER JOIN path ON path.idPath=files.idPath";
     if (!paths.empty())
     {
       std::string strPaths;
@@ -9989,9 +10290,6 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
       sql += PrepareSQL(" AND path.idPath IN (%s)", strPaths.substr(1).c_str());
     }
 
-    // For directory caching to work properly, we need to sort the files by path
-    sql += " ORDER BY path.strPath";
-
     m_pDS2->query(sql);
     if (m_pDS2->num_rows() > 0)
     {
@@ -9999,10 +10297,19 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
       VECSOURCES videoSources(*CMediaSourceSettings::GetInstance().GetSources("video"));
       CServiceBroker::GetMediaManager().GetRemovableDrives(videoSources);
 
-      int total = m_pDS2->num_rows();
-      int current = 0;
-      std::string lastDir;
-      bool gotDir = true;
+      // Only the directories changed since the last clean found all of their files are listed,
+      // the others are trusted after a stat
+      const std::map<int, int64_t> pathChecks = GetPathChecks(PATH_CHECK_MAX_AGE);
+      std::vector<CDirectoryChecker::Directory> directories;
+      std::map<std::string, size_t> directoryIndexes;
+      std::map<size_t, int> directoryPathIds;
+      struct PendingFile
+      {
+        std::string idFile;
+        std::string path;
+        size_t directory;
+      };
+      std::vector<PendingFile> pendingFiles;
 
       while (!m_pDS2->eof())
       {
@@ -10037,48 +10344,85 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
               CUtil::GetMatchingSource(fullPath, videoSources, bIsSource) >= 0)
           {
             const std::string pathDir = URIUtils::GetDirectory(fullPath);
-
-            // Cache file's directory in case it's different from the previous file
-            if (lastDir != pathDir)
+            auto directory = directoryIndexes.find(pathDir);
+            if (directory == directoryIndexes.end())
             {
-              lastDir = pathDir;
-              CFileItemList items; // Dummy list
-              gotDir = CDirectory::GetDirectory(pathDir, items, "",
-                                                DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
+              CDirectoryChecker::Directory checked;
+              checked.path = pathDir;
+              // the modification time is only tracked for the directories of the path table
+              if (URIUtils::PathEquals(pathDir, path))
+              {
+                const int idPath = m_pDS2->fv("path.idPath").get_asInt();
+                const auto pathCheck = pathChecks.find(idPath);
+                if (pathCheck != pathChecks.end())
+                  checked.knownMTime = pathCheck->second;
+                directoryPathIds[directories.size()] = idPath;
+              }
+              directory = directoryIndexes.emplace(pathDir, directories.size()).first;
+              directories.push_back(std::move(checked));
             }
-
-            // Keep existing files
-            if (gotDir && CFile::Exists(fullPath, true))
-              del = false;
+            pendingFiles.push_back(
+                {m_pDS2->fv("files.idFile").get_asString(), fullPath, directory->second});
+            del = false;
           }
         }
         if (del)
           filesToTestForDelete += m_pDS2->fv("files.idFile").get_asString() + ",";
 
-        if (handle == NULL && progress != NULL)
-        {
-          int percentage = current * 100 / total;
-          if (percentage > progress->GetPercentage())
-          {
-            progress->SetPercentage(percentage);
-            progress->Progress();
-          }
-          if (progress->IsCanceled())
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+
+      const bool checked = CDirectoryChecker().Check(
+          directories,
+          [handle, progress](size_t current, size_t total)
           {
-            progress->Close();
-            m_pDS2->close();
-            CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary,
-                                                               "OnCleanFinished");
-            return;
-          }
+            if (handle == NULL && progress != NULL)
+            {
+              int percentage = current * 100 / total;
+              if (percentage > progress->GetPercentage())
+              {
+                progress->SetPercentage(percentage);
+                progress->Progress();
+              }
+              return !progress->IsCanceled();
+            }
+            else if (handle != NULL)
+              handle->SetPercentage(current * 100 / (float)total);
+            return true;
+          });
+      if (!checked)
+      {
+        RollbackTransaction();
+        progress->Close();
+        CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary,
+                                                           "OnCleanFinished");
+        return;
+      }
+
+      // Keep existing files
+      std::vector<bool> directoryComplete(directories.size(), true);
+      for (const auto& file : pendingFiles)
+      {
+        if (!CDirectoryChecker::Exists(directories[file.directory], file.path))
+        {
+          filesToTestForDelete += file.idFile + ",";
+          directoryComplete[file.directory] = false;
         }
-        else if (handle != NULL)
-          handle->SetPercentage(current * 100 / (float)total);
+      }
 
-        m_pDS2->next();
-        current++;
+      std::set<int> existingPaths;
+      std::map<int, int64_t> completePaths;
+      for (const auto& directoryPathId : directoryPathIds)
+      {
+        const CDirectoryChecker::Directory& directory = directories[directoryPathId.first];
+        if (!directory.unchanged && !directory.listed)
+          continue;
+        existingPaths.insert(directoryPathId.second);
+        if (directory.mtime != 0 && directoryComplete[directoryPathId.first])
+          completePaths[directoryPathId.second] = directory.mtime;
       }
-      m_pDS2->close();
+      SetPathChecks(completePaths);
 
       std::string filesToDelete;
 
@@ -10197,7 +10541,8 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
             exists = true;
         }
         else
-          exists = CDirectory::Exists(path, false);
+          exists = existingPaths.find(m_pDS2->fv(0).get_asInt()) != existingPaths.end() ||
+                   CDirectory::Exists(path, false);
 
         if (((pathsDeleteDecision != pathsDeleteDecisions.end() && pathsDeleteDecision->second) ||
              (pathsDeleteDecision == pathsDeleteDecisions.end() && !exists)) &&
@@ -10270,6 +10615,7 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle,
           VIDEODB_ID_PARENTPATHID, VIDEODB_ID_EPISODE_PARENTPATHID,
           VIDEODB_ID_MUSICVIDEO_PARENTPATHID);
       m_pDS->exec(sql);
+      CleanPathChecks();
 
       CLog::Log(LOGDEBUG, LOGDATABASE, "{}: Cleaning genre table", __FUNCTION__);
       sql =
@@ -11403,6 +11749,9 @@ bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
+    // the counts are updated when the batch is committed
+    if (IsBatchActive())
+      return true;
     GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
     guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VideoDbContentType::MOVIES));
     guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VideoDbContentType::TVSHOWS));
@@ -11448,8 +11797,17 @@ bool CVideoDatabase::SetSingleValue(VideoDbContentType type,
     if (strTable.empty())
       return false;
 
-    return SetSingleValue(strTable, StringUtils::Format("c{:02}", dbField), strValue, strField,
-                          dbId);
+    if (!SetSingleValue(strTable, StringUtils::Format("c{:02}", dbField), strValue, strField, dbId))
+      return false;
+
+    // the sort keys are made again the next time the items are sorted by
+    if ((type == VideoDbContentType::MOVIES &&
+         (dbField == VIDEODB_ID_TITLE || dbField == VIDEODB_ID_SORTTITLE)) ||
+        (type == VideoDbContentType::EPISODES && dbField == VIDEODB_ID_EPISODE_TITLE))
+      m_pDS->exec(PrepareSQL("DELETE FROM sortkey WHERE media_id=%i AND media_type='%s'", dbId,
+                             type == VideoDbContentType::MOVIES ? MediaTypeMovie
+                                                                : MediaTypeEpisode));
+    return true;
   }
   catch (...)
   {
@@ -12497,7 +12855,8 @@ void CVideoDatabase::AddVideoAsset(VideoDbContentType itemType,
   if (!m_pDB || !m_pDS)
     return;
 
-  assert(m_pDB->in_transaction() == false);
+  // transactions begun during a batch are nested in it
+  assert(m_pDB->in_transaction() == false || IsBatchActive());
 
   MediaType mediaType;
   if (itemType == VideoDbContentType::MOVIES)
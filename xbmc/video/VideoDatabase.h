@@ -33,8 +33,7 @@ enum class VideoAssetType;
 
 namespace dbiplus
 {
-  class field_value;
-  typedef std::vector<field_value> sql_record;
+  class sql_record;
 }
 
 #ifndef my_offsetof
@@ -1204,6 +1203,17 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief Create the tables holding the episode counts of the tv shows and their seasons.
+   They are kept up to date by triggers, so listing the shows does not count their episodes.
+   */
+  void CreateTvShowCountsTables();
+
+  /*! \brief Get the statements recounting the episodes of tv shows and their seasons.
+   \param idShows SQL giving the ids of the shows to recount, a list or a subquery
+   \return the statements, to be run in order
+   */
+  std::vector<std::string> GetTvShowCountsSQL(const std::string& idShows) const;
+
   /*! \brief Helper to get a database id given a query.
    Returns an integer, -1 if not found, and greater than 0 if found.
    \param query the SQL that will retrieve a database id.
@@ -1217,6 +1227,7 @@ private:
    \return the number of rows, -1 for an error.
    */
   int RunQuery(const std::string &sql);
+  int RunQuery(const std::string& sql, const std::unique_ptr<dbiplus::Dataset>& pDS);
 
   void AppendIdLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
   void AppendLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
@@ -1245,6 +1256,8 @@ private:
 
   int GetMinSchemaVersion() const override { return 75; }
   int GetSchemaVersion() const override;
+  bool GetSearchIndexSource(const std::string& mediaType,
+                            SearchIndexSource& source) const override;
   virtual int GetExportVersion() const { return 1; }
   const char* GetBaseDBName() const override { return "MyVideos"; }
 
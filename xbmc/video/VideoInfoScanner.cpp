@@ -24,6 +24,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
+#include "filesystem/PathTaskQueue.h"
 #include "filesystem/PluginDirectory.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
@@ -62,6 +63,17 @@ using KODI::UTILITY::CDigest;
 namespace VIDEO
 {
 
+  struct CVideoInfoScanner::SDirectoryListing
+  {
+    CONTENT_TYPE content = CONTENT_NONE;
+    std::string dbHash; ///< hash in the database when listed
+    bool exists = false;
+    bool noMedia = false; ///< the directory contains a .nomedia file
+    std::string fastHash;
+    std::string hash; ///< empty if the directory is empty or can not be read
+    CFileItemList items; ///< not listed if the fast hash matches the hash in the database
+  };
+
   CVideoInfoScanner::CVideoInfoScanner()
   {
     m_bStop = false;
@@ -122,6 +134,14 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // List the directories ahead of their scan, so the latency of the servers adds up only
+      // once. Scraping and the database stay on this thread, in the order of the scan.
+      const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+      const unsigned int workers = advancedSettings->m_iVideoScannerWorkers;
+      if (workers > 0)
+        m_prefetchQueue = std::make_unique<CPathTaskQueue>(
+            workers, advancedSettings->m_iVideoScannerWorkersPerHost);
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
@@ -132,11 +152,16 @@ namespace VIDEO
          * occurs.
          */
         std::string directory = *m_pathsToScan.begin();
+
+        auto next = m_pathsToScan.begin();
+        for (unsigned int i = 0; i < 2 * workers && next != m_pathsToScan.end(); ++i, ++next)
+          Prefetch(*next);
+
         if (m_bStop)
         {
           bCancelled = true;
         }
-        else if (!CDirectory::Exists(directory))
+        else if (!DirectoryExists(directory))
         {
           /*
            * Note that this will skip clean (if m_bClean is enabled) if the directory really
@@ -151,6 +176,10 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      // discard the directories listed ahead of a canceled scan
+      m_prefetchQueue.reset();
+      m_prefetched.clear();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -270,9 +299,6 @@ namespace VIDEO
     if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
       return true;
 
-    if (HasNoMedia(strDirectory))
-      return true;
-
     bool ignoreFolder = !m_scanAll && settings.noupdate;
     if (content == CONTENT_NONE || ignoreFolder)
       return true;
@@ -295,32 +321,14 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str), info->Name()));
       }
 
-      std::string fastHash;
-      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
+      m_database.GetPathHash(strDirectory, dbHash);
+      const auto listing = GetListing(strDirectory, content, regexps, dbHash);
+      if (listing->noMedia)
+        return true;
 
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
-      }
-      else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        // do not consider inner folders with .nomedia
-        items.erase(std::remove_if(items.begin(), items.end(),
-                                   [this](const CFileItemPtr& item) {
-                                     return item->m_bIsFolder && HasNoMedia(item->GetPath());
-                                   }),
-                    items.end());
-        items.Stack();
-
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
-          hash = fastHash;
-      }
+      items.Assign(listing->items);
+      hash = listing->hash;
+      const std::string& fastHash = listing->fastHash;
 
       if (StringUtils::EqualsNoCase(hash, dbHash))
       { // hash matches - skipping
@@ -356,18 +364,25 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        items.SetPath(strDirectory);
-        GetPathHash(items, hash);
+        const bool hasDbHash = m_database.GetPathHash(strDirectory, dbHash);
+        const auto listing = GetListing(strDirectory, content, regexps, dbHash);
+        if (listing->noMedia)
+          return true;
+
+        hash = listing->hash;
         bSkip = true;
-        if (!m_database.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
+        if (!hasDbHash || !StringUtils::EqualsNoCase(dbHash, hash))
+        {
           bSkip = false;
-        else
-          items.Clear();
+          items.Assign(listing->items);
+          items.SetPath(strDirectory);
+        }
       }
       else
       {
+        if (HasNoMedia(strDirectory))
+          return true;
+
         CFileItemPtr item(new CFileItem(URIUtils::GetFileName(strDirectory)));
         item->SetPath(strDirectory);
         item->m_bIsFolder = true;
@@ -406,6 +421,17 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    // list the subfolders ahead of their scan
+    if (!m_bStop && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+    {
+      for (const auto& pItem : items)
+      {
+        if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() &&
+            !pItem->IsVideoExtras())
+          Prefetch(pItem->GetPath());
+      }
+    }
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -455,6 +481,8 @@ namespace VIDEO
     }
 
     m_database.Open();
+    // Write the items in a few large transactions, committed before scraping
+    const bool batch = m_database.BeginBatch();
 
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
@@ -485,6 +513,10 @@ namespace VIDEO
       // clear our scraper cache
       info2->ClearCache();
 
+      // reading the item over the network mustn't hold the write lock of the batch
+      if (URIUtils::IsRemote(pItem->GetPath()))
+        m_database.CommitBatchWrites();
+
       INFO_RET ret = INFO_CANCELLED;
       if (info2->Content() == CONTENT_TVSHOWS)
         ret = RetrieveInfoForTvShow(pItem.get(), bDirNames, info2, useLocal, pURL, fetchEpisodes, pDlgProgress);
@@ -537,11 +569,14 @@ namespace VIDEO
       }
 
       pURL = NULL;
+      m_database.BatchItemDone();
 
       // Keep track of directories we've seen
       if (m_bClean && pItem->m_bIsFolder)
         seenPaths.push_back(m_database.GetPathId(pItem->GetPath()));
     }
+    if (batch)
+      m_database.CommitBatch();
 
     if (content == CONTENT_TVSHOWS && ! seenPaths.empty())
     {
@@ -938,6 +973,7 @@ namespace VIDEO
       {
         if (!alreadyHasArt && !item->IsPlugin() && scraper->ID() != "metadata.local")
         {
+          m_database.CommitBatchWrites();
           CVideoInfoDownloader loader(scraper);
           loader.GetArtwork(showInfo);
         }
@@ -1954,6 +1990,9 @@ namespace VIDEO
         item.GetVideoInfoTag()->m_iEpisode = file->iEpisode;
       }
 
+      if (URIUtils::IsRemote(file->strPath))
+        m_database.CommitBatchWrites();
+
       // handle .nfo files
       CInfoScanner::INFO_TYPE result=CInfoScanner::NO_NFO;
       CScraperUrl scrUrl;
@@ -1988,6 +2027,7 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          m_database.CommitBatchWrites();
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -2106,6 +2146,7 @@ namespace VIDEO
 
       if (bFound)
       {
+        m_database.CommitBatchWrites();
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
@@ -2145,6 +2186,8 @@ namespace VIDEO
     if (m_handle && !url.GetTitle().empty())
       m_handle->SetText(url.GetTitle());
 
+    // don't hold the write lock of the batch while scraping
+    m_database.CommitBatchWrites();
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(uniqueIDs, url, movieDetails, pDialog);
 
@@ -2250,6 +2293,147 @@ namespace VIDEO
     return "";
   }
 
+  std::shared_ptr<CVideoInfoScanner::SDirectoryListing> CVideoInfoScanner::ListDirectory(
+      const std::string& directory,
+      CONTENT_TYPE content,
+      const std::vector<std::string>& excludes,
+      const std::string& dbHash) const
+  {
+    auto listing = std::make_shared<SDirectoryListing>();
+    listing->content = content;
+    listing->dbHash = dbHash;
+    if (HasNoMedia(directory))
+    {
+      listing->exists = true;
+      listing->noMedia = true;
+      return listing;
+    }
+
+    const std::string extensions = CServiceBroker::GetFileExtensionProvider().GetVideoExtensions();
+    if (content == CONTENT_TVSHOWS)
+    {
+      listing->exists =
+          CDirectory::GetDirectory(directory, listing->items, extensions, DIR_FLAG_DEFAULTS);
+      GetPathHash(listing->items, listing->hash);
+    }
+    else
+    {
+      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash &&
+          !URIUtils::IsPlugin(directory))
+        listing->fastHash = GetFastHash(directory, excludes);
+
+      if (!listing->fastHash.empty() && StringUtils::EqualsNoCase(listing->fastHash, dbHash))
+      { // fast hashes match - no need to process anything
+        listing->exists = true;
+        listing->hash = listing->fastHash;
+        return listing;
+      }
+
+      // need to fetch the folder
+      CFileItemList& items = listing->items;
+      listing->exists = CDirectory::GetDirectory(directory, items, extensions, DIR_FLAG_DEFAULTS);
+      // do not consider inner folders with .nomedia
+      items.erase(std::remove_if(items.begin(), items.end(),
+                                 [this](const CFileItemPtr& item) {
+                                   return item->m_bIsFolder && HasNoMedia(item->GetPath());
+                                 }),
+                  items.end());
+      items.Stack();
+
+      // check whether to re-use previously computed fast hash
+      if (!CanFastHash(items, excludes) || listing->fastHash.empty())
+        GetPathHash(items, listing->hash);
+      else
+        listing->hash = listing->fastHash;
+    }
+
+    if (!listing->exists)
+      listing->exists = CDirectory::Exists(directory);
+    return listing;
+  }
+
+  void CVideoInfoScanner::Prefetch(const std::string& directory)
+  {
+    // plugins are listed by the scan, some can not run in parallel
+    if (!m_prefetchQueue || m_bStop || URIUtils::IsPlugin(directory) ||
+        m_prefetched.find(directory) != m_prefetched.end())
+      return;
+
+    // only the directories the scan is going to list
+    std::shared_future<std::shared_ptr<SDirectoryListing>>& prefetched = m_prefetched[directory];
+    bool foundDirectly = false;
+    SScanSettings settings;
+    ScraperPtr info = m_database.GetScraperForPath(directory, settings, foundDirectly);
+    const CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+    if (content == CONTENT_TVSHOWS ? !foundDirectly || settings.parent_name_root
+                                   : content != CONTENT_MOVIES && content != CONTENT_MUSICVIDEOS)
+      return;
+    if (!m_scanAll && settings.noupdate)
+      return;
+
+    const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    const std::vector<std::string>& excludes =
+        content == CONTENT_TVSHOWS ? advancedSettings->m_tvshowExcludeFromScanRegExps
+                                   : advancedSettings->m_moviesExcludeFromScanRegExps;
+    if (CUtil::ExcludeFileOrFolder(directory, excludes))
+      return;
+
+    std::string dbHash;
+    m_database.GetPathHash(directory, dbHash);
+
+    auto promise = std::make_shared<std::promise<std::shared_ptr<SDirectoryListing>>>();
+    prefetched = promise->get_future().share();
+    m_prefetchQueue->Add(directory,
+                         [this, promise, directory, content, excludes, dbHash]()
+                         {
+                           std::shared_ptr<SDirectoryListing> listing;
+                           try
+                           {
+                             listing = ListDirectory(directory, content, excludes, dbHash);
+                           }
+                           catch (...)
+                           {
+                             CLog::Log(LOGERROR, "VideoInfoScanner: Failed to list {}",
+                                       CURL::GetRedacted(directory));
+                           }
+                           promise->set_value(listing);
+                         });
+  }
+
+  std::shared_ptr<CVideoInfoScanner::SDirectoryListing> CVideoInfoScanner::GetListing(
+      const std::string& directory,
+      CONTENT_TYPE content,
+      const std::vector<std::string>& excludes,
+      const std::string& dbHash)
+  {
+    const auto prefetched = m_prefetched.find(directory);
+    if (prefetched != m_prefetched.end())
+    {
+      const auto future = prefetched->second;
+      m_prefetched.erase(prefetched);
+      if (future.valid())
+      {
+        const std::shared_ptr<SDirectoryListing> listing = future.get();
+        // the hash in the database changes if the directory was scanned in the meantime
+        if (listing && listing->content == content && listing->dbHash == dbHash)
+          return listing;
+      }
+    }
+    return ListDirectory(directory, content, excludes, dbHash);
+  }
+
+  bool CVideoInfoScanner::DirectoryExists(const std::string& directory)
+  {
+    const auto prefetched = m_prefetched.find(directory);
+    if (prefetched != m_prefetched.end() && prefetched->second.valid())
+    {
+      const std::shared_ptr<SDirectoryListing> listing = prefetched->second.get();
+      if (listing)
+        return listing->exists;
+    }
+    return CDirectory::Exists(directory);
+  }
+
   std::string CVideoInfoScanner::GetRecursiveFastHash(const std::string &directory,
       const std::vector<std::string> &excludes) const
   {
@@ -2427,6 +2611,7 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const std::string &title, int year, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    m_database.CommitBatchWrites();
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(title, year, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
@@ -13,6 +13,9 @@
 #include "addons/Scraper.h"
 #include "guilib/GUIListItem.h"
 
+#include <future>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -21,6 +24,11 @@ class CRegExp;
 class CFileItem;
 class CFileItemList;
 
+namespace XFILE
+{
+class CPathTaskQueue;
+}
+
 namespace VIDEO
 {
   class IVideoInfoTagLoader;
@@ -223,6 +231,41 @@ namespace VIDEO
      */
     bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
 
+    struct SDirectoryListing;
+
+    /*! \brief List and hash a directory to scan.
+     Only accesses the file system, so directories can be listed by the workers ahead of their scan.
+     \param directory the directory
+     \param content the content of the directory, for tv shows the directory of a show
+     \param excludes string array of exclude expressions
+     \param dbHash the hash of the directory in the database, the directory is not listed if its
+     fast hash matches
+     \return the listing
+     */
+    std::shared_ptr<SDirectoryListing> ListDirectory(const std::string& directory,
+                                                     CONTENT_TYPE content,
+                                                     const std::vector<std::string>& excludes,
+                                                     const std::string& dbHash) const;
+
+    /*! \brief Start listing a directory on the workers ahead of its scan, if it is going to be
+     listed.
+     \param directory the directory
+     */
+    void Prefetch(const std::string& directory);
+
+    /*! \brief Get the listing of a directory, the one listed ahead if it is still valid.
+     \sa ListDirectory
+     */
+    std::shared_ptr<SDirectoryListing> GetListing(const std::string& directory,
+                                                  CONTENT_TYPE content,
+                                                  const std::vector<std::string>& excludes,
+                                                  const std::string& dbHash);
+
+    /*! \brief Whether a directory to scan exists, known without a further access if it was listed
+     ahead.
+     */
+    bool DirectoryExists(const std::string& directory);
+
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
      and we should return INFO_NOT_FOUND only if no information is found for any of
@@ -251,6 +294,10 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
 
+    std::unique_ptr<XFILE::CPathTaskQueue> m_prefetchQueue;
+    //! listings of the directories listed ahead, invalid for the ones not going to be listed
+    std::map<std::string, std::shared_future<std::shared_ptr<SDirectoryListing>>> m_prefetched;
+
   private:
     static void AddLocalItemArtwork(CGUIListItem::ArtMap& itemArt,
       const std::vector<std::string>& wantedArtTypes, const std::string& itemPath,
@@ -10,21 +10,469 @@
 
 #include "ServiceBroker.h"
 #include "TextureDatabase.h"
+#include "URL.h"
 #include "guilib/LocalizeStrings.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/Archive.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
+#include "utils/XMLStreamReader.h"
 #include "utils/XMLUtils.h"
 #include "utils/log.h"
 #include "video/VideoManagerTypes.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
+namespace
+{
+/* ParseNative() reads the tags of a parsed element, with the functions below, or of an element
+   read by LoadFromXML(): the children of that element ParseNative() reads are kept, the tags
+   parsed as TinyXML as elements and the other tags as the value of their first child. */
+struct SStreamedElement
+{
+  bool hasChild = false;
+  std::string value; ///< the value of the first child, the name of an element
+  CXMLStreamReader::Attributes attributes;
+  std::unique_ptr<TiXmlElement> element; ///< the element, for the tags parsed as TinyXML
+  std::map<std::string, std::vector<SStreamedElement>, std::less<>> children;
+};
+
+struct SStreamedChild
+{
+  enum
+  {
+    FIRST, ///< the first child of the name is kept
+    ALL, ///< all the children of the name are kept
+  } count;
+  bool element; ///< the children are kept as TinyXML elements
+  const std::map<std::string_view, SStreamedChild>* children; ///< the children read in turn
+};
+
+const std::map<std::string_view, SStreamedChild> noChildren;
+
+const std::map<std::string_view, SStreamedChild> actorChildren = {
+    {"name", {SStreamedChild::FIRST, false, nullptr}},
+    {"order", {SStreamedChild::FIRST, false, nullptr}},
+    {"role", {SStreamedChild::FIRST, false, nullptr}},
+    {"thumb", {SStreamedChild::ALL, true, nullptr}},
+};
+
+const std::map<std::string_view, SStreamedChild> movieChildren = {
+    {"actor", {SStreamedChild::ALL, false, &actorChildren}},
+    {"aired", {SStreamedChild::FIRST, false, nullptr}},
+    {"album", {SStreamedChild::FIRST, false, nullptr}},
+    {"artist", {SStreamedChild::ALL, true, nullptr}},
+    {"basepath", {SStreamedChild::FIRST, false, nullptr}},
+    {"code", {SStreamedChild::FIRST, false, nullptr}},
+    {"country", {SStreamedChild::ALL, false, nullptr}},
+    {"credits", {SStreamedChild::ALL, false, nullptr}},
+    {"dateadded", {SStreamedChild::FIRST, false, nullptr}},
+    {"director", {SStreamedChild::ALL, false, nullptr}},
+    {"displayafterseason", {SStreamedChild::FIRST, false, nullptr}},
+    {"displayepisode", {SStreamedChild::FIRST, false, nullptr}},
+    {"displayseason", {SStreamedChild::FIRST, false, nullptr}},
+    {"epbookmark", {SStreamedChild::FIRST, false, nullptr}},
+    {"episode", {SStreamedChild::FIRST, false, nullptr}},
+    {"episodebookmark", {SStreamedChild::FIRST, true, nullptr}},
+    {"episodeguide", {SStreamedChild::FIRST, true, nullptr}},
+    {"fanart", {SStreamedChild::FIRST, true, nullptr}},
+    {"file", {SStreamedChild::FIRST, false, nullptr}},
+    {"fileinfo", {SStreamedChild::FIRST, true, nullptr}},
+    {"filenameandpath", {SStreamedChild::FIRST, false, nullptr}},
+    {"genre", {SStreamedChild::ALL, false, nullptr}},
+    {"id", {SStreamedChild::FIRST, false, nullptr}},
+    {"lastplayed", {SStreamedChild::FIRST, false, nullptr}},
+    {"mpaa", {SStreamedChild::FIRST, false, nullptr}},
+    {"namedseason", {SStreamedChild::ALL, true, nullptr}},
+    {"originaltitle", {SStreamedChild::FIRST, false, nullptr}},
+    {"outline", {SStreamedChild::FIRST, false, nullptr}},
+    {"path", {SStreamedChild::FIRST, false, nullptr}},
+    {"playcount", {SStreamedChild::FIRST, false, nullptr}},
+    {"plot", {SStreamedChild::FIRST, false, nullptr}},
+    {"premiered", {SStreamedChild::FIRST, false, nullptr}},
+    {"rating", {SStreamedChild::FIRST, false, nullptr}},
+    {"ratings", {SStreamedChild::FIRST, true, nullptr}},
+    {"resume", {SStreamedChild::FIRST, true, nullptr}},
+    {"runtime", {SStreamedChild::FIRST, false, nullptr}},
+    {"season", {SStreamedChild::FIRST, false, nullptr}},
+    {"set", {SStreamedChild::FIRST, true, nullptr}},
+    {"showlink", {SStreamedChild::ALL, false, nullptr}},
+    {"showtitle", {SStreamedChild::FIRST, false, nullptr}},
+    {"sorttitle", {SStreamedChild::FIRST, false, nullptr}},
+    {"status", {SStreamedChild::FIRST, false, nullptr}},
+    {"studio", {SStreamedChild::ALL, false, nullptr}},
+    {"tag", {SStreamedChild::ALL, false, nullptr}},
+    {"tagline", {SStreamedChild::FIRST, false, nullptr}},
+    {"thumb", {SStreamedChild::ALL, true, nullptr}},
+    {"title", {SStreamedChild::FIRST, false, nullptr}},
+    {"top250", {SStreamedChild::FIRST, false, nullptr}},
+    {"track", {SStreamedChild::FIRST, false, nullptr}},
+    {"trailer", {SStreamedChild::FIRST, false, nullptr}},
+    {"uniqueid", {SStreamedChild::ALL, true, nullptr}},
+    {"userrating", {SStreamedChild::FIRST, false, nullptr}},
+    {"videoassetid", {SStreamedChild::FIRST, false, nullptr}},
+    {"videoassettitle", {SStreamedChild::FIRST, false, nullptr}},
+    {"videoassettype", {SStreamedChild::FIRST, false, nullptr}},
+    {"votes", {SStreamedChild::FIRST, false, nullptr}},
+    {"year", {SStreamedChild::FIRST, false, nullptr}},
+};
+
+/* Read the children of the element started last, keeping those described by children.
+   Returns false if the document can't be read, or if ParseNative() might read the parsed
+   element otherwise: a text or comment of the name of a tag is found by FirstChild(), and
+   XMLUtils::GetStringArray() doesn't return on a tag of an empty value. */
+bool ReadChildren(CXMLStreamReader& reader,
+                  const std::map<std::string_view, SStreamedChild>& children,
+                  SStreamedElement& element)
+{
+  using Node = CXMLStreamReader::Node;
+
+  while (true)
+  {
+    switch (reader.Next())
+    {
+      case Node::START_ELEMENT:
+      {
+        if (!element.hasChild)
+        {
+          element.hasChild = true;
+          element.value = reader.Name();
+        }
+
+        const auto it = children.find(reader.Name());
+        if (it == children.end())
+        {
+          if (!reader.SkipElement())
+            return false;
+          break;
+        }
+
+        const SStreamedChild& read = it->second;
+        auto& kept = element.children[std::string(reader.Name())];
+        if (read.count == SStreamedChild::FIRST && !kept.empty())
+        {
+          if (!reader.SkipElement())
+            return false;
+          break;
+        }
+
+        SStreamedElement& child = kept.emplace_back();
+        child.attributes = reader.GetAttributes();
+        if (read.element)
+        {
+          child.element = reader.ReadElement();
+          if (!child.element)
+            return false;
+          if (const TiXmlNode* first = child.element->FirstChild())
+          {
+            child.hasChild = true;
+            child.value = first->ValueStr();
+          }
+        }
+        else if (!ReadChildren(reader, read.children ? *read.children : noChildren, child))
+          return false;
+        else if (read.count == SStreamedChild::ALL && !read.children && child.hasChild &&
+                 child.value.empty())
+          return false;
+        break;
+      }
+      case Node::END_ELEMENT:
+        return true;
+      case Node::CHARACTERS:
+      case Node::CDATA:
+      case Node::COMMENT:
+        if (!element.hasChild)
+        {
+          element.hasChild = true;
+          element.value = reader.Value();
+        }
+        if (children.find(reader.Value()) != children.end())
+          return false;
+        break;
+      default:
+        return false;
+    }
+  }
+}
+
+const SStreamedElement* FirstChildElement(const SStreamedElement* element, std::string_view tag)
+{
+  const auto it = element->children.find(tag);
+  return it != element->children.end() && !it->second.empty() ? &it->second.front() : nullptr;
+}
+
+const char* Attribute(const SStreamedElement* element, std::string_view name)
+{
+  for (const auto& [attribute, value] : element->attributes)
+  {
+    if (attribute == name)
+      return value.c_str();
+  }
+  return nullptr;
+}
+
+const char* Attribute(const TiXmlElement* element, const char* name)
+{
+  return element->Attribute(name);
+}
+
+bool HasChild(const SStreamedElement* element)
+{
+  return element->hasChild;
+}
+
+bool HasChild(const TiXmlElement* element)
+{
+  return element->FirstChild() != nullptr;
+}
+
+bool GetString(const SStreamedElement* element, const char* tag, std::string& value)
+{
+  const SStreamedElement* child = FirstChildElement(element, tag);
+  if (!child)
+    return false;
+
+  if (child->hasChild)
+  {
+    value = child->value;
+    const char* encoded = Attribute(child, "urlencoded");
+    if (encoded && StringUtils::CompareNoCase(encoded, "yes") == 0)
+      value = CURL::Decode(value);
+    return true;
+  }
+  value.clear();
+  return true;
+}
+
+bool GetString(const TiXmlElement* element, const char* tag, std::string& value)
+{
+  return XMLUtils::GetString(element, tag, value);
+}
+
+//! The value of the first child of the first child of the name, as read by FirstChild()
+bool GetChildValue(const SStreamedElement* element, const char* tag, std::string& value)
+{
+  const SStreamedElement* child = FirstChildElement(element, tag);
+  if (!child || !child->hasChild)
+    return false;
+  value = child->value;
+  return true;
+}
+
+bool GetChildValue(const TiXmlElement* element, const char* tag, std::string& value)
+{
+  const TiXmlNode* child = element->FirstChild(tag);
+  if (!child || !child->FirstChild())
+    return false;
+  value = child->FirstChild()->Value();
+  return true;
+}
+
+bool GetInt(const SStreamedElement* element, const char* tag, int& value)
+{
+  std::string child;
+  if (!GetChildValue(element, tag, child))
+    return false;
+  value = atoi(child.c_str());
+  return true;
+}
+
+bool GetInt(const TiXmlElement* element, const char* tag, int& value)
+{
+  return XMLUtils::GetInt(element, tag, value);
+}
+
+bool GetFloat(const SStreamedElement* element, const char* tag, float& value)
+{
+  std::string child;
+  if (!GetChildValue(element, tag, child))
+    return false;
+  value = static_cast<float>(atof(child.c_str()));
+  return true;
+}
+
+bool GetFloat(const TiXmlElement* element, const char* tag, float& value)
+{
+  return XMLUtils::GetFloat(element, tag, value);
+}
+
+bool GetDouble(const SStreamedElement* element, const char* tag, double& value)
+{
+  std::string child;
+  if (!GetChildValue(element, tag, child))
+    return false;
+  value = atof(child.c_str());
+  return true;
+}
+
+bool GetDouble(const TiXmlElement* element, const char* tag, double& value)
+{
+  return XMLUtils::GetDouble(element, tag, value);
+}
+
+bool GetDate(const SStreamedElement* element, const char* tag, CDateTime& date)
+{
+  std::string value;
+  if (GetString(element, tag, value) && !value.empty())
+  {
+    date.SetFromDBDate(value);
+    return true;
+  }
+  return false;
+}
+
+bool GetDate(const TiXmlElement* element, const char* tag, CDateTime& date)
+{
+  return XMLUtils::GetDate(element, tag, date);
+}
+
+bool GetDateTime(const SStreamedElement* element, const char* tag, CDateTime& dateTime)
+{
+  std::string value;
+  if (GetString(element, tag, value) && !value.empty())
+  {
+    dateTime.SetFromDBDateTime(value);
+    return true;
+  }
+  return false;
+}
+
+bool GetDateTime(const TiXmlElement* element, const char* tag, CDateTime& dateTime)
+{
+  return XMLUtils::GetDateTime(element, tag, dateTime);
+}
+
+bool GetStringArray(const SStreamedElement* element,
+                    const char* tag,
+                    std::vector<std::string>& values,
+                    bool clear,
+                    const std::string& separator)
+{
+  const auto it = element->children.find(tag);
+  if (it == element->children.end() || it->second.empty())
+    return false;
+
+  bool result = false;
+  if (it->second.front().hasChild && clear)
+    values.clear();
+  for (const SStreamedElement& child : it->second)
+  {
+    if (!child.hasChild)
+      continue;
+
+    result = true;
+    const char* clearAttr = Attribute(&child, "clear");
+    if (clearAttr && StringUtils::CompareNoCase(clearAttr, "true") == 0)
+      values.clear();
+
+    if (separator.empty())
+      values.push_back(child.value);
+    else
+    {
+      std::vector<std::string> split = StringUtils::Split(child.value, separator);
+      values.insert(values.end(), split.begin(), split.end());
+    }
+  }
+  return result;
+}
+
+bool GetStringArray(const TiXmlElement* element,
+                    const char* tag,
+                    std::vector<std::string>& values,
+                    bool clear,
+                    const std::string& separator)
+{
+  return XMLUtils::GetStringArray(element, tag, values, clear, separator);
+}
+
+//! The value of an int attribute of the first child of the name
+bool GetIntAttribute(const SStreamedElement* element,
+                     const char* tag,
+                     const char* name,
+                     int& value)
+{
+  const SStreamedElement* child = FirstChildElement(element, tag);
+  const char* attribute = child ? Attribute(child, name) : nullptr;
+  return attribute && sscanf(attribute, "%d", &value) == 1;
+}
+
+bool GetIntAttribute(const TiXmlElement* element, const char* tag, const char* name, int& value)
+{
+  const TiXmlElement* child = element->FirstChildElement(tag);
+  return child && child->QueryIntAttribute(name, &value) == TIXML_SUCCESS;
+}
+
+//! The first child of the name, for the tags parsed as TinyXML
+const TiXmlElement* GetElement(const SStreamedElement* element, const char* tag)
+{
+  const SStreamedElement* child = FirstChildElement(element, tag);
+  return child ? child->element.get() : nullptr;
+}
+
+const TiXmlElement* GetElement(const TiXmlElement* element, const char* tag)
+{
+  return element->FirstChildElement(tag);
+}
+
+//! The first child node of the name, for the tags parsed as TinyXML
+const TiXmlNode* GetNode(const SStreamedElement* element, const char* tag)
+{
+  return GetElement(element, tag);
+}
+
+const TiXmlNode* GetNode(const TiXmlElement* element, const char* tag)
+{
+  return element->FirstChild(tag);
+}
+
+//! The children of the name, for the tags parsed as TinyXML
+std::vector<const TiXmlElement*> GetElements(const SStreamedElement* element, const char* tag)
+{
+  std::vector<const TiXmlElement*> elements;
+  const auto it = element->children.find(tag);
+  if (it != element->children.end())
+  {
+    for (const SStreamedElement& child : it->second)
+      elements.push_back(child.element.get());
+  }
+  return elements;
+}
+
+std::vector<const TiXmlElement*> GetElements(const TiXmlElement* element, const char* tag)
+{
+  std::vector<const TiXmlElement*> elements;
+  for (const TiXmlElement* child = element->FirstChildElement(tag); child;
+       child = child->NextSiblingElement(tag))
+    elements.push_back(child);
+  return elements;
+}
+
+//! The children of the name, for the tags read in turn
+std::vector<const SStreamedElement*> GetChildren(const SStreamedElement* element, const char* tag)
+{
+  std::vector<const SStreamedElement*> children;
+  const auto it = element->children.find(tag);
+  if (it != element->children.end())
+  {
+    for (const SStreamedElement& child : it->second)
+      children.push_back(&child);
+  }
+  return children;
+}
+
+std::vector<const TiXmlElement*> GetChildren(const TiXmlElement* element, const char* tag)
+{
+  return GetElements(element, tag);
+}
+} // namespace
+
 void CVideoInfoTag::Reset()
 {
   m_director.clear();
@@ -333,6 +781,54 @@ bool CVideoInfoTag::Load(const TiXmlElement *element, bool append, bool prioriti
   return true;
 }
 
+struct CVideoInfoTag::SXMLDetails
+{
+  SStreamedElement movie;
+};
+
+bool CVideoInfoTag::LoadFromXML(std::string_view document,
+                                bool append,
+                                bool prioritise,
+                                std::string_view rootName)
+{
+  const auto details = ReadXML(document, rootName);
+  if (!details)
+    return false;
+
+  LoadFromXML(*details, append, prioritise);
+  return true;
+}
+
+std::shared_ptr<const CVideoInfoTag::SXMLDetails> CVideoInfoTag::ReadXML(
+    std::string_view document, std::string_view rootName)
+{
+  using Node = CXMLStreamReader::Node;
+
+  CXMLStreamReader reader(document);
+  Node node;
+  while ((node = reader.Next()) == Node::COMMENT)
+  {
+    // a comment of that name would be found instead of the root element
+    if (!rootName.empty() && reader.Value() == rootName)
+      return nullptr;
+  }
+  if (node != Node::START_ELEMENT || (!rootName.empty() && reader.Name() != rootName))
+    return nullptr;
+
+  auto details = std::make_shared<SXMLDetails>();
+  if (!ReadChildren(reader, movieChildren, details->movie) || reader.Next() != Node::END_DOCUMENT)
+    return nullptr;
+
+  return details;
+}
+
+void CVideoInfoTag::LoadFromXML(const SXMLDetails& details, bool append, bool prioritise)
+{
+  if (!append)
+    Reset();
+  ParseNative(&details.movie, prioritise);
+}
+
 void CVideoInfoTag::Merge(CVideoInfoTag& other)
 {
   if (!other.m_director.empty())
@@ -998,24 +1494,25 @@ const std::string CVideoInfoTag::GetCast(bool bIncludeRole /*= false*/) const
   return StringUtils::TrimRight(strLabel, "\n");
 }
 
-void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
+template<typename Element>
+void CVideoInfoTag::ParseNative(const Element* movie, bool prioritise)
 {
   std::string value;
   float fValue;
 
-  if (XMLUtils::GetString(movie, "title", value))
+  if (GetString(movie, "title", value))
     SetTitle(value);
 
-  if (XMLUtils::GetString(movie, "originaltitle", value))
+  if (GetString(movie, "originaltitle", value))
     SetOriginalTitle(value);
 
-  if (XMLUtils::GetString(movie, "showtitle", value))
+  if (GetString(movie, "showtitle", value))
     SetShowTitle(value);
 
-  if (XMLUtils::GetString(movie, "sorttitle", value))
+  if (GetString(movie, "sorttitle", value))
     SetSortTitle(value);
 
-  const TiXmlElement* node = movie->FirstChildElement("ratings");
+  const TiXmlElement* node = GetElement(movie, "ratings");
   if (node)
   {
     for (const TiXmlElement* child = node->FirstChildElement("rating"); child != nullptr; child = child->NextSiblingElement("rating"))
@@ -1039,21 +1536,20 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
         m_strDefaultRating = name;
     }
   }
-  else if (XMLUtils::GetFloat(movie, "rating", fValue))
+  else if (GetFloat(movie, "rating", fValue))
   {
     CRating r(fValue, 0);
-    if (XMLUtils::GetString(movie, "votes", value))
+    if (GetString(movie, "votes", value))
       r.votes = StringUtils::ReturnDigits(value);
     int max_value = 10;
-    const TiXmlElement* rElement = movie->FirstChildElement("rating");
-    if (rElement && (rElement->QueryIntAttribute("max", &max_value) == TIXML_SUCCESS) && max_value >= 1)
+    if (GetIntAttribute(movie, "rating", "max", max_value) && max_value >= 1)
       r.rating = r.rating / max_value * 10; // Normalise the Movie Rating to between 1 and 10
     SetRating(r, "default");
     m_strDefaultRating = "default";
   }
-  XMLUtils::GetInt(movie, "userrating", m_iUserRating);
+  GetInt(movie, "userrating", m_iUserRating);
 
-  const TiXmlElement *epbookmark = movie->FirstChildElement("episodebookmark");
+  const TiXmlElement *epbookmark = GetElement(movie, "episodebookmark");
   if (epbookmark)
   {
     XMLUtils::GetDouble(epbookmark, "position", m_EpBookmark.timeInSeconds);
@@ -1066,61 +1562,60 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
     }
   }
   else
-    XMLUtils::GetDouble(movie, "epbookmark", m_EpBookmark.timeInSeconds);
+    GetDouble(movie, "epbookmark", m_EpBookmark.timeInSeconds);
 
   int max_value = 10;
-  const TiXmlElement* urElement = movie->FirstChildElement("userrating");
-  if (urElement && (urElement->QueryIntAttribute("max", &max_value) == TIXML_SUCCESS) && max_value >= 1)
+  if (GetIntAttribute(movie, "userrating", "max", max_value) && max_value >= 1)
     m_iUserRating = m_iUserRating / max_value * 10; // Normalise the user Movie Rating to between 1 and 10
-  XMLUtils::GetInt(movie, "top250", m_iTop250);
-  XMLUtils::GetInt(movie, "season", m_iSeason);
-  XMLUtils::GetInt(movie, "episode", m_iEpisode);
-  XMLUtils::GetInt(movie, "track", m_iTrack);
+  GetInt(movie, "top250", m_iTop250);
+  GetInt(movie, "season", m_iSeason);
+  GetInt(movie, "episode", m_iEpisode);
+  GetInt(movie, "track", m_iTrack);
 
-  XMLUtils::GetInt(movie, "displayseason", m_iSpecialSortSeason);
-  XMLUtils::GetInt(movie, "displayepisode", m_iSpecialSortEpisode);
+  GetInt(movie, "displayseason", m_iSpecialSortSeason);
+  GetInt(movie, "displayepisode", m_iSpecialSortEpisode);
   int after=0;
-  XMLUtils::GetInt(movie, "displayafterseason",after);
+  GetInt(movie, "displayafterseason",after);
   if (after > 0)
   {
     m_iSpecialSortSeason = after;
     m_iSpecialSortEpisode = 0x1000; // should be more than any realistic episode number
   }
 
-  if (XMLUtils::GetString(movie, "outline", value))
+  if (GetString(movie, "outline", value))
     SetPlotOutline(value);
 
-  if (XMLUtils::GetString(movie, "plot", value))
+  if (GetString(movie, "plot", value))
     SetPlot(value);
 
-  if (XMLUtils::GetString(movie, "tagline", value))
+  if (GetString(movie, "tagline", value))
     SetTagLine(value);
 
 
-  if (XMLUtils::GetString(movie, "runtime", value) && !value.empty())
+  if (GetString(movie, "runtime", value) && !value.empty())
     m_duration = GetDurationFromMinuteString(StringUtils::Trim(value));
 
-  if (XMLUtils::GetString(movie, "mpaa", value))
+  if (GetString(movie, "mpaa", value))
     SetMPAARating(value);
 
-  XMLUtils::GetInt(movie, "playcount", m_playCount);
-  XMLUtils::GetDate(movie, "lastplayed", m_lastPlayed);
+  GetInt(movie, "playcount", m_playCount);
+  GetDate(movie, "lastplayed", m_lastPlayed);
 
-  if (XMLUtils::GetString(movie, "file", value))
+  if (GetString(movie, "file", value))
     SetFile(value);
 
-  if (XMLUtils::GetString(movie, "path", value))
+  if (GetString(movie, "path", value))
     SetPath(value);
 
-  const TiXmlElement* uniqueid = movie->FirstChildElement("uniqueid");
-  if (uniqueid == nullptr)
+  const std::vector<const TiXmlElement*> uniqueids = GetElements(movie, "uniqueid");
+  if (uniqueids.empty())
   {
-    if (XMLUtils::GetString(movie, "id", value))
+    if (GetString(movie, "id", value))
       SetUniqueID(value);
   }
   else
   {
-    for (; uniqueid != nullptr; uniqueid = uniqueid->NextSiblingElement("uniqueid"))
+    for (const TiXmlElement* uniqueid : uniqueids)
     {
       if (uniqueid->FirstChild())
       {
@@ -1138,35 +1633,35 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
     }
   }
 
-  if (XMLUtils::GetString(movie, "filenameandpath", value))
+  if (GetString(movie, "filenameandpath", value))
     SetFileNameAndPath(value);
 
-  if (XMLUtils::GetDate(movie, "premiered", m_premiered))
+  if (GetDate(movie, "premiered", m_premiered))
   {
     m_bHasPremiered = true;
   }
   else
   {
     int year;
-    if (XMLUtils::GetInt(movie, "year", year))
+    if (GetInt(movie, "year", year))
       SetYear(year);
   }
 
-  if (XMLUtils::GetString(movie, "status", value))
+  if (GetString(movie, "status", value))
     SetStatus(value);
 
-  if (XMLUtils::GetString(movie, "code", value))
+  if (GetString(movie, "code", value))
     SetProductionCode(value);
 
-  XMLUtils::GetDate(movie, "aired", m_firstAired);
+  GetDate(movie, "aired", m_firstAired);
 
-  if (XMLUtils::GetString(movie, "album", value))
+  if (GetString(movie, "album", value))
     SetAlbum(value);
 
-  if (XMLUtils::GetString(movie, "trailer", value))
+  if (GetString(movie, "trailer", value))
     SetTrailer(value);
 
-  if (XMLUtils::GetString(movie, "basepath", value))
+  if (GetString(movie, "basepath", value))
     SetBasePath(value);
 
   // make sure the picture URLs have been parsed
@@ -1174,8 +1669,7 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
   size_t iThumbCount = m_strPictureURL.GetUrls().size();
   std::string xmlAdd = m_strPictureURL.GetData();
 
-  const TiXmlElement* thumb = movie->FirstChildElement("thumb");
-  while (thumb)
+  for (const TiXmlElement* thumb : GetElements(movie, "thumb"))
   {
     m_strPictureURL.ParseAndAppendUrl(thumb);
     if (prioritise)
@@ -1184,7 +1678,6 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
       temp << *thumb;
       xmlAdd = temp+xmlAdd;
     }
-    thumb = thumb->NextSiblingElement("thumb");
   }
 
   // prioritise thumbs from nfos
@@ -1199,27 +1692,26 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
   const std::string itemSeparator = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator;
 
   std::vector<std::string> genres(m_genre);
-  if (XMLUtils::GetStringArray(movie, "genre", genres, prioritise, itemSeparator))
+  if (GetStringArray(movie, "genre", genres, prioritise, itemSeparator))
     SetGenre(genres);
 
   std::vector<std::string> country(m_country);
-  if (XMLUtils::GetStringArray(movie, "country", country, prioritise, itemSeparator))
+  if (GetStringArray(movie, "country", country, prioritise, itemSeparator))
     SetCountry(country);
 
   std::vector<std::string> credits(m_writingCredits);
-  if (XMLUtils::GetStringArray(movie, "credits", credits, prioritise, itemSeparator))
+  if (GetStringArray(movie, "credits", credits, prioritise, itemSeparator))
     SetWritingCredits(credits);
 
   std::vector<std::string> director(m_director);
-  if (XMLUtils::GetStringArray(movie, "director", director, prioritise, itemSeparator))
+  if (GetStringArray(movie, "director", director, prioritise, itemSeparator))
     SetDirector(director);
 
   std::vector<std::string> showLink(m_showLink);
-  if (XMLUtils::GetStringArray(movie, "showlink", showLink, prioritise, itemSeparator))
+  if (GetStringArray(movie, "showlink", showLink, prioritise, itemSeparator))
     SetShowLink(showLink);
 
-  const TiXmlElement* namedSeason = movie->FirstChildElement("namedseason");
-  while (namedSeason != nullptr)
+  for (const TiXmlElement* namedSeason : GetElements(movie, "namedseason"))
   {
     if (namedSeason->FirstChild() != nullptr)
     {
@@ -1229,48 +1721,38 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
           namedSeason->Attribute("number", &seasonNumber) != nullptr)
         m_namedSeasons.insert(std::make_pair(seasonNumber, seasonName));
     }
-
-    namedSeason = namedSeason->NextSiblingElement("namedseason");
   }
 
   // cast
-  node = movie->FirstChildElement("actor");
-  if (node && node->FirstChild() && prioritise)
+  const auto actors = GetChildren(movie, "actor");
+  if (!actors.empty() && HasChild(actors.front()) && prioritise)
     m_cast.clear();
-  while (node)
+  for (const auto* actor : actors)
   {
-    const TiXmlNode *actor = node->FirstChild("name");
-    if (actor && actor->FirstChild())
+    SActorInfo info;
+    if (GetChildValue(actor, "name", info.strName))
     {
-      SActorInfo info;
-      info.strName = actor->FirstChild()->Value();
-
-      if (XMLUtils::GetString(node, "role", value))
+      if (GetString(actor, "role", value))
         info.strRole = StringUtils::Trim(value);
 
-      XMLUtils::GetInt(node, "order", info.order);
-      const TiXmlElement* thumb = node->FirstChildElement("thumb");
-      while (thumb)
-      {
+      GetInt(actor, "order", info.order);
+      for (const TiXmlElement* thumb : GetElements(actor, "thumb"))
         info.thumbUrl.ParseAndAppendUrl(thumb);
-        thumb = thumb->NextSiblingElement("thumb");
-      }
-      const char* clear=node->Attribute("clear");
+      const char* clear = Attribute(actor, "clear");
       if (clear && StringUtils::CompareNoCase(clear, "true"))
         m_cast.clear();
       m_cast.push_back(info);
     }
-    node = node->NextSiblingElement("actor");
   }
 
   // Pre-Jarvis NFO file:
   // <set>A set</set>
   m_updateSetOverview = false;
-  if (XMLUtils::GetString(movie, "set", value))
+  if (GetString(movie, "set", value))
     SetSet(value);
   // Jarvis+:
   // <set><name>A set</name><overview>A set with a number of movies...</overview></set>
-  node = movie->FirstChildElement("set");
+  node = GetElement(movie, "set");
   if (node)
   {
     // No name, no set
@@ -1286,21 +1768,21 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
   }
 
   std::vector<std::string> tags(m_tags);
-  if (XMLUtils::GetStringArray(movie, "tag", tags, prioritise, itemSeparator))
+  if (GetStringArray(movie, "tag", tags, prioritise, itemSeparator))
     SetTags(tags);
 
   m_assetInfo.ParseNative(movie);
 
   std::vector<std::string> studio(m_studio);
-  if (XMLUtils::GetStringArray(movie, "studio", studio, prioritise, itemSeparator))
+  if (GetStringArray(movie, "studio", studio, prioritise, itemSeparator))
     SetStudio(studio);
 
   // artists
   std::vector<std::string> artist(m_artist);
-  node = movie->FirstChildElement("artist");
-  if (node && node->FirstChild() && prioritise)
+  const std::vector<const TiXmlElement*> artists = GetElements(movie, "artist");
+  if (!artists.empty() && artists.front()->FirstChild() && prioritise)
     artist.clear();
-  while (node)
+  for (const TiXmlElement* node : artists)
   {
     const TiXmlNode* pNode = node->FirstChild("name");
     const char* pValue=NULL;
@@ -1316,11 +1798,10 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
       std::vector<std::string> newArtists = StringUtils::Split(pValue, itemSeparator);
       artist.insert(artist.end(), newArtists.begin(), newArtists.end());
     }
-    node = node->NextSiblingElement("artist");
   }
   SetArtist(artist);
 
-  node = movie->FirstChildElement("fileinfo");
+  node = GetElement(movie, "fileinfo");
   if (node)
   {
     // Try to pull from fileinfo/streamdetails/[video|audio|subtitle]
@@ -1381,7 +1862,7 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
 
   if (m_strEpisodeGuide.empty())
   {
-    const TiXmlElement* epguide = movie->FirstChildElement("episodeguide");
+    const TiXmlElement* epguide = GetElement(movie, "episodeguide");
     if (epguide)
     {
       // DEPRECIATE ME - support for old XML-encoded <episodeguide> blocks.
@@ -1400,7 +1881,7 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
   }
 
   // fanart
-  const TiXmlElement *fanart = movie->FirstChildElement("fanart");
+  const TiXmlElement *fanart = GetElement(movie, "fanart");
   if (fanart)
   {
     // we prioritise mixed-mode nfo's with fanart set
@@ -1416,7 +1897,7 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
   }
 
   // resumePoint
-  const TiXmlNode *resume = movie->FirstChild("resume");
+  const TiXmlNode* resume = GetNode(movie, "resume");
   if (resume)
   {
     XMLUtils::GetDouble(resume, "position", m_resumePoint.timeInSeconds);
@@ -1430,7 +1911,7 @@ void CVideoInfoTag::ParseNative(const TiXmlElement* movie, bool prioritise)
     }
   }
 
-  XMLUtils::GetDateTime(movie, "dateadded", m_dateAdded);
+  GetDateTime(movie, "dateadded", m_dateAdded);
 }
 
 bool CVideoInfoTag::HasStreamDetails() const
@@ -1860,16 +2341,17 @@ void CVideoInfoTag::CAssetInfo::Save(TiXmlNode* movie)
   XMLUtils::SetInt(movie, "videoassettype", static_cast<int>(m_type));
 }
 
-void CVideoInfoTag::CAssetInfo::ParseNative(const TiXmlElement* movie)
+template<typename Element>
+void CVideoInfoTag::CAssetInfo::ParseNative(const Element* movie)
 {
   std::string value;
-  if (XMLUtils::GetString(movie, "videoassettitle", value))
+  if (GetString(movie, "videoassettitle", value))
     m_title = value;
 
-  XMLUtils::GetInt(movie, "videoassetid", m_id);
+  GetInt(movie, "videoassetid", m_id);
 
   int assetType{-1};
-  XMLUtils::GetInt(movie, "videoassettype", assetType);
+  GetInt(movie, "videoassettype", assetType);
   m_type = static_cast<VideoAssetType>(assetType);
 }
 
@@ -16,7 +16,9 @@
 #include "utils/StreamDetails.h"
 #include "video/Bookmark.h"
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class CArchive;
@@ -72,6 +74,40 @@ public:
    \sa ParseNative
    */
   bool Load(const TiXmlElement *element, bool append = false, bool prioritise = false);
+  /* \brief Load information to a videoinfotag from an XML document, reading it in one pass
+   The tags are loaded as Load does, without parsing the whole document.
+
+   \param document   the UTF-8 XML document to read.
+   \param append     whether information should be added to the existing tag, or whether it should be reset first.
+   \param prioritise if appending, whether additive tags should be prioritised over existing values.
+   \param rootName   the name the root element must have, any name if empty.
+   \return false if the document can't be read this way, leaving the tag untouched: parse it and call Load instead.
+   \sa Load, CXMLStreamReader
+   */
+  bool LoadFromXML(std::string_view document,
+                   bool append = false,
+                   bool prioritise = false,
+                   std::string_view rootName = {});
+
+  //! The tags of an XML document read by ReadXML(), loaded by LoadFromXML()
+  struct SXMLDetails;
+
+  /* \brief Read the tags of an XML document in one pass, to load them later
+   \param document   the UTF-8 XML document to read.
+   \param rootName   the name the root element must have, any name if empty.
+   \return the tags read, nullptr if the document can't be read this way: parse it and call Load instead.
+   \sa LoadFromXML
+   */
+  static std::shared_ptr<const SXMLDetails> ReadXML(std::string_view document,
+                                                    std::string_view rootName = {});
+
+  /* \brief Load information to a videoinfotag from the tags of an XML document read by ReadXML()
+   \param details    the tags read.
+   \param append     whether information should be added to the existing tag, or whether it should be reset first.
+   \param prioritise if appending, whether additive tags should be prioritised over existing values.
+   \sa ReadXML
+   */
+  void LoadFromXML(const SXMLDetails& details, bool append = false, bool prioritise = false);
   bool Save(TiXmlNode *node, const std::string &tag, bool savePathInfo = true, const TiXmlElement *additionalNode = NULL);
   void Merge(CVideoInfoTag& other);
   void Archive(CArchive& ar) override;
@@ -229,9 +265,10 @@ public:
 
     /*!
      * @brief Restore all data from XML.
-     * @param movie The XML element containing the data.
+     * @param movie The XML element containing the data, parsed or read by LoadFromXML().
      */
-    void ParseNative(const TiXmlElement* movie);
+    template<typename Element>
+    void ParseNative(const Element* movie);
 
     /*!
      * @brief Merge in all valid data from another asset info.
@@ -419,11 +456,12 @@ private:
   /* \brief Parse our native XML format for video info.
    See Load for a description of the available tag types.
 
-   \param element    the root XML element to parse.
+   \param element    the root XML element to parse, a TiXmlElement or the element read by LoadFromXML.
    \param prioritise whether additive tags should be replaced (or prepended) by the content of the tags, or appended to.
    \sa Load
    */
-  void ParseNative(const TiXmlElement* element, bool prioritise);
+  template<typename Element>
+  void ParseNative(const Element* element, bool prioritise);
 
   std::string m_strDefaultRating;
   std::string m_strDefaultUniqueID;
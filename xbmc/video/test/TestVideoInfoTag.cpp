@@ -0,0 +1,265 @@
+/*
+ *  Copyright (C) 2024 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/XBMCTinyXML.h"
+#include "video/VideoInfoTag.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::vector<std::string> documents = {
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+    "<!-- created by a media manager -->\n"
+    "<movie>\n"
+    "  <title urlencoded=\"yes\">The%20Title</title>\n"
+    "  <title>A second title is not read</title>\n"
+    "  <originaltitle>  Le   Titre  </originaltitle>\n"
+    "  <sorttitle><![CDATA[Title, The]]></sorttitle>\n"
+    "  <ratings>\n"
+    "    <rating name=\"imdb\" max=\"10\" default=\"true\"><value>7.5</value>"
+    "<votes>12,345</votes></rating>\n"
+    "    <rating name=\"tmdb\" max=\"5\"><value>4</value><votes>67</votes></rating>\n"
+    "    <rating default=\"\"><value>6</value></rating>\n"
+    "  </ratings>\n"
+    "  <userrating max=\"5\">4</userrating>\n"
+    "  <top250>42</top250>\n"
+    "  <outline>An outline &amp; more, with &lt;entities&gt; &#x41;&#66; & an invalid one"
+    "</outline>\n"
+    "  <plot>Line one.\r\n\r\nLine two.<!-- a comment --> After the comment.</plot>\n"
+    "  <tagline/>\n"
+    "  <runtime> 128 </runtime>\n"
+    "  <mpaa>Rated PG-13</mpaa>\n"
+    "  <playcount>2</playcount>\n"
+    "  <lastplayed>2023-05-06</lastplayed>\n"
+    "  <file/>\n"
+    "  <path>smb://server/movies/</path>\n"
+    "  <filenameandpath>smb://server/movies/movie.mkv</filenameandpath>\n"
+    "  <basepath>smb://server/movies/movie.mkv</basepath>\n"
+    "  <uniqueid type=\"imdb\" default=\"true\">tt0000001</uniqueid>\n"
+    "  <uniqueid type=\"tmdb\">1</uniqueid>\n"
+    "  <uniqueid>no type</uniqueid>\n"
+    "  <uniqueid type=\"empty\"/>\n"
+    "  <premiered>2001-02-03</premiered>\n"
+    "  <year>1999</year>\n"
+    "  <status>Released</status>\n"
+    "  <code>ABC-1</code>\n"
+    "  <aired>2001-02-04</aired>\n"
+    "  <trailer>plugin://trailer/?id=1&amp;hd=1</trailer>\n"
+    "  <thumb aspect=\"poster\" preview=\"https://example.com/p/poster.jpg\">"
+    "https://example.com/poster.jpg</thumb>\n"
+    "  <thumb aspect=\"landscape\" spoof=\"https://example.com/\" cache=\"l.json\" post=\"yes\">"
+    "https://example.com/landscape.jpg</thumb>\n"
+    "  <thumb type=\"season\" season=\"1\" aspect=\"poster\">https://example.com/s1.jpg</thumb>\n"
+    "  <thumb/>\n"
+    "  <genre>Drama / Comedy</genre>\n"
+    "  <genre clear=\"true\">Action</genre>\n"
+    "  <genre/>\n"
+    "  <country>United States</country>\n"
+    "  <country>France</country>\n"
+    "  <credits>Writer One</credits>\n"
+    "  <director>Director One / Director Two</director>\n"
+    "  <showlink>A Show</showlink>\n"
+    "  <namedseason number=\"1\">The First Season</namedseason>\n"
+    "  <namedseason number=\"2\"/>\n"
+    "  <actor>\n"
+    "    <name>Actor One</name>\n"
+    "    <role>  Role One  </role>\n"
+    "    <order>0</order>\n"
+    "    <thumb>https://example.com/actor1.jpg</thumb>\n"
+    "    <thumb aspect=\"thumb\">https://example.com/actor1b.jpg</thumb>\n"
+    "  </actor>\n"
+    "  <actor><name>Actor Two</name><role>Role Two</role></actor>\n"
+    "  <actor><role>No name</role></actor>\n"
+    "  <actor clear=\"false\"><name>Actor Three</name><order>2</order></actor>\n"
+    "  <actor clear=\"true\"><name>Actor Four</name></actor>\n"
+    "  <set>\n"
+    "    <name>The Collection</name>\n"
+    "    <overview>The movies of the collection.</overview>\n"
+    "  </set>\n"
+    "  <tag>tag one</tag>\n"
+    "  <tag>tag two</tag>\n"
+    "  <videoassettitle>Director's Cut</videoassettitle>\n"
+    "  <videoassetid>40400</videoassetid>\n"
+    "  <videoassettype>1</videoassettype>\n"
+    "  <studio>Studio One</studio>\n"
+    "  <artist><name>Artist One</name></artist>\n"
+    "  <artist>Artist Two / Artist Three</artist>\n"
+    "  <artist clear=\"TRUE\">Artist Four</artist>\n"
+    "  <fileinfo>\n"
+    "    <streamdetails>\n"
+    "      <video><codec>HEVC</codec><aspect>2.39</aspect><width>3840</width>"
+    "<height>1608</height><durationinseconds>7680</durationinseconds>"
+    "<stereomode></stereomode><hdrtype>HDR10</hdrtype></video>\n"
+    "      <audio><codec>TrueHD</codec><language>ENG</language><channels>8</channels></audio>\n"
+    "      <audio><codec>ac3</codec><language>fre</language><channels>6</channels></audio>\n"
+    "      <subtitle><language>eng</language></subtitle>\n"
+    "    </streamdetails>\n"
+    "  </fileinfo>\n"
+    "  <fanart url=\"https://example.com/\">\n"
+    "    <thumb preview=\"p/fanart1.jpg\" colors=\"\">fanart1.jpg</thumb>\n"
+    "    <thumb>fanart2.jpg</thumb>\n"
+    "  </fanart>\n"
+    "  <resume><position>1234.5</position><total>7680</total>"
+    "<playerstate><nextsong>1</nextsong></playerstate></resume>\n"
+    "  <dateadded>2024-01-02 03:04:05</dateadded>\n"
+    "  <unknown><title>not read</title><actor><name>not read</name></actor></unknown>\n"
+    "</movie>\n",
+
+    "<episodedetails>\n"
+    "  <title><b>bold</b> title</title>\n"
+    "  <showtitle><!-- a comment first --></showtitle>\n"
+    "  <rating max=\"5\">3.5</rating>\n"
+    "  <votes>1,000</votes>\n"
+    "  <rating>not read</rating>\n"
+    "  <epbookmark>123.5</epbookmark>\n"
+    "  <season>2</season>\n"
+    "  <episode>3</episode>\n"
+    "  <displayseason>1</displayseason>\n"
+    "  <displayepisode>4</displayepisode>\n"
+    "  <displayafterseason>3</displayafterseason>\n"
+    "  <id>12345</id>\n"
+    "  <year>2005</year>\n"
+    "  <set>An Old Set</set>\n"
+    "  <episodeguide><url cache=\"guide.json\">https://example.com/guide</url></episodeguide>\n"
+    "  <actor><name>Guest</name><role>Himself</role></actor>\n"
+    "</episodedetails>",
+
+    "<episodedetails>\n"
+    "  <title>Bookmarked</title>\n"
+    "  <episodebookmark><position>42.5</position>"
+    "<playerstate><state a=\"1\"><b/></state></playerstate></episodebookmark>\n"
+    "  <epbookmark>not read</epbookmark>\n"
+    "  <track>7</track>\n"
+    "  <album>An Album</album>\n"
+    "  <episodeguide>&lt;episodeguide&gt;&lt;url&gt;https://example.com/old&lt;/url&gt;"
+    "&lt;/episodeguide&gt;</episodeguide>\n"
+    "  <set><overview>No name, no set</overview></set>\n"
+    "  <uniqueid>first</uniqueid>\n"
+    "</episodedetails>",
+
+    "<musicvideo>\n"
+    "  <title>  White   Space  \n  Condensed  </title>\n"
+    "  <artist><name></name>Artist</artist>\n"
+    "  <genre>Pop</genre>\n"
+    "  <track>3</track>\n"
+    "  <album>Unicode – 日本語 😀</album>\n"
+    "  <actor><name>Singer</name><thumb/></actor>\n"
+    "</musicvideo>\n",
+};
+
+std::string Save(CVideoInfoTag& details, const std::string& tag)
+{
+  CXBMCTinyXML doc;
+  details.Save(&doc, tag);
+  std::string saved;
+  saved << doc;
+  return saved;
+}
+
+// compare the details, including those not saved
+void ExpectSameDetails(CVideoInfoTag& expected, CVideoInfoTag& details)
+{
+  EXPECT_EQ(Save(expected, "episodedetails"), Save(details, "episodedetails"));
+  EXPECT_EQ(Save(expected, "musicvideo"), Save(details, "musicvideo"));
+  EXPECT_EQ(expected.m_strPictureURL.GetData(), details.m_strPictureURL.GetData());
+  EXPECT_EQ(expected.m_fanart.m_xml, details.m_fanart.m_xml);
+  EXPECT_EQ(expected.m_strEpisodeGuide, details.m_strEpisodeGuide);
+  EXPECT_EQ(expected.GetUpdateSetOverview(), details.GetUpdateSetOverview());
+  EXPECT_EQ(expected.GetDefaultUniqueID(), details.GetDefaultUniqueID());
+  ASSERT_EQ(expected.m_cast.size(), details.m_cast.size());
+  for (size_t i = 0; i < expected.m_cast.size(); i++)
+  {
+    EXPECT_EQ(expected.m_cast[i].strName, details.m_cast[i].strName);
+    EXPECT_EQ(expected.m_cast[i].strRole, details.m_cast[i].strRole);
+    EXPECT_EQ(expected.m_cast[i].order, details.m_cast[i].order);
+    EXPECT_EQ(expected.m_cast[i].thumbUrl.GetData(), details.m_cast[i].thumbUrl.GetData());
+  }
+}
+
+bool Load(CVideoInfoTag& details, const std::string& document, bool append, bool prioritise)
+{
+  CXBMCTinyXML doc;
+  doc.Parse(document, TIXML_ENCODING_UTF8);
+  return details.Load(doc.RootElement(), append, prioritise);
+}
+} // namespace
+
+TEST(TestVideoInfoTag, LoadFromXML)
+{
+  const bool condense = TiXmlBase::IsWhiteSpaceCondensed();
+  for (const bool condenseWhiteSpace : {true, false})
+  {
+    TiXmlBase::SetCondenseWhiteSpace(condenseWhiteSpace);
+    for (const auto& document : documents)
+    {
+      CVideoInfoTag expected;
+      ASSERT_TRUE(Load(expected, document, false, false));
+      CVideoInfoTag details;
+      ASSERT_TRUE(details.LoadFromXML(document)) << document;
+      ExpectSameDetails(expected, details);
+    }
+  }
+  TiXmlBase::SetCondenseWhiteSpace(condense);
+}
+
+TEST(TestVideoInfoTag, LoadFromXML_Append)
+{
+  // each document is loaded over the others, appended to or prioritised over them
+  for (const bool prioritise : {false, true})
+  {
+    for (const auto& first : documents)
+    {
+      for (const auto& document : documents)
+      {
+        CVideoInfoTag expected;
+        ASSERT_TRUE(Load(expected, first, false, false));
+        ASSERT_TRUE(Load(expected, document, true, prioritise));
+        CVideoInfoTag details;
+        ASSERT_TRUE(details.LoadFromXML(first));
+        ASSERT_TRUE(details.LoadFromXML(document, true, prioritise));
+        ExpectSameDetails(expected, details);
+      }
+    }
+  }
+}
+
+TEST(TestVideoInfoTag, LoadFromXML_Unsupported)
+{
+  CVideoInfoTag details;
+  ASSERT_TRUE(details.LoadFromXML("<movie><title>Title</title></movie>"));
+
+  // the documents that might be parsed otherwise leave the details untouched
+  const std::vector<std::string> unsupported = {
+      "",
+      "<movie><title>Other</title>",
+      "<!DOCTYPE movie><movie><title>Other</title></movie>",
+      "<movie><title>Other</title></movie><movie>",
+      "<movie>title<title>Other</title></movie>",
+      "<movie><actor>name<name>Other</name></actor></movie>",
+      "<movie><genre><![CDATA[]]></genre></movie>",
+      "<movie><title>\xE9</title></movie>",
+  };
+  for (const auto& document : unsupported)
+  {
+    EXPECT_FALSE(details.LoadFromXML(document)) << document;
+    EXPECT_EQ("Title", details.m_strTitle) << document;
+  }
+
+  // the root element is that of the given name
+  EXPECT_FALSE(details.LoadFromXML("<movie><title>Other</title></movie>", false, false, "details"));
+  EXPECT_FALSE(details.LoadFromXML("<!--details--><details><title>Other</title></details>",
+                                   false, false, "details"));
+  EXPECT_EQ("Title", details.m_strTitle);
+  EXPECT_TRUE(details.LoadFromXML("<details><title>Other</title></details>", true, false,
+                                  "details"));
+  EXPECT_EQ("Other", details.m_strTitle);
+}